@@ -0,0 +1,142 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include "dynamic_array.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/**
+ * @brief A bump-pointer arena.
+ * Allocation advances a cursor inside the current chunk; `deallocate` is a no-op and memory is
+ * only given back all at once, by `reset()` or the destructor. Chunks come from an upstream allocator.
+ * Satisfies the `Allocator` concept; pass `ArenaAllocator` (a copyable handle) where the allocator
+ * is stored by value.
+ * @tparam UpstreamT The allocator chunks are taken from. Defaults to `DefaultAllocator`.
+ */
+template <Allocator UpstreamT = DefaultAllocator>
+class Arena {
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    static constexpr std::align_val_t chunkAlignment = static_cast<std::align_val_t>(alignof(Chunk));
+
+    Chunk* _chunks = nullptr;
+    std::byte* _cursor = nullptr;
+    std::byte* _end = nullptr;
+    size_t _chunkSize;
+    size_t _bytesAllocated = 0;
+    UpstreamT _upstream;
+
+public:
+    /**
+     * @brief Constructs an empty arena. No memory is taken from upstream until the first allocation.
+     * @param chunkSize The usable size of a regular chunk. Larger requests get a chunk of their own.
+     */
+    explicit Arena(size_t chunkSize = 64 * 1024)
+        : _chunkSize(std::max<size_t>(chunkSize, 64)) {}
+
+    Arena(const Arena&) = delete;
+
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Destructor.
+     * Returns all chunks to upstream. Objects placed in the arena are not destroyed.
+     */
+    ~Arena() noexcept {
+        releaseChunks(_chunks);
+    }
+
+    /**
+     * @brief Allocates `count` bytes aligned to `alignment` by bumping the cursor.
+     * @throws std::bad_alloc If a new chunk is needed and upstream allocation fails.
+     */
+    void* allocate(size_t count, std::align_val_t alignment) {
+        size_t align = static_cast<size_t>(alignment);
+        auto cursor = reinterpret_cast<uintptr_t>(_cursor);
+        uintptr_t aligned = (cursor + align - 1) & ~(uintptr_t{align} - 1);
+        if (_cursor == nullptr || aligned + count > reinterpret_cast<uintptr_t>(_end)) {
+            addChunk(count + align);
+            cursor = reinterpret_cast<uintptr_t>(_cursor);
+            aligned = (cursor + align - 1) & ~(uintptr_t{align} - 1);
+        }
+        _cursor = reinterpret_cast<std::byte*>(aligned + count);
+        _bytesAllocated += count;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    /**
+     * @brief Does nothing: arena memory is reclaimed by `reset()` or the destructor.
+     */
+    void deallocate(void*, std::align_val_t) noexcept {}
+
+    /**
+     * @brief Releases everything allocated from the arena at once.
+     * The oldest chunk is kept for reuse, so an arena that is reset after every request reaches a
+     * steady state in which it never touches upstream.
+     */
+    void reset() noexcept {
+        if (_chunks == nullptr) {
+            return;
+        }
+        // Chunks are linked newest first; keep the oldest one.
+        while (_chunks->next != nullptr) {
+            Chunk* next = _chunks->next;
+            _upstream.deallocate(_chunks, chunkAlignment);
+            _chunks = next;
+        }
+        Chunk* first = _chunks;
+        _cursor = reinterpret_cast<std::byte*>(first + 1);
+        _end = _cursor + first->size;
+        _bytesAllocated = 0;
+    }
+
+    /**
+     * @brief Returns the number of bytes handed out since construction or the last `reset()`.
+     */
+    size_t bytesAllocated() const noexcept {
+        return _bytesAllocated;
+    }
+
+private:
+    void addChunk(size_t minimumSize) {
+        size_t size = std::max(_chunkSize, minimumSize);
+        void* memory = _upstream.allocate(sizeof(Chunk) + size, chunkAlignment);
+        Chunk* chunk = new (memory) Chunk{_chunks, size};
+        _chunks = chunk;
+        _cursor = reinterpret_cast<std::byte*>(chunk + 1);
+        _end = _cursor + size;
+    }
+
+    void releaseChunks(Chunk* chunk) noexcept {
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next;
+            _upstream.deallocate(chunk, chunkAlignment);
+            chunk = next;
+        }
+    }
+};
+
+/**
+ * @brief A copyable `Allocator` handle that forwards to an `Arena`. The arena must outlive it.
+ */
+template <Allocator UpstreamT = DefaultAllocator>
+struct ArenaAllocator {
+    Arena<UpstreamT>* arena = nullptr;
+
+    void* allocate(size_t count, std::align_val_t alignment) const {
+        return arena->allocate(count, alignment);
+    }
+
+    void deallocate(void* pointer, std::align_val_t alignment) const noexcept {
+        arena->deallocate(pointer, alignment);
+    }
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,164 @@
+#ifndef ATOMIC_UNIQUE_POINTER_HPP
+#define ATOMIC_UNIQUE_POINTER_HPP
+
+#include "unique_pointer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// What happens to the object displaced by `store`.
+enum class Reclaim {
+    Immediate, // delete it right away; no reader may still hold a borrowed pointer
+    Deferred,  // park it until `reclaimParked()` is called after readers have moved on
+};
+
+// Owning pointer slot that can be published and exchanged lock-free.
+// Readers borrow the current object with a single acquire load (`load()`); writers hand objects
+// in and out as `UniquePointer`s, so ownership never leaves the UniquePointer world.
+// Objects displaced while readers may still be looking at them can be parked and reclaimed later.
+// All objects are destroyed with the slot's own deleter.
+template <typename ValueT, typename DeleterT = DefaultDeleter<ValueT>>
+    requires Deleter<DeleterT, ValueT> &&
+             DefaultInit<DeleterT> &&
+             NotRvalueReference<DeleterT> &&
+             NotPointer<DeleterT> &&
+             NotArray<ValueT>
+class AtomicUniquePointer {
+public:
+    using ValueType = ValueT;
+    using DeleterType = DeleterT;
+    using UniquePointerType = UniquePointer<ValueT, DeleterT>;
+
+private:
+    struct Parked {
+        ValueT* pointer;
+        Parked* next;
+    };
+
+    std::atomic<ValueT*> _pointer = nullptr;
+    std::atomic<Parked*> _parked = nullptr;
+    [[no_unique_address]] DeleterT _deleter;
+
+public:
+    AtomicUniquePointer() noexcept {}
+
+    AtomicUniquePointer(nullptr_t) noexcept {}
+
+    AtomicUniquePointer(UniquePointerType&& pointer) noexcept
+        : _pointer(pointer.release()) {}
+
+    AtomicUniquePointer(const AtomicUniquePointer&) = delete;
+
+    AtomicUniquePointer& operator=(const AtomicUniquePointer&) = delete;
+
+    ~AtomicUniquePointer() noexcept {
+        destroy(_pointer.load(std::memory_order_acquire));
+        reclaimParked();
+    }
+
+    ValueT* load(std::memory_order order = std::memory_order_acquire) const noexcept {
+        return _pointer.load(order);
+    }
+
+    explicit operator bool() const noexcept {
+        return load() != nullptr;
+    }
+
+    UniquePointerType exchange(UniquePointerType&& desired, std::memory_order order = std::memory_order_acq_rel) noexcept {
+        return adopt(_pointer.exchange(desired.release(), order));
+    }
+
+    void store(UniquePointerType&& desired, Reclaim reclaim = Reclaim::Immediate) noexcept {
+        ValueT* previous = _pointer.exchange(desired.release(), std::memory_order_acq_rel);
+        if (reclaim == Reclaim::Immediate) {
+            destroy(previous);
+        } else {
+            park(previous);
+        }
+    }
+
+    // On success `desired` is installed and receives ownership of the displaced object.
+    // On failure `expected` is updated to the current object and `desired` is left untouched.
+    bool compareExchange(ValueT*& expected, UniquePointerType& desired, std::memory_order order = std::memory_order_acq_rel) noexcept {
+        ValueT* replacement = desired.get();
+        if (_pointer.compare_exchange_strong(expected, replacement, order, std::memory_order_acquire)) {
+            desired.release();
+            desired.reset(expected);
+            return true;
+        }
+        return false;
+    }
+
+    UniquePointerType release() noexcept {
+        return adopt(_pointer.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    void reset(Reclaim reclaim = Reclaim::Immediate) noexcept {
+        store(UniquePointerType(), reclaim);
+    }
+
+    // Hands `pointer` to the parking lot, e.g. an object taken out with `exchange` or `release`
+    // that readers may still be using.
+    void park(UniquePointerType&& pointer) noexcept {
+        park(pointer.release());
+    }
+
+    // Destroys every parked object. Call once no reader can still hold a pointer loaded
+    // before the corresponding `store`. Returns the number of objects destroyed.
+    size_t reclaimParked() noexcept {
+        Parked* node = _parked.exchange(nullptr, std::memory_order_acquire);
+        size_t count = 0;
+        while (node != nullptr) {
+            Parked* next = node->next;
+            destroy(node->pointer);
+            delete node;
+            node = next;
+            ++count;
+        }
+        return count;
+    }
+
+    bool hasParked() const noexcept {
+        return _parked.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    DeleterT& getDeleter() noexcept {
+        return _deleter;
+    }
+
+    const DeleterT& getDeleter() const noexcept {
+        return _deleter;
+    }
+
+private:
+    UniquePointerType adopt(ValueT* pointer) noexcept {
+        UniquePointerType result(pointer);
+        if constexpr (std::is_nothrow_copy_assignable_v<DeleterT>) {
+            result.getDeleter() = _deleter;
+        }
+        return result;
+    }
+
+    void destroy(ValueT* pointer) noexcept {
+        if (pointer != nullptr) {
+            _deleter(pointer);
+        }
+    }
+
+    void park(ValueT* pointer) noexcept {
+        if (pointer == nullptr) {
+            return;
+        }
+        Parked* node = new (std::nothrow) Parked{pointer, _parked.load(std::memory_order_relaxed)};
+        if (node == nullptr) {
+            // Out of memory: leaking is the only option that keeps readers safe.
+            return;
+        }
+        while (!_parked.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+#endif // ATOMIC_UNIQUE_POINTER_HPP
@@ -0,0 +1,33 @@
+#include "atomic_unique_pointer.hpp"
+#include <atomic>
+#include <print>
+#include <thread>
+
+struct Config {
+    int version;
+    int timeoutMs;
+};
+
+int main() {
+    AtomicUniquePointer<Config> current(makeUnique<Config>(1, 100));
+    std::atomic<bool> stop = false;
+
+    std::thread reader([&] {
+        long long reads = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            const Config* config = current.load();
+            reads += config->timeoutMs > 0;
+        }
+        std::println("reader: {} reads, last version {}", reads, current.load()->version);
+    });
+
+    for (int version = 2; version <= 5; ++version) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        current.store(makeUnique<Config>(version, version * 100), Reclaim::Deferred);
+        std::println("writer: published version {}", version);
+    }
+
+    stop = true;
+    reader.join();
+    std::println("reclaimed {} old configs", current.reclaimParked());
+}
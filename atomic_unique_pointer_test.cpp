@@ -0,0 +1,162 @@
+#include "atomic_unique_pointer.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+struct Config {
+    static int alive;
+
+    int version;
+
+    Config(int version)
+        : version(version) {
+        ++alive;
+    }
+
+    ~Config() {
+        --alive;
+    }
+};
+
+int Config::alive = 0;
+
+class AtomicUniquePointerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Config::alive = 0;
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(Config::alive, 0);
+    }
+};
+
+TEST_F(AtomicUniquePointerTest, DefaultIsNull) {
+    AtomicUniquePointer<Config> pointer;
+    EXPECT_EQ(pointer.load(), nullptr);
+    EXPECT_FALSE(pointer);
+}
+
+TEST_F(AtomicUniquePointerTest, TakesOwnership) {
+    {
+        AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+        ASSERT_NE(pointer.load(), nullptr);
+        EXPECT_EQ(pointer.load()->version, 1);
+        EXPECT_EQ(Config::alive, 1);
+    }
+    EXPECT_EQ(Config::alive, 0);
+}
+
+TEST_F(AtomicUniquePointerTest, Exchange) {
+    AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+    UniquePointer<Config> previous = pointer.exchange(makeUnique<Config>(2));
+    ASSERT_TRUE(previous);
+    EXPECT_EQ(previous->version, 1);
+    EXPECT_EQ(pointer.load()->version, 2);
+    EXPECT_EQ(Config::alive, 2);
+    previous.reset();
+    EXPECT_EQ(Config::alive, 1);
+}
+
+TEST_F(AtomicUniquePointerTest, StoreDestroysImmediately) {
+    AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+    pointer.store(makeUnique<Config>(2));
+    EXPECT_EQ(Config::alive, 1);
+    EXPECT_EQ(pointer.load()->version, 2);
+    pointer.reset();
+    EXPECT_EQ(Config::alive, 0);
+    EXPECT_EQ(pointer.load(), nullptr);
+}
+
+TEST_F(AtomicUniquePointerTest, StoreDeferredParksPrevious) {
+    AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+    Config* borrowed = pointer.load();
+    pointer.store(makeUnique<Config>(2), Reclaim::Deferred);
+    pointer.store(makeUnique<Config>(3), Reclaim::Deferred);
+    EXPECT_EQ(Config::alive, 3);
+    EXPECT_EQ(borrowed->version, 1);
+    EXPECT_TRUE(pointer.hasParked());
+    EXPECT_EQ(pointer.reclaimParked(), 2);
+    EXPECT_FALSE(pointer.hasParked());
+    EXPECT_EQ(Config::alive, 1);
+}
+
+TEST_F(AtomicUniquePointerTest, DestructorReclaimsParked) {
+    {
+        AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+        pointer.park(pointer.exchange(makeUnique<Config>(2)));
+        EXPECT_EQ(Config::alive, 2);
+    }
+    EXPECT_EQ(Config::alive, 0);
+}
+
+TEST_F(AtomicUniquePointerTest, CompareExchange) {
+    AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+    Config* expected = nullptr;
+    UniquePointer<Config> desired = makeUnique<Config>(2);
+
+    EXPECT_FALSE(pointer.compareExchange(expected, desired));
+    EXPECT_EQ(expected, pointer.load());
+    EXPECT_EQ(desired->version, 2);
+
+    EXPECT_TRUE(pointer.compareExchange(expected, desired));
+    EXPECT_EQ(pointer.load()->version, 2);
+    ASSERT_TRUE(desired);
+    EXPECT_EQ(desired->version, 1);
+    EXPECT_EQ(Config::alive, 2);
+}
+
+TEST_F(AtomicUniquePointerTest, Release) {
+    AtomicUniquePointer<Config> pointer(makeUnique<Config>(1));
+    UniquePointer<Config> owned = pointer.release();
+    EXPECT_EQ(pointer.load(), nullptr);
+    EXPECT_EQ(owned->version, 1);
+}
+
+struct CountingDeleter {
+    static int calls;
+
+    void operator()(Config* pointer) const noexcept {
+        ++calls;
+        delete pointer;
+    }
+};
+
+int CountingDeleter::calls = 0;
+
+TEST_F(AtomicUniquePointerTest, UsesDeleter) {
+    CountingDeleter::calls = 0;
+    {
+        AtomicUniquePointer<Config, CountingDeleter> pointer(UniquePointer<Config, CountingDeleter>(new Config(1)));
+        pointer.store(UniquePointer<Config, CountingDeleter>(new Config(2)));
+        EXPECT_EQ(CountingDeleter::calls, 1);
+        auto previous = pointer.exchange(UniquePointer<Config, CountingDeleter>(new Config(3)));
+    }
+    EXPECT_EQ(CountingDeleter::calls, 3);
+}
+
+TEST_F(AtomicUniquePointerTest, ConcurrentReadersSeeConsistentObjects) {
+    AtomicUniquePointer<Config> pointer(makeUnique<Config>(0));
+    std::atomic<bool> done = false;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                int version = pointer.load()->version;
+                EXPECT_GE(version, last);
+                last = version;
+            }
+        });
+    }
+    for (int version = 1; version <= 1000; ++version) {
+        pointer.store(makeUnique<Config>(version), Reclaim::Deferred);
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(pointer.reclaimParked(), 1000);
+    EXPECT_EQ(pointer.load()->version, 1000);
+}
@@ -0,0 +1,14 @@
+#ifndef CACHE_LINE_HPP
+#define CACHE_LINE_HPP
+
+#include <cstddef>
+
+// Size of a cache line used to keep independently written data apart (avoids false sharing).
+// Apple silicon fetches 128-byte lines; everything else we target uses 64 bytes.
+#if defined(__APPLE__) && defined(__aarch64__)
+inline constexpr std::size_t cacheLineSize = 128;
+#else
+inline constexpr std::size_t cacheLineSize = 64;
+#endif
+
+#endif // CACHE_LINE_HPP
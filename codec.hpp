@@ -0,0 +1,466 @@
+#ifndef CODEC_HPP
+#define CODEC_HPP
+
+#include "dynamic_array.hpp"
+#include "type_list.hpp"
+#include "varint.hpp"
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Fixed-size fields are stored in host byte order, and Stream VByte is little endian.
+static_assert(std::endian::native == std::endian::little, "The codec supports little-endian targets only");
+
+enum class FieldEncoding : uint8_t {
+    Raw,    // The bytes of a trivially copyable value.
+    Varint, // A 32-bit or narrower integer, LEB128 (zigzag for signed types).
+    Bytes,  // A contiguous sequence of trivially copyable elements, length first.
+};
+
+/**
+ * @brief A container of trivially copyable elements that can be encoded as one block of bytes,
+ * e.g. `std::string` or `DArray<float>`.
+ */
+template <typename T>
+concept ByteSequence = !std::is_trivially_copyable_v<T> && requires(T& value, const T& constValue, size_t n) {
+    { constValue.data() } -> std::convertible_to<const void*>;
+    { constValue.size() } -> std::convertible_to<size_t>;
+    value.resize(n);
+} && std::is_trivially_copyable_v<std::remove_cvref_t<decltype(*std::declval<T&>().data())>>;
+
+template <typename T>
+concept VarintValue = std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= 4;
+
+/**
+ * @brief Describes the data member `Member` of a record: trivially copyable members are encoded
+ * as their raw bytes, `ByteSequence` members as a length followed by the elements.
+ * Usage: `Field<&Trade::price>`.
+ */
+template <auto Member>
+struct Field;
+
+template <typename RecordT, typename ValueT, ValueT RecordT::* Member>
+struct Field<Member> {
+    static_assert(std::is_trivially_copyable_v<ValueT> || ByteSequence<ValueT>, "Field type has no binary encoding");
+
+    using Record = RecordT;
+    using Value = ValueT;
+    static constexpr auto member = Member;
+    static constexpr FieldEncoding encoding = ByteSequence<ValueT> ? FieldEncoding::Bytes : FieldEncoding::Raw;
+};
+
+/**
+ * @brief Describes an integer data member whose values are mostly small, encoded as a varint.
+ * Usage: `VarintField<&Trade::quantity>`.
+ */
+template <auto Member>
+struct VarintField;
+
+template <typename RecordT, typename ValueT, ValueT RecordT::* Member>
+struct VarintField<Member> {
+    static_assert(VarintValue<ValueT>, "Varint fields must be integers of at most 32 bits");
+
+    using Record = RecordT;
+    using Value = ValueT;
+    static constexpr auto member = Member;
+    static constexpr FieldEncoding encoding = FieldEncoding::Varint;
+};
+
+/**
+ * @brief Returns the number of descriptors among `OtherTs` that describe the same member as `FieldT`.
+ */
+template <typename FieldT, typename... OtherTs>
+constexpr size_t countFieldDescriptors() noexcept {
+    auto same = []<typename OtherT>() {
+        if constexpr (std::is_same_v<typename FieldT::Value, typename OtherT::Value>) {
+            return FieldT::member == OtherT::member;
+        } else {
+            return false;
+        }
+    };
+    return (size_t{same.template operator()<OtherTs>()} + ... + 0);
+}
+
+template <typename RecordT, typename FieldsT>
+class Codec;
+
+/**
+ * @brief A binary codec for `RecordT`, generated at compile time from a list of field descriptors.
+ * Consecutive `Raw` fields form a run. When the fields of a run are laid out back to back in the
+ * record, the run is copied with a single `memcpy`; a run that covers the whole record copies an
+ * entire batch at once. The format depends only on the descriptors, never on the record layout.
+ *
+ * A single record is encoded field by field, in list order. A batch is encoded column-wise: the
+ * record count (LEB128), then for each run the run bytes of every record, for each varint field
+ * its values in Stream VByte, and for each byte sequence field the lengths in Stream VByte
+ * followed by all elements.
+ * @tparam RecordT The record type. Batches are decoded into default-constructed records.
+ * @tparam FieldTs `Field` and `VarintField` descriptors of members of `RecordT`.
+ */
+template <typename RecordT, typename... FieldTs>
+class Codec<RecordT, TypeList<FieldTs...>> {
+    static_assert(sizeof...(FieldTs) > 0, "A codec needs at least one field");
+    static_assert((std::is_same_v<typename FieldTs::Record, RecordT> && ...), "Fields must be members of the record");
+    static_assert(((countFieldDescriptors<FieldTs, FieldTs...>() == 1) && ...), "A member can be described only once");
+
+private:
+    using Fields = TypeList<FieldTs...>;
+
+    template <size_t I>
+    using FieldAt = typename Fields::template type_at_t<I>;
+
+    template <size_t I>
+    using ValueAt = typename FieldAt<I>::Value;
+
+    static constexpr size_t fieldCount = Fields::size;
+    static constexpr std::array<FieldEncoding, fieldCount> encodings = {FieldTs::encoding...};
+    static constexpr std::array<size_t, fieldCount> sizes = {sizeof(typename FieldTs::Value)...};
+
+public:
+    /**
+     * @brief Appends the encoding of `record` to `out`.
+     */
+    static void encode(const RecordT& record, DArray<std::byte>& out) {
+        forEachGroup([&]<size_t First, size_t Last>() {
+            if constexpr (encodings[First] == FieldEncoding::Raw) {
+                size_t start = out.size();
+                out.resizeForOverwrite(start + runSize(First, Last));
+                copyRunOut<First, Last>(record, out.data() + start);
+            } else if constexpr (encodings[First] == FieldEncoding::Varint) {
+                writeVarint(toVarint(record.*FieldAt<First>::member), out);
+            } else {
+                const auto& value = record.*FieldAt<First>::member;
+                writeVarint(value.size(), out);
+                appendElements(value, out);
+            }
+        });
+    }
+
+    /**
+     * @brief Consumes one encoded record from `reader` into `record`.
+     * @throws std::out_of_range If the input is truncated.
+     * @throws std::invalid_argument If a varint does not fit its field.
+     */
+    static void decode(ByteReader& reader, RecordT& record) {
+        forEachGroup([&]<size_t First, size_t Last>() {
+            if constexpr (encodings[First] == FieldEncoding::Raw) {
+                copyRunIn<First, Last>(reader.take(runSize(First, Last)), record);
+            } else if constexpr (encodings[First] == FieldEncoding::Varint) {
+                record.*FieldAt<First>::member = fromVarint<ValueAt<First>>(reader.readVarint());
+            } else {
+                auto& value = record.*FieldAt<First>::member;
+                size_t length = checkedLength<ValueAt<First>>(reader.readVarint(), reader);
+                readElements(reader.take(length * elementSize<ValueAt<First>>()), length, value);
+            }
+        });
+    }
+
+    /**
+     * @brief Decodes one record from the front of `input`.
+     * @return The number of bytes consumed.
+     * @throws std::out_of_range If the input is truncated.
+     * @throws std::invalid_argument If a varint does not fit its field.
+     */
+    static size_t decode(std::span<const std::byte> input, RecordT& record) {
+        ByteReader reader(input);
+        decode(reader, record);
+        return input.size() - reader.remaining();
+    }
+
+    /**
+     * @brief Appends the column-wise encoding of `records` to `out`.
+     * @throws std::length_error If a byte sequence field holds 2^32 or more elements.
+     */
+    static void encodeBatch(std::span<const RecordT> records, DArray<std::byte>& out) {
+        size_t count = records.size();
+        writeVarint(count, out);
+        if (count == 0) {
+            return;
+        }
+        DArray<uint32_t> column;
+        forEachGroup([&]<size_t First, size_t Last>() {
+            if constexpr (encodings[First] == FieldEncoding::Raw) {
+                constexpr size_t bytes = runSize(First, Last);
+                size_t start = out.size();
+                out.resizeForOverwrite(start + bytes * count);
+                std::byte* dst = out.data() + start;
+                if (coversRecord<First, Last>(records[0])) {
+                    std::memcpy(dst, records.data(), bytes * count);
+                } else {
+                    for (const RecordT& record : records) {
+                        copyRunOut<First, Last>(record, dst);
+                        dst += bytes;
+                    }
+                }
+            } else if constexpr (encodings[First] == FieldEncoding::Varint) {
+                column.resizeForOverwrite(count);
+                for (size_t i = 0; i < count; ++i) {
+                    column[i] = toVarint(records[i].*FieldAt<First>::member);
+                }
+                encodeStreamVByte(column, out);
+            } else {
+                column.resizeForOverwrite(count);
+                for (size_t i = 0; i < count; ++i) {
+                    size_t length = (records[i].*FieldAt<First>::member).size();
+                    if (length > std::numeric_limits<uint32_t>::max()) {
+                        throw std::length_error("Field is too long for a batch");
+                    }
+                    column[i] = static_cast<uint32_t>(length);
+                }
+                encodeStreamVByte(column, out);
+                for (const RecordT& record : records) {
+                    appendElements(record.*FieldAt<First>::member, out);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Consumes a batch encoded by `encodeBatch` from `reader` and appends its records to
+     * `records`. Decoding into a reused array avoids allocating and faulting in fresh memory. If
+     * decoding fails, `records` keeps its previous contents.
+     * @throws std::out_of_range If the input is truncated.
+     * @throws std::invalid_argument If a varint does not fit its field.
+     */
+    static void decodeBatch(ByteReader& reader, DArray<RecordT>& records) {
+        uint64_t count = reader.readVarint();
+        // Every record takes at least `minimumRecordSize` bytes, which bounds the allocation below
+        // by the input size rather than by a corrupted count.
+        if (count > reader.remaining() / minimumRecordSize()) {
+            throw std::out_of_range("Truncated input");
+        }
+        if (count == 0) {
+            return;
+        }
+        size_t start = records.size();
+        if constexpr (tilesRecord()) {
+            // Every byte of the new records is overwritten below.
+            records.resizeForOverwrite(start + count);
+        } else {
+            records.resize(start + count);
+        }
+        // On failure the partially decoded records are removed again.
+        auto guard = makeExceptionGuard([&records, start] { records.resize(start); });
+        std::span<RecordT> batch = records.slice(start, count);
+        DArray<uint32_t> column;
+        forEachGroup([&]<size_t First, size_t Last>() {
+            if constexpr (encodings[First] == FieldEncoding::Raw) {
+                constexpr size_t bytes = runSize(First, Last);
+                const std::byte* src = reader.take(bytes * count);
+                if (coversRecord<First, Last>(batch[0])) {
+                    std::memcpy(static_cast<void*>(batch.data()), src, bytes * count);
+                } else {
+                    for (RecordT& record : batch) {
+                        copyRunIn<First, Last>(src, record);
+                        src += bytes;
+                    }
+                }
+            } else if constexpr (encodings[First] == FieldEncoding::Varint) {
+                column.resizeForOverwrite(count);
+                decodeStreamVByte(reader, column);
+                for (size_t i = 0; i < count; ++i) {
+                    batch[i].*FieldAt<First>::member = fromVarint<ValueAt<First>>(column[i]);
+                }
+            } else {
+                column.resizeForOverwrite(count);
+                decodeStreamVByte(reader, column);
+                uint64_t total = 0;
+                for (uint32_t length : column) {
+                    total += length;
+                }
+                const std::byte* src = reader.take(checkedLength<ValueAt<First>>(total, reader) * elementSize<ValueAt<First>>());
+                for (size_t i = 0; i < count; ++i) {
+                    readElements(src, column[i], batch[i].*FieldAt<First>::member);
+                    src += column[i] * elementSize<ValueAt<First>>();
+                }
+            }
+        });
+        guard.complete();
+    }
+
+    /**
+     * @brief Consumes a batch encoded by `encodeBatch` from `reader`.
+     * @throws std::out_of_range If the input is truncated.
+     * @throws std::invalid_argument If a varint does not fit its field.
+     */
+    static DArray<RecordT> decodeBatch(ByteReader& reader) {
+        DArray<RecordT> records;
+        decodeBatch(reader, records);
+        return records;
+    }
+
+    /**
+     * @brief Decodes a batch from the front of `input`.
+     * @throws std::out_of_range If the input is truncated.
+     * @throws std::invalid_argument If a varint does not fit its field.
+     */
+    static DArray<RecordT> decodeBatch(std::span<const std::byte> input) {
+        ByteReader reader(input);
+        return decodeBatch(reader);
+    }
+
+private:
+    // Calls `visit.template operator()<First, Last>()` for each group of fields, in order: a run of
+    // consecutive raw fields, or a single varint or byte sequence field.
+    template <size_t First = 0, typename VisitorT>
+    static void forEachGroup(VisitorT&& visit) {
+        if constexpr (First < fieldCount) {
+            constexpr size_t last = runEnd(First);
+            visit.template operator()<First, last>();
+            forEachGroup<last>(visit);
+        }
+    }
+
+    static constexpr size_t runEnd(size_t first) noexcept {
+        if (encodings[first] != FieldEncoding::Raw) {
+            return first + 1;
+        }
+        size_t last = first + 1;
+        while (last < fieldCount && encodings[last] == FieldEncoding::Raw) {
+            ++last;
+        }
+        return last;
+    }
+
+    static constexpr size_t runSize(size_t first, size_t last) noexcept {
+        size_t size = 0;
+        for (size_t i = first; i < last; ++i) {
+            size += sizes[i];
+        }
+        return size;
+    }
+
+    // True if the fields are raw and together occupy every byte of a trivially copyable record.
+    static constexpr bool tilesRecord() noexcept {
+        return std::is_trivially_copyable_v<RecordT> && runEnd(0) == fieldCount && runSize(0, fieldCount) == sizeof(RecordT);
+    }
+
+    static constexpr size_t minimumRecordSize() noexcept {
+        size_t size = 0;
+        for (size_t i = 0; i < fieldCount; ++i) {
+            // A varint or a length takes at least one byte (in Stream VByte, one data byte).
+            size += encodings[i] == FieldEncoding::Raw ? sizes[i] : 1;
+        }
+        return std::max<size_t>(size, 1);
+    }
+
+    template <size_t I>
+    static size_t offsetOf(const RecordT& record) noexcept {
+        return static_cast<size_t>(reinterpret_cast<const std::byte*>(std::addressof(record.*FieldAt<I>::member)) -
+                                   reinterpret_cast<const std::byte*>(std::addressof(record)));
+    }
+
+    // True if the fields [First, Last) follow each other without padding. Member offsets are
+    // constants, so after inlining the compiler folds this to `true` or `false`.
+    template <size_t First, size_t Last>
+    static bool contiguous(const RecordT& record) noexcept {
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return ((offsetOf<First + Is>(record) + sizes[First + Is] == offsetOf<First + Is + 1>(record)) && ...);
+        }(std::make_index_sequence<Last - First - 1>{});
+    }
+
+    template <size_t First, size_t Last>
+    static bool coversRecord(const RecordT& record) noexcept {
+        if constexpr (tilesRecord()) {
+            return contiguous<First, Last>(record);
+        } else {
+            return false;
+        }
+    }
+
+    template <size_t First, size_t Last>
+    static void copyRunOut(const RecordT& record, std::byte* dst) noexcept {
+        const auto* bytes = reinterpret_cast<const std::byte*>(std::addressof(record));
+        if (contiguous<First, Last>(record)) {
+            std::memcpy(dst, bytes + offsetOf<First>(record), runSize(First, Last));
+        } else {
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                ((std::memcpy(dst, bytes + offsetOf<First + Is>(record), sizes[First + Is]), dst += sizes[First + Is]), ...);
+            }(std::make_index_sequence<Last - First>{});
+        }
+    }
+
+    template <size_t First, size_t Last>
+    static void copyRunIn(const std::byte* src, RecordT& record) noexcept {
+        auto* bytes = reinterpret_cast<std::byte*>(std::addressof(record));
+        if (contiguous<First, Last>(record)) {
+            std::memcpy(bytes + offsetOf<First>(record), src, runSize(First, Last));
+        } else {
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                ((std::memcpy(bytes + offsetOf<First + Is>(record), src, sizes[First + Is]), src += sizes[First + Is]), ...);
+            }(std::make_index_sequence<Last - First>{});
+        }
+    }
+
+    template <typename ValueT>
+    static uint32_t toVarint(ValueT value) noexcept {
+        if constexpr (std::is_signed_v<ValueT>) {
+            return zigzagEncode(value);
+        } else {
+            return value;
+        }
+    }
+
+    template <typename ValueT>
+    static ValueT fromVarint(uint64_t encoded) {
+        if (encoded > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Varint out of range");
+        }
+        auto value = static_cast<uint32_t>(encoded);
+        if constexpr (std::is_signed_v<ValueT>) {
+            int32_t decoded = zigzagDecode(value);
+            if (!std::in_range<ValueT>(decoded)) {
+                throw std::invalid_argument("Varint out of range");
+            }
+            return static_cast<ValueT>(decoded);
+        } else {
+            if (!std::in_range<ValueT>(value)) {
+                throw std::invalid_argument("Varint out of range");
+            }
+            return static_cast<ValueT>(value);
+        }
+    }
+
+    template <typename SequenceT>
+    static constexpr size_t elementSize() noexcept {
+        return sizeof(*std::declval<SequenceT&>().data());
+    }
+
+    // Rejects lengths whose elements cannot possibly be in the input before anything is allocated.
+    template <typename SequenceT>
+    static size_t checkedLength(uint64_t length, const ByteReader& reader) {
+        if (length > reader.remaining() / elementSize<SequenceT>()) {
+            throw std::out_of_range("Truncated input");
+        }
+        return static_cast<size_t>(length);
+    }
+
+    template <typename SequenceT>
+    static void appendElements(const SequenceT& value, DArray<std::byte>& out) {
+        size_t bytes = value.size() * elementSize<SequenceT>();
+        if (bytes > 0) {
+            size_t start = out.size();
+            out.resizeForOverwrite(start + bytes);
+            std::memcpy(out.data() + start, value.data(), bytes);
+        }
+    }
+
+    template <typename SequenceT>
+    static void readElements(const std::byte* src, size_t length, SequenceT& value) {
+        value.resize(length);
+        if (length > 0) {
+            std::memcpy(static_cast<void*>(value.data()), src, length * elementSize<SequenceT>());
+        }
+    }
+};
+
+#endif // CODEC_HPP
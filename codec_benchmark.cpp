@@ -0,0 +1,84 @@
+#include "codec.hpp"
+#include "dynamic_array.hpp"
+#include <chrono>
+#include <cstring>
+#include <print>
+#include <string>
+
+// Encode and decode throughput of `Codec` batches, in bytes of records per second. A flat record
+// should run at the speed of a plain `memcpy` of the same bytes, which is printed first.
+
+namespace {
+
+struct Tick {
+    uint64_t timestamp;
+    double bid;
+    double ask;
+    uint32_t bidSize;
+    uint32_t askSize;
+};
+
+using TickCodec = Codec<Tick, TypeList<Field<&Tick::timestamp>, Field<&Tick::bid>, Field<&Tick::ask>,
+                                       Field<&Tick::bidSize>, Field<&Tick::askSize>>>;
+
+struct Trade {
+    uint64_t timestamp;
+    double price;
+    uint32_t quantity;
+    std::string symbol;
+};
+
+using TradeCodec = Codec<Trade, TypeList<Field<&Trade::timestamp>, Field<&Trade::price>,
+                                         VarintField<&Trade::quantity>, Field<&Trade::symbol>>>;
+
+constexpr size_t recordCount = 1 << 20;
+constexpr int repetitions = 20;
+
+template <typename CallT>
+double measure(size_t bytes, CallT call) {
+    call();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        call();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(bytes) * repetitions / elapsed.count() / 1e9;
+}
+
+template <typename CodecT, typename RecordT>
+void report(const char* name, const DArray<RecordT>& records) {
+    DArray<std::byte> encoded;
+    size_t bytes = records.size() * sizeof(RecordT);
+    double encodeRate = measure(bytes, [&] {
+        encoded.clear();
+        CodecT::encodeBatch(records, encoded);
+    });
+    DArray<RecordT> decoded;
+    double decodeRate = measure(bytes, [&] {
+        decoded.clear();
+        ByteReader reader(encoded);
+        CodecT::decodeBatch(reader, decoded);
+    });
+    std::println("{:>8} {:>12.2f} {:>12.2f} {:>14}", name, encodeRate, decodeRate, encoded.size());
+}
+
+} // namespace
+
+int main() {
+    DArray<Tick> ticks;
+    DArray<Trade> trades;
+    ticks.reserve(recordCount);
+    trades.reserve(recordCount);
+    for (size_t i = 0; i < recordCount; ++i) {
+        ticks.push({1'700'000'000'000 + i, 100.0 + i % 50, 100.5 + i % 50, static_cast<uint32_t>(i % 300), static_cast<uint32_t>(i % 700)});
+        trades.push({1'700'000'000'000 + i, 100.0 + i % 50, static_cast<uint32_t>(i % 1000), i % 2 ? "MSFT" : "AAPL"});
+    }
+
+    DArray<Tick> copy(recordCount);
+    double copyRate = measure(recordCount * sizeof(Tick), [&] { std::memcpy(static_cast<void*>(copy.data()), ticks.data(), recordCount * sizeof(Tick)); });
+
+    std::println("{:>8} {:>12} {:>12} {:>14}", "record", "encode GB/s", "decode GB/s", "encoded bytes");
+    std::println("{:>8} {:>12.2f} {:>12.2f} {:>14}", "memcpy", copyRate, copyRate, recordCount * sizeof(Tick));
+    report<TickCodec>("tick", ticks);
+    report<TradeCodec>("trade", trades);
+}
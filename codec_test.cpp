@@ -0,0 +1,180 @@
+#include "codec.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+struct Point {
+    int32_t x;
+    int32_t y;
+    float weight;
+    uint32_t id;
+};
+
+using PointCodec = Codec<Point, TypeList<Field<&Point::x>, Field<&Point::y>, Field<&Point::weight>, Field<&Point::id>>>;
+
+struct Order {
+    uint64_t id;
+    double price;
+    int32_t quantity;
+    std::string symbol;
+    uint16_t venue;
+    DArray<float> fills;
+};
+
+using OrderCodec = Codec<Order, TypeList<Field<&Order::id>, Field<&Order::price>, VarintField<&Order::quantity>,
+                                         Field<&Order::symbol>, VarintField<&Order::venue>, Field<&Order::fills>>>;
+
+// The same fields as `Point`, declared in a different order and with padding in between.
+struct PaddedPoint {
+    uint32_t id;
+    double padding;
+    int32_t x;
+    int32_t y;
+    float weight;
+};
+
+using PaddedPointCodec = Codec<PaddedPoint, TypeList<Field<&PaddedPoint::x>, Field<&PaddedPoint::y>,
+                                                     Field<&PaddedPoint::weight>, Field<&PaddedPoint::id>>>;
+
+Order makeOrder(int i) {
+    Order order{static_cast<uint64_t>(i) * 1000003, 100.25 + i, i % 7 - 3, "SYM" + std::to_string(i), static_cast<uint16_t>(i % 3), {}};
+    for (int j = 0; j < i % 4; ++j) {
+        order.fills.push(static_cast<float>(i + j));
+    }
+    return order;
+}
+
+void expectEqual(const Order& actual, const Order& expected) {
+    EXPECT_EQ(actual.id, expected.id);
+    EXPECT_EQ(actual.price, expected.price);
+    EXPECT_EQ(actual.quantity, expected.quantity);
+    EXPECT_EQ(actual.symbol, expected.symbol);
+    EXPECT_EQ(actual.venue, expected.venue);
+    ASSERT_EQ(actual.fills.size(), expected.fills.size());
+    for (size_t i = 0; i < expected.fills.size(); ++i) {
+        EXPECT_EQ(actual.fills[i], expected.fills[i]);
+    }
+}
+
+} // namespace
+
+// Test that a flat record is encoded as its bytes, and a flat batch as the bytes of the array
+TEST(CodecTest, FlatRecord) {
+    Point point{1, -2, 0.5f, 7};
+    DArray<std::byte> out;
+
+    PointCodec::encode(point, out);
+
+    ASSERT_EQ(out.size(), sizeof(Point));
+    EXPECT_EQ(std::memcmp(out.data(), &point, sizeof(Point)), 0);
+    Point decoded{};
+    EXPECT_EQ(PointCodec::decode(out, decoded), sizeof(Point));
+    EXPECT_EQ(decoded.x, 1);
+    EXPECT_EQ(decoded.y, -2);
+    EXPECT_EQ(decoded.weight, 0.5f);
+    EXPECT_EQ(decoded.id, 7);
+
+    DArray<Point> points = {{1, 2, 3.0f, 4}, {5, 6, 7.0f, 8}, {9, 10, 11.0f, 12}};
+    out.clear();
+    PointCodec::encodeBatch(points, out);
+    ASSERT_EQ(out.size(), 1 + points.size() * sizeof(Point));
+    EXPECT_EQ(std::memcmp(out.data() + 1, points.data(), points.size() * sizeof(Point)), 0);
+    DArray<Point> decodedPoints = PointCodec::decodeBatch(out);
+    ASSERT_EQ(decodedPoints.size(), 3);
+    EXPECT_EQ(std::memcmp(decodedPoints.data(), points.data(), points.size() * sizeof(Point)), 0);
+}
+
+// Test that the format depends on the field list, not on the layout of the record
+TEST(CodecTest, LayoutIndependence) {
+    DArray<Point> points;
+    DArray<PaddedPoint> paddedPoints;
+    for (int i = 0; i < 10; ++i) {
+        points.push({i, -i, i * 0.25f, static_cast<uint32_t>(100 + i)});
+        paddedPoints.push({static_cast<uint32_t>(100 + i), 0.0, i, -i, i * 0.25f});
+    }
+    DArray<std::byte> out;
+    DArray<std::byte> paddedOut;
+
+    PointCodec::encodeBatch(points, out);
+    PaddedPointCodec::encodeBatch(paddedPoints, paddedOut);
+
+    ASSERT_EQ(out.size(), paddedOut.size());
+    EXPECT_EQ(std::memcmp(out.data(), paddedOut.data(), out.size()), 0);
+    DArray<PaddedPoint> decoded = PaddedPointCodec::decodeBatch(out);
+    ASSERT_EQ(decoded.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(decoded[i].x, i);
+        EXPECT_EQ(decoded[i].y, -i);
+        EXPECT_EQ(decoded[i].weight, i * 0.25f);
+        EXPECT_EQ(decoded[i].id, 100 + i);
+    }
+}
+
+// Test a record with varint and byte sequence fields, one record at a time
+TEST(CodecTest, MixedRecord) {
+    DArray<std::byte> out;
+    for (int i = 0; i < 20; ++i) {
+        OrderCodec::encode(makeOrder(i), out);
+    }
+
+    ByteReader reader(out);
+    for (int i = 0; i < 20; ++i) {
+        Order decoded{};
+        OrderCodec::decode(reader, decoded);
+        expectEqual(decoded, makeOrder(i));
+    }
+    EXPECT_EQ(reader.remaining(), 0);
+}
+
+// Test a batch of records with varint and byte sequence fields
+TEST(CodecTest, MixedBatch) {
+    DArray<Order> orders;
+    for (int i = 0; i < 1000; ++i) {
+        orders.push(makeOrder(i));
+    }
+    DArray<std::byte> out;
+
+    OrderCodec::encodeBatch(orders, out);
+    OrderCodec::encodeBatch(std::span<const Order>(), out);
+
+    ByteReader reader(out);
+    DArray<Order> decoded = OrderCodec::decodeBatch(reader);
+    ASSERT_EQ(decoded.size(), orders.size());
+    for (size_t i = 0; i < orders.size(); ++i) {
+        expectEqual(decoded[i], orders[i]);
+    }
+    EXPECT_TRUE(OrderCodec::decodeBatch(reader).empty());
+    EXPECT_EQ(reader.remaining(), 0);
+}
+
+// Test that truncated and corrupted input is rejected
+TEST(CodecTest, MalformedInput) {
+    DArray<Order> orders;
+    for (int i = 0; i < 50; ++i) {
+        orders.push(makeOrder(i));
+    }
+    DArray<std::byte> out;
+    OrderCodec::encodeBatch(orders, out);
+
+    for (size_t size = 0; size < out.size(); size += 7) {
+        EXPECT_THROW(OrderCodec::decodeBatch(out.slice(0, size)), std::out_of_range) << "size " << size;
+    }
+
+    // A huge record count is rejected before anything is allocated.
+    DArray<std::byte> huge;
+    writeVarint(uint64_t{1} << 60, huge);
+    EXPECT_THROW(PointCodec::decodeBatch(huge), std::out_of_range);
+
+    // 70000 does not fit the uint16_t venue.
+    DArray<std::byte> single;
+    Order order = makeOrder(1);
+    OrderCodec::encode(order, single);
+    size_t venueOffset = 8 + 8 + 1 + 1 + order.symbol.size();
+    single.erase(single.begin() + venueOffset);
+    DArray<std::byte> venue;
+    writeVarint(70000, venue);
+    single.insert(single.begin() + venueOffset, venue);
+    Order decoded{};
+    EXPECT_THROW(OrderCodec::decode(single, decoded), std::invalid_argument);
+}
@@ -0,0 +1,157 @@
+// The library as a C++20 module: `import cpp_ds;` parses the headers once, when the module is
+// built, instead of in every translation unit. Every public name is exported; `DS_TARGET_*` are
+// macros and stay with cpu_dispatch.hpp. Formatting support is not exported;
+// include dynamic_array_format.hpp where DArray has to be printed.
+module;
+
+#include "arena.hpp"
+#include "atomic_unique_pointer.hpp"
+#include "cache_line.hpp"
+#include "codec.hpp"
+#include "cpu_dispatch.hpp"
+#include "dynamic_array.hpp"
+#include "exception_guard.hpp"
+#include "hierarchical_bitmap.hpp"
+#include "latency_histogram.hpp"
+#include "memory_footprint.hpp"
+#include "minimal_perfect_hash.hpp"
+#include "mpmc_queue.hpp"
+#include "packed_memory_array.hpp"
+#include "perf_benchmark.hpp"
+#include "pipeline.hpp"
+#include "roaring_bitmap.hpp"
+#include "simd_kernels.hpp"
+#include "size_class_pool.hpp"
+#include "sparse_set.hpp"
+#include "spsc_queue.hpp"
+#include "stable_array.hpp"
+#include "static_map.hpp"
+#include "strided_slice.hpp"
+#include "suffix_array.hpp"
+#include "table.hpp"
+#include "task.hpp"
+#include "timing_wheel.hpp"
+#include "type_list.hpp"
+#include "unique_pointer.hpp"
+#include "varint.hpp"
+#include "worker_threads.hpp"
+
+export module cpp_ds;
+
+export using ::Allocator;
+export using ::DefaultAllocator;
+export using ::isTriviallyRelocatable;
+export using ::DArray;
+export using ::concat;
+export using ::StridedSlice;
+export using ::SparseSet;
+export using ::StableArray;
+export using ::SpscQueue;
+export using ::MpmcQueue;
+export using ::TimerHandle;
+export using ::TimingWheel;
+export using ::TypeList;
+export using ::DefaultDeleter;
+export using ::UniquePointer;
+export using ::makeUnique;
+export using ::cacheLineSize;
+export using ::ExceptionGuard;
+export using ::makeExceptionGuard;
+export using ::Reclaim;
+export using ::AtomicUniquePointer;
+export using ::ColumnTypes;
+export using ::ColumnType;
+export using ::columnTypeOf;
+export using ::ColumnSpec;
+export using ::Column;
+export using ::Projection;
+export using ::Table;
+export using ::Batch;
+export using ::MorselScan;
+export using ::Stage;
+export using ::ThreadPool;
+export using ::Channel;
+export using ::BufferPool;
+export using ::Arena;
+export using ::ArenaAllocator;
+export using ::FrameAllocation;
+export using ::TaskResult;
+export using ::Task;
+export using ::Generator;
+export using ::CpuTarget;
+export using ::cpuTargetCount;
+export using ::cpuTargetName;
+export using ::parseCpuTarget;
+export using ::detectCpuTargets;
+export using ::activeCpuTargets;
+export using ::cpuTargetEnabled;
+export using ::Dispatched;
+export using ::sumValues;
+export using ::findValue;
+export using ::PerfEvent;
+export using ::perfEventCount;
+export using ::perfEventName;
+export using ::PerfSample;
+export using ::PerfCounters;
+export using ::pinThreadToCpu;
+export using ::CacheMode;
+export using ::BenchmarkOptions;
+export using ::BenchmarkResult;
+export using ::PerfBenchmark;
+export using ::zigzagEncode;
+export using ::zigzagDecode;
+export using ::writeVarint;
+export using ::ByteReader;
+export using ::streamVByteControlSize;
+export using ::encodeStreamVByte;
+export using ::decodeStreamVByte;
+export using ::FieldEncoding;
+export using ::ByteSequence;
+export using ::VarintValue;
+export using ::Field;
+export using ::VarintField;
+export using ::Codec;
+export using ::SizeClass;
+export using ::sizeClassOf;
+export using ::SizeClassPool;
+export using ::SizeClassPoolAllocator;
+export using ::PoolDeleter;
+export using ::PoolPointer;
+export using ::makePooled;
+export using ::HistogramBuckets;
+export using ::HistogramSnapshot;
+export using ::LatencyHistogram;
+export using ::CycleClock;
+export using ::ScopedTimer;
+export using ::MemoryFootprint;
+export using ::FootprintTraits;
+export using ::FootprintFields;
+export using ::FootprintField;
+export using ::ownsHeapMemory;
+export using ::heapFootprint;
+export using ::memoryFootprint;
+export using ::parallelFootprintThreshold;
+export using ::sumFootprints;
+export using ::runWorkers;
+export using ::StaticKey;
+export using ::staticHash;
+export using ::StaticSet;
+export using ::StaticMap;
+export using ::StaticTupleMap;
+export using ::makeStaticSet;
+export using ::makeStaticMap;
+export using ::makeStaticTupleMap;
+export using ::PackedMemoryArray;
+export using ::HierarchicalBitmap;
+export using ::BitsetOperation;
+export using ::roaringBitsetWords;
+export using ::roaringArrayLimit;
+export using ::bitsetOperationKernel;
+export using ::intersectSortedKernel;
+export using ::RoaringContainerKind;
+export using ::RoaringBitmap;
+export using ::RoaringView;
+export using ::inducedSort;
+export using ::SuffixArray;
+export using ::buildSuffixArrays;
+export using ::MinimalPerfectHash;
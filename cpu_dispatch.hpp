@@ -0,0 +1,188 @@
+#ifndef CPU_DISPATCH_HPP
+#define CPU_DISPATCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+// Kernels are compiled for several instruction sets in the same binary: each variant is a function
+// with a `DS_TARGET_*` attribute, so the binary still runs on CPUs that lack the wider instructions.
+// The CPU is inspected once, and callers go through a `Dispatched` function pointer chosen from it.
+#if defined(__x86_64__)
+#define DS_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#define DS_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx2,bmi,bmi2,popcnt")))
+#endif
+
+/**
+ * @brief An instruction set a kernel variant can be compiled for, in order of preference.
+ * NEON is part of the arm64 baseline; the AVX targets exist only on x86.
+ */
+enum class CpuTarget : uint8_t {
+    Scalar,
+    Neon,
+    Avx2,
+    Avx512,
+};
+
+inline constexpr size_t cpuTargetCount = 4;
+
+/**
+ * @brief Returns the lowercase name of `target`, as accepted by the `CPP_DS_CPU_TARGET` override.
+ */
+constexpr std::string_view cpuTargetName(CpuTarget target) noexcept {
+    switch (target) {
+    case CpuTarget::Scalar:
+        return "scalar";
+    case CpuTarget::Neon:
+        return "neon";
+    case CpuTarget::Avx2:
+        return "avx2";
+    case CpuTarget::Avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parses a target name. Returns `false` and leaves `target` untouched if the name is unknown.
+ */
+constexpr bool parseCpuTarget(std::string_view name, CpuTarget& target) noexcept {
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        if (name == cpuTargetName(static_cast<CpuTarget>(i))) {
+            target = static_cast<CpuTarget>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Queries the CPU (CPUID and XGETBV on x86) for the targets it can run.
+ * @return A bit mask with bit `i` set if `CpuTarget(i)` is supported. `Scalar` is always set.
+ */
+inline uint32_t detectCpuTargets() noexcept {
+    uint32_t targets = 1u << static_cast<unsigned>(CpuTarget::Scalar);
+#if defined(__aarch64__)
+    targets |= 1u << static_cast<unsigned>(CpuTarget::Neon);
+#elif defined(__x86_64__)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+        return targets;
+    }
+    // The CPU may support AVX while the OS does not save the wider registers on context switches.
+    uint32_t xcr0, xcr0High;
+    __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+    bool ymmEnabled = (xcr0 & 0x06) == 0x06;
+    bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return targets;
+    }
+    bool bmi = (ebx & bit_BMI) && (ebx & bit_BMI2);
+    if (ymmEnabled && bmi && (ebx & bit_AVX2)) {
+        targets |= 1u << static_cast<unsigned>(CpuTarget::Avx2);
+        if (zmmEnabled && (ebx & bit_AVX512F) && (ebx & bit_AVX512BW) && (ebx & bit_AVX512VL)) {
+            targets |= 1u << static_cast<unsigned>(CpuTarget::Avx512);
+        }
+    }
+#endif
+    return targets;
+}
+
+/**
+ * @brief Returns the bit mask of targets this process may use, detected once on first call.
+ * The `CPP_DS_CPU_TARGET` environment variable (e.g. `CPP_DS_CPU_TARGET=avx2`) caps the selection
+ * for testing and benchmarking; it can lower the target but never enable one the CPU lacks.
+ */
+inline uint32_t activeCpuTargets() noexcept {
+    static const uint32_t targets = [] {
+        uint32_t supported = detectCpuTargets();
+        CpuTarget limit;
+        const char* override = std::getenv("CPP_DS_CPU_TARGET");
+        if (override != nullptr && parseCpuTarget(override, limit)) {
+            supported &= (2u << static_cast<unsigned>(limit)) - 1;
+        }
+        return supported;
+    }();
+    return targets;
+}
+
+/**
+ * @brief Returns true if kernels compiled for `target` can run in this process.
+ */
+inline bool cpuTargetEnabled(CpuTarget target) noexcept {
+    return activeCpuTargets() & (1u << static_cast<unsigned>(target));
+}
+
+template <typename FunctionT>
+class Dispatched;
+
+/**
+ * @brief A function implemented by several kernel variants, bound to the best one for this CPU.
+ * The choice is made once, at construction; calls are a plain indirect call through a cached
+ * pointer. Intended to be a namespace-scope `inline const` object next to its variants.
+ * @tparam ResultT The return type.
+ * @tparam ArgTs The parameter types.
+ */
+template <typename ResultT, typename... ArgTs>
+class Dispatched<ResultT(ArgTs...)> {
+public:
+    using Function = ResultT (*)(ArgTs...);
+
+private:
+    std::array<Function, cpuTargetCount> _variants{};
+    Function _selected = nullptr;
+    CpuTarget _target = CpuTarget::Scalar;
+
+public:
+    /**
+     * @brief Binds to the best variant enabled for this process (see `activeCpuTargets`).
+     * @param variants Pairs of target and implementation. A `Scalar` variant is required.
+     */
+    Dispatched(std::initializer_list<std::pair<CpuTarget, Function>> variants) noexcept
+        : Dispatched(variants, activeCpuTargets()) {}
+
+    /**
+     * @brief Binds to the best variant whose target is in `enabled`.
+     */
+    Dispatched(std::initializer_list<std::pair<CpuTarget, Function>> variants, uint32_t enabled) noexcept {
+        for (const auto& [target, function] : variants) {
+            _variants[static_cast<size_t>(target)] = function;
+        }
+        for (size_t i = cpuTargetCount; i-- > 0;) {
+            if (_variants[i] != nullptr && (i == 0 || (enabled & (1u << i)))) {
+                _selected = _variants[i];
+                _target = static_cast<CpuTarget>(i);
+                break;
+            }
+        }
+    }
+
+    ResultT operator()(ArgTs... args) const {
+        return _selected(std::forward<ArgTs>(args)...);
+    }
+
+    /**
+     * @brief Returns the target of the selected variant.
+     */
+    CpuTarget target() const noexcept {
+        return _target;
+    }
+
+    /**
+     * @brief Returns the variant compiled for `target`, or `nullptr` if there is none.
+     * Calling a variant whose target is not enabled is undefined behavior (typically SIGILL).
+     */
+    Function variant(CpuTarget target) const noexcept {
+        return _variants[static_cast<size_t>(target)];
+    }
+};
+
+#endif // CPU_DISPATCH_HPP
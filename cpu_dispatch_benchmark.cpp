@@ -0,0 +1,51 @@
+#include "dynamic_array.hpp"
+#include "simd_kernels.hpp"
+#include <chrono>
+#include <print>
+#include <random>
+
+// Throughput of every variant of each dispatched kernel that this CPU can run, over a buffer that
+// fits in L2. Run with `CPP_DS_CPU_TARGET=<name>` to check which variant the dispatcher picks.
+
+constexpr size_t valueCount = 64 * 1024;
+constexpr int repetitions = 2000;
+
+template <typename CallT>
+double measure(CallT call) {
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        sink = sink + static_cast<size_t>(call());
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(valueCount) * repetitions / elapsed.count() / 1e9;
+}
+
+template <typename KernelT, typename CallT>
+void report(const char* name, const KernelT& kernel, CallT call) {
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        auto target = static_cast<CpuTarget>(i);
+        auto variant = kernel.variant(target);
+        if (variant == nullptr || !cpuTargetEnabled(target)) {
+            continue;
+        }
+        double rate = measure([&] { return call(variant); });
+        std::println("{:>10} {:>8} {:>14.2f}{}", name, cpuTargetName(target), rate, target == kernel.target() ? "  (selected)" : "");
+    }
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int32_t> distribution(0, 1 << 20);
+    DArray<int32_t> values;
+    values.reserve(valueCount);
+    for (size_t i = 0; i < valueCount; ++i) {
+        values.push(distribution(random));
+    }
+    std::span<const int32_t> data = values;
+
+    std::println("{:>10} {:>8} {:>14}", "kernel", "target", "G values/s");
+    report("sum", sumValues, [&](auto variant) { return variant(data); });
+    // A needle that is never found, so that every variant scans the whole buffer.
+    report("find", findValue, [&](auto variant) { return variant(data, -1); });
+}
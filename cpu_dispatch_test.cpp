@@ -0,0 +1,101 @@
+#include "dynamic_array.hpp"
+#include "simd_kernels.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+
+int twice(int value) {
+    return 2 * value;
+}
+
+int thrice(int value) {
+    return 3 * value;
+}
+
+constexpr uint32_t targetBit(CpuTarget target) {
+    return 1u << static_cast<unsigned>(target);
+}
+
+// Runs `check` with every variant of `kernel` that this CPU can execute.
+template <typename KernelT, typename CheckT>
+void forEachVariant(const KernelT& kernel, CheckT check) {
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        auto target = static_cast<CpuTarget>(i);
+        if (kernel.variant(target) != nullptr && cpuTargetEnabled(target)) {
+            SCOPED_TRACE(cpuTargetName(target));
+            check(kernel.variant(target));
+        }
+    }
+}
+
+} // namespace
+
+// Test target names used by the environment override
+TEST(CpuDispatchTest, TargetNames) {
+    CpuTarget target = CpuTarget::Scalar;
+
+    EXPECT_TRUE(parseCpuTarget("avx2", target));
+    EXPECT_EQ(target, CpuTarget::Avx2);
+    EXPECT_FALSE(parseCpuTarget("sse9", target));
+    EXPECT_EQ(target, CpuTarget::Avx2);
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        ASSERT_TRUE(parseCpuTarget(cpuTargetName(static_cast<CpuTarget>(i)), target));
+        EXPECT_EQ(static_cast<size_t>(target), i);
+    }
+}
+
+// Test that detection always reports the scalar target and that the active set is a subset of it
+TEST(CpuDispatchTest, Detection) {
+    uint32_t detected = detectCpuTargets();
+
+    EXPECT_TRUE(detected & targetBit(CpuTarget::Scalar));
+    EXPECT_EQ(activeCpuTargets() & ~detected, 0);
+    EXPECT_TRUE(cpuTargetEnabled(CpuTarget::Scalar));
+    EXPECT_TRUE(cpuTargetEnabled(sumValues.target()));
+}
+
+// Test that the best enabled variant is selected, falling back to scalar
+TEST(CpuDispatchTest, Selection) {
+    using Function = Dispatched<int(int)>;
+    Function both({{CpuTarget::Scalar, twice}, {CpuTarget::Avx2, thrice}}, targetBit(CpuTarget::Avx2));
+    Function scalarOnly({{CpuTarget::Scalar, twice}, {CpuTarget::Avx2, thrice}}, 0);
+    Function missing({{CpuTarget::Scalar, twice}, {CpuTarget::Avx2, thrice}}, targetBit(CpuTarget::Avx512));
+
+    EXPECT_EQ(both.target(), CpuTarget::Avx2);
+    EXPECT_EQ(both(5), 15);
+    EXPECT_EQ(scalarOnly.target(), CpuTarget::Scalar);
+    EXPECT_EQ(scalarOnly(5), 10);
+    EXPECT_EQ(missing.target(), CpuTarget::Scalar);
+    EXPECT_EQ(both.variant(CpuTarget::Neon), nullptr);
+}
+
+// Test that every variant of sumValues agrees with the scalar one, including ragged tails
+TEST(CpuDispatchTest, SumValues) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int32_t> distribution(INT32_MIN, INT32_MAX);
+    DArray<int32_t> values;
+    for (size_t size = 0; size < 100; ++size) {
+        int64_t expected = sumValuesScalar(values);
+        forEachVariant(sumValues, [&](auto variant) { EXPECT_EQ(variant(values), expected); });
+        values.push(distribution(random));
+    }
+    EXPECT_EQ(sumValues(values), sumValuesScalar(values));
+}
+
+// Test that every variant of findValue reports the first match or the size
+TEST(CpuDispatchTest, FindValue) {
+    DArray<int32_t> values;
+    for (int32_t i = 0; i < 100; ++i) {
+        values.push(i % 37);
+    }
+    for (size_t size = 0; size <= values.size(); ++size) {
+        std::span<const int32_t> prefix = values.slice(0, size);
+        for (int32_t needle : {0, 5, 36, 99}) {
+            size_t expected = findValueScalar(prefix, needle);
+            forEachVariant(findValue, [&](auto variant) { EXPECT_EQ(variant(prefix, needle), expected); });
+        }
+    }
+    EXPECT_EQ(findValue(values, 36), 36);
+    EXPECT_EQ(findValue(values, -1), values.size());
+}
@@ -1,19 +1,23 @@
 #ifndef DYNAMIC_ARRAY_HPP
 #define DYNAMIC_ARRAY_HPP
 
-#include <__utility/exception_guard.h>
-#include <__utility/is_pointer_in_range.h>
+#include "exception_guard.hpp"
+#include "strided_slice.hpp"
+#include <algorithm>
 #include <cassert>
 #include <concepts>
 #include <cstddef>
-#include <format>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
-#include <memory>
 #include <new>
+#include <ranges>
+#include <span>
 #include <stdexcept>
-#include <string_view>
+#include <type_traits>
+#include <version>
 
 template <typename T>
 concept Allocator = requires(T t, size_t count, std::align_val_t alignment, void* pointer) {
@@ -31,6 +35,252 @@ struct DefaultAllocator {
     }
 };
 
+/**
+ * @brief Whether objects of type `T` can be relocated (moved to new storage and the source
+ * destroyed) with a plain `memmove`. True for trivially copyable types; specialize it to opt in
+ * other types whose moves are pure bit copies (e.g. types that just own a heap pointer).
+ */
+template <typename T>
+inline constexpr bool isTriviallyRelocatable = std::is_trivially_copyable_v<T>;
+
+/**
+ * @brief Returns true if `pointer` points into [first, last).
+ * Compares addresses as integers, since the built-in `<` is unspecified for pointers into
+ * different objects (e.g. an argument that may or may not alias the array).
+ */
+template <typename T, typename U>
+bool isPointerInRange(const T* first, const T* last, const U* pointer) noexcept {
+    auto address = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<uintptr_t>(first) <= address && address < reinterpret_cast<uintptr_t>(last);
+}
+
+/**
+ * @brief The untyped relocation core of `DArray`.
+ * For trivially relocatable elements, growth, insertion, erasure and splicing only move bytes, so
+ * each of these operations (growth policy, allocation, moving elements around the gap, rolling
+ * back when construction throws) is implemented here once per element size and alignment rather
+ * than once per element type: `DArray<int32_t>`, `DArray<uint32_t>` and `DArray<float>` share a
+ * single copy. Each instantiation keeps only the typed construction of new elements, which it
+ * passes in as a `Construct` function, and the destruction of erased ones.
+ * @tparam elementSize The size of the elements.
+ * @tparam elementAlignment The alignment of the elements.
+ * @tparam AllocatorT The allocator the storage comes from.
+ */
+template <size_t elementSize, size_t elementAlignment, Allocator AllocatorT>
+class RelocationCore {
+private:
+    // Stands in for an element, so that arrays of blocks have the layout of arrays of elements.
+    struct Block {
+        alignas(elementAlignment) std::byte bytes[elementSize];
+    };
+
+public:
+    /**
+     * @brief Constructs `n` elements at `destination` from `source`, which is passed through from
+     * the typed caller unchanged (an element to copy, a range, or the constructor arguments).
+     */
+    using Construct = void (*)(void* destination, size_t n, const void* source);
+
+    static constexpr size_t maxSize = std::numeric_limits<size_t>::max() / elementSize;
+
+    /**
+     * @brief Inserts `n` elements made by `construct` before element `position` of the `size`
+     * elements at `data`, growing the storage if `capacity` is insufficient. If `source` points
+     * into the elements that make room, it is moved along with them. If `construct` throws, the
+     * array is unchanged.
+     * @return The storage of the array, which is new if it grew.
+     * @throws std::length_error If the new size is greater than `maxSize`.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    [[gnu::noinline]] static void* insert(void* data, size_t& size, size_t& capacity, const AllocatorT& allocator, size_t position, size_t n, Construct construct, const void* source) {
+        auto* blocks = static_cast<Block*>(data);
+        if (n == 0) {
+            return data;
+        }
+        if (n <= capacity - size) {
+            if (position < size) {
+                if (isPointerInRange(blocks + position, blocks + size, static_cast<const Block*>(source))) {
+                    source = static_cast<const Block*>(source) + n;
+                }
+                openGap(blocks, size, position, n);
+                auto guard = makeExceptionGuard([blocks, size, position, n]() noexcept {
+                    closeGap(blocks, size + n, position + n, n);
+                });
+                construct(blocks + position, n, source);
+                guard.complete();
+            } else {
+                construct(blocks + position, n, source);
+            }
+            size += n;
+            return data;
+        }
+        size_t newCapacity = grownCapacity(capacity, size + n);
+        Block* grown = allocate(allocator, newCapacity);
+        auto guard = makeExceptionGuard([&allocator, grown]() noexcept {
+            deallocate(allocator, grown);
+        });
+        construct(grown + position, n, source);
+        guard.complete();
+        relocateAroundGap(blocks, size, grown, position, n);
+        deallocate(allocator, blocks);
+        size += n;
+        capacity = newCapacity;
+        return grown;
+    }
+
+    /**
+     * @brief Closes the gap left by the `n` elements destroyed at `position`.
+     */
+    [[gnu::noinline]] static void erase(void* data, size_t& size, size_t position, size_t n) noexcept {
+        closeGap(static_cast<Block*>(data), size, position + n, n);
+        size -= n;
+    }
+
+    /**
+     * @brief Moves the elements to new storage for `n` elements, unless `capacity` is already enough.
+     * @return The storage of the array.
+     * @throws std::length_error If `n` is greater than `maxSize`.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    [[gnu::noinline]] static void* reserve(void* data, size_t size, size_t& capacity, const AllocatorT& allocator, size_t n) {
+        if (n <= capacity) {
+            return data;
+        }
+        if (n > maxSize) {
+            throw std::length_error("Required capacity is too large");
+        }
+        Block* moved = allocate(allocator, n);
+        relocateAroundGap(static_cast<Block*>(data), size, moved, size, 0);
+        deallocate(allocator, static_cast<Block*>(data));
+        capacity = n;
+        return moved;
+    }
+
+    /**
+     * @brief Moves the elements to storage that fits them exactly, or frees the storage if there
+     * are none. If the allocation fails, the storage is kept.
+     * @return The storage of the array.
+     */
+    [[gnu::noinline]] static void* shrinkToFit(void* data, size_t size, size_t& capacity, const AllocatorT& allocator) noexcept {
+        Block* fitted = nullptr;
+        if (size > 0) {
+            try {
+                fitted = allocate(allocator, size);
+            } catch (...) {
+                return data;
+            }
+            relocateAroundGap(static_cast<Block*>(data), size, fitted, size, 0);
+        }
+        deallocate(allocator, static_cast<Block*>(data));
+        capacity = size;
+        return fitted;
+    }
+
+    /**
+     * @brief Moves the elements [first, last) of another array, the `otherSize` elements at
+     * `other`, before element `position`, growing the storage if needed. The other array closes
+     * the gap they leave.
+     * @return The storage of the array, which is new if it grew.
+     * @throws std::bad_alloc If memory allocation fails (both arrays are unchanged).
+     */
+    [[gnu::noinline]] static void* splice(void* data, size_t& size, size_t& capacity, const AllocatorT& allocator, size_t position, void* other, size_t& otherSize, size_t first, size_t last) {
+        auto* blocks = static_cast<Block*>(data);
+        size_t n = last - first;
+        if (n == 0) {
+            return data;
+        }
+        if (n <= capacity - size) {
+            openGap(blocks, size, position, n);
+        } else {
+            size_t newCapacity = grownCapacity(capacity, size + n);
+            Block* grown = allocate(allocator, newCapacity);
+            relocateAroundGap(blocks, size, grown, position, n);
+            deallocate(allocator, blocks);
+            blocks = grown;
+            capacity = newCapacity;
+        }
+        auto* otherBlocks = static_cast<Block*>(other);
+        std::memcpy(blocks + position, otherBlocks + first, n * elementSize);
+        closeGap(otherBlocks, otherSize, last, n);
+        size += n;
+        otherSize -= n;
+        return blocks;
+    }
+
+    /**
+     * @brief Swaps the adjacent ranges [first, middle) and [middle, last) of the elements at `data`.
+     */
+    [[gnu::noinline]] static void rotate(void* data, size_t first, size_t middle, size_t last) noexcept {
+        auto* blocks = static_cast<Block*>(data);
+        std::rotate(blocks + first, blocks + middle, blocks + last);
+    }
+
+    /**
+     * @brief Moves the elements from `index` on to new storage that fits them exactly.
+     * @return The new storage, or null if there are no such elements.
+     * @throws std::bad_alloc If memory allocation fails (the array is unchanged).
+     */
+    [[gnu::noinline]] static void* splitAt(void* data, size_t& size, size_t index, const AllocatorT& allocator) {
+        size_t n = size - index;
+        if (n == 0) {
+            return nullptr;
+        }
+        Block* tail = allocate(allocator, n);
+        std::memcpy(tail, static_cast<Block*>(data) + index, n * elementSize);
+        size = index;
+        return tail;
+    }
+
+    /**
+     * @brief Returns the capacity to grow to when `required` elements must fit: at least double the
+     * current capacity, capped at `maxSize`.
+     * @throws std::length_error If `required` is greater than `maxSize`.
+     */
+    [[gnu::noinline]] static size_t grownCapacity(size_t capacity, size_t required) {
+        if (required > maxSize) {
+            throw std::length_error("Required capacity is too large");
+        }
+        if (capacity >= maxSize / 2) {
+            return maxSize;
+        }
+        return std::max(capacity * 2, required);
+    }
+
+private:
+    static Block* allocate(const AllocatorT& allocator, size_t n) {
+        if (n > maxSize) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Block*>(allocator.allocate(n * elementSize, static_cast<std::align_val_t>(elementAlignment)));
+    }
+
+    static void deallocate(const AllocatorT& allocator, Block* blocks) noexcept {
+        if (blocks != nullptr) {
+            allocator.deallocate(static_cast<void*>(blocks), static_cast<std::align_val_t>(elementAlignment));
+        }
+    }
+
+    // Moves the elements [position, size) `n` places to the right; the storage must have room.
+    static void openGap(Block* blocks, size_t size, size_t position, size_t n) noexcept {
+        std::memmove(blocks + position + n, blocks + position, (size - position) * elementSize);
+    }
+
+    // Moves the elements [position, size) `n` places to the left, over elements already destroyed.
+    static void closeGap(Block* blocks, size_t size, size_t position, size_t n) noexcept {
+        std::memmove(blocks + position - n, blocks + position, (size - position) * elementSize);
+    }
+
+    // Moves the `size` elements at `source` to the separate storage `destination`, leaving a gap of
+    // `n` elements before the element at `position`.
+    static void relocateAroundGap(const Block* source, size_t size, Block* destination, size_t position, size_t n) noexcept {
+        if (size == 0) {
+            return;
+        }
+        std::memcpy(destination, source, position * elementSize);
+        std::memcpy(destination + position + n, source + position, (size - position) * elementSize);
+    }
+};
+
 /**
  * @brief A dynamic array (vector-like) implementation.
  * @tparam ElementT The type of elements stored in the array.
@@ -44,6 +294,11 @@ private:
     size_t _capacity = 0;
     AllocatorT _allocator;
 
+    // The relocation core shared with other element types of the same size and alignment. An alias
+    // template, so that `ElementT` only needs to be complete where the core is used.
+    template <typename T = ElementT>
+    using Core = RelocationCore<sizeof(T), alignof(T), AllocatorT>;
+
 public:
     /**
      * @brief Default constructor.
@@ -60,10 +315,10 @@ public:
      */
     explicit DArray(size_t n) {
         if (n > 0) {
-            auto guard = std::__make_exception_guard(DestroyArray(*this));
+            auto guard = makeExceptionGuard(DestroyArray(*this));
             allocate(n);
             constructAtEnd(n);
-            guard.__complete();
+            guard.complete();
         }
     }
 
@@ -77,10 +332,10 @@ public:
      */
     DArray(const ElementT& x, size_t n) {
         if (n > 0) {
-            auto guard = std::__make_exception_guard(DestroyArray(*this));
+            auto guard = makeExceptionGuard(DestroyArray(*this));
             allocate(n);
             constructAtEnd(x, n);
-            guard.__complete();
+            guard.complete();
         }
     }
 
@@ -95,13 +350,41 @@ public:
     DArray(const ElementT* first, const ElementT* last) {
         size_t n = static_cast<size_t>(last - first);
         if (n > 0) {
-            auto guard = std::__make_exception_guard(DestroyArray(*this));
+            auto guard = makeExceptionGuard(DestroyArray(*this));
             allocate(n);
             constructAtEnd(first, last, n);
-            guard.__complete();
+            guard.complete();
         }
     }
 
+#if defined(__cpp_lib_containers_ranges)
+    /**
+     * @brief Range constructor (`std::from_range`).
+     * Constructs a DArray with the elements of `range`. This is the constructor `std::ranges::to<DArray>`
+     * uses. Sized and forward ranges are measured first, so the storage is allocated exactly once.
+     * @param range The range to copy (or move, for rvalue element references) elements from.
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws Any exception thrown by the ElementT constructor.
+     */
+    template <std::ranges::input_range RangeT>
+        requires std::constructible_from<ElementT, std::ranges::range_reference_t<RangeT>>
+    DArray(std::from_range_t, RangeT&& range) {
+        auto guard = makeExceptionGuard(DestroyArray(*this));
+        if constexpr (std::ranges::sized_range<RangeT> || std::ranges::forward_range<RangeT>) {
+            size_t n = static_cast<size_t>(std::ranges::distance(range));
+            if (n > 0) {
+                allocate(n);
+                constructRangeAtEnd(std::ranges::begin(range), n);
+            }
+        } else {
+            for (auto&& element : range) {
+                emplaceAtEnd(std::forward<decltype(element)>(element));
+            }
+        }
+        guard.complete();
+    }
+
+#endif
     /**
      * @brief Initializer list constructor.
      * Constructs a DArray with elements from an initializer list.
@@ -111,10 +394,10 @@ public:
      */
     DArray(std::initializer_list<ElementT> elements) {
         if (elements.size() > 0) {
-            auto guard = std::__make_exception_guard(DestroyArray(*this));
+            auto guard = makeExceptionGuard(DestroyArray(*this));
             allocate(elements.size());
             constructAtEnd(elements.begin(), elements.end(), elements.size());
-            guard.__complete();
+            guard.complete();
         }
     }
 
@@ -127,10 +410,10 @@ public:
      */
     DArray(const DArray& other) {
         if (other.size() > 0) {
-            auto guard = std::__make_exception_guard(DestroyArray(*this));
+            auto guard = makeExceptionGuard(DestroyArray(*this));
             allocate(other.size());
             constructAtEnd(other.begin(), other.end(), other.size());
-            guard.__complete();
+            guard.complete();
         }
     }
 
@@ -179,6 +462,19 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Assigns the elements viewed by `elements` to the DArray.
+     * Clears existing elements and constructs new ones. Accepts slices and other DArrays.
+     * @param elements A view of the elements to copy.
+     * @return A reference to the DArray.
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws Any exception thrown by the ElementT copy constructor.
+     */
+    DArray& assign(std::span<const ElementT> elements) {
+        copy(elements.data(), elements.data() + elements.size(), elements.size());
+        return *this;
+    }
+
     /**
      * @brief Assignment operator from an initializer list.
      * Assigns elements from an initializer list to the DArray.
@@ -201,7 +497,7 @@ public:
      * @throws Any exception thrown by the ElementT copy constructor.
      */
     DArray& operator=(const DArray& other) {
-        if (this != std::addressof(other)) {
+        if (this != addressOf(other)) {
             copy(other.begin(), other.end(), other.size());
         }
         return *this;
@@ -214,7 +510,7 @@ public:
      * @return A reference to the DArray.
      */
     DArray& operator=(DArray&& other) noexcept {
-        if (this != std::addressof(other)) {
+        if (this != addressOf(other)) {
             destroy();
             swap(other);
         }
@@ -351,6 +647,51 @@ public:
         return _data + _size;
     }
 
+    /**
+     * @brief Returns a non-owning view of `count` elements starting at index `first`.
+     * The view is invalidated by any operation that reallocates the array.
+     * @param first The index of the first element of the slice.
+     * @param count The number of elements in the slice.
+     * @return A span over [first, first + count).
+     * @throws std::out_of_range If the slice does not fit in the array.
+     */
+    std::span<ElementT> slice(size_t first, size_t count) {
+        checkSlice(first, count, 1);
+        return {_data + first, count};
+    }
+
+    /**
+     * @brief Returns a non-owning view of `count` elements starting at index `first` (const version).
+     * @throws std::out_of_range If the slice does not fit in the array.
+     */
+    std::span<const ElementT> slice(size_t first, size_t count) const {
+        checkSlice(first, count, 1);
+        return {_data + first, count};
+    }
+
+    /**
+     * @brief Returns a non-owning view of `count` elements taken every `stride` elements, starting at index `first`.
+     * The view is invalidated by any operation that reallocates the array.
+     * @param first The index of the first element of the slice.
+     * @param count The number of elements in the slice.
+     * @param stride The distance between consecutive elements of the slice.
+     * @return A strided view over indices first, first + stride, ..., first + (count - 1) * stride.
+     * @throws std::out_of_range If the slice does not fit in the array.
+     */
+    StridedSlice<ElementT> slice(size_t first, size_t count, size_t stride) {
+        checkSlice(first, count, stride);
+        return {_data + first, count, static_cast<std::ptrdiff_t>(stride)};
+    }
+
+    /**
+     * @brief Returns a strided non-owning view (const version).
+     * @throws std::out_of_range If the slice does not fit in the array.
+     */
+    StridedSlice<const ElementT> slice(size_t first, size_t count, size_t stride) const {
+        checkSlice(first, count, stride);
+        return {_data + first, count, static_cast<std::ptrdiff_t>(stride)};
+    }
+
     /**
      * @brief Returns a reverse iterator to the reverse beginning of the array (non-const version).
      * @return A `std::reverse_iterator<ElementT*>` pointing to the last element.
@@ -427,7 +768,9 @@ public:
      * @throws Any exception thrown by the ElementT move constructor.
      */
     void reserve(size_t n) {
-        if (n > _capacity) {
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            _data = static_cast<ElementT*>(Core<>::reserve(_data, _size, _capacity, _allocator, n));
+        } else if (n > _capacity) {
             if (n > maxSize()) {
                 throw std::length_error("Required capacity is too large");
             } else {
@@ -448,7 +791,9 @@ public:
      */
     void shrinkToFit() noexcept {
         if (_capacity > _size) {
-            if (_size > 0) {
+            if constexpr (isTriviallyRelocatable<ElementT>) {
+                _data = static_cast<ElementT*>(Core<>::shrinkToFit(_data, _size, _capacity, _allocator));
+            } else if (_size > 0) {
                 try {
                     AllocateTransaction transaction(*this);
                     transaction.allocate(_size);
@@ -464,6 +809,32 @@ public:
         }
     }
 
+    /**
+     * @brief Changes the number of elements to `n`.
+     * Elements past `n` are destroyed; if the DArray grows, default-constructed elements are
+     * appended, reallocating with the usual growth policy if the capacity is insufficient.
+     * @param n The new size.
+     * @throws std::length_error If `n` is greater than `maxSize()`.
+     * @throws std::bad_alloc If memory reallocation fails.
+     * @throws Any exception thrown by the ElementT default/move constructor.
+     */
+    void resize(size_t n) {
+        resizeTo<false>(n);
+    }
+
+    /**
+     * @brief Like `resize()`, but appended elements are default-initialized rather than
+     * value-initialized: elements of trivial types (`int`, `std::byte`, ...) are left uninitialized,
+     * for the caller to overwrite (e.g. with `memcpy`) without first paying for zeroing them.
+     * @param n The new size.
+     * @throws std::length_error If `n` is greater than `maxSize()`.
+     * @throws std::bad_alloc If memory reallocation fails.
+     * @throws Any exception thrown by the ElementT default/move constructor.
+     */
+    void resizeForOverwrite(size_t n) {
+        resizeTo<true>(n);
+    }
+
     /**
      * @brief Clears the contents of the DArray.
      * Destroys all elements, but the allocated capacity remains unchanged.
@@ -496,17 +867,21 @@ public:
      * @throws Any exception thrown by the ElementT copy/move constructor.
      */
     ElementT* insert(ElementT* position, const ElementT& element) {
-        size_t index = position - begin();
-        if (_size < _capacity) {
-            if (position == end()) {
-                constructOneAtEnd(element);
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            return insertRelocating<constructCopies>(position, 1, addressOf(element));
+        } else {
+            size_t index = position - begin();
+            if (_size < _capacity) {
+                if (position == end()) {
+                    constructOneAtEnd(element);
+                } else {
+                    shiftAndConstructOneAt(position, element);
+                }
             } else {
-                shiftAndConstructOneAt(position, element);
+                growAndConstructOneAt(position, element);
             }
-        } else {
-            growAndConstructOneAt(position, element);
+            return begin() + index;
         }
-        return begin() + index;
     }
 
     /**
@@ -519,17 +894,21 @@ public:
      * @throws Any exception thrown by the ElementT move constructor.
      */
     ElementT* insert(ElementT* position, ElementT&& element) {
-        size_t index = position - begin();
-        if (_size < _capacity) {
-            if (position == end()) {
-                constructOneAtEnd(std::move(element));
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            return insertRelocating<constructMoved>(position, 1, addressOf(element));
+        } else {
+            size_t index = position - begin();
+            if (_size < _capacity) {
+                if (position == end()) {
+                    constructOneAtEnd(std::move(element));
+                } else {
+                    shiftAndConstructOneAt(position, std::move(element));
+                }
             } else {
-                shiftAndConstructOneAt(position, std::move(element));
+                growAndConstructOneAt(position, std::move(element));
             }
-        } else {
-            growAndConstructOneAt(position, std::move(element));
+            return begin() + index;
         }
-        return begin() + index;
     }
 
     /**
@@ -543,19 +922,23 @@ public:
      * @throws Any exception thrown by the ElementT copy/move constructor.
      */
     ElementT* insert(ElementT* position, const ElementT& element, size_t n) {
-        size_t index = position - begin();
-        if (n > 0) {
-            if (_size + n <= _capacity) {
-                if (position == end()) {
-                    constructAtEnd(element, n);
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            return insertRelocating<constructCopies>(position, n, addressOf(element));
+        } else {
+            size_t index = position - begin();
+            if (n > 0) {
+                if (_size + n <= _capacity) {
+                    if (position == end()) {
+                        constructAtEnd(element, n);
+                    } else {
+                        shiftAndConstructAt(position, element, n);
+                    }
                 } else {
-                    shiftAndConstructAt(position, element, n);
+                    growAndConstructAt(position, element, n);
                 }
-            } else {
-                growAndConstructAt(position, element, n);
             }
+            return begin() + index;
         }
-        return begin() + index;
     }
 
     /**
@@ -569,20 +952,37 @@ public:
      * @throws Any exception thrown by the ElementT copy/move constructor.
      */
     ElementT* insert(ElementT* position, const ElementT* first, const ElementT* last) {
-        size_t index = position - begin();
-        size_t n = last - first;
-        if (n > 0) {
-            if (_size + n <= _capacity) {
-                if (position == end()) {
-                    constructAtEnd(first, last, n);
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            return insertRelocating<constructRange>(position, last - first, first);
+        } else {
+            size_t index = position - begin();
+            size_t n = last - first;
+            if (n > 0) {
+                if (_size + n <= _capacity) {
+                    if (position == end()) {
+                        constructAtEnd(first, last, n);
+                    } else {
+                        shiftAndConstructAt(position, first, last, n);
+                    }
                 } else {
-                    shiftAndConstructAt(position, first, last, n);
+                    growAndConstructAt(position, first, last, n);
                 }
-            } else {
-                growAndConstructAt(position, first, last, n);
             }
+            return begin() + index;
         }
-        return begin() + index;
+    }
+
+    /**
+     * @brief Inserts the elements viewed by `elements` at the specified `position`.
+     * Elements from `position` onwards are shifted to the right.
+     * @param position An iterator pointing to the position where elements should be inserted.
+     * @param elements A view of the elements to copy, e.g. a slice of another DArray.
+     * @return An iterator pointing to the first newly inserted element.
+     * @throws std::bad_alloc If memory reallocation fails.
+     * @throws Any exception thrown by the ElementT copy/move constructor.
+     */
+    ElementT* insert(ElementT* position, std::span<const ElementT> elements) {
+        return insert(position, elements.data(), elements.data() + elements.size());
     }
 
     /**
@@ -595,19 +995,23 @@ public:
      * @throws Any exception thrown by the ElementT copy/move constructor.
      */
     ElementT* insert(ElementT* position, std::initializer_list<ElementT> elements) {
-        size_t index = position - begin();
-        if (elements.size() > 0) {
-            if (_size + elements.size() <= _capacity) {
-                if (position == end()) {
-                    constructAtEnd(elements.begin(), elements.end(), elements.size());
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            return insertRelocating<constructRange>(position, elements.size(), elements.begin());
+        } else {
+            size_t index = position - begin();
+            if (elements.size() > 0) {
+                if (_size + elements.size() <= _capacity) {
+                    if (position == end()) {
+                        constructAtEnd(elements.begin(), elements.end(), elements.size());
+                    } else {
+                        shiftAndConstructAt(position, elements.begin(), elements.end(), elements.size());
+                    }
                 } else {
-                    shiftAndConstructAt(position, elements.begin(), elements.end(), elements.size());
+                    growAndConstructAt(position, elements.begin(), elements.end(), elements.size());
                 }
-            } else {
-                growAndConstructAt(position, elements.begin(), elements.end(), elements.size());
             }
+            return begin() + index;
         }
-        return begin() + index;
     }
 
     /**
@@ -653,6 +1057,8 @@ public:
     void push(const ElementT& element) {
         if (_size < _capacity) {
             constructOneAtEnd(element);
+        } else if constexpr (isTriviallyRelocatable<ElementT>) {
+            insertRelocating<constructCopies>(end(), 1, addressOf(element));
         } else {
             growAndConstructOneAt(end(), element);
         }
@@ -668,6 +1074,8 @@ public:
     void push(ElementT&& element) {
         if (_size < _capacity) {
             constructOneAtEnd(std::move(element));
+        } else if constexpr (isTriviallyRelocatable<ElementT>) {
+            insertRelocating<constructMoved>(end(), 1, addressOf(element));
         } else {
             growAndConstructOneAt(end(), std::move(element));
         }
@@ -695,6 +1103,8 @@ public:
     ElementT& emplaceAtEnd(Args&&... args) {
         if (_size < _capacity) {
             constructOneAtEnd(std::forward<Args>(args)...);
+        } else if constexpr (isTriviallyRelocatable<ElementT>) {
+            emplaceRelocating(end(), std::forward<Args>(args)...);
         } else {
             growAndConstructOneAt(end(), std::forward<Args>(args)...);
         }
@@ -714,17 +1124,21 @@ public:
      */
     template <typename... Args>
     ElementT& emplace(ElementT* position, Args&&... args) {
-        size_t index = position - begin();
-        if (_size < _capacity) {
-            if (position == end()) {
-                constructOneAtEnd(std::forward<Args>(args)...);
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            return *emplaceRelocating(position, std::forward<Args>(args)...);
+        } else {
+            size_t index = position - begin();
+            if (_size < _capacity) {
+                if (position == end()) {
+                    constructOneAtEnd(std::forward<Args>(args)...);
+                } else {
+                    shiftAndEmplaceOneAt(position, std::forward<Args>(args)...);
+                }
             } else {
-                shiftAndEmplaceOneAt(position, std::forward<Args>(args)...);
+                growAndConstructOneAt(position, std::forward<Args>(args)...);
             }
-        } else {
-            growAndConstructOneAt(position, std::forward<Args>(args)...);
+            return _data[index];
         }
-        return _data[index];
     }
 
     /**
@@ -738,6 +1152,120 @@ public:
         std::swap(_capacity, other._capacity);
     }
 
+    /**
+     * @brief Relocates all elements of `other` to the end of the DArray.
+     * Elements are moved in bulk (a single `memmove` for trivially relocatable types).
+     * If the capacity is insufficient, a reallocation occurs.
+     * @param other The DArray to take elements from. Afterwards it is empty but keeps its capacity.
+     * @throws std::bad_alloc If memory reallocation fails (both arrays are unchanged).
+     */
+    void append(DArray&& other)
+        requires std::is_nothrow_move_constructible_v<ElementT>
+    {
+        splice(end(), other, other.begin(), other.end());
+    }
+
+    /**
+     * @brief Appends copies of the elements viewed by `elements`.
+     * @throws std::bad_alloc If memory reallocation fails.
+     * @throws Any exception thrown by the ElementT copy/move constructor.
+     */
+    void append(std::span<const ElementT> elements) {
+        insert(end(), elements);
+    }
+
+    /**
+     * @brief Appends elements from an initializer list.
+     * @throws std::bad_alloc If memory reallocation fails.
+     * @throws Any exception thrown by the ElementT copy/move constructor.
+     */
+    void append(std::initializer_list<ElementT> elements) {
+        insert(end(), elements);
+    }
+
+    /**
+     * @brief Relocates the elements [first, last) of `other` into the DArray at `position`.
+     * The elements are removed from `other`, whose remaining elements close the gap.
+     * All moves are bulk relocations (`memmove` for trivially relocatable types).
+     * If `other` is this DArray, the range is rotated into place; `position` must not lie inside (first, last).
+     * @param position An iterator pointing to the position where elements should be inserted.
+     * @param other The DArray to take elements from.
+     * @param first An iterator to the first element of `other` to move.
+     * @param last An iterator one past the last element of `other` to move.
+     * @return An iterator pointing to the first moved element in this DArray.
+     * @throws std::bad_alloc If memory allocation fails (both arrays are unchanged).
+     */
+    ElementT* splice(ElementT* position, DArray& other, ElementT* first, ElementT* last)
+        requires std::is_nothrow_move_constructible_v<ElementT>
+    {
+        size_t index = position - begin();
+        size_t n = last - first;
+        if (this == addressOf(other)) {
+            if (position < first) {
+                rotate(position, first, last);
+                return position;
+            }
+            if (position > last) {
+                rotate(first, last, position);
+                return position - n;
+            }
+            return first;
+        }
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            _data = static_cast<ElementT*>(Core<>::splice(_data, _size, _capacity, _allocator, index, other._data, other._size, first - other.begin(), last - other.begin()));
+            return begin() + index;
+        } else {
+            if (n == 0) {
+                return position;
+            }
+            if (_size + n > _capacity) {
+                size_t newCapacity = extendedCapacity(_size + n);
+                ElementT* data = allocateData(newCapacity);
+                relocate(begin(), position, data);
+                relocate(position, end(), data + index + n);
+                deallocateData(_data);
+                _data = data;
+                _capacity = newCapacity;
+            } else {
+                relocate(position, end(), position + n);
+            }
+            relocate(first, last, _data + index);
+            relocate(last, other.end(), first);
+            _size += n;
+            other._size -= n;
+            return begin() + index;
+        }
+    }
+
+    /**
+     * @brief Splits the DArray at `index`: elements [index, size()) are relocated into a new DArray.
+     * The new DArray is allocated exactly once with capacity for the tail; this DArray keeps its capacity.
+     * @param index The index of the first element of the tail.
+     * @return A DArray holding the tail.
+     * @throws std::out_of_range If `index` is greater than `size()`.
+     * @throws std::bad_alloc If memory allocation fails (the DArray is unchanged).
+     */
+    DArray splitAt(size_t index)
+        requires std::is_nothrow_move_constructible_v<ElementT>
+    {
+        if (index > _size) {
+            throw std::out_of_range("Index is out of range");
+        }
+        DArray tail;
+        size_t n = _size - index;
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            tail._data = static_cast<ElementT*>(Core<>::splitAt(_data, _size, index, tail._allocator));
+            tail._size = n;
+            tail._capacity = n;
+        } else if (n > 0) {
+            tail.allocate(n);
+            relocate(begin() + index, end(), tail._data);
+            tail._size = n;
+            _size = index;
+        }
+        return tail;
+    }
+
 private:
     void allocate(size_t n) {
         _data = allocateData(n);
@@ -763,20 +1291,38 @@ private:
         _allocator.deallocate(static_cast<void*>(ptr), alignment());
     }
 
+    template <bool ForOverwrite = false>
     void constructAtEnd(size_t n) {
         assert(n > 0);
         assert(_size + n <= _capacity);
-        constructDefaultElements(end(), end() + n);
+        constructDefaultElements<ForOverwrite>(end(), end() + n);
         _size += n;
     }
 
+    template <bool ForOverwrite = false>
     static void constructDefaultElements(ElementT* first, ElementT* last) {
         auto firstCopy = first;
-        auto guard = std::__make_exception_guard(DestructRangeInReverse(firstCopy, first));
+        auto guard = makeExceptionGuard(DestructRangeInReverse(firstCopy, first));
         for (; first != last; ++first) {
-            new (first) ElementT();
+            if constexpr (ForOverwrite) {
+                new (first) ElementT;
+            } else {
+                new (first) ElementT();
+            }
+        }
+        guard.complete();
+    }
+
+    template <bool ForOverwrite>
+    void resizeTo(size_t n) {
+        if (n < _size) {
+            destructAtEnd(_size - n);
+        } else if (n > _size) {
+            if (n > _capacity) {
+                reserve(extendedCapacity(n));
+            }
+            constructAtEnd<ForOverwrite>(n - _size);
         }
-        guard.__complete();
     }
 
     void constructAtEnd(const ElementT& element, size_t n) {
@@ -788,11 +1334,11 @@ private:
 
     static void copyElement(const ElementT& element, size_t n, ElementT* dst) {
         auto dstCopy = dst;
-        auto guard = std::__make_exception_guard(DestructRangeInReverse(dstCopy, dst));
+        auto guard = makeExceptionGuard(DestructRangeInReverse(dstCopy, dst));
         for (ElementT* last = dst + n; dst != last; ++dst) {
             new (dst) ElementT(element);
         }
-        guard.__complete();
+        guard.complete();
     }
 
     void constructAtEnd(const ElementT* first, const ElementT* last, size_t n) {
@@ -802,21 +1348,96 @@ private:
         _size += n;
     }
 
+    template <std::input_iterator IteratorT>
+    void constructRangeAtEnd(IteratorT first, size_t n) {
+        assert(n > 0);
+        assert(_size + n <= _capacity);
+        ElementT* dst = end();
+        ElementT* dstCopy = dst;
+        auto guard = makeExceptionGuard(DestructRangeInReverse(dstCopy, dst));
+        for (size_t i = 0; i < n; ++i, ++first, ++dst) {
+            new (dst) ElementT(*first);
+        }
+        guard.complete();
+        _size += n;
+    }
+
     static void copyRange(const ElementT* first, const ElementT* last, ElementT* dst) {
         auto dstCopy = dst;
-        auto guard = std::__make_exception_guard(DestructRangeInReverse(dstCopy, dst));
+        auto guard = makeExceptionGuard(DestructRangeInReverse(dstCopy, dst));
         for (; first != last; ++first, ++dst) {
             new (dst) ElementT(*first);
         }
-        guard.__complete();
+        guard.complete();
     }
 
-    static void moveRange(ElementT* first, ElementT* last, ElementT* dst) {
+    // Members constrained to elements that are not trivially relocatable are the typed fallbacks
+    // for what the relocation core does with bytes.
+    static void moveRange(ElementT* first, ElementT* last, ElementT* dst)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         for (; first != last; ++first, ++dst) {
             new (dst) ElementT(std::move(*first));
         }
     }
 
+    // Moves all elements to the new storage `dst`, around the `n` elements already constructed there
+    // for `position`, and leaves the DArray empty.
+    void relocateAroundGap(ElementT* dst, ElementT* position, size_t n)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
+        size_t index = position - begin();
+        moveRange(begin(), position, dst);
+        moveRange(position, end(), dst + index + n);
+        clear();
+    }
+
+    // Swaps the adjacent ranges [first, middle) and [middle, last). Types that cannot be swapped
+    // are relocated through a scratch buffer holding the shorter range.
+    void rotate(ElementT* first, ElementT* middle, ElementT* last) {
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            Core<>::rotate(_data, first - begin(), middle - begin(), last - begin());
+        } else if constexpr (std::is_nothrow_swappable_v<ElementT>) {
+            std::rotate(first, middle, last);
+        } else {
+            size_t left = middle - first;
+            size_t right = last - middle;
+            AllocateTransaction transaction(*this);
+            transaction.allocate(std::min(left, right));
+            if (left <= right) {
+                relocate(first, middle, transaction.data);
+                relocate(middle, last, first);
+                relocate(transaction.data, transaction.data + left, last - left);
+            } else {
+                relocate(middle, last, transaction.data);
+                relocate(first, middle, first + right);
+                relocate(transaction.data, transaction.data + right, first);
+            }
+        }
+    }
+
+    // Moves [first, last) to `dst` and ends the lifetime of the source objects. The ranges may overlap.
+    static void relocate(ElementT* first, ElementT* last, ElementT* dst) noexcept
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
+        if (first == dst || first == last) {
+            return;
+        }
+        if (isPointerInRange(first, last, dst)) {
+            for (ElementT* dstLast = dst + (last - first); last != first;) {
+                --last;
+                --dstLast;
+                new (dstLast) ElementT(std::move(*last));
+                last->~ElementT();
+            }
+        } else {
+            for (; first != last; ++first, ++dst) {
+                new (dst) ElementT(std::move(*first));
+                first->~ElementT();
+            }
+        }
+    }
+
     void destructAtEnd(size_t n) noexcept {
         assert(n <= _size);
         ElementT* srcBegin = end() - n;
@@ -826,13 +1447,17 @@ private:
     }
 
     void destructAt(ElementT* position, size_t n) noexcept {
-        assert(std::__is_pointer_in_range(begin(), end() - 1, position));
+        assert(isPointerInRange(begin(), end() - 1, position));
         assert(n > 0);
         assert(position + n <= end());
         ElementT* srcBegin = position;
         ElementT* srcEnd = position + n;
         DestructRangeInReverse(srcBegin, srcEnd)();
-        shiftTailLeft(position + n, n);
+        if constexpr (isTriviallyRelocatable<ElementT>) {
+            Core<>::erase(_data, _size, position - begin(), n);
+        } else {
+            shiftTailLeft(position + n, n);
+        }
     }
 
     void copy(const ElementT& element, size_t n) {
@@ -861,53 +1486,96 @@ private:
         }
     }
 
+    // Inserts `n` elements at `position` through the relocation core, which calls `construct` to
+    // build them from `source`.
+    template <auto construct>
+    ElementT* insertRelocating(ElementT* position, size_t n, const void* source) {
+        size_t index = position - begin();
+        _data = static_cast<ElementT*>(Core<>::insert(_data, _size, _capacity, _allocator, index, n, construct, source));
+        return begin() + index;
+    }
+
+    template <typename... Args>
+    ElementT* emplaceRelocating(ElementT* position, Args&&... args) {
+        auto construct = [&args...](void* destination) {
+            new (destination) ElementT(std::forward<Args>(args)...);
+        };
+        return insertRelocating<constructWith<decltype(construct)>>(position, 1, addressOf(construct));
+    }
+
+    // The `Construct` functions handed to the relocation core.
+    static void constructCopies(void* destination, size_t n, const void* source)
+        requires isTriviallyRelocatable<ElementT>
+    {
+        copyElement(*static_cast<const ElementT*>(source), n, static_cast<ElementT*>(destination));
+    }
+
+    static void constructRange(void* destination, size_t n, const void* source)
+        requires isTriviallyRelocatable<ElementT>
+    {
+        const auto* first = static_cast<const ElementT*>(source);
+        copyRange(first, first + n, static_cast<ElementT*>(destination));
+    }
+
+    static void constructMoved(void* destination, size_t, const void* source)
+        requires isTriviallyRelocatable<ElementT>
+    {
+        // `source` is the address of an rvalue argument, passed as const only to fit the signature.
+        new (destination) ElementT(std::move(*const_cast<ElementT*>(static_cast<const ElementT*>(source))));
+    }
+
+    template <typename FunctionT>
+    static void constructWith(void* destination, size_t, const void* source) {
+        (*static_cast<const FunctionT*>(source))(destination);
+    }
+
     template <typename... Args>
     void constructOneAtEnd(Args&&... args) {
         new (end()) ElementT(std::forward<Args>(args)...);
         ++_size;
     }
 
+    // Growth is the cold path of every insertion; keeping it out of line stops each caller from
+    // carrying its own copy.
     template <typename... Args>
-    void growAndConstructOneAt(ElementT* position, Args&&... args) {
+    [[gnu::noinline]] void growAndConstructOneAt(ElementT* position, Args&&... args) {
         size_t newSize = _size + 1;
         size_t newCapacity = extendedCapacity(newSize);
         AllocateTransaction transaction(*this);
         transaction.allocate(newCapacity);
         ElementT* dst = transaction.data + (position - begin());
         new (dst) ElementT(std::forward<Args>(args)...);
-        moveRange(begin(), position, transaction.data);
-        moveRange(position, end(), dst + 1);
-        clear();
+        relocateAroundGap(transaction.data, position, 1);
         std::swap(_data, transaction.data);
         _size = newSize;
         _capacity = newCapacity;
     }
 
-    void growAndConstructAt(ElementT* position, const ElementT& element, size_t n) {
+    [[gnu::noinline]] void growAndConstructAt(ElementT* position, const ElementT& element, size_t n)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         size_t newSize = _size + n;
         size_t newCapacity = extendedCapacity(newSize);
         AllocateTransaction transaction(*this);
         transaction.allocate(newCapacity);
         ElementT* dst = transaction.data + (position - begin());
         copyElement(element, n, dst);
-        moveRange(begin(), position, transaction.data);
-        moveRange(position, end(), dst + n);
-        clear();
+        relocateAroundGap(transaction.data, position, n);
         std::swap(_data, transaction.data);
         _size = newSize;
         _capacity = newCapacity;
     }
 
-    void growAndConstructAt(ElementT* position, const ElementT* first, const ElementT* last, size_t n) {
+    [[gnu::noinline]] void growAndConstructAt(ElementT* position, const ElementT* first, const ElementT* last, size_t n)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         size_t newSize = _size + n;
         size_t newCapacity = extendedCapacity(newSize);
         AllocateTransaction transaction(*this);
         transaction.allocate(newCapacity);
         ElementT* dst = transaction.data + (position - begin());
         copyRange(first, last, dst);
-        moveRange(begin(), position, transaction.data);
-        moveRange(position, end(), dst + n);
-        clear();
+        relocateAroundGap(transaction.data, position, n);
         std::swap(_data, transaction.data);
         _size = newSize;
         _capacity = newCapacity;
@@ -916,69 +1584,81 @@ private:
     template <typename... Args>
     void shiftAndEmplaceOneAt(ElementT* position, Args&&... args) {
         shiftTailRight(position, 1);
-        auto guard = std::__make_exception_guard(ShiftArrayTailLeft(*this, position + 1, 1));
+        auto guard = makeExceptionGuard(ShiftArrayTailLeft(*this, position + 1, 1));
         new (position) ElementT(std::forward<Args>(args)...);
-        guard.__complete();
+        guard.complete();
     }
 
-    void shiftAndConstructOneAt(ElementT* position, const ElementT& element) {
+    void shiftAndConstructOneAt(ElementT* position, const ElementT& element)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         shiftTailRight(position, 1);
-        const ElementT* src = std::pointer_traits<const ElementT*>::pointer_to(element);
-        if (std::__is_pointer_in_range(position, end(), src)) {
+        const ElementT* src = addressOf(element);
+        if (isPointerInRange(position, end(), src)) {
             ++src;
         }
-        auto guard = std::__make_exception_guard(ShiftArrayTailLeft(*this, position + 1, 1));
+        auto guard = makeExceptionGuard(ShiftArrayTailLeft(*this, position + 1, 1));
         new (position) ElementT(*src);
-        guard.__complete();
+        guard.complete();
     }
 
-    void shiftAndConstructOneAt(ElementT* position, ElementT&& element) noexcept {
+    void shiftAndConstructOneAt(ElementT* position, ElementT&& element) noexcept
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         shiftTailRight(position, 1);
-        ElementT* src = std::pointer_traits<ElementT*>::pointer_to(element);
-        if (std::__is_pointer_in_range(position, end(), src)) {
+        ElementT* src = addressOf(element);
+        if (isPointerInRange(position, end(), src)) {
             ++src;
         }
         new (position) ElementT(std::move(*src));
     }
 
-    void shiftAndConstructAt(ElementT* position, const ElementT& element, size_t n) {
+    void shiftAndConstructAt(ElementT* position, const ElementT& element, size_t n)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         shiftTailRight(position, n);
-        const ElementT* src = std::pointer_traits<const ElementT*>::pointer_to(element);
-        if (std::__is_pointer_in_range(position, end(), src)) {
+        const ElementT* src = addressOf(element);
+        if (isPointerInRange(position, end(), src)) {
             src += n;
         }
-        auto guard = std::__make_exception_guard(ShiftArrayTailLeft(*this, position + n, n));
+        auto guard = makeExceptionGuard(ShiftArrayTailLeft(*this, position + n, n));
         copyElement(*src, n, position);
-        guard.__complete();
+        guard.complete();
     }
 
-    void shiftAndConstructAt(ElementT* position, const ElementT* first, const ElementT* last, size_t n) {
+    void shiftAndConstructAt(ElementT* position, const ElementT* first, const ElementT* last, size_t n)
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
         shiftTailRight(position, n);
         const ElementT* src = first;
-        if (std::__is_pointer_in_range(position, end(), src)) {
+        if (isPointerInRange(position, end(), src)) {
             src += n;
         }
-        auto guard = std::__make_exception_guard(ShiftArrayTailLeft(*this, position + n, n));
+        auto guard = makeExceptionGuard(ShiftArrayTailLeft(*this, position + n, n));
         copyRange(src, src + n, position);
-        guard.__complete();
+        guard.complete();
     }
 
-    void shiftTailRight(ElementT* position, size_t n) noexcept {
-        assert(std::__is_pointer_in_range(begin(), end(), position));
+    void shiftTailRight(ElementT* position, size_t n) noexcept
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
+        assert(isPointerInRange(begin(), end(), position));
         assert(n > 0);
         assert(_size + n <= _capacity);
         auto srcBegin = std::reverse_iterator<ElementT*>(end());
         auto srcEnd = std::reverse_iterator<ElementT*>(position);
         auto dst = std::reverse_iterator<ElementT*>(end() + n);
         for (; srcBegin != srcEnd; ++srcBegin, ++dst) {
-            new (std::to_address(dst)) ElementT(std::move(*srcBegin));
+            new (std::prev(dst.base())) ElementT(std::move(*srcBegin));
             srcBegin->~ElementT();
         }
         _size += n;
     }
 
-    void shiftTailLeft(ElementT* position, size_t n) noexcept {
-        assert(std::__is_pointer_in_range(begin(), end(), position));
+    void shiftTailLeft(ElementT* position, size_t n) noexcept
+        requires(!isTriviallyRelocatable<ElementT>)
+    {
+        assert(isPointerInRange(begin(), end(), position));
         assert(n > 0);
         assert(position - n >= begin());
         ElementT* srcBegin = position;
@@ -991,19 +1671,24 @@ private:
         _size -= n;
     }
 
+    // `std::addressof` without pulling in <memory>.
+    template <typename T>
+    static T* addressOf(T& object) noexcept {
+        return __builtin_addressof(object);
+    }
+
+    void checkSlice(size_t first, size_t count, size_t stride) const {
+        if (count == 0 ? first > _size : first >= _size || (stride > 0 && count - 1 > (_size - 1 - first) / stride)) {
+            throw std::out_of_range("Slice is out of range");
+        }
+    }
+
     std::align_val_t alignment() const noexcept {
         return static_cast<std::align_val_t>(alignof(ElementT));
     }
 
     size_t extendedCapacity(size_t requiredCapacity) const {
-        size_t ms = maxSize();
-        if (requiredCapacity > ms) {
-            throw std::length_error("Required capacity is too large");
-        }
-        if (_capacity >= ms / 2) {
-            return ms;
-        }
-        return std::max(_capacity * 2, requiredCapacity);
+        return Core<>::grownCapacity(_capacity, requiredCapacity);
     }
 
     struct AllocateTransaction {
@@ -1063,25 +1748,49 @@ private:
             , position(position)
             , n(n) {};
 
-        void operator()() const {
+        void operator()() const
+            requires(!isTriviallyRelocatable<ElementT>)
+        {
             array.shiftTailLeft(position, n);
         }
     };
 
-    friend std::formatter<DArray<ElementT>>;
 };
 
-template <typename ElementT>
-struct std::formatter<DArray<ElementT>> : std::formatter<std::string_view> {
-    auto format(const DArray<ElementT>& array, auto& context) const {
-        std::string result = "[";
-        for (int i = 0; i < array.size(); ++i) {
-            if (i > 0) result += " ";
-            result += std::format("{}", *(array._data + i));
-        }
-        result += "]";
-        return std::formatter<std::string_view>::format(result, context);
-    }
-};
+template <typename T>
+inline constexpr bool isDArray = false;
 
+template <typename ElementT, Allocator AllocatorT>
+inline constexpr bool isDArray<DArray<ElementT, AllocatorT>> = true;
+
+// A DArray is just an owning pointer plus sizes, so it relocates bitwise when its allocator does.
+template <typename ElementT, Allocator AllocatorT>
+inline constexpr bool isTriviallyRelocatable<DArray<ElementT, AllocatorT>> = std::is_trivially_copyable_v<AllocatorT>;
+
+/**
+ * @brief Concatenates DArrays of the same type into a new DArray.
+ * The result is allocated exactly once. Elements of rvalue arguments are relocated in bulk
+ * (their arrays are left empty); elements of lvalue arguments are copied.
+ * @param first The first array.
+ * @param rest The remaining arrays, in order.
+ * @return A DArray holding all elements in argument order.
+ * @throws std::bad_alloc If memory allocation fails.
+ * @throws Any exception thrown by the ElementT copy constructor.
+ */
+template <typename ArrayT, typename... ArrayTs>
+    requires isDArray<std::remove_cvref_t<ArrayT>> &&
+             (std::same_as<std::remove_cvref_t<ArrayTs>, std::remove_cvref_t<ArrayT>> && ...)
+std::remove_cvref_t<ArrayT> concat(ArrayT&& first, ArrayTs&&... rest) {
+    std::remove_cvref_t<ArrayT> result;
+    result.reserve((first.size() + ... + rest.size()));
+    result.append(std::forward<ArrayT>(first));
+    (result.append(std::forward<ArrayTs>(rest)), ...);
+    return result;
+}
+
+#if defined(__cpp_lib_containers_ranges)
+template <std::ranges::input_range RangeT>
+DArray(std::from_range_t, RangeT&&) -> DArray<std::ranges::range_value_t<RangeT>>;
+
+#endif
 #endif // DYNAMIC_ARRAY_HPP
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "dynamic_array.hpp"
+#include "dynamic_array_format.hpp"
 #include <print>
 
 template <typename T>
@@ -122,4 +122,25 @@ int main() {
     arr19.swap(arr20);
     print_info(arr19);
     print_info(arr20);
+
+    std::println("Slices");
+    DArray<int> arr21 = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    DArray<int> arr22;
+    arr22.assign(arr21.slice(2, 4));
+    print_info(arr22);
+    for (int& x : arr21.slice(0, 5, 2)) {
+        x = 0;
+    }
+    print_info(arr21);
+
+    std::println("Concat, splice and split");
+    DArray<int> arr23 = {1, 2, 3};
+    DArray<int> arr24 = {4, 5, 6};
+    DArray<int> arr25 = concat(arr23, std::move(arr24));
+    print_info(arr25);
+    arr23.splice(arr23.begin(), arr25, arr25.end() - 2, arr25.end());
+    print_info(arr23);
+    DArray<int> arr26 = arr25.splitAt(2);
+    print_info(arr25);
+    print_info(arr26);
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef DYNAMIC_ARRAY_FORMAT_HPP
+#define DYNAMIC_ARRAY_FORMAT_HPP
+
+#include "dynamic_array.hpp"
+#include <format>
+#include <string>
+#include <string_view>
+
+// `std::format` support for DArray, kept out of dynamic_array.hpp so that code using only the
+// container does not pay for parsing <format>. Elements are printed as "[a b c]".
+template <typename ElementT>
+struct std::formatter<DArray<ElementT>> : std::formatter<std::string_view> {
+    auto format(const DArray<ElementT>& array, auto& context) const {
+        std::string result = "[";
+        for (size_t i = 0; i < array.size(); ++i) {
+            if (i > 0) result += " ";
+            result += std::format("{}", array[i]);
+        }
+        result += "]";
+        return std::formatter<std::string_view>::format(result, context);
+    }
+};
+
+#endif // DYNAMIC_ARRAY_FORMAT_HPP
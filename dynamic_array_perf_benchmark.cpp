@@ -0,0 +1,85 @@
+#include "dynamic_array.hpp"
+#include "perf_benchmark.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+// Hardware-counter profile of common `DArray` operations.
+// Usage: dynamic_array_perf_benchmark [--cold] [--cpu N] [--repetitions N]
+// Counters need perf events enabled (`kernel.perf_event_paranoid` <= 2, and not blocked by the
+// container's seccomp profile); without them only wall time is reported.
+
+constexpr size_t elementCount = 1 << 20;
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--cold") == 0) {
+            options.cacheMode = CacheMode::Cold;
+        } else if (std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            options.cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            options.repetitions = static_cast<size_t>(std::atoll(argv[++i]));
+        } else {
+            std::println("usage: {} [--cold] [--cpu N] [--repetitions N]", argv[0]);
+            return 1;
+        }
+    }
+
+    PerfBenchmark bench(options);
+    DArray<uint32_t> indices(elementCount);
+    std::iota(indices.begin(), indices.end(), 0u);
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(1));
+    DArray<uint64_t> values(elementCount);
+    std::iota(values.begin(), values.end(), 0);
+    uint64_t sink = 0;
+
+    bench.run("push", elementCount, [] { return DArray<uint64_t>(); }, [](DArray<uint64_t>& array) {
+        for (size_t i = 0; i < elementCount; ++i) {
+            array.push(i);
+        }
+    });
+
+    bench.run("push (reserved)", elementCount, [] {
+        DArray<uint64_t> array;
+        array.reserve(elementCount);
+        return array;
+    }, [](DArray<uint64_t>& array) {
+        for (size_t i = 0; i < elementCount; ++i) {
+            array.push(i);
+        }
+    });
+
+    bench.run("sequential read", elementCount, [&] {
+        sink += std::accumulate(values.begin(), values.end(), uint64_t{0});
+    });
+
+    bench.run("random read", elementCount, [&] {
+        uint64_t sum = 0;
+        for (uint32_t index : indices) {
+            sum += values[index];
+        }
+        sink += sum;
+    });
+
+    bench.run("data-dependent branch", elementCount, [&] {
+        uint64_t count = 0;
+        for (uint32_t index : indices) {
+            if (index & 1) {
+                ++count;
+            }
+        }
+        sink += count;
+    });
+
+    bench.run("insert at front", 1000, [] { return DArray<uint64_t>(elementCount / 16); }, [](DArray<uint64_t>& array) {
+        for (uint64_t i = 0; i < 1000; ++i) {
+            array.insert(array.begin(), i);
+        }
+    });
+
+    bench.print();
+    std::println("checksum: {}", sink);
+}
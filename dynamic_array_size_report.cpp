@@ -0,0 +1,54 @@
+// Translation unit for the `dynamic_array_size_report` target. It is compiled once per entry of
+// `SizeReportTypes`, each time explicitly instantiating `DArray` for that type only, plus once
+// without `SIZE_REPORT_TYPE_INDEX` as the baseline. The relocation cores are shared between types
+// of the same size and alignment, so they are only emitted by the baseline; each type's object
+// holds just the code owned by the instantiation itself.
+
+#include "dynamic_array.hpp"
+#include "type_list.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+struct Pixel {
+    uint8_t r, g, b, a;
+};
+
+using SizeReportTypes = TypeList<int32_t, uint32_t, float, Pixel, int64_t, double, void*, std::pair<int32_t, int32_t>, std::string>;
+
+#if defined(SIZE_REPORT_TYPE_INDEX)
+using SizeReportType = SizeReportTypes::type_at_t<SIZE_REPORT_TYPE_INDEX>;
+
+extern template class RelocationCore<sizeof(SizeReportType), alignof(SizeReportType), DefaultAllocator>;
+template class DArray<SizeReportType>;
+#else
+// Emits the out-of-line core functions used by `DArray<T>`; types that are not trivially
+// relocatable only use the growth policy.
+template <typename T>
+void emitCore() {
+    using Core = RelocationCore<sizeof(T), alignof(T), DefaultAllocator>;
+    if constexpr (isTriviallyRelocatable<T>) {
+        [[maybe_unused]] static void (*volatile functions[])() = {
+            reinterpret_cast<void (*)()>(&Core::insert),
+            reinterpret_cast<void (*)()>(&Core::erase),
+            reinterpret_cast<void (*)()>(&Core::reserve),
+            reinterpret_cast<void (*)()>(&Core::shrinkToFit),
+            reinterpret_cast<void (*)()>(&Core::splice),
+            reinterpret_cast<void (*)()>(&Core::rotate),
+            reinterpret_cast<void (*)()>(&Core::splitAt),
+            reinterpret_cast<void (*)()>(&Core::grownCapacity),
+        };
+    } else {
+        [[maybe_unused]] static void (*volatile functions[])() = {
+            reinterpret_cast<void (*)()>(&Core::grownCapacity),
+        };
+    }
+}
+
+template <typename... Types>
+void emitCores(TypeList<Types...>) {
+    (emitCore<Types>(), ...);
+}
+
+template void emitCores(SizeReportTypes);
+#endif
@@ -3,7 +3,13 @@
 #include <initializer_list>
 #include <limits>
 #include <new>
+#include <algorithm>
+#include <forward_list>
+#include <numeric>
 #include <print>
+#include <ranges>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 
 // Test allocator that can throw during allocation
@@ -1113,6 +1119,53 @@ TEST_F(DArrayTest, ShrinkToFitZeroSize) {
     EXPECT_EQ(Probe::destructionCount, 3);
 }
 
+// Test that resize() grows with default-constructed elements and shrinks by destroying the tail
+TEST_F(DArrayTest, Resize) {
+    std::initializer_list<Probe> elements = {1, 2, 3};
+    {
+        DArrayType arr = elements;
+
+        arr.resize(5);
+
+        EXPECT_EQ(arr.size(), 5);
+        EXPECT_EQ(arr.capacity(), 6);
+        EXPECT_EQ(arr[2].id, 3);
+        EXPECT_EQ(arr[4].id, 0);
+
+        arr.resize(2);
+
+        EXPECT_EQ(arr.size(), 2);
+        EXPECT_EQ(arr.capacity(), 6);
+        EXPECT_EQ(arr[1].id, 2);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, 2);
+    EXPECT_EQ(TestAllocator::deallocationCount, 2);
+    EXPECT_EQ(Probe::constructionCount, 8);
+    EXPECT_EQ(Probe::destructionCount, 5);
+}
+
+// Test that resizeForOverwrite() keeps existing elements and default-constructs class types
+TEST_F(DArrayTest, ResizeForOverwrite) {
+    DArray<int> ints = {1, 2, 3};
+
+    ints.resizeForOverwrite(100);
+    std::fill(ints.begin() + 3, ints.end(), 7);
+
+    EXPECT_EQ(ints.size(), 100);
+    EXPECT_EQ(ints[2], 3);
+    EXPECT_EQ(ints[99], 7);
+
+    {
+        DArrayType arr;
+        arr.resizeForOverwrite(4);
+
+        EXPECT_EQ(arr.size(), 4);
+        EXPECT_EQ(arr[3].id, 0);
+    }
+    EXPECT_EQ(Probe::constructionCount, 4);
+    EXPECT_EQ(Probe::destructionCount, 4);
+}
+
 // =============================================================================
 // Modifiers
 // =============================================================================
@@ -2179,6 +2232,558 @@ TEST_F(DArrayTest, EmplaceReallocElementFailure) {
     EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
 }
 
+// =============================================================================
+// Slices and Ranges
+// =============================================================================
+
+static_assert(std::ranges::contiguous_range<DArray<int>>);
+static_assert(std::ranges::sized_range<DArray<int>>);
+static_assert(std::ranges::contiguous_range<const DArray<int>>);
+static_assert(std::ranges::random_access_range<StridedSlice<int>>);
+static_assert(std::ranges::view<StridedSlice<int>>);
+static_assert(std::ranges::borrowed_range<StridedSlice<int>>);
+static_assert(std::is_convertible_v<DArray<int>&, std::span<int>>);
+static_assert(std::is_convertible_v<const DArray<int>&, std::span<const int>>);
+
+// Test that a DArray can be viewed as a span
+TEST_F(DArrayTest, SpanConversion) {
+    DArray<int> arr = {1, 2, 3, 4};
+    std::span<int> view = arr;
+    view[1] = 20;
+
+    EXPECT_EQ(view.size(), 4);
+    EXPECT_EQ(view.data(), arr.data());
+    EXPECT_EQ(arr[1], 20);
+}
+
+// Test that slice returns a view into the array
+TEST_F(DArrayTest, Slice) {
+    DArray<int> arr = {0, 1, 2, 3, 4, 5};
+    std::span<int> view = arr.slice(2, 3);
+
+    EXPECT_EQ(view.size(), 3);
+    EXPECT_EQ(view.data(), arr.data() + 2);
+    std::ranges::fill(view, 7);
+    EXPECT_EQ(arr[1], 1);
+    EXPECT_EQ(arr[2], 7);
+    EXPECT_EQ(arr[4], 7);
+    EXPECT_EQ(arr[5], 5);
+
+    const DArray<int>& constArr = arr;
+    std::span<const int> constView = constArr.slice(0, 2);
+    EXPECT_EQ(constView[1], 1);
+}
+
+// Test slice bounds checking
+TEST_F(DArrayTest, SliceOutOfRange) {
+    DArray<int> arr = {0, 1, 2, 3};
+
+    EXPECT_TRUE(arr.slice(4, 0).empty());
+    EXPECT_EQ(arr.slice(0, 4).size(), 4);
+    EXPECT_THROW(arr.slice(5, 0), std::out_of_range);
+    EXPECT_THROW(arr.slice(2, 3), std::out_of_range);
+    EXPECT_THROW(arr.slice(1, std::numeric_limits<size_t>::max()), std::out_of_range);
+}
+
+// Test that strided slices visit every stride-th element
+TEST_F(DArrayTest, StridedSlice) {
+    DArray<int> arr(10);
+    std::iota(arr.begin(), arr.end(), 0);
+    StridedSlice<int> view = arr.slice(1, 3, 3);
+
+    EXPECT_EQ(view.size(), 3);
+    EXPECT_EQ(view[0], 1);
+    EXPECT_EQ(view[1], 4);
+    EXPECT_EQ(view[2], 7);
+    EXPECT_EQ(std::ranges::distance(view), 3);
+    EXPECT_EQ(view.end() - view.begin(), 3);
+    EXPECT_EQ(*(view.begin() + 2), 7);
+
+    for (int& element : view) {
+        element = -element;
+    }
+    EXPECT_EQ(arr[4], -4);
+    EXPECT_EQ(arr[5], 5);
+
+    auto reversed = view | std::views::reverse;
+    EXPECT_EQ(*reversed.begin(), -7);
+}
+
+// Test strided slice bounds checking
+TEST_F(DArrayTest, StridedSliceOutOfRange) {
+    DArray<int> arr(10);
+
+    EXPECT_EQ(arr.slice(0, 4, 3).size(), 4);
+    EXPECT_EQ(arr.slice(9, 1, 100).size(), 1);
+    EXPECT_EQ(arr.slice(3, 5, 0).size(), 5);
+    EXPECT_EQ(arr.slice(10, 0, 2).size(), 0);
+    EXPECT_THROW(arr.slice(1, 4, 3), std::out_of_range);
+    EXPECT_THROW(arr.slice(10, 1, 0), std::out_of_range);
+}
+
+// Test that range algorithms work on slices without copying
+TEST_F(DArrayTest, SliceAlgorithms) {
+    DArray<int> arr = {5, 4, 3, 2, 1, 0};
+    std::ranges::sort(arr.slice(0, 3));
+
+    EXPECT_EQ(arr[0], 3);
+    EXPECT_EQ(arr[1], 4);
+    EXPECT_EQ(arr[2], 5);
+    EXPECT_EQ(arr[3], 2);
+
+    const DArray<int>& constArr = arr;
+    StridedSlice<const int> evens = constArr.slice(0, 3, 2);
+    EXPECT_EQ(std::ranges::max(evens), 5);
+}
+
+// Test assign and insert from slices
+TEST_F(DArrayTest, AssignInsertSpan) {
+    std::initializer_list<Probe> elements = {1, 2, 3, 4, 5};
+    {
+        DArrayType source = elements;
+        DArrayType arr;
+        arr.assign(source.slice(1, 3));
+
+        EXPECT_EQ(arr.size(), 3);
+        EXPECT_EQ(arr[0].id, 2);
+        EXPECT_EQ(arr[2].id, 4);
+
+        arr.insert(arr.begin() + 1, source.slice(3, 2));
+        EXPECT_EQ(arr.size(), 5);
+        EXPECT_EQ(arr[0].id, 2);
+        EXPECT_EQ(arr[1].id, 4);
+        EXPECT_EQ(arr[2].id, 5);
+        EXPECT_EQ(arr[3].id, 3);
+
+        arr.assign(source);
+        EXPECT_EQ(arr.size(), 5);
+        EXPECT_EQ(arr[4].id, 5);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+#if defined(__cpp_lib_containers_ranges)
+// Test that constructing from a sized range allocates exactly once
+TEST_F(DArrayTest, FromRangeSized) {
+    std::initializer_list<Probe> elements = {1, 2, 3, 4, 5};
+    {
+        DArrayType source = elements;
+        DArrayType arr(std::from_range, source | std::views::drop(1));
+
+        EXPECT_EQ(TestAllocator::allocationCount, 2);
+        EXPECT_EQ(arr.size(), 4);
+        EXPECT_EQ(arr.capacity(), 4);
+        EXPECT_EQ(arr[0].id, 2);
+        EXPECT_EQ(arr[3].id, 5);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test that constructing from a forward range that is not sized still allocates exactly once
+TEST_F(DArrayTest, FromRangeForward) {
+    std::forward_list<int> list = {1, 2, 3};
+    {
+        DArrayType arr(std::from_range, list);
+
+        EXPECT_EQ(TestAllocator::allocationCount, 1);
+        EXPECT_EQ(arr.capacity(), 3);
+        EXPECT_EQ(arr[2].id, 3);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+}
+
+// Test constructing from a single-pass input range
+TEST_F(DArrayTest, FromRangeInput) {
+    std::istringstream input("1 2 3 4 5");
+    DArray<int> arr(std::from_range, std::views::istream<int>(input));
+
+    EXPECT_EQ(arr.size(), 5);
+    EXPECT_EQ(arr[4], 5);
+}
+
+// Test from_range constructor with element construction failure
+TEST_F(DArrayTest, FromRangeElementFailure) {
+    std::initializer_list<Probe> elements = {1, 2, 3, 4, 5};
+    Probe::constructorThrowsAt = 8;
+    {
+        DArrayType source = elements;
+
+        EXPECT_THROW({ DArrayType arr(std::from_range, source); }, std::runtime_error);
+
+        EXPECT_EQ(source.size(), 5);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test class template argument deduction from a range
+TEST_F(DArrayTest, FromRangeDeduction) {
+    DArray arr(std::from_range, std::views::iota(0, 4) | std::views::transform([](int i) { return i * 0.5; }));
+
+    static_assert(std::is_same_v<decltype(arr), DArray<double>>);
+    EXPECT_EQ(arr.size(), 4);
+    EXPECT_EQ(arr[3], 1.5);
+}
+#endif
+
+#if defined(__cpp_lib_ranges_to_container)
+// Test std::ranges::to with a single allocation
+TEST_F(DArrayTest, RangesTo) {
+    DArray<int> source = {1, 2, 3, 4, 5, 6};
+    {
+        auto arr = source.slice(0, 6, 2) | std::ranges::to<DArray<Probe, TestAllocator>>();
+
+        EXPECT_EQ(TestAllocator::allocationCount, 1);
+        EXPECT_EQ(arr.size(), 3);
+        EXPECT_EQ(arr[2].id, 5);
+    }
+    auto deduced = source | std::views::filter([](int i) { return i % 2 == 0; }) | std::ranges::to<DArray>();
+    static_assert(std::is_same_v<decltype(deduced), DArray<int>>);
+    EXPECT_EQ(deduced.size(), 3);
+}
+#endif
+
+// =============================================================================
+// Bulk Data Movement
+// =============================================================================
+
+static_assert(isTriviallyRelocatable<int>);
+static_assert(!isTriviallyRelocatable<Probe>);
+static_assert(isTriviallyRelocatable<DArray<Probe>>);
+
+// Test that concat allocates exactly once and keeps argument order
+TEST_F(DArrayTest, Concat) {
+    std::initializer_list<Probe> elements = {1, 2, 3};
+    {
+        DArrayType a = elements;
+        DArrayType b = elements;
+        DArrayType c;
+        DArrayType d = elements;
+        int allocations = TestAllocator::allocationCount;
+
+        DArrayType all = concat(a, std::move(b), c, std::move(d));
+
+        EXPECT_EQ(TestAllocator::allocationCount, allocations + 1);
+        EXPECT_EQ(all.size(), 9);
+        EXPECT_EQ(all.capacity(), 9);
+        for (size_t i = 0; i < all.size(); ++i) {
+            EXPECT_EQ(all[i].id, static_cast<int>(i % 3) + 1);
+        }
+        EXPECT_EQ(a.size(), 3);
+        EXPECT_TRUE(b.empty());
+        EXPECT_TRUE(d.empty());
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test concat of trivially relocatable elements
+TEST_F(DArrayTest, ConcatTrivial) {
+    DArray<int> a = {1, 2};
+    DArray<int> b = {3, 4, 5};
+
+    DArray<int> all = concat(std::move(a), std::move(b));
+
+    EXPECT_EQ(all.size(), 5);
+    EXPECT_EQ(all[0], 1);
+    EXPECT_EQ(all[4], 5);
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(b.empty());
+}
+
+// Test appending another array without reallocation
+TEST_F(DArrayTest, AppendMove) {
+    std::initializer_list<Probe> elements = {1, 2, 3};
+    {
+        DArrayType arr;
+        arr.reserve(10);
+        arr.append(elements);
+        DArrayType other = elements;
+        int allocations = TestAllocator::allocationCount;
+
+        arr.append(std::move(other));
+
+        EXPECT_EQ(TestAllocator::allocationCount, allocations);
+        EXPECT_EQ(arr.size(), 6);
+        EXPECT_EQ(arr[3].id, 1);
+        EXPECT_EQ(arr[5].id, 3);
+        EXPECT_TRUE(other.empty());
+        EXPECT_EQ(other.capacity(), 3);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test splicing a range between arrays with and without reallocation
+TEST_F(DArrayTest, Splice) {
+    std::initializer_list<Probe> elements = {1, 2, 3, 4, 5};
+    std::initializer_list<Probe> others = {10, 20, 30, 40};
+    {
+        DArrayType dst = elements;
+        DArrayType src = others;
+
+        Probe* result = dst.splice(dst.begin() + 1, src, src.begin() + 1, src.begin() + 3);
+
+        EXPECT_EQ(result, dst.begin() + 1);
+        EXPECT_EQ(dst.size(), 7);
+        EXPECT_EQ(dst.capacity(), 10);
+        EXPECT_EQ(dst[0].id, 1);
+        EXPECT_EQ(dst[1].id, 20);
+        EXPECT_EQ(dst[2].id, 30);
+        EXPECT_EQ(dst[3].id, 2);
+        EXPECT_EQ(dst[6].id, 5);
+        EXPECT_EQ(src.size(), 2);
+        EXPECT_EQ(src[0].id, 10);
+        EXPECT_EQ(src[1].id, 40);
+
+        dst.splice(dst.end() - 1, src, src.begin(), src.end());
+
+        EXPECT_EQ(dst.size(), 9);
+        EXPECT_EQ(dst.capacity(), 10);
+        EXPECT_EQ(dst[6].id, 10);
+        EXPECT_EQ(dst[7].id, 40);
+        EXPECT_EQ(dst[8].id, 5);
+        EXPECT_TRUE(src.empty());
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test splice with reallocation failure
+TEST_F(DArrayTest, SpliceReallocFailure) {
+    std::initializer_list<Probe> elements = {1, 2, 3};
+    TestAllocator::allocationThrowsAt = 3;
+    {
+        DArrayType dst = elements;
+        DArrayType src = elements;
+
+        EXPECT_THROW({ dst.splice(dst.begin(), src, src.begin(), src.end()); }, std::bad_alloc);
+
+        EXPECT_EQ(dst.size(), 3);
+        EXPECT_EQ(src.size(), 3);
+        EXPECT_EQ(dst[0].id, 1);
+        EXPECT_EQ(src[2].id, 3);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test splicing within the same array
+TEST_F(DArrayTest, SpliceSelf) {
+    DArray<int> arr = {0, 1, 2, 3, 4, 5};
+
+    int* result = arr.splice(arr.begin() + 1, arr, arr.begin() + 3, arr.begin() + 5);
+    EXPECT_EQ(result, arr.begin() + 1);
+    EXPECT_TRUE(std::ranges::equal(arr, std::initializer_list<int>{0, 3, 4, 1, 2, 5}));
+
+    result = arr.splice(arr.end(), arr, arr.begin(), arr.begin() + 2);
+    EXPECT_EQ(result, arr.begin() + 4);
+    EXPECT_TRUE(std::ranges::equal(arr, std::initializer_list<int>{4, 1, 2, 5, 0, 3}));
+}
+
+// Test splicing within the same array for a type that is not assignable
+TEST_F(DArrayTest, SpliceSelfRelocate) {
+    std::initializer_list<Probe> elements = {0, 1, 2, 3, 4};
+    {
+        DArrayType arr = elements;
+
+        arr.splice(arr.begin(), arr, arr.begin() + 3, arr.end());
+        EXPECT_TRUE(std::ranges::equal(arr, std::initializer_list<int>{3, 4, 0, 1, 2}, {}, &Probe::id));
+
+        arr.splice(arr.end(), arr, arr.begin(), arr.begin() + 1);
+        EXPECT_TRUE(std::ranges::equal(arr, std::initializer_list<int>{4, 0, 1, 2, 3}, {}, &Probe::id));
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test splitting an array
+TEST_F(DArrayTest, SplitAt) {
+    std::initializer_list<Probe> elements = {1, 2, 3, 4, 5};
+    {
+        DArrayType arr = elements;
+        int allocations = TestAllocator::allocationCount;
+
+        DArrayType tail = arr.splitAt(2);
+
+        EXPECT_EQ(TestAllocator::allocationCount, allocations + 1);
+        EXPECT_EQ(arr.size(), 2);
+        EXPECT_EQ(arr.capacity(), 5);
+        EXPECT_EQ(tail.size(), 3);
+        EXPECT_EQ(tail.capacity(), 3);
+        EXPECT_EQ(arr[1].id, 2);
+        EXPECT_EQ(tail[0].id, 3);
+        EXPECT_EQ(tail[2].id, 5);
+
+        EXPECT_TRUE(arr.splitAt(2).empty());
+        EXPECT_THROW(arr.splitAt(3), std::out_of_range);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
+// Test bulk movement of nested arrays (trivially relocatable non-trivial type)
+TEST_F(DArrayTest, SplitAtNested) {
+    DArray<DArray<int>> arr;
+    for (int i = 0; i < 4; ++i) {
+        arr.push(DArray<int>(i, 3));
+    }
+
+    DArray<DArray<int>> tail = arr.splitAt(1);
+    arr.append(std::move(tail));
+    arr.append(arr.splitAt(0));
+
+    EXPECT_EQ(arr.size(), 4);
+    EXPECT_EQ(arr[3][2], 3);
+}
+
+// =============================================================================
+// Relocation Core
+// =============================================================================
+
+// Test the untyped operations on raw elements
+TEST_F(DArrayTest, RelocationCore) {
+    using Core = RelocationCore<sizeof(int), alignof(int), DefaultAllocator>;
+    auto constructCopies = [](void* destination, size_t n, const void* source) {
+        std::fill_n(static_cast<int*>(destination), n, *static_cast<const int*>(source));
+    };
+    DefaultAllocator allocator;
+    void* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+    int value = 7;
+    data = Core::insert(data, size, capacity, allocator, 0, 3, constructCopies, &value);
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(capacity, 3);
+    int* ints = static_cast<int*>(data);
+    EXPECT_EQ(ints[2], 7);
+    ints[0] = 0;
+    ints[1] = 1;
+    ints[2] = 2;
+
+    data = Core::reserve(data, size, capacity, allocator, 8);
+    ints = static_cast<int*>(data);
+    EXPECT_EQ(capacity, 8);
+    EXPECT_EQ(ints[2], 2);
+
+    // The source moves along with the elements that make room for the copies.
+    EXPECT_EQ(Core::insert(data, size, capacity, allocator, 1, 2, constructCopies, ints + 2), data);
+    EXPECT_EQ(size, 5);
+    EXPECT_EQ(ints[1], 2);
+    EXPECT_EQ(ints[2], 2);
+    EXPECT_EQ(ints[3], 1);
+
+    Core::erase(data, size, 1, 2);
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(ints[1], 1);
+    EXPECT_EQ(ints[2], 2);
+
+    data = Core::shrinkToFit(data, size, capacity, allocator);
+    ints = static_cast<int*>(data);
+    EXPECT_EQ(capacity, 3);
+    Core::rotate(data, 0, 1, 3);
+    EXPECT_EQ(ints[0], 1);
+    EXPECT_EQ(ints[2], 0);
+
+    void* tail = Core::splitAt(data, size, 1, allocator);
+    size_t tailSize = 2;
+    EXPECT_EQ(size, 1);
+    EXPECT_EQ(static_cast<int*>(tail)[1], 0);
+    data = Core::splice(data, size, capacity, allocator, 0, tail, tailSize, 0, 2);
+    ints = static_cast<int*>(data);
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(tailSize, 0);
+    EXPECT_EQ(ints[0], 2);
+    EXPECT_EQ(ints[1], 0);
+    EXPECT_EQ(ints[2], 1);
+    allocator.deallocate(tail, std::align_val_t(alignof(int)));
+    allocator.deallocate(data, std::align_val_t(alignof(int)));
+
+    EXPECT_EQ(Core::grownCapacity(4, 5), 8);
+    EXPECT_EQ(Core::grownCapacity(4, 20), 20);
+    EXPECT_EQ(Core::grownCapacity(Core::maxSize - 1, Core::maxSize), Core::maxSize);
+    EXPECT_THROW(Core::grownCapacity(4, Core::maxSize + 1), std::length_error);
+}
+
+// Test that an insertion whose construction throws leaves the elements and storage unchanged
+TEST_F(DArrayTest, RelocationCoreRollback) {
+    using Core = RelocationCore<sizeof(int), alignof(int), DefaultAllocator>;
+    auto constructThrowing = [](void*, size_t, const void*) {
+        throw std::runtime_error("construct");
+    };
+    DefaultAllocator allocator;
+    size_t size = 3;
+    size_t capacity = 4;
+    void* data = allocator.allocate(capacity * sizeof(int), std::align_val_t(alignof(int)));
+    int* ints = static_cast<int*>(data);
+    ints[0] = 0;
+    ints[1] = 1;
+    ints[2] = 2;
+
+    EXPECT_THROW(Core::insert(data, size, capacity, allocator, 1, 1, constructThrowing, nullptr), std::runtime_error);
+    EXPECT_THROW(Core::insert(data, size, capacity, allocator, 1, 2, constructThrowing, nullptr), std::runtime_error);
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(capacity, 4);
+    EXPECT_EQ(ints[0], 0);
+    EXPECT_EQ(ints[1], 1);
+    EXPECT_EQ(ints[2], 2);
+    allocator.deallocate(data, std::align_val_t(alignof(int)));
+}
+
+// Test growth, insertion and erasure of trivially copyable elements through the core
+TEST_F(DArrayTest, RelocationCoreTrivial) {
+    struct Point {
+        int x;
+        double y;
+    };
+    DArray<Point> arr;
+    for (int i = 0; i < 10; ++i) {
+        arr.push({i, i * 0.5});
+    }
+
+    arr.insert(arr.begin() + 3, Point{-1, -1.0}, 4);
+    arr.erase(arr.begin(), arr.begin() + 2);
+    arr.emplace(arr.end() - 1, Point{42, 0.0});
+    arr.shrinkToFit();
+
+    EXPECT_EQ(arr.size(), 13);
+    EXPECT_EQ(arr.capacity(), 13);
+    EXPECT_EQ(arr[0].x, 2);
+    EXPECT_EQ(arr[1].x, -1);
+    EXPECT_EQ(arr[5].x, 3);
+    EXPECT_EQ(arr[11].x, 42);
+    EXPECT_EQ(arr[12].x, 9);
+    EXPECT_EQ(arr[12].y, 4.5);
+}
+
+// Test that trivially relocatable elements with owning members are never copied, moved or leaked by the core
+TEST_F(DArrayTest, RelocationCoreNested) {
+    std::initializer_list<Probe> elements = {1, 2};
+    {
+        DArray<DArrayType> arr;
+        for (int i = 0; i < 5; ++i) {
+            arr.push(DArrayType(elements));
+        }
+        int constructions = Probe::constructionCount;
+        int destructions = Probe::destructionCount;
+
+        arr.reserve(32);
+        arr.insert(arr.begin() + 1, DArrayType());
+        arr.erase(arr.begin() + 2);
+        arr.shrinkToFit();
+
+        EXPECT_EQ(Probe::constructionCount, constructions);
+        EXPECT_EQ(Probe::destructionCount, destructions + 2);
+        EXPECT_EQ(arr.size(), 5);
+        EXPECT_TRUE(arr[1].empty());
+        EXPECT_EQ(arr[4][1].id, 2);
+    }
+    EXPECT_EQ(TestAllocator::allocationCount, TestAllocator::deallocationCount);
+    EXPECT_EQ(Probe::constructionCount, Probe::destructionCount);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,49 @@
+#ifndef EXCEPTION_GUARD_HPP
+#define EXCEPTION_GUARD_HPP
+
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Runs a rollback action when the scope is left by an exception.
+ * Call `complete()` once the guarded operation has succeeded; otherwise the destructor runs the
+ * rollback. A portable stand-in for libc++'s internal `std::__exception_guard`.
+ * @tparam RollbackT A callable taking no arguments. It must not throw.
+ */
+template <typename RollbackT>
+class [[nodiscard]] ExceptionGuard {
+private:
+    RollbackT _rollback;
+    bool _completed = false;
+
+public:
+    explicit ExceptionGuard(RollbackT rollback) noexcept(std::is_nothrow_move_constructible_v<RollbackT>)
+        : _rollback(std::move(rollback)) {}
+
+    ExceptionGuard(const ExceptionGuard&) = delete;
+
+    ExceptionGuard& operator=(const ExceptionGuard&) = delete;
+
+    ~ExceptionGuard() {
+        if (!_completed) {
+            _rollback();
+        }
+    }
+
+    /**
+     * @brief Marks the guarded operation as successful, so the rollback is not run.
+     */
+    void complete() noexcept {
+        _completed = true;
+    }
+};
+
+/**
+ * @brief Creates an `ExceptionGuard` running `rollback` unless it is completed.
+ */
+template <typename RollbackT>
+ExceptionGuard<RollbackT> makeExceptionGuard(RollbackT rollback) noexcept(std::is_nothrow_move_constructible_v<RollbackT>) {
+    return ExceptionGuard<RollbackT>(std::move(rollback));
+}
+
+#endif // EXCEPTION_GUARD_HPP
@@ -0,0 +1,29 @@
+#include "exception_guard.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+// Test that the rollback runs when the scope is left by an exception
+TEST(ExceptionGuardTest, RollbackOnException) {
+    int rollbacks = 0;
+
+    EXPECT_THROW(
+        {
+            auto guard = makeExceptionGuard([&] { ++rollbacks; });
+            throw std::runtime_error("failed");
+            guard.complete();
+        },
+        std::runtime_error);
+
+    EXPECT_EQ(rollbacks, 1);
+}
+
+// Test that a completed guard does nothing
+TEST(ExceptionGuardTest, Complete) {
+    int rollbacks = 0;
+    {
+        auto guard = makeExceptionGuard([&] { ++rollbacks; });
+        guard.complete();
+    }
+
+    EXPECT_EQ(rollbacks, 0);
+}
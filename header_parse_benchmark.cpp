@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <print>
+#include <string>
+#include <vector>
+
+// Compile-time benchmark: how long the compiler takes to parse each header of the library on its
+// own (`-fsyntax-only` on a translation unit that only includes it), minus an empty translation
+// unit. The compiler, flags and source directory are baked in by CMake; see the
+// `header_parse_report` target. Usage: header_parse_benchmark [runs]
+
+#ifndef HEADER_BENCHMARK_COMPILER
+#define HEADER_BENCHMARK_COMPILER "c++"
+#endif
+#ifndef HEADER_BENCHMARK_FLAGS
+#define HEADER_BENCHMARK_FLAGS "-std=c++23"
+#endif
+#ifndef HEADER_BENCHMARK_SOURCE_DIR
+#define HEADER_BENCHMARK_SOURCE_DIR "."
+#endif
+
+namespace fs = std::filesystem;
+
+// Returns the fastest of `runs` compilations of `source` in milliseconds, or a negative value if it failed.
+double parseMilliseconds(const fs::path& source, int runs) {
+    std::string command = std::string(HEADER_BENCHMARK_COMPILER) + " " + HEADER_BENCHMARK_FLAGS + " -fsyntax-only -I\"" +
+                          HEADER_BENCHMARK_SOURCE_DIR + "\" \"" + source.string() + "\"";
+    double best = -1;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        if (std::system(command.c_str()) != 0) {
+            return -1;
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = best < 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int runs = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    fs::path directory = fs::temp_directory_path() / "header_parse_benchmark";
+    fs::create_directories(directory);
+
+    std::vector<std::string> headers;
+    for (const fs::directory_entry& entry : fs::directory_iterator(HEADER_BENCHMARK_SOURCE_DIR)) {
+        if (entry.path().extension() == ".hpp") {
+            headers.push_back(entry.path().filename().string());
+        }
+    }
+    std::ranges::sort(headers);
+
+    fs::path empty = directory / "empty.cpp";
+    std::ofstream(empty) << "\n";
+    double baseline = parseMilliseconds(empty, runs);
+    if (baseline < 0) {
+        std::println("failed to run {}", HEADER_BENCHMARK_COMPILER);
+        return 1;
+    }
+
+    std::println("{} {}, best of {} runs, empty translation unit: {:.1f} ms", HEADER_BENCHMARK_COMPILER, HEADER_BENCHMARK_FLAGS, runs, baseline);
+    std::println("{:<32} {:>12}", "header", "parse (ms)");
+    for (const std::string& header : headers) {
+        fs::path source = directory / (fs::path(header).stem().string() + ".cpp");
+        std::ofstream(source) << "#include \"" << header << "\"\n";
+        double milliseconds = parseMilliseconds(source, runs);
+        if (milliseconds < 0) {
+            std::println("{:<32} {:>12}", header, "failed");
+        } else {
+            std::println("{:<32} {:>12.1f}", header, milliseconds - baseline);
+        }
+    }
+    fs::remove_all(directory);
+}
@@ -0,0 +1,323 @@
+#ifndef HIERARCHICAL_BITMAP_HPP
+#define HIERARCHICAL_BITMAP_HPP
+
+#include "dynamic_array.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief A set of integers drawn from [0, universe) as a bitmap with 64-way summary levels, for
+ * successor and predecessor queries over both members and non-members (e.g. free IDs).
+ * Above the leaf bitmap, each summary level has one bit per word of the level below, set if that
+ * word holds a member; a second, parallel set of levels has the bit set if the word holds a
+ * non-member. A query looks at one word per level on the way up and one on the way down, finding
+ * bits with `std::countr_zero`/`std::bit_width` (`tzcnt`/`lzcnt` with BMI1/LZCNT enabled), so it
+ * costs O(log64 universe): at most 6 levels for 2^32 IDs. All levels live in one `DArray<uint64_t>`.
+ */
+class HierarchicalBitmap {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+private:
+    // Enough levels for any 64-bit universe.
+    static constexpr size_t maxLevels = 11;
+
+    static constexpr uint64_t allBits = ~uint64_t{0};
+
+    enum Tree : size_t { Members, Absent };
+
+    size_t _universe = 0;
+    size_t _size = 0;
+    size_t _levelCount = 1;
+    // Words per level; level 0 (the leaves) is shared by both trees.
+    std::array<size_t, maxLevels> _wordCounts{};
+    // Where each level of each tree starts in `_words`.
+    std::array<std::array<size_t, maxLevels>, 2> _offsets{};
+    DArray<uint64_t> _words;
+
+public:
+    /**
+     * @brief Constructs an empty set for integers in [0, universe).
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    explicit HierarchicalBitmap(size_t universe)
+        : _universe(universe) {
+        _wordCounts[0] = std::max<size_t>((universe + 63) / 64, 1);
+        while (_wordCounts[_levelCount - 1] > 1) {
+            _wordCounts[_levelCount] = (_wordCounts[_levelCount - 1] + 63) / 64;
+            ++_levelCount;
+        }
+        size_t total = _wordCounts[0];
+        for (Tree tree : {Members, Absent}) {
+            for (size_t level = 1; level < _levelCount; ++level) {
+                _offsets[tree][level] = total;
+                total += _wordCounts[level];
+            }
+        }
+        _words = DArray<uint64_t>(total);
+        refresh(0, _wordCounts[0] - 1);
+    }
+
+    size_t universe() const noexcept {
+        return _universe;
+    }
+
+    /**
+     * @brief Returns the number of members.
+     */
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Checks whether `id` is a member. Integers outside the universe are never members.
+     */
+    bool contains(size_t id) const noexcept {
+        return id < _universe && (_words[id / 64] >> (id % 64) & 1) != 0;
+    }
+
+    /**
+     * @brief Adds `id` to the set.
+     * @return Whether `id` was not a member before.
+     * @throws std::out_of_range If `id` is outside the universe.
+     */
+    bool insert(size_t id) {
+        checkId(id);
+        uint64_t& leaf = _words[id / 64];
+        uint64_t old = leaf;
+        leaf |= uint64_t{1} << (id % 64);
+        if (leaf == old) {
+            return false;
+        }
+        ++_size;
+        if (old == 0) {
+            propagate(Members, id / 64, true);
+        }
+        if (absentBits(id / 64) == 0) {
+            propagate(Absent, id / 64, false);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Removes `id` from the set.
+     * @return Whether `id` was a member.
+     */
+    bool erase(size_t id) noexcept {
+        if (id >= _universe) {
+            return false;
+        }
+        uint64_t& leaf = _words[id / 64];
+        uint64_t old = leaf;
+        bool wasFull = absentBits(id / 64) == 0;
+        leaf &= ~(uint64_t{1} << (id % 64));
+        if (leaf == old) {
+            return false;
+        }
+        --_size;
+        if (leaf == 0) {
+            propagate(Members, id / 64, false);
+        }
+        if (wasFull) {
+            propagate(Absent, id / 64, true);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Adds all integers in [first, last) to the set, a word at a time.
+     * @throws std::out_of_range If the range is not within the universe.
+     */
+    void insertRange(size_t first, size_t last) {
+        assignRange(first, last, true);
+    }
+
+    /**
+     * @brief Removes all integers in [first, last) from the set, a word at a time.
+     * @throws std::out_of_range If the range is not within the universe.
+     */
+    void eraseRange(size_t first, size_t last) {
+        assignRange(first, last, false);
+    }
+
+    void clear() noexcept {
+        if (_size > 0) {
+            std::fill(_words.begin(), _words.begin() + _wordCounts[0], 0);
+            _size = 0;
+            refresh(0, _wordCounts[0] - 1);
+        }
+    }
+
+    /**
+     * @brief Returns the smallest member not less than `x`, or `npos` if there is none.
+     */
+    size_t successor(size_t x) const noexcept {
+        return next<Members>(x);
+    }
+
+    /**
+     * @brief Returns the largest member not greater than `x`, or `npos` if there is none.
+     */
+    size_t predecessor(size_t x) const noexcept {
+        return previous<Members>(x);
+    }
+
+    /**
+     * @brief Returns the smallest non-member not less than `x`, or `npos` if there is none.
+     */
+    size_t nextAbsent(size_t x) const noexcept {
+        return next<Absent>(x);
+    }
+
+    /**
+     * @brief Returns the largest non-member not greater than `x`, or `npos` if there is none.
+     */
+    size_t previousAbsent(size_t x) const noexcept {
+        return previous<Absent>(x);
+    }
+
+private:
+    void checkId(size_t id) const {
+        if (id >= _universe) {
+            throw std::out_of_range("ID out of universe");
+        }
+    }
+
+    // Returns the non-members of leaf word `index`. Bits past the universe are neither.
+    uint64_t absentBits(size_t index) const noexcept {
+        uint64_t valid = index == _wordCounts[0] - 1 && _universe % 64 != 0 ? allBits >> (64 - _universe % 64) : allBits;
+        return ~_words[index] & valid;
+    }
+
+    // Returns word `index` of `level` as seen by `tree`: the absent tree sees the leaves inverted.
+    template <Tree TreeV>
+    uint64_t word(size_t level, size_t index) const noexcept {
+        if (level == 0) {
+            return TreeV == Members ? _words[index] : absentBits(index);
+        }
+        return _words[_offsets[TreeV][level] + index];
+    }
+
+    template <Tree TreeV>
+    size_t next(size_t x) const noexcept {
+        if (x >= _universe) {
+            return npos;
+        }
+        // Climb until a word has a bit at or after the position, then descend to its lowest bit.
+        size_t level = 0;
+        size_t position = x;
+        uint64_t bits = word<TreeV>(0, position / 64) & (allBits << (position % 64));
+        while (bits == 0) {
+            if (++level == _levelCount) {
+                return npos;
+            }
+            position = position / 64 + 1;
+            if (position / 64 >= _wordCounts[level]) {
+                return npos;
+            }
+            bits = word<TreeV>(level, position / 64) & (allBits << (position % 64));
+        }
+        position = position / 64 * 64 + static_cast<size_t>(std::countr_zero(bits));
+        while (level-- > 0) {
+            position = position * 64 + static_cast<size_t>(std::countr_zero(word<TreeV>(level, position)));
+        }
+        return position;
+    }
+
+    template <Tree TreeV>
+    size_t previous(size_t x) const noexcept {
+        if (_universe == 0) {
+            return npos;
+        }
+        size_t position = std::min(x, _universe - 1);
+        size_t level = 0;
+        uint64_t bits = word<TreeV>(0, position / 64) & (allBits >> (63 - position % 64));
+        while (bits == 0) {
+            if (++level == _levelCount || position < 64) {
+                return npos;
+            }
+            position = position / 64 - 1;
+            bits = word<TreeV>(level, position / 64) & (allBits >> (63 - position % 64));
+        }
+        position = position / 64 * 64 + static_cast<size_t>(std::bit_width(bits)) - 1;
+        while (level-- > 0) {
+            position = position * 64 + static_cast<size_t>(std::bit_width(word<TreeV>(level, position))) - 1;
+        }
+        return position;
+    }
+
+    // Sets or clears the summary bit of word `index` of the leaves in `tree`, and continues up
+    // while the summary word it lands in turns empty or non-empty.
+    void propagate(Tree tree, size_t index, bool value) noexcept {
+        for (size_t level = 1; level < _levelCount; ++level) {
+            uint64_t& summary = _words[_offsets[tree][level] + index / 64];
+            uint64_t old = summary;
+            if (value) {
+                summary |= uint64_t{1} << (index % 64);
+            } else {
+                summary &= ~(uint64_t{1} << (index % 64));
+            }
+            if ((old == 0) == (summary == 0)) {
+                return;
+            }
+            index /= 64;
+        }
+    }
+
+    // Rebuilds the summary words above leaf words [first, last] in both trees.
+    void refresh(size_t first, size_t last) noexcept {
+        for (size_t level = 1; level < _levelCount; ++level) {
+            for (size_t summary = first / 64; summary <= last / 64; ++summary) {
+                uint64_t members = 0;
+                uint64_t absent = 0;
+                size_t childEnd = std::min(summary * 64 + 64, _wordCounts[level - 1]);
+                for (size_t child = summary * 64; child < childEnd; ++child) {
+                    uint64_t bit = uint64_t{1} << (child % 64);
+                    uint64_t memberWord = level == 1 ? _words[child] : _words[_offsets[Members][level - 1] + child];
+                    uint64_t absentWord = level == 1 ? absentBits(child) : _words[_offsets[Absent][level - 1] + child];
+                    members |= memberWord != 0 ? bit : 0;
+                    absent |= absentWord != 0 ? bit : 0;
+                }
+                _words[_offsets[Members][level] + summary] = members;
+                _words[_offsets[Absent][level] + summary] = absent;
+            }
+            first /= 64;
+            last /= 64;
+        }
+    }
+
+    void assignRange(size_t first, size_t last, bool value) {
+        if (first > last || last > _universe) {
+            throw std::out_of_range("Range out of universe");
+        }
+        if (first == last) {
+            return;
+        }
+        size_t firstWord = first / 64;
+        size_t lastWord = (last - 1) / 64;
+        for (size_t index = firstWord; index <= lastWord; ++index) {
+            uint64_t mask = allBits;
+            if (index == firstWord) {
+                mask &= allBits << (first % 64);
+            }
+            if (index == lastWord) {
+                mask &= allBits >> (63 - (last - 1) % 64);
+            }
+            uint64_t& leaf = _words[index];
+            uint64_t old = leaf;
+            leaf = value ? leaf | mask : leaf & ~mask;
+            _size = _size + static_cast<size_t>(std::popcount(leaf)) - static_cast<size_t>(std::popcount(old));
+        }
+        refresh(firstWord, lastWord);
+    }
+};
+
+#endif // HIERARCHICAL_BITMAP_HPP
@@ -0,0 +1,82 @@
+#include "dynamic_array.hpp"
+#include "hierarchical_bitmap.hpp"
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+
+// Successor queries on a sparse bitmap and next-free queries on a nearly full one, against a
+// scan of the flat leaf bitmap. Probes are random, so most of the time goes to cache misses on
+// the leaf and lowest summary words. Pass the log2 of the universe (default 28; 32 needs 512 MiB).
+
+namespace {
+
+constexpr int queries = 1'000'000;
+
+// The flat alternative: scan words from `x` until one has a set bit.
+size_t flatSuccessor(const DArray<uint64_t>& words, size_t x) {
+    size_t index = x / 64;
+    uint64_t bits = words[index] & (~uint64_t{0} << (x % 64));
+    while (bits == 0) {
+        if (++index == words.size()) {
+            return HierarchicalBitmap::npos;
+        }
+        bits = words[index];
+    }
+    return index * 64 + static_cast<size_t>(std::countr_zero(bits));
+}
+
+template <typename QueryT>
+double nanosecondsPerQuery(const DArray<size_t>& probes, QueryT query) {
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t probe : probes) {
+        checksum += query(probe);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("  (checksum {})", checksum);
+    return elapsed.count() / static_cast<double>(probes.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t universe = size_t{1} << (argc > 1 ? std::atoi(argv[1]) : 28);
+    std::mt19937_64 random(3);
+    DArray<size_t> probes;
+    for (int i = 0; i < queries; ++i) {
+        probes.push(random() % universe);
+    }
+
+    // One member per ~million IDs.
+    HierarchicalBitmap sparse(universe);
+    DArray<uint64_t> flat(universe / 64);
+    for (size_t i = 0; i < universe >> 20; ++i) {
+        size_t id = random() % universe;
+        sparse.insert(id);
+        flat[id / 64] |= uint64_t{1} << (id % 64);
+    }
+    double hierarchical = nanosecondsPerQuery(probes, [&](size_t x) { return sparse.successor(x); });
+    double scan = nanosecondsPerQuery(DArray<size_t>(probes.begin(), probes.begin() + 1000), [&](size_t x) { return flatSuccessor(flat, x); });
+    std::println("sparse successor: {:.1f} ns hierarchical, {:.1f} ns flat scan", hierarchical, scan);
+
+    // All IDs taken but one per ~million.
+    HierarchicalBitmap dense(universe);
+    dense.insertRange(0, universe);
+    for (size_t i = 0; i < universe >> 20; ++i) {
+        dense.erase(random() % universe);
+    }
+    double nextFree = nanosecondsPerQuery(probes, [&](size_t x) { return dense.nextAbsent(x); });
+    std::println("dense next free: {:.1f} ns", nextFree);
+
+    double churn = nanosecondsPerQuery(probes, [&](size_t x) {
+        size_t id = dense.nextAbsent(x);
+        if (id != HierarchicalBitmap::npos) {
+            dense.insert(id);
+            dense.erase(id);
+        }
+        return id;
+    });
+    std::println("allocate and free: {:.1f} ns", churn);
+}
@@ -0,0 +1,140 @@
+#include "hierarchical_bitmap.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Compares every query of `bitmap` against an ordered set of the same members at `probes` points.
+void expectSameAs(const HierarchicalBitmap& bitmap, const std::set<size_t>& members, const std::vector<size_t>& probes) {
+    ASSERT_EQ(bitmap.size(), members.size());
+    size_t universe = bitmap.universe();
+    // The nearest non-members of every ID, by brute force.
+    std::vector<size_t> nextAbsent(universe + 1, HierarchicalBitmap::npos);
+    std::vector<size_t> previousAbsent(universe, HierarchicalBitmap::npos);
+    for (size_t id = universe; id-- > 0;) {
+        nextAbsent[id] = members.contains(id) ? nextAbsent[id + 1] : id;
+    }
+    for (size_t id = 0; id < universe; ++id) {
+        previousAbsent[id] = !members.contains(id) ? id : id > 0 ? previousAbsent[id - 1] : HierarchicalBitmap::npos;
+    }
+    for (size_t x : probes) {
+        auto after = members.lower_bound(x);
+        EXPECT_EQ(bitmap.successor(x), after == members.end() || x >= universe ? HierarchicalBitmap::npos : *after) << x;
+        auto upTo = members.upper_bound(x);
+        EXPECT_EQ(bitmap.predecessor(x), upTo == members.begin() ? HierarchicalBitmap::npos : *std::prev(upTo)) << x;
+        EXPECT_EQ(bitmap.nextAbsent(x), x < universe ? nextAbsent[x] : HierarchicalBitmap::npos) << x;
+        EXPECT_EQ(bitmap.previousAbsent(x), previousAbsent[std::min(x, universe - 1)]) << x;
+    }
+}
+
+} // namespace
+
+// Test an empty bitmap and universes that do not fill the last word
+TEST(HierarchicalBitmapTest, Empty) {
+    HierarchicalBitmap bitmap(100);
+    EXPECT_TRUE(bitmap.empty());
+    EXPECT_EQ(bitmap.successor(0), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.predecessor(99), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.nextAbsent(0), 0);
+    EXPECT_EQ(bitmap.nextAbsent(99), 99);
+    EXPECT_EQ(bitmap.nextAbsent(100), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.previousAbsent(1000), 99);
+    EXPECT_FALSE(bitmap.contains(100));
+    EXPECT_THROW(bitmap.insert(100), std::out_of_range);
+    EXPECT_FALSE(bitmap.erase(100));
+
+    HierarchicalBitmap none(0);
+    EXPECT_EQ(none.successor(0), HierarchicalBitmap::npos);
+    EXPECT_EQ(none.previousAbsent(0), HierarchicalBitmap::npos);
+}
+
+// Test that a full bitmap has no absent IDs, including in a partial last word
+TEST(HierarchicalBitmapTest, Full) {
+    HierarchicalBitmap bitmap(5000);
+    bitmap.insertRange(0, 5000);
+    EXPECT_EQ(bitmap.size(), 5000);
+    EXPECT_EQ(bitmap.nextAbsent(0), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.previousAbsent(4999), HierarchicalBitmap::npos);
+    EXPECT_TRUE(bitmap.erase(4999));
+    EXPECT_EQ(bitmap.nextAbsent(0), 4999);
+    EXPECT_EQ(bitmap.previousAbsent(HierarchicalBitmap::npos), 4999);
+    EXPECT_TRUE(bitmap.insert(4999));
+    EXPECT_EQ(bitmap.nextAbsent(0), HierarchicalBitmap::npos);
+    bitmap.clear();
+    EXPECT_EQ(bitmap.successor(0), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.nextAbsent(0), 0);
+}
+
+// Test random inserts and erases over three summary levels against std::set
+TEST(HierarchicalBitmapTest, RandomAgainstSet) {
+    constexpr size_t universe = 300'000;
+    HierarchicalBitmap bitmap(universe);
+    std::set<size_t> members;
+    std::mt19937_64 random(5);
+    std::vector<size_t> probes = {0, 1, 63, 64, 4095, 4096, universe - 1, universe, universe + 5};
+    for (int i = 0; i < 300; ++i) {
+        probes.push_back(random() % universe);
+    }
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 2000; ++i) {
+            // Clustered IDs, so that some words fill up completely.
+            size_t id = (random() % 40) * 7000 + random() % (round < 2 ? 70 : 7000);
+            EXPECT_EQ(bitmap.insert(id), members.insert(id).second);
+        }
+        for (int i = 0; i < 500; ++i) {
+            size_t id = random() % universe;
+            EXPECT_EQ(bitmap.erase(id), members.erase(id) == 1);
+        }
+        expectSameAs(bitmap, members, probes);
+    }
+    for (size_t id : members) {
+        EXPECT_TRUE(bitmap.contains(id));
+    }
+}
+
+// Test range inserts and erases against std::set
+TEST(HierarchicalBitmapTest, Ranges) {
+    constexpr size_t universe = 70'000;
+    HierarchicalBitmap bitmap(universe);
+    std::set<size_t> members;
+    std::mt19937_64 random(9);
+    std::vector<size_t> probes;
+    for (int i = 0; i < 200; ++i) {
+        probes.push_back(random() % universe);
+    }
+    for (int i = 0; i < 50; ++i) {
+        size_t first = random() % universe;
+        size_t last = std::min(universe, first + random() % (i % 2 ? 10000 : 100));
+        if (i % 3 == 2) {
+            bitmap.eraseRange(first, last);
+            members.erase(members.lower_bound(first), members.lower_bound(last));
+        } else {
+            bitmap.insertRange(first, last);
+            for (size_t id = first; id < last; ++id) {
+                members.insert(id);
+            }
+        }
+        expectSameAs(bitmap, members, probes);
+    }
+    EXPECT_THROW(bitmap.insertRange(5, universe + 1), std::out_of_range);
+    EXPECT_THROW(bitmap.eraseRange(6, 5), std::out_of_range);
+}
+
+// Test the allocation pattern: take the lowest free ID, free some, and reuse them in order
+TEST(HierarchicalBitmapTest, IdAllocation) {
+    HierarchicalBitmap used(1 << 20);
+    for (size_t i = 0; i < 100'000; ++i) {
+        size_t id = used.nextAbsent(0);
+        ASSERT_EQ(id, i);
+        used.insert(id);
+    }
+    used.erase(77);
+    used.erase(65'000);
+    EXPECT_EQ(used.nextAbsent(0), 77);
+    EXPECT_EQ(used.nextAbsent(78), 65'000);
+    EXPECT_EQ(used.nextAbsent(65'001), 100'000);
+    EXPECT_EQ(used.predecessor(1 << 20), 99'999);
+}
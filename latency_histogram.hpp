@@ -0,0 +1,440 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include "cache_line.hpp"
+#include "dynamic_array.hpp"
+#include "varint.hpp"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief The log-linear bucket layout shared by all histograms (as in HdrHistogram).
+ * Values below 2^`subBucketBits` get a bucket each; above that, every power-of-two range is split
+ * into 2^(`subBucketBits` - 1) equal buckets, so a bucket is never wider than 1/64 of its values.
+ */
+struct HistogramBuckets {
+    static constexpr unsigned subBucketBits = 7;
+    static constexpr uint64_t halfCount = uint64_t{1} << (subBucketBits - 1);
+    static constexpr size_t count = (66 - subBucketBits) * halfCount;
+
+    static constexpr size_t indexOf(uint64_t value) noexcept {
+        auto width = static_cast<unsigned>(std::bit_width(value));
+        unsigned exponent = width > subBucketBits ? width - subBucketBits : 0;
+        return exponent * halfCount + (value >> exponent);
+    }
+
+    static constexpr unsigned exponentOf(size_t index) noexcept {
+        return index < 2 * halfCount ? 0 : static_cast<unsigned>(index / halfCount - 1);
+    }
+
+    /**
+     * @brief Returns the smallest value that falls into bucket `index`.
+     */
+    static constexpr uint64_t lowerBound(size_t index) noexcept {
+        unsigned exponent = exponentOf(index);
+        return (index - exponent * halfCount) << exponent;
+    }
+
+    /**
+     * @brief Returns the largest value that falls into bucket `index`.
+     */
+    static constexpr uint64_t upperBound(size_t index) noexcept {
+        return lowerBound(index) + ((uint64_t{1} << exponentOf(index)) - 1);
+    }
+};
+
+/**
+ * @brief A merged, immutable view of histogram counts, answering percentile queries.
+ * Results are bucket bounds, accurate to the bucket width (under 1.6% of the value).
+ */
+class HistogramSnapshot {
+private:
+    DArray<uint64_t> _counts;
+    uint64_t _total = 0;
+
+public:
+    HistogramSnapshot()
+        : _counts(HistogramBuckets::count) {}
+
+    /**
+     * @brief Adds `n` occurrences of `value`.
+     */
+    void add(uint64_t value, uint64_t n = 1) noexcept {
+        _counts[HistogramBuckets::indexOf(value)] += n;
+        _total += n;
+    }
+
+    /**
+     * @brief Adds the counts of `other`.
+     */
+    void merge(const HistogramSnapshot& other) noexcept {
+        for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+            _counts[i] += other._counts[i];
+        }
+        _total += other._total;
+    }
+
+    /**
+     * @brief Returns the counts recorded since `earlier`, a snapshot of the same histogram.
+     */
+    HistogramSnapshot since(const HistogramSnapshot& earlier) const {
+        HistogramSnapshot interval;
+        for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+            interval._counts[i] = _counts[i] - earlier._counts[i];
+        }
+        interval._total = _total - earlier._total;
+        return interval;
+    }
+
+    uint64_t count() const noexcept {
+        return _total;
+    }
+
+    std::span<const uint64_t> counts() const noexcept {
+        return _counts;
+    }
+
+    /**
+     * @brief Returns the value below or at which `percentile` percent of the values lie, as the
+     * upper bound of its bucket. Returns 0 for an empty histogram.
+     * @param percentile A percentage in [0, 100].
+     */
+    uint64_t percentile(double percentile) const noexcept {
+        if (_total == 0) {
+            return 0;
+        }
+        double clamped = percentile < 0 ? 0 : percentile > 100 ? 100 : percentile;
+        auto rank = static_cast<uint64_t>(clamped / 100 * static_cast<double>(_total) + 0.5);
+        rank = rank == 0 ? 1 : rank > _total ? _total : rank;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+            seen += _counts[i];
+            if (seen >= rank) {
+                return HistogramBuckets::upperBound(i);
+            }
+        }
+        return max();
+    }
+
+    /**
+     * @brief Returns the lower bound of the lowest non-empty bucket, or 0 if empty.
+     */
+    uint64_t min() const noexcept {
+        for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+            if (_counts[i] != 0) {
+                return HistogramBuckets::lowerBound(i);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Returns the upper bound of the highest non-empty bucket, or 0 if empty.
+     */
+    uint64_t max() const noexcept {
+        for (size_t i = HistogramBuckets::count; i-- > 0;) {
+            if (_counts[i] != 0) {
+                return HistogramBuckets::upperBound(i);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Returns the mean, taking every value as the middle of its bucket.
+     */
+    double mean() const noexcept {
+        if (_total == 0) {
+            return 0;
+        }
+        double sum = 0;
+        for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+            if (_counts[i] != 0) {
+                double middle = (static_cast<double>(HistogramBuckets::lowerBound(i)) + static_cast<double>(HistogramBuckets::upperBound(i))) / 2;
+                sum += middle * static_cast<double>(_counts[i]);
+            }
+        }
+        return sum / static_cast<double>(_total);
+    }
+
+    /**
+     * @brief Appends a compact encoding: the layout's `subBucketBits`, the number of non-empty
+     * buckets, then for each of them the distance from the previous one and its count (all LEB128).
+     * Latency distributions occupy a few hundred buckets, so a snapshot takes well under 1 KiB.
+     */
+    void serialize(DArray<std::byte>& out) const {
+        size_t nonEmpty = 0;
+        for (uint64_t n : _counts) {
+            nonEmpty += n != 0;
+        }
+        writeVarint(HistogramBuckets::subBucketBits, out);
+        writeVarint(nonEmpty, out);
+        size_t previous = 0;
+        for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+            if (_counts[i] != 0) {
+                writeVarint(i - previous, out);
+                writeVarint(_counts[i], out);
+                previous = i;
+            }
+        }
+    }
+
+    /**
+     * @brief Consumes a snapshot written by `serialize` from `reader`.
+     * @throws std::out_of_range If the input is truncated.
+     * @throws std::invalid_argument If the input does not describe a snapshot of this layout.
+     */
+    static HistogramSnapshot deserialize(ByteReader& reader) {
+        if (reader.readVarint() != HistogramBuckets::subBucketBits) {
+            throw std::invalid_argument("Histogram has a different bucket layout");
+        }
+        uint64_t nonEmpty = reader.readVarint();
+        if (nonEmpty > HistogramBuckets::count) {
+            throw std::invalid_argument("Histogram has too many buckets");
+        }
+        HistogramSnapshot snapshot;
+        uint64_t index = 0;
+        for (uint64_t i = 0; i < nonEmpty; ++i) {
+            index += reader.readVarint();
+            if (index >= HistogramBuckets::count) {
+                throw std::invalid_argument("Histogram bucket out of range");
+            }
+            uint64_t n = reader.readVarint();
+            snapshot._counts[index] += n;
+            snapshot._total += n;
+        }
+        return snapshot;
+    }
+
+    static HistogramSnapshot deserialize(std::span<const std::byte> input) {
+        ByteReader reader(input);
+        return deserialize(reader);
+    }
+};
+
+/**
+ * @brief A latency histogram that any number of threads can record into without locks.
+ * Each recording thread gets a shard of its own on first use: a `DArray<uint64_t>` of buckets that
+ * only it writes, so recording is a plain load, add and store (through `std::atomic_ref`, relaxed)
+ * with no read-modify-write and no shared cache lines. Readers merge the shards.
+ */
+class LatencyHistogram {
+private:
+    struct alignas(cacheLineSize) Shard {
+        DArray<uint64_t> counts;
+        std::thread::id owner;
+        Shard* next = nullptr;
+
+        explicit Shard(std::thread::id owner)
+            : counts(HistogramBuckets::count)
+            , owner(owner) {}
+    };
+
+    struct ShardCache {
+        uint64_t histogramId = 0;
+        Shard* shard = nullptr;
+    };
+
+    static inline std::atomic<uint64_t> nextId = 1;
+
+    std::atomic<Shard*> _shards = nullptr;
+    const uint64_t _id = nextId.fetch_add(1, std::memory_order_relaxed);
+    std::atomic<uint64_t> _dropped = 0;
+    std::mutex _intervalMutex;
+    HistogramSnapshot _intervalStart;
+
+public:
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Destructor. No thread may be recording.
+     */
+    ~LatencyHistogram() noexcept {
+        Shard* shard = _shards.load(std::memory_order_acquire);
+        while (shard != nullptr) {
+            delete std::exchange(shard, shard->next);
+        }
+    }
+
+    /**
+     * @brief Records one occurrence of `value`.
+     * Never throws: if the shard of a new thread cannot be allocated, the value is counted in
+     * `dropped()` instead.
+     */
+    void record(uint64_t value) noexcept {
+        ShardCache& cache = shardCache();
+        Shard* shard = cache.histogramId == _id ? cache.shard : attachThread(cache);
+        if (shard == nullptr) [[unlikely]] {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // The owner is the only writer, so a relaxed load and store replace an atomic increment.
+        std::atomic_ref<uint64_t> bucket(shard->counts[HistogramBuckets::indexOf(value)]);
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the merged counts of all threads since construction.
+     * Values recorded concurrently may or may not be included.
+     */
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot merged;
+        for (Shard* shard = _shards.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+            for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+                uint64_t n = std::atomic_ref<uint64_t>(shard->counts[i]).load(std::memory_order_relaxed);
+                if (n != 0) {
+                    merged.add(HistogramBuckets::lowerBound(i), n);
+                }
+            }
+        }
+        return merged;
+    }
+
+    /**
+     * @brief Returns the counts recorded since the previous call (or since construction), for
+     * periodic reporting. Calls are serialized; recording is never blocked.
+     */
+    HistogramSnapshot intervalSnapshot() {
+        std::lock_guard lock(_intervalMutex);
+        // Taken under the lock so that interval starts only move forward.
+        HistogramSnapshot current = snapshot();
+        HistogramSnapshot interval = current.since(_intervalStart);
+        _intervalStart = std::move(current);
+        return interval;
+    }
+
+    /**
+     * @brief Returns the number of values that could not be recorded.
+     */
+    uint64_t dropped() const noexcept {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static ShardCache& shardCache() noexcept {
+        // One entry per thread: a thread that alternates between histograms looks its shard up again.
+        static thread_local ShardCache cache;
+        return cache;
+    }
+
+    [[gnu::noinline]] Shard* attachThread(ShardCache& cache) noexcept {
+        std::thread::id self = std::this_thread::get_id();
+        Shard* shard = _shards.load(std::memory_order_acquire);
+        while (shard != nullptr && shard->owner != self) {
+            shard = shard->next;
+        }
+        if (shard == nullptr) {
+            try {
+                shard = new Shard(self);
+            } catch (const std::bad_alloc&) {
+                return nullptr;
+            }
+            shard->next = _shards.load(std::memory_order_relaxed);
+            while (!_shards.compare_exchange_weak(shard->next, shard, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        cache = {_id, shard};
+        return shard;
+    }
+};
+
+/**
+ * @brief A low-overhead timestamp counter: `rdtsc` on x86-64, the virtual counter (`cntvct_el0`)
+ * on arm64, `std::chrono::steady_clock` elsewhere.
+ * Reads are not serializing, so they measure operations of more than a few dozen cycles; the x86
+ * counter is assumed invariant (constant rate across frequency changes), as on every CPU since ~2008.
+ */
+struct CycleClock {
+    static uint64_t now() noexcept {
+#if defined(__x86_64__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Returns the length of a tick, measured once on first use.
+     * On x86 the counter is timed against `steady_clock` for about 10 ms; on arm64 its frequency
+     * is read from `cntfrq_el0`.
+     */
+    static double nanosecondsPerTick() noexcept {
+        static const double calibrated = calibrate();
+        return calibrated;
+    }
+
+    /**
+     * @brief Converts a tick count to nanoseconds with a 32.32 fixed-point multiply.
+     */
+    static uint64_t toNanoseconds(uint64_t ticks) noexcept {
+        static const auto factor = static_cast<uint64_t>(nanosecondsPerTick() * 4294967296.0);
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * factor) >> 32);
+    }
+
+private:
+    static double calibrate() noexcept {
+#if defined(__x86_64__)
+        using std::chrono::steady_clock;
+        steady_clock::time_point start = steady_clock::now();
+        uint64_t startTicks = now();
+        steady_clock::time_point end;
+        do {
+            end = steady_clock::now();
+        } while (end - start < std::chrono::milliseconds(10));
+        uint64_t ticks = now() - startTicks;
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / static_cast<double>(ticks);
+#elif defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return 1e9 / static_cast<double>(frequency);
+#else
+        return 1.0;
+#endif
+    }
+};
+
+/**
+ * @brief Records the nanoseconds between its construction and destruction into a histogram.
+ * Usage: `{ ScopedTimer timer(pushLatency); array.push(x); }`.
+ */
+class ScopedTimer {
+private:
+    LatencyHistogram& _histogram;
+    uint64_t _start;
+
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram) noexcept
+        : _histogram(histogram)
+        , _start(CycleClock::now()) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() noexcept {
+        _histogram.record(CycleClock::toNanoseconds(CycleClock::now() - _start));
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,81 @@
+#include "dynamic_array.hpp"
+#include "latency_histogram.hpp"
+#include "size_class_pool.hpp"
+#include "unique_pointer.hpp"
+#include <chrono>
+#include <print>
+#include <thread>
+
+namespace {
+
+struct Order {
+    int64_t id;
+    double price;
+    int64_t quantity;
+};
+
+constexpr int operations = 1'000'000;
+
+void report(const char* name, const HistogramSnapshot& snapshot) {
+    std::println("{:>12} {:>10} {:>8} {:>8} {:>8} {:>10}", name, snapshot.count(), snapshot.percentile(50),
+                 snapshot.percentile(99), snapshot.percentile(99.9), snapshot.max());
+}
+
+} // namespace
+
+int main() {
+    std::println("{:>12} {:>10} {:>8} {:>8} {:>8} {:>10}", "ns", "count", "p50", "p99", "p99.9", "max");
+
+    // A tight loop of `record` calls shows the cost of recording itself.
+    LatencyHistogram overhead;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < operations; ++i) {
+        overhead.record(static_cast<uint64_t>(i) & 1023);
+    }
+    std::chrono::duration<double, std::nano> recordTime = std::chrono::steady_clock::now() - start;
+
+    // Pushes are cheap, except the ones that reallocate.
+    LatencyHistogram push;
+    DArray<int64_t> array;
+    for (int i = 0; i < operations; ++i) {
+        ScopedTimer timer(push);
+        array.push(i);
+    }
+    report("push", push.snapshot());
+
+    LatencyHistogram heap;
+    for (int i = 0; i < operations; ++i) {
+        ScopedTimer timer(heap);
+        UniquePointer<Order> order = makeUnique<Order>(Order{i, 1.5, 10});
+    }
+    report("makeUnique", heap.snapshot());
+
+    SizeClassPool<TypeList<Order>> pool;
+    LatencyHistogram pooled;
+    for (int i = 0; i < operations; ++i) {
+        ScopedTimer timer(pooled);
+        PoolPointer<Order, decltype(pool)> order = makePooled<Order>(pool, Order{i, 1.5, 10});
+    }
+    report("makePooled", pooled.snapshot());
+
+    // Four threads record into one histogram, each into its own shard.
+    LatencyHistogram shared;
+    DArray<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push(std::thread([&shared] {
+            for (int i = 0; i < operations; ++i) {
+                ScopedTimer timer(shared);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    HistogramSnapshot sharedSnapshot = shared.intervalSnapshot();
+    report("empty scope", sharedSnapshot);
+
+    DArray<std::byte> encoded;
+    sharedSnapshot.serialize(encoded);
+    std::println("record: {:.1f} ns, tick: {:.3f} ns, serialized snapshot: {} bytes", recordTime.count() / operations,
+                 CycleClock::nanosecondsPerTick(), encoded.size());
+}
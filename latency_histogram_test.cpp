@@ -0,0 +1,172 @@
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Test that every value falls between the bounds of its bucket and that buckets stay narrow
+TEST(LatencyHistogramTest, BucketBounds) {
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = random() >> (random() % 64);
+        size_t index = HistogramBuckets::indexOf(value);
+        ASSERT_LT(index, HistogramBuckets::count);
+        EXPECT_LE(HistogramBuckets::lowerBound(index), value);
+        EXPECT_GE(HistogramBuckets::upperBound(index), value);
+        uint64_t width = HistogramBuckets::upperBound(index) - HistogramBuckets::lowerBound(index);
+        EXPECT_LE(width, value / 64);
+    }
+    for (uint64_t value = 0; value < 128; ++value) {
+        EXPECT_EQ(HistogramBuckets::indexOf(value), value);
+    }
+    EXPECT_EQ(HistogramBuckets::indexOf(UINT64_MAX), HistogramBuckets::count - 1);
+    EXPECT_EQ(HistogramBuckets::upperBound(HistogramBuckets::count - 1), UINT64_MAX);
+    for (size_t i = 1; i < HistogramBuckets::count; ++i) {
+        ASSERT_EQ(HistogramBuckets::lowerBound(i), HistogramBuckets::upperBound(i - 1) + 1);
+    }
+}
+
+// Test percentiles, extremes and mean of a uniform distribution
+TEST(LatencyHistogramTest, Percentiles) {
+    HistogramSnapshot snapshot;
+    EXPECT_EQ(snapshot.percentile(50), 0);
+    EXPECT_EQ(snapshot.max(), 0);
+    for (uint64_t value = 1; value <= 10000; ++value) {
+        snapshot.add(value);
+    }
+    EXPECT_EQ(snapshot.count(), 10000);
+    EXPECT_EQ(snapshot.min(), 1);
+    EXPECT_NEAR(static_cast<double>(snapshot.max()), 10000, 10000 / 64.0);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(50)), 5000, 5000 / 64.0);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(99)), 9900, 9900 / 64.0);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(99.9)), 9990, 9990 / 64.0);
+    EXPECT_EQ(snapshot.percentile(0), 1);
+    EXPECT_EQ(snapshot.percentile(100), snapshot.max());
+    EXPECT_NEAR(snapshot.mean(), 5000.5, 5000 / 64.0);
+}
+
+// Test that values recorded by many threads are all merged into the snapshot
+TEST(LatencyHistogramTest, ThreadShards) {
+    constexpr int threadCount = 4;
+    constexpr uint64_t perThread = 50000;
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (uint64_t i = 0; i < perThread; ++i) {
+                histogram.record(100 * (t + 1));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    HistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), threadCount * perThread);
+    for (int t = 0; t < threadCount; ++t) {
+        EXPECT_EQ(snapshot.counts()[HistogramBuckets::indexOf(100 * (t + 1))], perThread);
+    }
+    EXPECT_EQ(histogram.dropped(), 0);
+}
+
+// Test that a thread keeps separate shards for histograms it alternates between
+TEST(LatencyHistogramTest, AlternatingHistograms) {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    for (int i = 0; i < 10; ++i) {
+        first.record(1);
+        second.record(2);
+    }
+    EXPECT_EQ(first.snapshot().count(), 10);
+    EXPECT_EQ(first.snapshot().counts()[1], 10);
+    EXPECT_EQ(second.snapshot().count(), 10);
+    EXPECT_EQ(second.snapshot().counts()[2], 10);
+}
+
+// Test that interval snapshots cover only the values recorded since the previous one
+TEST(LatencyHistogramTest, IntervalSnapshot) {
+    LatencyHistogram histogram;
+    histogram.record(10);
+    histogram.record(20);
+    HistogramSnapshot first = histogram.intervalSnapshot();
+    EXPECT_EQ(first.count(), 2);
+    histogram.record(1000);
+    HistogramSnapshot second = histogram.intervalSnapshot();
+    EXPECT_EQ(second.count(), 1);
+    EXPECT_EQ(second.min(), HistogramBuckets::lowerBound(HistogramBuckets::indexOf(1000)));
+    EXPECT_EQ(histogram.intervalSnapshot().count(), 0);
+    EXPECT_EQ(histogram.snapshot().count(), 3);
+}
+
+// Test that concurrent interval snapshots split the recorded values without overlap
+TEST(LatencyHistogramTest, ConcurrentIntervalSnapshots) {
+    constexpr uint64_t recorded = 1000000;
+    LatencyHistogram histogram;
+    std::atomic<bool> recording = true;
+    std::thread recorder([&histogram, &recording] {
+        for (uint64_t i = 0; i < recorded; ++i) {
+            histogram.record(i % 1000);
+        }
+        recording = false;
+    });
+    uint64_t counts[2] = {};
+    std::vector<std::thread> reporters;
+    for (uint64_t& count : counts) {
+        reporters.emplace_back([&histogram, &recording, &count] {
+            while (recording) {
+                count += histogram.intervalSnapshot().count();
+            }
+        });
+    }
+    recorder.join();
+    for (std::thread& reporter : reporters) {
+        reporter.join();
+    }
+    EXPECT_EQ(counts[0] + counts[1] + histogram.intervalSnapshot().count(), recorded);
+}
+
+// Test that a snapshot survives serialization and that malformed input is rejected
+TEST(LatencyHistogramTest, Serialization) {
+    HistogramSnapshot snapshot;
+    std::mt19937_64 random(3);
+    std::lognormal_distribution<double> latency(8, 1);
+    for (int i = 0; i < 100000; ++i) {
+        snapshot.add(static_cast<uint64_t>(latency(random)));
+    }
+    snapshot.add(UINT64_MAX);
+    DArray<std::byte> encoded;
+    snapshot.serialize(encoded);
+    EXPECT_LT(encoded.size(), 2048);
+    HistogramSnapshot decoded = HistogramSnapshot::deserialize(encoded);
+    EXPECT_EQ(decoded.count(), snapshot.count());
+    for (size_t i = 0; i < HistogramBuckets::count; ++i) {
+        ASSERT_EQ(decoded.counts()[i], snapshot.counts()[i]);
+    }
+
+    EXPECT_THROW(HistogramSnapshot::deserialize(std::span(encoded.data(), encoded.size() - 1)), std::out_of_range);
+    DArray<std::byte> wrongLayout;
+    writeVarint(HistogramBuckets::subBucketBits + 1, wrongLayout);
+    writeVarint(0, wrongLayout);
+    EXPECT_THROW(HistogramSnapshot::deserialize(wrongLayout), std::invalid_argument);
+    DArray<std::byte> outOfRange;
+    writeVarint(HistogramBuckets::subBucketBits, outOfRange);
+    writeVarint(1, outOfRange);
+    writeVarint(HistogramBuckets::count, outOfRange);
+    writeVarint(1, outOfRange);
+    EXPECT_THROW(HistogramSnapshot::deserialize(outOfRange), std::invalid_argument);
+}
+
+// Test that a scoped timer records the duration of its scope in nanoseconds
+TEST(LatencyHistogramTest, ScopedTimer) {
+    LatencyHistogram histogram;
+    {
+        ScopedTimer timer(histogram);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    HistogramSnapshot snapshot = histogram.snapshot();
+    ASSERT_EQ(snapshot.count(), 1);
+    EXPECT_GE(snapshot.max(), 19'000'000);
+    EXPECT_LT(snapshot.min(), 200'000'000);
+}
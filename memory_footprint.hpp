@@ -0,0 +1,217 @@
+#ifndef MEMORY_FOOTPRINT_HPP
+#define MEMORY_FOOTPRINT_HPP
+
+#include "dynamic_array.hpp"
+#include "sparse_set.hpp"
+#include "stable_array.hpp"
+#include "type_list.hpp"
+#include "unique_pointer.hpp"
+#include "worker_threads.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Memory accounting for nested containers, kept out of the container headers so that code that
+// does not ask for it does not pay for parsing <thread>.
+
+/**
+ * @brief Bytes held by a value: `used` by live objects and `allocated` in total, so that
+ * `slack()` is reserved capacity that holds nothing yet.
+ */
+struct MemoryFootprint {
+    size_t used = 0;
+    size_t allocated = 0;
+
+    size_t slack() const noexcept {
+        return allocated - used;
+    }
+
+    MemoryFootprint& operator+=(const MemoryFootprint& other) noexcept {
+        used += other.used;
+        allocated += other.allocated;
+        return *this;
+    }
+
+    friend MemoryFootprint operator+(MemoryFootprint left, const MemoryFootprint& right) noexcept {
+        return left += right;
+    }
+
+    friend bool operator==(const MemoryFootprint&, const MemoryFootprint&) = default;
+};
+
+/**
+ * @brief The customization point: specialize it with a
+ * `static MemoryFootprint heap(const T& value)` that returns the bytes `value` owns outside of
+ * itself, including what its elements own (call `heapFootprint` on them).
+ */
+template <typename T>
+struct FootprintTraits;
+
+/**
+ * @brief The default for aggregates: specialize it with `using type = TypeList<...>` of
+ * `FootprintField` descriptors (or any descriptors with a static `member`, such as the codec's
+ * `Field`), and the heap footprint of the record is the sum over those members.
+ */
+template <typename T>
+struct FootprintFields;
+
+/**
+ * @brief Describes the data member `Member` of a record. Usage: `FootprintField<&Tenant::name>`.
+ */
+template <auto Member>
+struct FootprintField {
+    static constexpr auto member = Member;
+};
+
+/**
+ * @brief Whether `T` may own memory outside of itself, i.e. whether its elements must be visited.
+ */
+template <typename T>
+inline constexpr bool ownsHeapMemory = requires { FootprintTraits<T>::heap(std::declval<const T&>()); } ||
+                                       requires { typename FootprintFields<T>::type; } ||
+                                       !std::is_trivially_copyable_v<T>;
+
+template <typename T>
+MemoryFootprint heapFootprint(const T& value);
+
+template <typename T, typename... FieldTs>
+MemoryFootprint fieldsFootprint(const T& value, TypeList<FieldTs...>) {
+    MemoryFootprint footprint;
+    ((footprint += heapFootprint(value.*FieldTs::member)), ...);
+    return footprint;
+}
+
+// Set on the threads of a parallel sum, so that the sums of nested containers stay sequential.
+inline bool& insideParallelFootprint() noexcept {
+    static thread_local bool inside = false;
+    return inside;
+}
+
+/**
+ * @brief Returns the bytes `value` owns outside of itself, recursively.
+ * Trivially copyable types own nothing; other types need a `FootprintTraits` or
+ * `FootprintFields` specialization, so that no owner is silently counted as empty.
+ */
+template <typename T>
+MemoryFootprint heapFootprint(const T& value) {
+    if constexpr (requires { FootprintTraits<T>::heap(value); }) {
+        return FootprintTraits<T>::heap(value);
+    } else if constexpr (requires { typename FootprintFields<T>::type; }) {
+        return fieldsFootprint(value, typename FootprintFields<T>::type{});
+    } else {
+        static_assert(std::is_trivially_copyable_v<T>, "Specialize FootprintTraits or FootprintFields for this type");
+        return {};
+    }
+}
+
+/**
+ * @brief Returns the bytes held by `value`: its own `sizeof` plus everything it owns.
+ * @throws std::bad_alloc If memory allocation for a parallel sum fails.
+ */
+template <typename T>
+MemoryFootprint memoryFootprint(const T& value) {
+    return MemoryFootprint{sizeof(T), sizeof(T)} + heapFootprint(value);
+}
+
+/**
+ * @brief Elements per thread from which `sumFootprints` splits the work across threads.
+ */
+inline constexpr size_t parallelFootprintThreshold = 32 * 1024;
+
+/**
+ * @brief Returns the sum of `footprintAt(i)` for i in [0, count).
+ * Counts of at least twice `parallelFootprintThreshold` are split across up to
+ * `std::thread::hardware_concurrency()` threads. Sums started from such a thread stay on it, so
+ * nested containers do not multiply threads. See `runWorkers` for threads that cannot be started
+ * and for exceptions.
+ * @throws std::bad_alloc If memory allocation fails.
+ */
+template <typename FootprintAtT>
+MemoryFootprint sumFootprints(size_t count, const FootprintAtT& footprintAt) {
+    auto sumRange = [&](size_t first, size_t last) {
+        MemoryFootprint sum;
+        for (size_t i = first; i < last; ++i) {
+            sum += footprintAt(i);
+        }
+        return sum;
+    };
+    bool& inside = insideParallelFootprint();
+    size_t workers = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), count / parallelFootprintThreshold);
+    if (inside || workers < 2) {
+        return sumRange(0, count);
+    }
+    auto rangeEnd = [&](size_t worker) {
+        return worker + 1 == workers ? count : (worker + 1) * (count / workers);
+    };
+    DArray<MemoryFootprint> partial(workers);
+    inside = true;
+    // Never completed: the flag is cleared however the sum ends.
+    auto leave = makeExceptionGuard([&inside]() noexcept { inside = false; });
+    runWorkers(workers, [&](size_t worker) {
+        insideParallelFootprint() = true;
+        partial[worker] = sumRange(worker * (count / workers), rangeEnd(worker));
+    });
+    MemoryFootprint sum;
+    for (const MemoryFootprint& footprint : partial) {
+        sum += footprint;
+    }
+    return sum;
+}
+
+template <typename ElementT, Allocator AllocatorT>
+struct FootprintTraits<DArray<ElementT, AllocatorT>> {
+    static MemoryFootprint heap(const DArray<ElementT, AllocatorT>& array) {
+        MemoryFootprint footprint{array.size() * sizeof(ElementT), array.capacity() * sizeof(ElementT)};
+        if constexpr (ownsHeapMemory<ElementT>) {
+            const ElementT* elements = array.data();
+            footprint += sumFootprints(array.size(), [elements](size_t i) { return heapFootprint(elements[i]); });
+        }
+        return footprint;
+    }
+};
+
+// Counts the pointee as the static type; a derived object behind a base pointer is undercounted.
+template <typename ValueT, typename DeleterT>
+struct FootprintTraits<UniquePointer<ValueT, DeleterT>> {
+    static MemoryFootprint heap(const UniquePointer<ValueT, DeleterT>& pointer) {
+        if (pointer.get() == nullptr) {
+            return {};
+        }
+        return memoryFootprint(*pointer);
+    }
+};
+
+template <typename ElementT, Allocator AllocatorT>
+struct FootprintTraits<StableArray<ElementT, AllocatorT>> {
+    static MemoryFootprint heap(const StableArray<ElementT, AllocatorT>& array) {
+        MemoryFootprint footprint{array.size() * sizeof(ElementT), array.capacity() * sizeof(ElementT)};
+        footprint += heapFootprint(array._index) + heapFootprint(array._chunks) + heapFootprint(array._free);
+        if constexpr (ownsHeapMemory<ElementT>) {
+            footprint += sumFootprints(array.size(), [&array](size_t i) { return heapFootprint(array[i]); });
+        }
+        return footprint;
+    }
+};
+
+template <std::unsigned_integral KeyT, Allocator AllocatorT>
+struct FootprintTraits<SparseSet<KeyT, AllocatorT>> {
+    static MemoryFootprint heap(const SparseSet<KeyT, AllocatorT>& set) {
+        return heapFootprint(set._dense) + heapFootprint(set._sparse);
+    }
+};
+
+// Short strings live inside the object; longer ones own a buffer with room for the terminator.
+template <typename CharT, typename TraitsT, typename AllocatorT>
+struct FootprintTraits<std::basic_string<CharT, TraitsT, AllocatorT>> {
+    static MemoryFootprint heap(const std::basic_string<CharT, TraitsT, AllocatorT>& string) {
+        auto object = reinterpret_cast<const std::byte*>(&string);
+        if (isPointerInRange(object, object + sizeof(string), string.data())) {
+            return {};
+        }
+        return {(string.size() + 1) * sizeof(CharT), (string.capacity() + 1) * sizeof(CharT)};
+    }
+};
+
+#endif // MEMORY_FOOTPRINT_HPP
@@ -0,0 +1,46 @@
+#include "memory_footprint.hpp"
+#include <print>
+#include <string>
+
+namespace {
+
+struct Order {
+    int64_t id;
+    double price;
+    int64_t quantity;
+};
+
+struct Tenant {
+    std::string name;
+    DArray<DArray<UniquePointer<Order>>> books;
+};
+
+} // namespace
+
+template <>
+struct FootprintFields<Tenant> {
+    using type = TypeList<FootprintField<&Tenant::name>, FootprintField<&Tenant::books>>;
+};
+
+int main() {
+    DArray<Tenant> tenants;
+    for (int t = 0; t < 3; ++t) {
+        Tenant tenant{"tenant-with-a-long-name-" + std::to_string(t), {}};
+        for (int book = 0; book < 10 * (t + 1); ++book) {
+            DArray<UniquePointer<Order>> orders;
+            for (int i = 0; i < 100 * (t + 1); ++i) {
+                orders.push(makeUnique<Order>(Order{i, 1.5, 10}));
+            }
+            tenant.books.push(std::move(orders));
+        }
+        tenants.push(std::move(tenant));
+    }
+
+    std::println("{:>28} {:>10} {:>10} {:>10}", "tenant", "used", "allocated", "slack");
+    for (const Tenant& tenant : tenants) {
+        MemoryFootprint footprint = memoryFootprint(tenant);
+        std::println("{:>28} {:>10} {:>10} {:>10}", tenant.name, footprint.used, footprint.allocated, footprint.slack());
+    }
+    MemoryFootprint total = memoryFootprint(tenants);
+    std::println("{:>28} {:>10} {:>10} {:>10}", "all", total.used, total.allocated, total.slack());
+}
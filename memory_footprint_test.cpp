@@ -0,0 +1,152 @@
+#include "memory_footprint.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct Tenant {
+    std::string name;
+    DArray<int64_t> orders;
+    int32_t region;
+};
+
+struct Point {
+    double x;
+    double y;
+};
+
+} // namespace
+
+template <>
+struct FootprintFields<Tenant> {
+    using type = TypeList<FootprintField<&Tenant::name>, FootprintField<&Tenant::orders>>;
+};
+
+// Test that trivially copyable values hold just their own bytes
+TEST(MemoryFootprintTest, TriviallyCopyable) {
+    EXPECT_EQ(memoryFootprint(42), (MemoryFootprint{sizeof(int), sizeof(int)}));
+    EXPECT_EQ(memoryFootprint(Point{1, 2}), (MemoryFootprint{sizeof(Point), sizeof(Point)}));
+    EXPECT_EQ(heapFootprint(Point{1, 2}), MemoryFootprint{});
+}
+
+// Test that an array reports its live elements as used and its reserved capacity as slack
+TEST(MemoryFootprintTest, DArray) {
+    DArray<int32_t> array;
+    EXPECT_EQ(heapFootprint(array), MemoryFootprint{});
+    array.reserve(10);
+    array.push(1);
+    array.push(2);
+    MemoryFootprint footprint = heapFootprint(array);
+    EXPECT_EQ(footprint.used, 2 * sizeof(int32_t));
+    EXPECT_EQ(footprint.allocated, 10 * sizeof(int32_t));
+    EXPECT_EQ(footprint.slack(), 8 * sizeof(int32_t));
+    EXPECT_EQ(memoryFootprint(array), (footprint + MemoryFootprint{sizeof(array), sizeof(array)}));
+}
+
+// Test that nested arrays and owning pointers are visited recursively
+TEST(MemoryFootprintTest, Nested) {
+    DArray<DArray<UniquePointer<Point>>> nested;
+    nested.reserve(4);
+    nested.push(DArray<UniquePointer<Point>>());
+    nested.push(DArray<UniquePointer<Point>>());
+    nested[0].reserve(3);
+    nested[0].push(makeUnique<Point>(1.0, 2.0));
+    nested[0].push(nullptr);
+    nested[1].reserve(1);
+    nested[1].push(makeUnique<Point>(3.0, 4.0));
+
+    constexpr size_t inner = sizeof(DArray<UniquePointer<Point>>);
+    constexpr size_t pointer = sizeof(UniquePointer<Point>);
+    MemoryFootprint footprint = heapFootprint(nested);
+    EXPECT_EQ(footprint.used, 2 * inner + 3 * pointer + 2 * sizeof(Point));
+    EXPECT_EQ(footprint.allocated, 4 * inner + 4 * pointer + 2 * sizeof(Point));
+}
+
+// Test that short strings own nothing and long strings own their buffer and terminator
+TEST(MemoryFootprintTest, String) {
+    std::string shortString = "abc";
+    EXPECT_EQ(heapFootprint(shortString), MemoryFootprint{});
+    std::string longString(100, 'x');
+    longString.reserve(200);
+    MemoryFootprint footprint = heapFootprint(longString);
+    EXPECT_EQ(footprint.used, 101);
+    EXPECT_EQ(footprint.allocated, longString.capacity() + 1);
+}
+
+// Test that a record with a field list sums the footprints of the listed members
+TEST(MemoryFootprintTest, Fields) {
+    Tenant tenant{std::string(50, 'n'), DArray<int64_t>(), 7};
+    tenant.orders.reserve(8);
+    tenant.orders.push(1);
+    MemoryFootprint footprint = heapFootprint(tenant);
+    EXPECT_EQ(footprint, heapFootprint(tenant.name) + heapFootprint(tenant.orders));
+    EXPECT_EQ(footprint.used, 51 + sizeof(int64_t));
+
+    DArray<Tenant> tenants;
+    tenants.push(tenant);
+    EXPECT_EQ(heapFootprint(tenants).used, sizeof(Tenant) + footprint.used);
+}
+
+// Test the footprints of a stable array and a sparse set
+TEST(MemoryFootprintTest, OtherContainers) {
+    StableArray<DArray<int32_t>> stable(4);
+    stable.push(DArray<int32_t>(3));
+    MemoryFootprint stableFootprint = heapFootprint(stable);
+    EXPECT_EQ(stableFootprint.used, sizeof(DArray<int32_t>) + 2 * sizeof(DArray<int32_t>*) + 3 * sizeof(int32_t));
+    EXPECT_GE(stableFootprint.allocated, 4 * sizeof(DArray<int32_t>) + sizeof(DArray<int32_t>*) * 2 + 3 * sizeof(int32_t));
+
+    SparseSet<uint32_t> set(1000);
+    set.insert(5);
+    MemoryFootprint setFootprint = heapFootprint(set);
+    EXPECT_EQ(setFootprint.used, 1001 * sizeof(uint32_t));
+    EXPECT_GE(setFootprint.allocated, setFootprint.used);
+}
+
+// Test that a sum large enough to run in parallel matches the sequential result
+TEST(MemoryFootprintTest, LargeArray) {
+    constexpr size_t count = 4 * parallelFootprintThreshold + 123;
+    DArray<DArray<int32_t>> arrays;
+    arrays.reserve(count);
+    size_t expectedUsed = count * sizeof(DArray<int32_t>);
+    for (size_t i = 0; i < count; ++i) {
+        arrays.push(DArray<int32_t>(i % 5));
+        expectedUsed += (i % 5) * sizeof(int32_t);
+    }
+    MemoryFootprint footprint = heapFootprint(arrays);
+    EXPECT_EQ(footprint.used, expectedUsed);
+    EXPECT_GE(footprint.allocated, expectedUsed);
+    EXPECT_FALSE(insideParallelFootprint());
+}
+
+namespace {
+
+struct Unmeasurable {
+    bool fails = false;
+};
+
+} // namespace
+
+template <>
+struct FootprintTraits<Unmeasurable> {
+    static MemoryFootprint heap(const Unmeasurable& value) {
+        if (value.fails) {
+            throw std::runtime_error("unmeasurable");
+        }
+        return {};
+    }
+};
+
+// Test that an exception from a footprint propagates from a parallel sum and leaves it reusable
+TEST(MemoryFootprintTest, ThrowingTraits) {
+    DArray<Unmeasurable> values(4 * parallelFootprintThreshold);
+    values[10].fails = true;
+    EXPECT_THROW(heapFootprint(values), std::runtime_error);
+    EXPECT_FALSE(insideParallelFootprint());
+    values[10].fails = false;
+    values.back().fails = true;
+    EXPECT_THROW(heapFootprint(values), std::runtime_error);
+    EXPECT_FALSE(insideParallelFootprint());
+    values.back().fails = false;
+    EXPECT_EQ(heapFootprint(values).used, values.size() * sizeof(Unmeasurable));
+}
@@ -0,0 +1,346 @@
+#ifndef MINIMAL_PERFECT_HASH_HPP
+#define MINIMAL_PERFECT_HASH_HPP
+
+#include "dynamic_array.hpp"
+#include "static_map.hpp"
+#include "worker_threads.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+static_assert(std::endian::native == std::endian::little, "The minimal perfect hash image supports little-endian targets only");
+
+/**
+ * @brief A minimal perfect hash function for a large set of keys fixed at construction, in the
+ * BBHash layout: it maps the n keys to distinct indices in [0, n) without storing the keys, in
+ * about `gamma * e^(1/gamma) * 8/7` bits per key: 3.1 with `gamma` 1, 3.8 with the default 2.
+ * Level 0 is a bitmap of `gamma * n` bits into which every key hashes; keys that hash to a bit of
+ * their own set it, and the rest move on to the next level, sized for them alone. A key's index is
+ * the number of set bits before its bit across all levels. Each 64-byte block stores that count for
+ * its start next to 448 bits, so each level a lookup visits costs one cache miss, and a key is found
+ * on level 0 with probability e^(-1/gamma): 61% with `gamma` 2, 37% with 1. Keys still colliding
+ * after the last level go to a sorted list.
+ * The tables form one array of words (`data()`, `wordCount()`) that `fromImage` uses in place, e.g.
+ * from a mapped file.
+ */
+class MinimalPerfectHash {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    // The most levels a function can have; keys still colliding after them go to the sorted list.
+    static constexpr size_t maxLevels = 32;
+
+private:
+    // A block: the number of set bits in all earlier blocks, then `blockBits` bits of a level.
+    // Blocks are 64-byte aligned in memory the hash owns, and in images mapped at page boundaries.
+    struct alignas(64) Block {
+        uint64_t words[8];
+    };
+
+    static constexpr size_t blockBits = 7 * 64;
+    static constexpr uint64_t imageMagic = 0x313030304648504d; // "MPHF0001"
+    static constexpr size_t headerWords = 8;
+    // Keys per thread from which construction splits the work across threads.
+    static constexpr size_t parallelThreshold = 64 * 1024;
+
+    // Image layout, in 64-bit words: the header, the first block of each level and the total block
+    // count (padded to a multiple of 8 words), the blocks, then the sorted fingerprints of the
+    // remaining keys (padded likewise).
+    enum HeaderField : size_t {
+        Magic,
+        KeyCount,
+        LevelCount,
+        BlockCount,
+        RemainingCount,
+        Seed,
+    };
+
+    DArray<Block> _storage;
+    std::span<const uint64_t> _image;
+
+public:
+    MinimalPerfectHash() = default;
+
+    /**
+     * @brief Builds the function for `keys`, on up to `std::thread::hardware_concurrency()` threads
+     * for large sets. `seed` selects the hash functions; if a 64-bit hash of two keys collides,
+     * another seed will separate them.
+     * @param gamma Bits of level 0 per key, at least 1: more memory, fewer levels per lookup.
+     * @param levelLimit Levels before the sorted list, at most `maxLevels`: fewer bound the misses of
+     * a lookup, at the cost of 64 bits and a binary search per key in the list.
+     * @throws std::invalid_argument If `gamma` is below 1, `levelLimit` is above `maxLevels`, or two
+     * keys are equal or have the same 64-bit hash under `seed`.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    template <StaticKey KeyT>
+    explicit MinimalPerfectHash(std::span<const KeyT> keys, double gamma = 2.0, uint64_t seed = 0, size_t levelLimit = maxLevels) {
+        if (!(gamma >= 1.0)) {
+            throw std::invalid_argument("gamma must be at least 1");
+        }
+        if (levelLimit > maxLevels) {
+            throw std::invalid_argument("Too many levels");
+        }
+        DArray<uint64_t> remaining;
+        remaining.resizeForOverwrite(keys.size());
+        forEachRange(keys.size(), workerCount(keys.size()), [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                remaining[i] = staticHash(keys[i], seed);
+            }
+        });
+        size_t count = keys.size();
+        DArray<DArray<uint64_t>> levels;
+        while (count > 0 && levels.size() < levelLimit) {
+            size_t level = levels.size();
+            auto blocks = std::max<size_t>(static_cast<size_t>(std::ceil(gamma * static_cast<double>(count) / blockBits)), 1);
+            levels.push(placeLevel(remaining, count, level, blocks * blockBits));
+        }
+        std::sort(remaining.begin(), remaining.begin() + count);
+        if (std::adjacent_find(remaining.begin(), remaining.begin() + count) != remaining.begin() + count) {
+            throw std::invalid_argument("Keys are not distinct under this seed");
+        }
+        assemble(keys.size(), seed, levels, std::span<const uint64_t>(remaining.data(), count));
+    }
+
+    MinimalPerfectHash(MinimalPerfectHash&& other) noexcept
+        : _storage(std::move(other._storage))
+        , _image(std::exchange(other._image, {})) {}
+
+    MinimalPerfectHash& operator=(MinimalPerfectHash&& other) noexcept {
+        _storage = std::move(other._storage);
+        _image = std::exchange(other._image, {});
+        return *this;
+    }
+
+    /**
+     * @brief Uses an image written from `data()` in place, without copying; it must outlive the
+     * result. The layout is checked, the bits and counts are trusted.
+     * @throws std::invalid_argument If the image is malformed.
+     */
+    static MinimalPerfectHash fromImage(std::span<const uint64_t> image) {
+        if (image.size() < headerWords || image[Magic] != imageMagic) {
+            throw std::invalid_argument("Not a minimal perfect hash image");
+        }
+        uint64_t levelCount = image[LevelCount];
+        uint64_t blockCount = image[BlockCount];
+        uint64_t remainingCount = image[RemainingCount];
+        if (levelCount > maxLevels || blockCount > image.size() / 8 || remainingCount > image.size() || remainingCount > image[KeyCount] ||
+            imageWords(levelCount, blockCount, remainingCount) != image.size()) {
+            throw std::invalid_argument("Truncated minimal perfect hash image");
+        }
+        const uint64_t* starts = image.data() + headerWords;
+        for (size_t level = 0; level < levelCount; ++level) {
+            if (starts[level] >= starts[level + 1] || (level == 0 && starts[0] != 0)) {
+                throw std::invalid_argument("Malformed minimal perfect hash levels");
+            }
+        }
+        if (starts[levelCount] != blockCount) {
+            throw std::invalid_argument("Malformed minimal perfect hash levels");
+        }
+        MinimalPerfectHash hash;
+        hash._image = image;
+        return hash;
+    }
+
+    size_t keyCount() const noexcept {
+        return header(KeyCount);
+    }
+
+    size_t levelCount() const noexcept {
+        return header(LevelCount);
+    }
+
+    /**
+     * @brief Returns the size of the tables in bits per key.
+     */
+    double bitsPerKey() const noexcept {
+        return keyCount() == 0 ? 0.0 : static_cast<double>(_image.size() * 64) / static_cast<double>(keyCount());
+    }
+
+    /**
+     * @brief Returns the image, `wordCount()` little-endian words to store and pass to `fromImage`.
+     */
+    const uint64_t* data() const noexcept {
+        return _image.data();
+    }
+
+    size_t wordCount() const noexcept {
+        return _image.size();
+    }
+
+    /**
+     * @brief Returns the index of `key` in [0, keyCount()). Keys outside the set give an arbitrary
+     * index or `npos`; store the keys alongside the values to tell them apart.
+     */
+    template <StaticKey KeyT>
+    size_t indexOf(const KeyT& key) const noexcept {
+        return indexOfHash(staticHash(key, header(Seed)));
+    }
+
+    /**
+     * @brief Writes the index of `keys[i]` to `indices[i]`. Blocks of level 0 are prefetched for a
+     * group of keys before any is looked up, so their cache misses overlap.
+     */
+    template <StaticKey KeyT>
+    void indicesOf(std::span<const KeyT> keys, std::span<size_t> indices) const noexcept {
+        constexpr size_t groupSize = 16;
+        uint64_t hashes[groupSize];
+        uint64_t seed = header(Seed);
+        for (size_t first = 0; first < keys.size(); first += groupSize) {
+            size_t size = std::min(groupSize, keys.size() - first);
+            for (size_t i = 0; i < size; ++i) {
+                hashes[i] = staticHash(keys[first + i], seed);
+                if (levelCount() > 0) {
+                    size_t bit;
+                    __builtin_prefetch(blockOf(hashes[i], 0, bit));
+                }
+            }
+            for (size_t i = 0; i < size; ++i) {
+                indices[first + i] = indexOfHash(hashes[i]);
+            }
+        }
+    }
+
+private:
+    uint64_t header(HeaderField field) const noexcept {
+        return _image.empty() ? 0 : _image[field];
+    }
+
+    static size_t roundToBlock(size_t words) noexcept {
+        return (words + 7) & ~size_t{7};
+    }
+
+    static size_t blocksOffset(size_t levelCount) noexcept {
+        return headerWords + roundToBlock(levelCount + 1);
+    }
+
+    static size_t imageWords(size_t levelCount, size_t blockCount, size_t remainingCount) noexcept {
+        return blocksOffset(levelCount) + 8 * blockCount + roundToBlock(remainingCount);
+    }
+
+    static uint64_t levelPosition(uint64_t hash, size_t level, uint64_t bitCount) noexcept {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(staticHash(hash, level + 1)) * bitCount) >> 64);
+    }
+
+    // Returns the block that holds the bit of `hash` on `level`, and the bit's position in it.
+    const uint64_t* blockOf(uint64_t hash, size_t level, size_t& bit) const noexcept {
+        const uint64_t* starts = _image.data() + headerWords;
+        uint64_t position = levelPosition(hash, level, (starts[level + 1] - starts[level]) * blockBits);
+        bit = position % blockBits;
+        return _image.data() + blocksOffset(levelCount()) + 8 * (starts[level] + position / blockBits);
+    }
+
+    size_t indexOfHash(uint64_t hash) const noexcept {
+        size_t levels = levelCount();
+        for (size_t level = 0; level < levels; ++level) {
+            size_t bit;
+            const uint64_t* block = blockOf(hash, level, bit);
+            uint64_t word = block[1 + bit / 64];
+            if ((word >> (bit % 64) & 1) != 0) {
+                uint64_t rank = block[0];
+                for (size_t i = 0; i < bit / 64; ++i) {
+                    rank += static_cast<uint64_t>(std::popcount(block[1 + i]));
+                }
+                return rank + static_cast<uint64_t>(std::popcount(word & ((uint64_t{1} << (bit % 64)) - 1)));
+            }
+        }
+        size_t remainingCount = header(RemainingCount);
+        const uint64_t* remaining = _image.data() + blocksOffset(levels) + 8 * header(BlockCount);
+        const uint64_t* found = std::lower_bound(remaining, remaining + remainingCount, hash);
+        if (found == remaining + remainingCount || *found != hash) {
+            return npos;
+        }
+        return keyCount() - remainingCount + static_cast<size_t>(found - remaining);
+    }
+
+    static size_t workerCount(size_t count) noexcept {
+        return std::clamp<size_t>(count / parallelThreshold, 1, std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    // Runs `function(worker, first, last)` on `workers` consecutive ranges of [0, count), one per
+    // worker of `runWorkers`.
+    template <typename FunctionT>
+    static void forEachRange(size_t count, size_t workers, const FunctionT& function) {
+        runWorkers(workers, [&](size_t worker) {
+            size_t first = worker * (count / workers);
+            function(worker, first, worker + 1 == workers ? count : first + count / workers);
+        });
+    }
+
+    // Builds the bits of `level` for the first `count` hashes of `remaining`, and moves the hashes
+    // that collided to the front, updating `count`.
+    static DArray<uint64_t> placeLevel(DArray<uint64_t>& remaining, size_t& count, size_t level, uint64_t bitCount) {
+        DArray<uint64_t> taken(bitCount / 64);
+        DArray<uint64_t> collided(bitCount / 64);
+        size_t workers = workerCount(count);
+        forEachRange(count, workers, [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                uint64_t position = levelPosition(remaining[i], level, bitCount);
+                uint64_t bit = uint64_t{1} << (position % 64);
+                if ((std::atomic_ref(taken[position / 64]).fetch_or(bit, std::memory_order_relaxed) & bit) != 0) {
+                    std::atomic_ref(collided[position / 64]).fetch_or(bit, std::memory_order_relaxed);
+                }
+            }
+        });
+        for (size_t i = 0; i < taken.size(); ++i) {
+            taken[i] &= ~collided[i];
+        }
+        DArray<size_t> kept(workers);
+        forEachRange(count, workers, [&](size_t worker, size_t first, size_t last) {
+            size_t out = first;
+            for (size_t i = first; i < last; ++i) {
+                uint64_t position = levelPosition(remaining[i], level, bitCount);
+                remaining[out] = remaining[i];
+                out += (taken[position / 64] >> (position % 64) & 1) == 0 ? 1 : 0;
+            }
+            kept[worker] = out - first;
+        });
+        size_t next = 0;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            uint64_t* first = remaining.begin() + worker * (count / workers);
+            next = static_cast<size_t>(std::copy(first, first + kept[worker], remaining.begin() + next) - remaining.begin());
+        }
+        count = next;
+        return taken;
+    }
+
+    void assemble(size_t keyCount, uint64_t seed, const DArray<DArray<uint64_t>>& levels, std::span<const uint64_t> remaining) {
+        size_t blockCount = 0;
+        for (const DArray<uint64_t>& level : levels) {
+            blockCount += level.size() / 7;
+        }
+        size_t words = imageWords(levels.size(), blockCount, remaining.size());
+        _storage = DArray<Block>(words / 8);
+        auto image = reinterpret_cast<uint64_t*>(_storage.data());
+        image[Magic] = imageMagic;
+        image[KeyCount] = keyCount;
+        image[LevelCount] = levels.size();
+        image[BlockCount] = blockCount;
+        image[RemainingCount] = remaining.size();
+        image[Seed] = seed;
+        uint64_t* starts = image + headerWords;
+        uint64_t* block = image + blocksOffset(levels.size());
+        uint64_t rank = 0;
+        for (const DArray<uint64_t>& level : levels) {
+            starts[1] = starts[0] + level.size() / 7;
+            ++starts;
+            for (size_t i = 0; i < level.size(); i += 7, block += 8) {
+                block[0] = rank;
+                std::copy(level.begin() + i, level.begin() + i + 7, block + 1);
+                for (size_t j = 1; j < 8; ++j) {
+                    rank += static_cast<uint64_t>(std::popcount(block[j]));
+                }
+            }
+        }
+        std::copy(remaining.begin(), remaining.end(), block);
+        _image = std::span<const uint64_t>(image, words);
+    }
+};
+
+#endif // MINIMAL_PERFECT_HASH_HPP
@@ -0,0 +1,55 @@
+#include "minimal_perfect_hash.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+
+// Construction and lookups for random 64-bit keys, at both ends of the space/levels trade-off.
+// With tens of millions of keys the tables outgrow the caches, so lookups in random order pay a
+// miss per level visited; batches overlap the level-0 misses. Pass the key count in millions
+// (default 10).
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = static_cast<size_t>(argc > 1 ? std::atoi(argv[1]) : 10) * 1'000'000;
+    std::mt19937_64 random(7);
+    DArray<uint64_t> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys.push(random());
+    }
+    DArray<uint64_t> probes;
+    for (size_t i = 0; i < 2'000'000; ++i) {
+        probes.push(keys[random() % count]);
+    }
+    DArray<size_t> indices(probes.size());
+
+    for (double gamma : {1.0, 2.0}) {
+        auto start = std::chrono::steady_clock::now();
+        MinimalPerfectHash hash(std::span<const uint64_t>(keys), gamma);
+        double build = secondsSince(start);
+        std::println("gamma {}: built {} keys in {:.2f} s, {:.2f} bits per key, {} levels", gamma, count, build, hash.bitsPerKey(), hash.levelCount());
+
+        size_t checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (uint64_t probe : probes) {
+            checksum += hash.indexOf(probe);
+        }
+        double single = secondsSince(start) * 1e9 / static_cast<double>(probes.size());
+
+        start = std::chrono::steady_clock::now();
+        hash.indicesOf(std::span<const uint64_t>(probes), std::span<size_t>(indices));
+        double batch = secondsSince(start) * 1e9 / static_cast<double>(probes.size());
+        for (size_t index : indices) {
+            checksum -= index;
+        }
+        std::println("  lookup {:.1f} ns, batched {:.1f} ns (checksum {})", single, batch, checksum);
+    }
+}
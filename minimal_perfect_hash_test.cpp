@@ -0,0 +1,125 @@
+#include "minimal_perfect_hash.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+std::vector<uint64_t> randomKeys(size_t count, uint32_t seed) {
+    std::mt19937_64 random(seed);
+    std::unordered_set<uint64_t> unique;
+    while (unique.size() < count) {
+        unique.insert(random());
+    }
+    return std::vector<uint64_t>(unique.begin(), unique.end());
+}
+
+// Checks that the indices of `keys` are exactly [0, keys.size()).
+template <typename KeyT>
+void expectPermutation(const MinimalPerfectHash& hash, const std::vector<KeyT>& keys) {
+    std::vector<bool> seen(keys.size());
+    for (const KeyT& key : keys) {
+        size_t index = hash.indexOf(key);
+        ASSERT_LT(index, keys.size());
+        ASSERT_FALSE(seen[index]) << "index " << index << " taken twice";
+        seen[index] = true;
+    }
+}
+
+} // namespace
+
+// Test that every key gets its own index, within the expected space, for both load factors
+TEST(MinimalPerfectHashTest, MapsKeysToDistinctIndices) {
+    std::vector<uint64_t> keys = randomKeys(200000, 1);
+    MinimalPerfectHash compact(std::span<const uint64_t>(keys), 1.0);
+    MinimalPerfectHash fast{std::span<const uint64_t>(keys)};
+    EXPECT_EQ(compact.keyCount(), keys.size());
+    expectPermutation(compact, keys);
+    expectPermutation(fast, keys);
+    EXPECT_LT(compact.bitsPerKey(), 3.3);
+    EXPECT_LT(fast.bitsPerKey(), 4.0);
+    EXPECT_LT(fast.levelCount(), compact.levelCount());
+
+    for (size_t count : {0, 1, 2, 100, 449}) {
+        std::vector<uint64_t> few = randomKeys(count, 2);
+        MinimalPerfectHash hash{std::span<const uint64_t>(few)};
+        EXPECT_EQ(hash.keyCount(), count);
+        expectPermutation(hash, few);
+    }
+    EXPECT_EQ(MinimalPerfectHash().indexOf(uint64_t{5}), MinimalPerfectHash::npos);
+}
+
+// Test string keys, and that keys that collide on every level land in the sorted list
+TEST(MinimalPerfectHashTest, StringKeysAndRemainingList) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 50000; ++i) {
+        names.push_back("tenant-" + std::to_string(i * 7919));
+    }
+    std::vector<std::string_view> keys(names.begin(), names.end());
+    MinimalPerfectHash hash{std::span<const std::string_view>(keys), 1.0, 42};
+    expectPermutation(hash, keys);
+
+    // One level places about a third of the keys; the sorted list takes the rest.
+    std::vector<uint64_t> many = randomKeys(5000, 3);
+    MinimalPerfectHash shallow{std::span<const uint64_t>(many), 1.0, 0, 1};
+    EXPECT_EQ(shallow.levelCount(), 1);
+    EXPECT_GT(shallow.bitsPerKey(), 32);
+    expectPermutation(shallow, many);
+    MinimalPerfectHash listOnly{std::span<const uint64_t>(many), 1.0, 0, 0};
+    expectPermutation(listOnly, many);
+    EXPECT_THROW(MinimalPerfectHash(std::span<const uint64_t>(many), 1.0, 0, MinimalPerfectHash::maxLevels + 1), std::invalid_argument);
+}
+
+// Test that batch lookups agree with single lookups
+TEST(MinimalPerfectHashTest, BatchLookups) {
+    std::vector<uint64_t> keys = randomKeys(10000, 4);
+    MinimalPerfectHash hash{std::span<const uint64_t>(keys)};
+    std::vector<size_t> indices(keys.size() - 3);
+    hash.indicesOf(std::span<const uint64_t>(keys.data(), indices.size()), std::span<size_t>(indices));
+    for (size_t i = 0; i < indices.size(); ++i) {
+        ASSERT_EQ(indices[i], hash.indexOf(keys[i]));
+    }
+}
+
+// Test that an image of the tables works in place, and that malformed images are rejected
+TEST(MinimalPerfectHashTest, Image) {
+    std::vector<uint64_t> keys = randomKeys(30000, 5);
+    MinimalPerfectHash hash(std::span<const uint64_t>(keys), 1.5, 9);
+    std::vector<uint64_t> image(hash.data(), hash.data() + hash.wordCount());
+    MinimalPerfectHash loaded = MinimalPerfectHash::fromImage(image);
+    EXPECT_EQ(loaded.data(), image.data());
+    EXPECT_EQ(loaded.keyCount(), keys.size());
+    for (uint64_t key : keys) {
+        ASSERT_EQ(loaded.indexOf(key), hash.indexOf(key));
+    }
+
+    MinimalPerfectHash moved = std::move(hash);
+    EXPECT_EQ(hash.wordCount(), 0);
+    EXPECT_EQ(moved.indexOf(keys[0]), loaded.indexOf(keys[0]));
+
+    auto rejected = [](std::vector<uint64_t> words) {
+        EXPECT_THROW(MinimalPerfectHash::fromImage(words), std::invalid_argument);
+    };
+    rejected({});
+    rejected(std::vector<uint64_t>(image.begin(), image.end() - 8));
+    std::vector<uint64_t> corrupt = image;
+    corrupt[0] ^= 1;
+    rejected(corrupt);
+    corrupt = image;
+    corrupt[2] = 1000; // Level count.
+    rejected(corrupt);
+    corrupt = image;
+    std::swap(corrupt[9], corrupt[10]); // Level starts out of order.
+    rejected(corrupt);
+}
+
+// Test that duplicate keys and bad parameters are rejected
+TEST(MinimalPerfectHashTest, InvalidInput) {
+    std::vector<uint64_t> keys = randomKeys(1000, 6);
+    keys.push_back(keys[17]);
+    EXPECT_THROW(MinimalPerfectHash{std::span<const uint64_t>(keys)}, std::invalid_argument);
+    keys.pop_back();
+    EXPECT_THROW(MinimalPerfectHash(std::span<const uint64_t>(keys), 0.5), std::invalid_argument);
+}
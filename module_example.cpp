@@ -0,0 +1,19 @@
+#include <cstdint>
+#include <print>
+
+import cpp_ds;
+
+int main() {
+    DArray<int> values = {3, 1, 2};
+    values.push(4);
+    values.insert(values.begin(), 0);
+
+    SparseSet<uint32_t> ids(16);
+    for (int value : values) {
+        ids.insert(static_cast<uint32_t>(value));
+    }
+
+    UniquePointer<int> answer = makeUnique<int>(42);
+
+    std::println("{} values, {} ids, answer {}", values.size(), ids.size(), *answer);
+}
@@ -0,0 +1,353 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include "cache_line.hpp"
+#include "dynamic_array.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief A bounded multi-producer/multi-consumer queue (Vyukov-style).
+ * Every slot carries its own sequence number that tells whether it is ready to be written
+ * for position `p` (sequence == p) or read for position `p` (sequence == p + 1), so producers
+ * and consumers only contend on the position counter and on the slot they claimed.
+ * Slots are padded to a cache line so that neighbouring slots never false-share.
+ *
+ * `try*` operations never block. `push`/`pop`/`emplace` take a ticket and wait for their slot,
+ * spinning briefly before sleeping on the slot's sequence number (`std::atomic::wait`, which is
+ * futex-based on Linux).
+ *
+ * Elements must be nothrow move constructible and assignable: once a position is claimed its
+ * slot has to be published, otherwise every later operation on that slot would wait forever.
+ * @tparam ElementT The type of elements stored in the queue.
+ * @tparam AllocatorT The allocator type used for the slot storage. Defaults to `DefaultAllocator`.
+ */
+template <typename ElementT, Allocator AllocatorT = DefaultAllocator>
+    requires std::is_nothrow_move_constructible_v<ElementT> &&
+             std::is_nothrow_move_assignable_v<ElementT>
+class MpmcQueue {
+private:
+    struct alignas(cacheLineSize) Slot {
+        std::atomic<size_t> sequence;
+        alignas(ElementT) std::byte storage[sizeof(ElementT)];
+
+        ElementT* get() noexcept {
+            return std::launder(reinterpret_cast<ElementT*>(storage));
+        }
+    };
+
+    static constexpr int spinLimit = 128;
+
+    DArray<Slot, AllocatorT> _slots;
+    size_t _mask;
+
+    alignas(cacheLineSize) std::atomic<size_t> _enqueuePosition = 0;
+    alignas(cacheLineSize) std::atomic<size_t> _dequeuePosition = 0;
+
+public:
+    /**
+     * @brief Constructs an empty queue able to hold at least `capacity` elements.
+     * @param capacity The minimum capacity. Rounded up to the next power of two (at least 2: with a
+     * single slot "written for position p" and "free for position p + 1" share a sequence number).
+     * @throws std::length_error If the rounded capacity is not representable.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    explicit MpmcQueue(size_t capacity)
+        : _slots(roundedCapacity(capacity))
+        , _mask(_slots.size() - 1) {
+        for (size_t i = 0; i < _slots.size(); ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Destructor.
+     * Destroys the elements still in the queue. All producers and consumers must have stopped.
+     */
+    ~MpmcQueue() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<ElementT>) {
+            size_t last = _enqueuePosition.load(std::memory_order_acquire);
+            for (size_t pos = _dequeuePosition.load(std::memory_order_acquire); pos < last; ++pos) {
+                Slot& slot = slotAt(pos);
+                if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+                    slot.get()->~ElementT();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of slots in the queue (a power of two).
+     */
+    size_t capacity() const noexcept {
+        return _mask + 1;
+    }
+
+    /**
+     * @brief Returns an approximate number of elements in the queue.
+     * Negative while consumers are waiting in `pop()`; clamped to zero.
+     */
+    size_t size() const noexcept {
+        size_t dequeued = _dequeuePosition.load(std::memory_order_acquire);
+        size_t enqueued = _enqueuePosition.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /**
+     * @brief Checks whether the queue looks empty. Same caveats as `size()`.
+     */
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Appends a copy of `element` if there is room.
+     * @return `true` on success, `false` if the queue is full.
+     * @throws Any exception thrown by the ElementT copy constructor (the queue is unchanged).
+     */
+    bool tryPush(const ElementT& element) {
+        if constexpr (std::is_nothrow_copy_constructible_v<ElementT>) {
+            return tryEmplace(element);
+        } else {
+            return tryEmplace(ElementT(element));
+        }
+    }
+
+    /**
+     * @brief Appends `element` (moved) if there is room.
+     * @return `true` on success, `false` if the queue is full (`element` is left untouched).
+     */
+    bool tryPush(ElementT&& element) noexcept {
+        return tryEmplace(std::move(element));
+    }
+
+    /**
+     * @brief Constructs an element in-place at the back of the queue if there is room.
+     * @return `true` on success, `false` if the queue is full.
+     */
+    template <typename... Args>
+        requires std::is_nothrow_constructible_v<ElementT, Args...>
+    bool tryEmplace(Args&&... args) noexcept {
+        size_t pos = _enqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slotAt(pos);
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (_enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    publish(slot, pos, std::forward<Args>(args)...);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Appends a copy of `element`, waiting for room if the queue is full.
+     * @throws Any exception thrown by the ElementT copy constructor (the queue is unchanged).
+     */
+    void push(const ElementT& element) {
+        if constexpr (std::is_nothrow_copy_constructible_v<ElementT>) {
+            emplace(element);
+        } else {
+            emplace(ElementT(element));
+        }
+    }
+
+    /**
+     * @brief Appends `element` (moved), waiting for room if the queue is full.
+     */
+    void push(ElementT&& element) noexcept {
+        emplace(std::move(element));
+    }
+
+    /**
+     * @brief Constructs an element in-place at the back of the queue, waiting for room if the queue is full.
+     */
+    template <typename... Args>
+        requires std::is_nothrow_constructible_v<ElementT, Args...>
+    void emplace(Args&&... args) noexcept {
+        size_t pos = _enqueuePosition.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slotAt(pos);
+        waitForSequence(slot, pos);
+        publish(slot, pos, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Copies as many elements from [first, last) as there are free consecutive slots.
+     * The whole batch is claimed with a single CAS on the enqueue position.
+     * @return The number of elements pushed (a prefix of the range).
+     */
+    size_t pushMany(const ElementT* first, const ElementT* last) noexcept
+        requires std::is_nothrow_copy_constructible_v<ElementT>
+    {
+        size_t count = static_cast<size_t>(last - first);
+        if (count == 0) {
+            return 0;
+        }
+        size_t pos = _enqueuePosition.load(std::memory_order_relaxed);
+        size_t n = 0;
+        for (;;) {
+            auto diff = static_cast<std::ptrdiff_t>(slotAt(pos).sequence.load(std::memory_order_acquire) - pos);
+            if (diff < 0) {
+                return 0;
+            }
+            if (diff == 0) {
+                n = 1;
+                while (n < count && n < capacity() &&
+                       slotAt(pos + n).sequence.load(std::memory_order_acquire) == pos + n) {
+                    ++n;
+                }
+                if (_enqueuePosition.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                pos = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            publish(slotAt(pos + i), pos + i, first[i]);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Moves the front element into `element` if the queue is not empty.
+     * @return `true` on success, `false` if the queue is empty.
+     */
+    bool tryPop(ElementT& element) noexcept {
+        size_t pos = _dequeuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slotAt(pos);
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (_dequeuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    consume(slot, pos, element);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Moves the front element into `element`, waiting for one if the queue is empty.
+     */
+    void pop(ElementT& element) noexcept {
+        size_t pos = _dequeuePosition.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slotAt(pos);
+        waitForSequence(slot, pos + 1);
+        consume(slot, pos, element);
+    }
+
+    /**
+     * @brief Moves up to `n` front elements into `dst`, claiming them with a single CAS.
+     * `dst` must point to `n` constructed (assignable) elements.
+     * @return The number of elements popped.
+     */
+    size_t popMany(ElementT* dst, size_t n) noexcept {
+        if (n == 0) {
+            return 0;
+        }
+        size_t pos = _dequeuePosition.load(std::memory_order_relaxed);
+        size_t ready = 0;
+        for (;;) {
+            auto diff = static_cast<std::ptrdiff_t>(slotAt(pos).sequence.load(std::memory_order_acquire) - (pos + 1));
+            if (diff < 0) {
+                return 0;
+            }
+            if (diff == 0) {
+                ready = 1;
+                while (ready < n && ready < capacity() &&
+                       slotAt(pos + ready).sequence.load(std::memory_order_acquire) == pos + ready + 1) {
+                    ++ready;
+                }
+                if (_dequeuePosition.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                pos = _dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < ready; ++i) {
+            consume(slotAt(pos + i), pos + i, dst[i]);
+        }
+        return ready;
+    }
+
+private:
+    static size_t roundedCapacity(size_t capacity) {
+        if (capacity > (std::numeric_limits<size_t>::max() >> 1) + 1) {
+            throw std::length_error("Required capacity is too large");
+        }
+        return std::bit_ceil(capacity > 2 ? capacity : 2);
+    }
+
+    Slot& slotAt(size_t position) noexcept {
+        return _slots[position & _mask];
+    }
+
+    template <typename... Args>
+    void publish(Slot& slot, size_t pos, Args&&... args) noexcept {
+        new (slot.storage) ElementT(std::forward<Args>(args)...);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        slot.sequence.notify_all();
+    }
+
+    void consume(Slot& slot, size_t pos, ElementT& element) noexcept {
+        ElementT* src = slot.get();
+        element = std::move(*src);
+        src->~ElementT();
+        slot.sequence.store(pos + capacity(), std::memory_order_release);
+        slot.sequence.notify_all();
+    }
+
+    static void waitForSequence(Slot& slot, size_t expected) noexcept {
+        for (int i = 0; i < spinLimit; ++i) {
+            if (slot.sequence.load(std::memory_order_acquire) == expected) {
+                return;
+            }
+            cpuRelax();
+        }
+        for (;;) {
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == expected) {
+                return;
+            }
+            slot.sequence.wait(sequence, std::memory_order_acquire);
+        }
+    }
+
+    static void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+};
+
+#endif // MPMC_QUEUE_HPP
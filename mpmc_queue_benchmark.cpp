@@ -0,0 +1,92 @@
+#include "dynamic_array.hpp"
+#include "mpmc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <print>
+#include <thread>
+#include <vector>
+
+// Contention benchmark: half of the threads produce, half consume, all hammering one queue.
+// Compares the MPMC queue against the mutex-protected `DArray` it replaces; both are bounded
+// to the same capacity so that the baseline's O(n) `erase(begin())` stays comparable.
+
+constexpr size_t queueCapacity = 1024;
+constexpr size_t itemsPerProducer = 100'000;
+
+struct LockedDArrayQueue {
+    std::mutex mutex;
+    DArray<size_t> items;
+
+    bool tryPush(size_t value) {
+        std::lock_guard lock(mutex);
+        if (items.size() == queueCapacity) {
+            return false;
+        }
+        items.push(value);
+        return true;
+    }
+
+    bool tryPop(size_t& value) {
+        std::lock_guard lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        value = items.front();
+        items.erase(items.begin());
+        return true;
+    }
+};
+
+template <typename Queue, typename Push, typename Pop>
+double run(int threads, Queue& queue, Push push, Pop pop) {
+    int producers = std::max(1, threads / 2);
+    int consumers = std::max(1, threads - producers);
+    size_t total = producers * itemsPerProducer;
+    std::atomic<size_t> consumed = 0;
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; ++p) {
+        workers.emplace_back([&] {
+            for (size_t i = 0; i < itemsPerProducer; ++i) {
+                while (!push(queue, i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        workers.emplace_back([&] {
+            size_t value;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (pop(queue, value)) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return total / elapsed.count() / 1e6;
+}
+
+int main() {
+    std::println("{:>8} {:>16} {:>16}", "threads", "mpmc (M ops/s)", "mutex (M ops/s)");
+    for (int threads = 2; threads <= 64; threads *= 2) {
+        auto push = [](auto& queue, size_t value) { return queue.tryPush(value); };
+        auto pop = [](auto& queue, size_t& value) { return queue.tryPop(value); };
+
+        MpmcQueue<size_t> mpmc(queueCapacity);
+        double mpmcRate = run(threads, mpmc, push, pop);
+
+        LockedDArrayQueue locked;
+        double lockedRate = run(threads, locked, push, pop);
+
+        std::println("{:>8} {:>16.2f} {:>16.2f}", threads, mpmcRate, lockedRate);
+    }
+}
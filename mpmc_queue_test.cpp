@@ -0,0 +1,157 @@
+#include "mpmc_queue.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MpmcQueueTest, CapacityIsRoundedToPowerOfTwo) {
+    EXPECT_EQ(MpmcQueue<int>(0).capacity(), 2);
+    EXPECT_EQ(MpmcQueue<int>(1).capacity(), 2);
+    EXPECT_EQ(MpmcQueue<int>(3).capacity(), 4);
+    EXPECT_EQ(MpmcQueue<int>(1000).capacity(), 1024);
+}
+
+TEST(MpmcQueueTest, TryPushAndTryPop) {
+    MpmcQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.size(), 4);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpmcQueueTest, NonTrivialElements) {
+    MpmcQueue<std::string> queue(2);
+    std::string hello = "hello";
+    EXPECT_TRUE(queue.tryPush(hello));
+    EXPECT_TRUE(queue.tryPush(std::string(3, 'x')));
+    EXPECT_FALSE(queue.tryPush("full"));
+
+    std::string value;
+    queue.pop(value);
+    EXPECT_EQ(value, "hello");
+    queue.pop(value);
+    EXPECT_EQ(value, "xxx");
+}
+
+TEST(MpmcQueueTest, DestructorDestroysRemainingElements) {
+    auto shared = std::make_shared<int>(0);
+    {
+        MpmcQueue<std::shared_ptr<int>> queue(4);
+        queue.push(shared);
+        queue.push(shared);
+        EXPECT_EQ(shared.use_count(), 3);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(MpmcQueueTest, PushManyPopMany) {
+    MpmcQueue<int> queue(8);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10] = {};
+
+    EXPECT_EQ(queue.pushMany(in, in + 6), 6);
+    EXPECT_EQ(queue.popMany(out, 4), 4);
+    EXPECT_EQ(queue.pushMany(in + 6, in + 10), 4);
+    EXPECT_EQ(queue.pushMany(in, in + 10), 2);
+    EXPECT_EQ(queue.popMany(out + 4, 6), 6);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_EQ(queue.popMany(out, 10), 2);
+    EXPECT_EQ(queue.popMany(out, 10), 0);
+}
+
+TEST(MpmcQueueTest, BlockingPopWaitsForProducer) {
+    MpmcQueue<int> queue(2);
+    std::atomic<bool> popped = false;
+    int value = 0;
+    std::thread consumer([&] {
+        queue.pop(value);
+        popped = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(popped);
+    queue.push(42);
+    consumer.join();
+    EXPECT_TRUE(popped);
+    EXPECT_EQ(value, 42);
+}
+
+TEST(MpmcQueueTest, BlockingPushWaitsForConsumer) {
+    MpmcQueue<int> queue(2);
+    queue.push(1);
+    queue.push(2);
+    std::atomic<bool> pushed = false;
+    std::thread producer([&] {
+        queue.push(3);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed);
+    int value = 0;
+    queue.pop(value);
+    EXPECT_EQ(value, 1);
+    producer.join();
+    queue.pop(value);
+    EXPECT_EQ(value, 2);
+    queue.pop(value);
+    EXPECT_EQ(value, 3);
+}
+
+TEST(MpmcQueueTest, ManyProducersManyConsumers) {
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr int perProducer = 50'000;
+    MpmcQueue<int> queue(64);
+    std::atomic<long long> sum = 0;
+    std::atomic<int> received = 0;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                int value = p * perProducer + i;
+                if (i % 2 == 0) {
+                    queue.push(value);
+                } else {
+                    while (!queue.tryPush(value)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            int batch[8];
+            while (received.load() < producers * perProducer) {
+                size_t n = queue.popMany(batch, c % 2 == 0 ? 8 : 1);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    sum += batch[i];
+                }
+                received += static_cast<int>(n);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    long long total = static_cast<long long>(producers) * perProducer;
+    EXPECT_EQ(received.load(), total);
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+    EXPECT_TRUE(queue.empty());
+}
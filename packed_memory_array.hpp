@@ -0,0 +1,430 @@
+#ifndef PACKED_MEMORY_ARRAY_HPP
+#define PACKED_MEMORY_ARRAY_HPP
+
+#include "dynamic_array.hpp"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief A sorted multiset stored in one `DArray` with gaps left between the elements (a packed
+ * memory array), so that an insert moves O(log² n) elements amortized instead of half the array.
+ * The slots are split into segments of about log n slots. Each segment keeps its elements packed
+ * at its start, and a segment that runs out of room (or empties) spreads the elements of the
+ * smallest enclosing window of 2, 4, 8... segments evenly over it. Windows are allowed to be
+ * denser the smaller they are; when even the whole array is too dense or too sparse it is
+ * reallocated at twice or half the size. Scans walk the segments in order, so they stay close to
+ * the speed of a plain sorted array.
+ * @tparam ElementT The element type. Gaps hold default-constructed elements.
+ * @tparam CompareT The strict weak order of the elements. Defaults to `std::less<>`.
+ * @tparam AllocatorT The allocator used for the slots. Defaults to `DefaultAllocator`.
+ */
+template <typename ElementT, typename CompareT = std::less<>, Allocator AllocatorT = DefaultAllocator>
+class PackedMemoryArray {
+    static_assert(std::default_initializable<ElementT>, "Gaps are default-constructed elements");
+    static_assert(std::is_nothrow_move_constructible_v<ElementT> && std::is_nothrow_move_assignable_v<ElementT>,
+                  "Rebalancing moves elements and must not throw halfway");
+
+public:
+    /**
+     * @brief The smallest number of slots in a segment.
+     */
+    static constexpr size_t minSegmentSize = 8;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementT;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElementT*;
+        using reference = const ElementT&;
+
+    private:
+        friend class PackedMemoryArray;
+
+        const PackedMemoryArray* _array = nullptr;
+        size_t _segment = 0;
+        size_t _offset = 0;
+
+    public:
+        Iterator() noexcept = default;
+
+        Iterator(const PackedMemoryArray* array, size_t segment, size_t offset) noexcept
+            : _array(array)
+            , _segment(segment)
+            , _offset(offset) {
+            skipExhausted();
+        }
+
+        reference operator*() const noexcept {
+            return _array->_slots[_segment * _array->_segmentSize + _offset];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        Iterator& operator++() noexcept {
+            ++_offset;
+            skipExhausted();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& left, const Iterator& right) noexcept {
+            return left._segment == right._segment && left._offset == right._offset;
+        }
+
+    private:
+        void skipExhausted() noexcept {
+            while (_segment < _array->_counts.size() && _offset == _array->_counts[_segment]) {
+                ++_segment;
+                _offset = 0;
+            }
+        }
+    };
+
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+private:
+    DArray<ElementT, AllocatorT> _slots;
+    // The number of elements packed at the start of each segment.
+    DArray<uint32_t, AllocatorT> _counts;
+    // Reused as the staging area of rebalances.
+    DArray<ElementT, AllocatorT> _scratch;
+    size_t _segmentSize = minSegmentSize;
+    size_t _size = 0;
+    [[no_unique_address]] CompareT _compare;
+
+public:
+    PackedMemoryArray() = default;
+
+    explicit PackedMemoryArray(CompareT compare)
+        : _compare(std::move(compare)) {}
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    /**
+     * @brief Returns the number of slots, used and empty.
+     */
+    size_t capacity() const noexcept {
+        return _slots.size();
+    }
+
+    size_t segmentSize() const noexcept {
+        return _segmentSize;
+    }
+
+    Iterator begin() const noexcept {
+        return Iterator(this, 0, 0);
+    }
+
+    Iterator end() const noexcept {
+        return Iterator(this, _counts.size(), 0);
+    }
+
+    /**
+     * @brief Calls `function` with every element in order, one tight loop per segment.
+     */
+    template <typename FunctionT>
+    void forEach(FunctionT function) const {
+        for (size_t segment = 0; segment < _counts.size(); ++segment) {
+            const ElementT* first = _slots.data() + segment * _segmentSize;
+            for (const ElementT* element = first; element != first + _counts[segment]; ++element) {
+                function(*element);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns an iterator to the first element not less than `value`, or `end()`.
+     */
+    Iterator lowerBound(const ElementT& value) const {
+        if (_size == 0) {
+            return end();
+        }
+        // Every segment holds at least one element once there are two or more (see `lowerDensity`),
+        // so the segments can be searched by their first elements.
+        size_t segment = lastSegmentWhere([&](const ElementT& first) { return _compare(first, value); });
+        const ElementT* first = segmentBegin(segment);
+        const ElementT* found = std::lower_bound(first, first + _counts[segment], value, _compare);
+        return Iterator(this, segment, static_cast<size_t>(found - first));
+    }
+
+    bool contains(const ElementT& value) const {
+        Iterator found = lowerBound(value);
+        return found != end() && !_compare(value, *found);
+    }
+
+    /**
+     * @brief Inserts `value` after the elements equal to it.
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws Any exception thrown by the ElementT copy constructor.
+     */
+    void insert(const ElementT& value) {
+        insert(ElementT(value));
+    }
+
+    void insert(ElementT&& value) {
+        if (_slots.empty()) {
+            reallocate(1);
+        }
+        size_t segment = lastSegmentWhere([&](const ElementT& first) { return !_compare(value, first); });
+        if (_counts[segment] < _segmentSize) {
+            ElementT* first = segmentBegin(segment);
+            ElementT* last = first + _counts[segment];
+            ElementT* position = std::upper_bound(first, last, value, _compare);
+            std::move_backward(position, last, last + 1);
+            *position = std::move(value);
+            ++_counts[segment];
+            ++_size;
+            return;
+        }
+        for (size_t level = 1; level <= height(); ++level) {
+            auto [window, count] = windowOf(segment, level);
+            if (static_cast<double>(count + 1) <= upperDensity(level) * static_cast<double>(windowSlots(level))) {
+                rebalance(window, size_t{1} << level, &value);
+                return;
+            }
+        }
+        reallocate(_size + 1, &value);
+    }
+
+    /**
+     * @brief Inserts a batch of elements sorted by the array's order.
+     * A batch that is small next to the array is inserted element by element; a larger one is
+     * merged with all elements in one pass, which costs O(n + batch) moves.
+     * @throws std::invalid_argument If `batch` is not sorted.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    void insertSorted(std::span<const ElementT> batch) {
+        if (!std::is_sorted(batch.begin(), batch.end(), _compare)) {
+            throw std::invalid_argument("Batch is not sorted");
+        }
+        if (batch.size() * _segmentSize < _size) {
+            for (const ElementT& value : batch) {
+                insert(value);
+            }
+            return;
+        }
+        // Everything that can throw (copies and allocations) happens before elements are moved.
+        DArray<ElementT, AllocatorT> incoming;
+        incoming.reserve(batch.size());
+        for (const ElementT& value : batch) {
+            incoming.push(value);
+        }
+        Layout layout = allocateLayout(_size + batch.size());
+        _scratch.clear();
+        _scratch.reserve(_size + batch.size());
+        // Existing elements go first among equals, as they would with `insert`.
+        size_t next = 0;
+        gather(0, _counts.size(), [&](ElementT& element) {
+            while (next < incoming.size() && _compare(incoming[next], element)) {
+                _scratch.push(std::move(incoming[next++]));
+            }
+            _scratch.push(std::move(element));
+        });
+        for (; next < incoming.size(); ++next) {
+            _scratch.push(std::move(incoming[next]));
+        }
+        install(std::move(layout));
+    }
+
+    /**
+     * @brief Erases one element equal to `value`.
+     * @return Whether there was such an element.
+     */
+    bool erase(const ElementT& value) {
+        Iterator found = lowerBound(value);
+        if (found == end() || _compare(value, *found)) {
+            return false;
+        }
+        size_t segment = found._segment;
+        ElementT* first = segmentBegin(segment);
+        std::move(first + found._offset + 1, first + _counts[segment], first + found._offset);
+        --_counts[segment];
+        --_size;
+        if (height() == 0 || _counts[segment] >= lowerDensity(0) * static_cast<double>(_segmentSize)) {
+            return true;
+        }
+        for (size_t level = 1; level <= height(); ++level) {
+            auto [window, count] = windowOf(segment, level);
+            if (static_cast<double>(count) >= lowerDensity(level) * static_cast<double>(windowSlots(level))) {
+                rebalance(window, size_t{1} << level, nullptr);
+                return true;
+            }
+        }
+        reallocate(_size);
+        return true;
+    }
+
+    void clear() noexcept {
+        _slots.clear();
+        _counts.clear();
+        _segmentSize = minSegmentSize;
+        _size = 0;
+    }
+
+private:
+    ElementT* segmentBegin(size_t segment) noexcept {
+        return _slots.data() + segment * _segmentSize;
+    }
+
+    const ElementT* segmentBegin(size_t segment) const noexcept {
+        return _slots.data() + segment * _segmentSize;
+    }
+
+    size_t height() const noexcept {
+        return static_cast<size_t>(std::countr_zero(_counts.size()));
+    }
+
+    size_t windowSlots(size_t level) const noexcept {
+        return _segmentSize << level;
+    }
+
+    // Windows may be fuller the smaller they are: from 100% for a segment down to 75% for the
+    // whole array, which is then grown to half that density.
+    double upperDensity(size_t level) const noexcept {
+        return 1.0 - 0.25 * static_cast<double>(level) / static_cast<double>(height());
+    }
+
+    // Windows must hold at least 1/8 of their slots for a segment and 1/4 for the whole array,
+    // which is then shrunk. With at least 8 slots per segment, no segment is left empty.
+    double lowerDensity(size_t level) const noexcept {
+        return height() == 0 ? 0.0 : 0.125 + 0.125 * static_cast<double>(level) / static_cast<double>(height());
+    }
+
+    // Returns the first segment of the window at `level` containing `segment`, and its element count.
+    std::pair<size_t, size_t> windowOf(size_t segment, size_t level) const noexcept {
+        size_t first = segment & ~((size_t{1} << level) - 1);
+        size_t count = 0;
+        for (size_t i = first; i < first + (size_t{1} << level); ++i) {
+            count += _counts[i];
+        }
+        return {first, count};
+    }
+
+    // Returns the last segment whose first element satisfies `predicate` (which holds for a prefix
+    // of the segments), or 0 if none does.
+    template <typename PredicateT>
+    size_t lastSegmentWhere(PredicateT predicate) const {
+        size_t low = 0;
+        size_t high = _counts.size();
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (_counts[middle] > 0 && predicate(*segmentBegin(middle))) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low == 0 ? 0 : low - 1;
+    }
+
+    // Moves the elements of segments [first, last) out, in order, through `sink`.
+    template <typename SinkT>
+    void gather(size_t first, size_t last, SinkT sink) {
+        for (size_t segment = first; segment < last; ++segment) {
+            ElementT* begin = segmentBegin(segment);
+            for (ElementT* element = begin; element != begin + _counts[segment]; ++element) {
+                sink(*element);
+            }
+        }
+    }
+
+    // Moves the elements of `_scratch` into segments [first, first + segments), spread evenly.
+    void scatter(size_t first, size_t segments) noexcept {
+        size_t count = _scratch.size();
+        size_t next = 0;
+        for (size_t i = 0; i < segments; ++i) {
+            size_t share = count / segments + (i < count % segments);
+            std::move(_scratch.begin() + next, _scratch.begin() + next + share, segmentBegin(first + i));
+            _counts[first + i] = static_cast<uint32_t>(share);
+            next += share;
+        }
+        _scratch.clear();
+    }
+
+    // Spreads the elements of a window evenly over it, merging in `*extra` if it is given.
+    void rebalance(size_t first, size_t segments, ElementT* extra) {
+        _scratch.clear();
+        _scratch.reserve(segments * _segmentSize);
+        bool placed = extra == nullptr;
+        gather(first, first + segments, [&](ElementT& element) {
+            if (!placed && _compare(*extra, element)) {
+                _scratch.push(std::move(*extra));
+                placed = true;
+            }
+            _scratch.push(std::move(element));
+        });
+        if (!placed) {
+            _scratch.push(std::move(*extra));
+        }
+        _size += extra != nullptr;
+        scatter(first, segments);
+    }
+
+    struct Layout {
+        DArray<ElementT, AllocatorT> slots;
+        DArray<uint32_t, AllocatorT> counts;
+        size_t segmentSize;
+    };
+
+    // Returns empty slots for `count` elements: at most half full, and at least a quarter full
+    // unless tiny, in segments of about log2 of the slot count.
+    static Layout allocateLayout(size_t count) {
+        size_t slots = std::max(std::bit_ceil(2 * count), minSegmentSize);
+        size_t segmentSize = std::max(std::bit_ceil(static_cast<size_t>(std::bit_width(slots))), minSegmentSize);
+        return {DArray<ElementT, AllocatorT>(slots), DArray<uint32_t, AllocatorT>(slots / segmentSize), segmentSize};
+    }
+
+    // Replaces the slots with `layout` and spreads the elements of `_scratch` over it.
+    void install(Layout&& layout) noexcept {
+        _slots = std::move(layout.slots);
+        _counts = std::move(layout.counts);
+        _segmentSize = layout.segmentSize;
+        _size = _scratch.size();
+        scatter(0, _counts.size());
+    }
+
+    // Moves all elements (and `*extra`) into a new layout sized for `count` elements.
+    void reallocate(size_t count, ElementT* extra = nullptr) {
+        Layout layout = allocateLayout(count);
+        _scratch.clear();
+        _scratch.reserve(count);
+        bool placed = extra == nullptr;
+        gather(0, _counts.size(), [&](ElementT& element) {
+            if (!placed && _compare(*extra, element)) {
+                _scratch.push(std::move(*extra));
+                placed = true;
+            }
+            _scratch.push(std::move(element));
+        });
+        if (!placed) {
+            _scratch.push(std::move(*extra));
+        }
+        install(std::move(layout));
+    }
+};
+
+#endif // PACKED_MEMORY_ARRAY_HPP
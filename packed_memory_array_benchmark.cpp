@@ -0,0 +1,67 @@
+#include "dynamic_array.hpp"
+#include "packed_memory_array.hpp"
+#include <algorithm>
+#include <chrono>
+#include <print>
+#include <random>
+
+// Sorted inserts into a plain sorted DArray (which shifts half the array each time) against a
+// packed memory array, and the cost of scanning each afterwards.
+
+namespace {
+
+template <typename CallT>
+double seconds(CallT call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+int main() {
+    std::println("{:>9} {:>14} {:>14} {:>14} {:>14}", "elements", "DArray insert", "PMA insert", "DArray scan", "PMA scan");
+    for (size_t count : {10'000, 100'000, 300'000}) {
+        std::mt19937_64 random(42);
+        DArray<int64_t> values;
+        for (size_t i = 0; i < count; ++i) {
+            values.push(static_cast<int64_t>(random() >> 1));
+        }
+
+        DArray<int64_t> sorted;
+        double arrayInsert = seconds([&] {
+            for (int64_t value : values) {
+                sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), value), value);
+            }
+        });
+        PackedMemoryArray<int64_t> packed;
+        double packedInsert = seconds([&] {
+            for (int64_t value : values) {
+                packed.insert(value);
+            }
+        });
+
+        int64_t arraySum = 0;
+        int64_t packedSum = 0;
+        constexpr int scans = 20;
+        double arrayScan = seconds([&] {
+            for (int s = 0; s < scans; ++s) {
+                for (int64_t value : sorted) {
+                    arraySum += value >> 20;
+                }
+            }
+        });
+        double packedScan = seconds([&] {
+            for (int s = 0; s < scans; ++s) {
+                packed.forEach([&](int64_t value) { packedSum += value >> 20; });
+            }
+        });
+        if (arraySum != packedSum) {
+            std::println("mismatch");
+            return 1;
+        }
+        std::println("{:>9} {:>12.1f}ns {:>12.1f}ns {:>12.2f}ns {:>12.2f}ns", count, arrayInsert / count * 1e9, packedInsert / count * 1e9,
+                     arrayScan / scans / count * 1e9, packedScan / scans / count * 1e9);
+    }
+}
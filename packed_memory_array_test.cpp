@@ -0,0 +1,152 @@
+#include "packed_memory_array.hpp"
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Checks that `array` holds exactly the elements of `expected` (sorted), both through iterators
+// and through `forEach`.
+template <typename ElementT, typename CompareT>
+void expectElements(const PackedMemoryArray<ElementT, CompareT>& array, const std::vector<ElementT>& expected) {
+    ASSERT_EQ(array.size(), expected.size());
+    std::vector<ElementT> iterated(array.begin(), array.end());
+    EXPECT_EQ(iterated, expected);
+    std::vector<ElementT> visited;
+    array.forEach([&](const ElementT& element) { visited.push_back(element); });
+    EXPECT_EQ(visited, expected);
+}
+
+} // namespace
+
+// Test that an empty array has no elements and no slots
+TEST(PackedMemoryArrayTest, Empty) {
+    PackedMemoryArray<int> array;
+    EXPECT_TRUE(array.empty());
+    EXPECT_EQ(array.capacity(), 0);
+    EXPECT_EQ(array.begin(), array.end());
+    EXPECT_EQ(array.lowerBound(5), array.end());
+    EXPECT_FALSE(array.contains(5));
+    EXPECT_FALSE(array.erase(5));
+}
+
+// Test inserting in random order keeps the elements sorted and the density bounded
+TEST(PackedMemoryArrayTest, RandomInserts) {
+    PackedMemoryArray<int> array;
+    std::vector<int> expected;
+    std::mt19937 random(1);
+    for (int i = 0; i < 20000; ++i) {
+        int value = static_cast<int>(random() % 5000);
+        array.insert(value);
+        expected.insert(std::upper_bound(expected.begin(), expected.end(), value), value);
+        ASSERT_LE(array.size(), array.capacity());
+    }
+    expectElements(array, expected);
+    EXPECT_GE(array.size() * 4, array.capacity());
+}
+
+// Test that ascending and descending streams, which always hit the same segment, stay sorted
+TEST(PackedMemoryArrayTest, MonotoneInserts) {
+    PackedMemoryArray<int> ascending;
+    PackedMemoryArray<int> descending;
+    std::vector<int> expected;
+    for (int i = 0; i < 10000; ++i) {
+        ascending.insert(i);
+        descending.insert(9999 - i);
+        expected.push_back(i);
+    }
+    expectElements(ascending, expected);
+    expectElements(descending, expected);
+}
+
+// Test lower bounds and lookups, including duplicates and values between elements
+TEST(PackedMemoryArrayTest, LowerBound) {
+    PackedMemoryArray<int> array;
+    for (int i = 0; i < 1000; ++i) {
+        array.insert(2 * i);
+        array.insert(2 * i);
+    }
+    for (int value = -1; value < 2001; ++value) {
+        auto found = array.lowerBound(value);
+        if (value >= 1999) {
+            EXPECT_EQ(found, array.end()) << value;
+        } else {
+            EXPECT_EQ(*found, (value + 1) / 2 * 2) << value;
+        }
+        EXPECT_EQ(array.contains(value), value >= 0 && value < 2000 && value % 2 == 0) << value;
+    }
+}
+
+// Test that erasing removes one occurrence at a time and shrinks a sparse array
+TEST(PackedMemoryArrayTest, Erase) {
+    PackedMemoryArray<int> array;
+    std::vector<int> expected;
+    std::mt19937 random(2);
+    for (int i = 0; i < 5000; ++i) {
+        int value = static_cast<int>(random() % 1000);
+        array.insert(value);
+        expected.insert(std::upper_bound(expected.begin(), expected.end(), value), value);
+    }
+    size_t grownCapacity = array.capacity();
+    std::shuffle(expected.begin(), expected.end(), random);
+    std::vector<int> remaining = expected;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_TRUE(array.erase(expected[i]));
+        remaining.erase(std::find(remaining.begin(), remaining.end(), expected[i]));
+        if (i % 500 == 0) {
+            std::vector<int> sorted = remaining;
+            std::sort(sorted.begin(), sorted.end());
+            expectElements(array, sorted);
+            EXPECT_GE(array.size() * 8 + array.segmentSize(), array.capacity());
+        }
+    }
+    EXPECT_TRUE(array.empty());
+    EXPECT_LT(array.capacity(), grownCapacity);
+    EXPECT_FALSE(array.erase(0));
+}
+
+// Test sorted batch inserts, both merged in one pass and inserted one by one
+TEST(PackedMemoryArrayTest, InsertSorted) {
+    PackedMemoryArray<int> array;
+    std::vector<int> expected;
+    for (int round = 0; round < 5; ++round) {
+        std::vector<int> batch;
+        for (int i = 0; i < 3000; ++i) {
+            batch.push_back(i * 5 + round);
+        }
+        array.insertSorted(batch);
+        expected.insert(expected.end(), batch.begin(), batch.end());
+    }
+    std::vector<int> small = {-1, 7, 7, 100000};
+    array.insertSorted(small);
+    expected.insert(expected.end(), small.begin(), small.end());
+    std::sort(expected.begin(), expected.end());
+    expectElements(array, expected);
+
+    std::vector<int> unsorted = {3, 1};
+    EXPECT_THROW(array.insertSorted(unsorted), std::invalid_argument);
+    EXPECT_EQ(array.size(), expected.size());
+}
+
+// Test a custom order and elements that own memory
+TEST(PackedMemoryArrayTest, CustomOrder) {
+    PackedMemoryArray<std::string, std::greater<>> array;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 2000; ++i) {
+        std::string value = "key-" + std::to_string(i * 7919 % 2000) + std::string(20, 'x');
+        array.insert(value);
+        expected.push_back(value);
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    expectElements(array, expected);
+    EXPECT_TRUE(array.erase(expected[10]));
+    EXPECT_FALSE(array.contains(expected[10]));
+    array.clear();
+    EXPECT_TRUE(array.empty());
+    array.insert("again");
+    expectElements(array, {"again"});
+}
@@ -0,0 +1,362 @@
+#ifndef PERF_BENCHMARK_HPP
+#define PERF_BENCHMARK_HPP
+
+#include "cache_line.hpp"
+#include "dynamic_array.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A hardware event counted by `PerfCounters`.
+ */
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    DtlbMisses,
+    BranchMisses,
+};
+
+inline constexpr size_t perfEventCount = 6;
+
+constexpr std::string_view perfEventName(PerfEvent event) noexcept {
+    switch (event) {
+    case PerfEvent::Cycles:
+        return "cycles";
+    case PerfEvent::Instructions:
+        return "instructions";
+    case PerfEvent::L1dMisses:
+        return "L1d misses";
+    case PerfEvent::LlcMisses:
+        return "LLC misses";
+    case PerfEvent::DtlbMisses:
+        return "dTLB misses";
+    case PerfEvent::BranchMisses:
+        return "branch misses";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Counter values of one measurement. An event is empty if it could not be counted.
+ */
+using PerfSample = std::array<std::optional<double>, perfEventCount>;
+
+/**
+ * @brief User-space hardware counters of the calling thread, read through Linux `perf_event_open`.
+ * Each event is opened on its own rather than as a group, so that an event the CPU, the kernel or
+ * a container sandbox refuses only drops that event; when the kernel multiplexes counters, values
+ * are scaled by the fraction of time they ran. On other systems, or when perf events are disabled
+ * (e.g. `perf_event_paranoid` or a seccomp profile), every event is unavailable and samples are empty.
+ */
+class PerfCounters {
+private:
+    std::array<int, perfEventCount> _descriptors;
+
+public:
+    PerfCounters() noexcept {
+        _descriptors.fill(-1);
+#if defined(__linux__)
+        for (size_t i = 0; i < perfEventCount; ++i) {
+            _descriptors[i] = open(static_cast<PerfEvent>(i));
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() noexcept {
+#if defined(__linux__)
+        for (int descriptor : _descriptors) {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Returns true if `event` is being counted.
+     */
+    bool available(PerfEvent event) const noexcept {
+        return _descriptors[static_cast<size_t>(event)] >= 0;
+    }
+
+    /**
+     * @brief Returns true if any event is being counted.
+     */
+    bool anyAvailable() const noexcept {
+        for (size_t i = 0; i < perfEventCount; ++i) {
+            if (available(static_cast<PerfEvent>(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Resets and starts all counters.
+     */
+    void start() noexcept {
+#if defined(__linux__)
+        for (int descriptor : _descriptors) {
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Stops all counters and returns the counts since `start()`.
+     */
+    PerfSample stop() noexcept {
+        PerfSample sample;
+#if defined(__linux__)
+        for (int descriptor : _descriptors) {
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (size_t i = 0; i < perfEventCount; ++i) {
+            // With both time formats set the kernel reports {value, time enabled, time running}.
+            uint64_t values[3];
+            if (_descriptors[i] < 0 || read(_descriptors[i], values, sizeof(values)) != sizeof(values) || values[2] == 0) {
+                continue;
+            }
+            sample[i] = static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+        }
+#endif
+        return sample;
+    }
+
+private:
+#if defined(__linux__)
+    static int open(PerfEvent event) noexcept {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        constexpr uint64_t readMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        switch (event) {
+        case PerfEvent::Cycles:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::Instructions:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::L1dMisses:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_L1D | readMiss;
+            break;
+        case PerfEvent::LlcMisses:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_LL | readMiss;
+            break;
+        case PerfEvent::DtlbMisses:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_DTLB | readMiss;
+            break;
+        case PerfEvent::BranchMisses:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        }
+        long descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        return static_cast<int>(descriptor);
+    }
+#endif
+};
+
+/**
+ * @brief Pins the calling thread to `cpu`, so that counters and caches belong to a single core.
+ * @return `false` if pinning is not supported (e.g. macOS) or the CPU is not available to the process.
+ */
+inline bool pinThreadToCpu(int cpu) noexcept {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+enum class CacheMode : uint8_t {
+    Warm, // One untimed run first; every measured run starts with the working set cached.
+    Cold, // Caches are flushed by streaming through a large buffer before every measured run.
+};
+
+struct BenchmarkOptions {
+    size_t repetitions = 10;
+    CacheMode cacheMode = CacheMode::Warm;
+    int cpu = -1; // Pin to this CPU; negative leaves the thread unpinned.
+    size_t evictionBytes = 64 * 1024 * 1024; // Should exceed the last-level cache.
+};
+
+/**
+ * @brief Averages of one benchmark, normalized per operation.
+ */
+struct BenchmarkResult {
+    std::string name;
+    double nanoseconds = 0;
+    PerfSample counters;
+
+    std::optional<double> perOperation(PerfEvent event) const noexcept {
+        return counters[static_cast<size_t>(event)];
+    }
+};
+
+/**
+ * @brief Runs operations under `PerfCounters` and reports wall time and counters per operation.
+ * Usage: `bench.run("push", n, setup, body)`, where `setup()` builds fresh state outside of the
+ * measurement and `body(state)` performs `n` operations on it; then `bench.print()`.
+ */
+class PerfBenchmark {
+private:
+    BenchmarkOptions _options;
+    PerfCounters _counters;
+    DArray<BenchmarkResult> _results;
+    DArray<std::byte> _evictionBuffer;
+    bool _pinned = false;
+
+public:
+    /**
+     * @throws std::invalid_argument If `options.repetitions` is 0.
+     * @throws std::bad_alloc If the eviction buffer cannot be allocated.
+     */
+    explicit PerfBenchmark(BenchmarkOptions options = {})
+        : _options(options) {
+        if (_options.repetitions == 0) {
+            throw std::invalid_argument("A benchmark needs at least one repetition");
+        }
+        if (_options.cpu >= 0) {
+            _pinned = pinThreadToCpu(_options.cpu);
+        }
+        if (_options.cacheMode == CacheMode::Cold) {
+            _evictionBuffer = DArray<std::byte>(_options.evictionBytes);
+        }
+    }
+
+    /**
+     * @brief Measures `body(setup())` over the configured number of repetitions.
+     * @param operations The number of operations one call of `body` performs; results are divided by it.
+     */
+    template <typename SetupT, typename BodyT>
+    const BenchmarkResult& run(std::string name, size_t operations, SetupT setup, BodyT body) {
+        if (_options.cacheMode == CacheMode::Warm) {
+            auto state = setup();
+            body(state);
+        }
+        BenchmarkResult result{std::move(name)};
+        std::chrono::nanoseconds elapsed{0};
+        for (size_t r = 0; r < _options.repetitions; ++r) {
+            auto state = setup();
+            if (_options.cacheMode == CacheMode::Cold) {
+                evictCaches();
+            }
+            // The clock is read inside the counting window, so the ioctls are not timed.
+            _counters.start();
+            auto start = std::chrono::steady_clock::now();
+            body(state);
+            auto end = std::chrono::steady_clock::now();
+            PerfSample sample = _counters.stop();
+            elapsed += end - start;
+            for (size_t i = 0; i < perfEventCount; ++i) {
+                if (sample[i]) {
+                    result.counters[i] = result.counters[i].value_or(0) + *sample[i];
+                }
+            }
+        }
+        double divisor = static_cast<double>(_options.repetitions) * static_cast<double>(operations);
+        result.nanoseconds = static_cast<double>(elapsed.count()) / divisor;
+        for (std::optional<double>& counter : result.counters) {
+            if (counter) {
+                *counter /= divisor;
+            }
+        }
+        _results.push(std::move(result));
+        return _results.back();
+    }
+
+    /**
+     * @brief Measures `body()`, which needs no fresh state between repetitions.
+     */
+    template <typename BodyT>
+    const BenchmarkResult& run(std::string name, size_t operations, BodyT body) {
+        return run(std::move(name), operations, [] { return 0; }, [&](int) { body(); });
+    }
+
+    const DArray<BenchmarkResult>& results() const noexcept {
+        return _results;
+    }
+
+    const PerfCounters& counters() const noexcept {
+        return _counters;
+    }
+
+    /**
+     * @brief Prints a table of the results. Unavailable counters are shown as `-`.
+     */
+    void print() const {
+        std::println("cache: {}, cpu: {}, counters: {}",
+                     _options.cacheMode == CacheMode::Warm ? "warm" : "cold",
+                     _pinned ? std::to_string(_options.cpu) : "unpinned",
+                     _counters.anyAvailable() ? "perf_event_open" : "unavailable, wall time only");
+        std::print("{:<24} {:>10}", "per operation", "ns");
+        for (size_t i = 0; i < perfEventCount; ++i) {
+            std::print(" {:>13}", perfEventName(static_cast<PerfEvent>(i)));
+        }
+        std::println(" {:>6}", "IPC");
+        for (const BenchmarkResult& result : _results) {
+            std::print("{:<24} {:>10.2f}", result.name, result.nanoseconds);
+            for (const std::optional<double>& counter : result.counters) {
+                std::print(" {:>13}", counter ? std::format("{:.2f}", *counter) : "-");
+            }
+            std::optional<double> cycles = result.perOperation(PerfEvent::Cycles);
+            std::optional<double> instructions = result.perOperation(PerfEvent::Instructions);
+            std::println(" {:>6}", cycles && instructions && *cycles > 0 ? std::format("{:.2f}", *instructions / *cycles) : "-");
+        }
+    }
+
+private:
+    void evictCaches() noexcept {
+        // One store per line of a buffer larger than the last-level cache displaces the working set.
+        volatile std::byte* data = _evictionBuffer.data();
+        for (size_t i = 0; i < _evictionBuffer.size(); i += cacheLineSize) {
+            data[i] = static_cast<std::byte>(i);
+        }
+    }
+};
+
+#endif // PERF_BENCHMARK_HPP
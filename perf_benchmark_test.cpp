@@ -0,0 +1,91 @@
+#include "perf_benchmark.hpp"
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+uint64_t spin(uint64_t iterations) {
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+} // namespace
+
+// Test that every event is either counted or reported as missing, never both
+TEST(PerfBenchmarkTest, CountersOrFallback) {
+    PerfCounters counters;
+
+    counters.start();
+    spin(100000);
+    PerfSample sample = counters.stop();
+
+    for (size_t i = 0; i < perfEventCount; ++i) {
+        auto event = static_cast<PerfEvent>(i);
+        SCOPED_TRACE(perfEventName(event));
+        if (!counters.available(event)) {
+            EXPECT_FALSE(sample[i].has_value());
+        }
+    }
+    if (sample[static_cast<size_t>(PerfEvent::Instructions)]) {
+        EXPECT_GT(*sample[static_cast<size_t>(PerfEvent::Instructions)], 100000);
+    }
+}
+
+// Test thread pinning
+TEST(PerfBenchmarkTest, Pinning) {
+    EXPECT_FALSE(pinThreadToCpu(-1));
+#if defined(__linux__)
+    cpu_set_t original;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(original), &original), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &original)) {
+        ++cpu;
+    }
+    EXPECT_TRUE(pinThreadToCpu(cpu));
+    EXPECT_EQ(sched_getcpu(), cpu);
+    sched_setaffinity(0, sizeof(original), &original);
+#endif
+}
+
+// Test that warm runs do one untimed pass and every repetition gets fresh state
+TEST(PerfBenchmarkTest, WarmRun) {
+    PerfBenchmark bench({.repetitions = 4});
+    int setups = 0;
+    int bodies = 0;
+
+    const BenchmarkResult& result = bench.run("spin", 1000, [&] { return ++setups; }, [&](int& state) {
+        EXPECT_EQ(state, setups);
+        ++bodies;
+        spin(1000);
+    });
+
+    EXPECT_EQ(setups, 5);
+    EXPECT_EQ(bodies, 5);
+    EXPECT_EQ(result.name, "spin");
+    EXPECT_GT(result.nanoseconds, 0);
+    for (size_t i = 0; i < perfEventCount; ++i) {
+        EXPECT_EQ(result.counters[i].has_value(), bench.counters().available(static_cast<PerfEvent>(i)));
+    }
+    EXPECT_EQ(bench.results().size(), 1);
+}
+
+// Test that cold runs skip the warm-up pass
+TEST(PerfBenchmarkTest, ColdRun) {
+    PerfBenchmark bench({.repetitions = 2, .cacheMode = CacheMode::Cold, .evictionBytes = 1 << 20});
+    int bodies = 0;
+
+    bench.run("spin", 1, [&] { ++bodies; });
+
+    EXPECT_EQ(bodies, 2);
+}
+
+// Test that a benchmark without repetitions is rejected
+TEST(PerfBenchmarkTest, ZeroRepetitions) {
+    EXPECT_THROW(PerfBenchmark({.repetitions = 0}), std::invalid_argument);
+}
@@ -0,0 +1,497 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "dynamic_array.hpp"
+#include "mpmc_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+class ThreadPool;
+
+/**
+ * @brief A pipeline stage: a coroutine that is started by `ThreadPool::spawn` and runs to completion
+ * on the pool's threads, suspending whenever it waits on a `Channel`.
+ * The frame destroys itself when the coroutine finishes.
+ */
+class Stage {
+public:
+    struct promise_type {
+        ThreadPool* pool = nullptr;
+
+        Stage get_return_object() noexcept {
+            return Stage(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept;
+    };
+
+private:
+    std::coroutine_handle<promise_type> _handle;
+
+public:
+    Stage(Stage&& other) noexcept
+        : _handle(std::exchange(other._handle, nullptr)) {}
+
+    Stage(const Stage&) = delete;
+
+    Stage& operator=(const Stage&) = delete;
+
+    /**
+     * @brief Destroys the coroutine if it was never spawned.
+     */
+    ~Stage() noexcept {
+        if (_handle) {
+            _handle.destroy();
+        }
+    }
+
+private:
+    explicit Stage(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle(handle) {}
+
+    friend class ThreadPool;
+};
+
+/**
+ * @brief A fixed set of worker threads that resume coroutines.
+ * Ready coroutines are queued in a bounded `MpmcQueue`. Every spawned stage is in the queue at most
+ * once, so the queue can never fill up as long as no more than `maxStages` stages are alive.
+ */
+class ThreadPool {
+private:
+    MpmcQueue<std::coroutine_handle<>> _ready;
+    DArray<std::thread> _threads;
+    size_t _maxStages;
+    std::atomic<size_t> _running = 0;
+    std::mutex _errorMutex;
+    std::exception_ptr _error;
+
+public:
+    /**
+     * @brief Starts `threadCount` worker threads (at least one).
+     * @param maxStages The maximum number of stages that may be alive at the same time.
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws std::system_error If a thread cannot be started.
+     */
+    explicit ThreadPool(size_t threadCount, size_t maxStages = 64)
+        : _ready(maxStages + std::max<size_t>(threadCount, 1))
+        , _maxStages(maxStages) {
+        threadCount = std::max<size_t>(threadCount, 1);
+        _threads.reserve(threadCount);
+        try {
+            for (size_t i = 0; i < threadCount; ++i) {
+                _threads.emplaceAtEnd([this] { work(); });
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Stops and joins the worker threads. Call `wait()` first: stages that have not
+     * finished by now are never resumed again.
+     */
+    ~ThreadPool() noexcept {
+        stop();
+    }
+
+    size_t threadCount() const noexcept {
+        return _threads.size();
+    }
+
+    /**
+     * @brief Starts `stage` on the pool.
+     * @throws std::length_error If `maxStages` stages are already running (the stage is destroyed).
+     */
+    void spawn(Stage stage) {
+        if (_running.fetch_add(1, std::memory_order_relaxed) >= _maxStages) {
+            _running.fetch_sub(1, std::memory_order_relaxed);
+            throw std::length_error("Too many stages");
+        }
+        std::coroutine_handle<Stage::promise_type> handle = std::exchange(stage._handle, nullptr);
+        handle.promise().pool = this;
+        schedule(handle);
+    }
+
+    /**
+     * @brief Queues a suspended coroutine to be resumed on one of the worker threads.
+     */
+    void schedule(std::coroutine_handle<> handle) noexcept {
+        _ready.push(handle);
+    }
+
+    /**
+     * @brief Blocks until all spawned stages have finished.
+     * @throws The first exception that escaped from a stage, if any.
+     */
+    void wait() {
+        for (size_t running; (running = _running.load(std::memory_order_acquire)) != 0;) {
+            _running.wait(running, std::memory_order_acquire);
+        }
+        std::lock_guard lock(_errorMutex);
+        if (_error) {
+            std::rethrow_exception(std::exchange(_error, nullptr));
+        }
+    }
+
+private:
+    void work() noexcept {
+        for (;;) {
+            std::coroutine_handle<> handle;
+            _ready.pop(handle);
+            if (!handle) {
+                return;
+            }
+            handle.resume();
+        }
+    }
+
+    void stop() noexcept {
+        for (size_t i = 0; i < _threads.size(); ++i) {
+            _ready.push(std::coroutine_handle<>());
+        }
+        for (std::thread& thread : _threads) {
+            thread.join();
+        }
+        _threads.clear();
+    }
+
+    void stageFinished() noexcept {
+        if (_running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _running.notify_all();
+        }
+    }
+
+    void stageFailed(std::exception_ptr error) noexcept {
+        std::lock_guard lock(_errorMutex);
+        if (!_error) {
+            _error = std::move(error);
+        }
+    }
+
+    friend class Stage;
+};
+
+inline void Stage::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+    ThreadPool* pool = handle.promise().pool;
+    handle.destroy();
+    pool->stageFinished();
+}
+
+inline void Stage::promise_type::unhandled_exception() noexcept {
+    pool->stageFailed(std::current_exception());
+}
+
+/**
+ * @brief A bounded channel between pipeline stages.
+ * `co_await send(value)` suspends the sender while the channel is full (backpressure) and
+ * `co_await receive()` suspends the receiver while it is empty. Values are moved, never copied.
+ * Suspended stages are kept in intrusive lists inside their own frames and are resumed through
+ * the pool, so neither waiting nor waking allocates.
+ * @tparam ElementT The type of values passed, typically a `DArray` batch. Must be nothrow move constructible.
+ */
+template <typename ElementT>
+    requires std::is_nothrow_move_constructible_v<ElementT>
+class Channel {
+public:
+    class SendAwaiter {
+    private:
+        Channel& _channel;
+        ElementT _value;
+        bool _sent = false;
+        std::coroutine_handle<> _handle;
+        SendAwaiter* _next = nullptr;
+
+    public:
+        SendAwaiter(Channel& channel, ElementT&& value) noexcept
+            : _channel(channel)
+            , _value(std::move(value)) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            std::lock_guard lock(_channel._mutex);
+            if (_channel._closed) {
+                return false;
+            }
+            if (ReceiveAwaiter* receiver = _channel._receivers.pop()) {
+                receiver->_value.emplace(std::move(_value));
+                _channel._pool.schedule(receiver->_handle);
+                _sent = true;
+                return false;
+            }
+            if (_channel._size < _channel._slots.size()) {
+                _channel.pushSlot(std::move(_value));
+                _sent = true;
+                return false;
+            }
+            _handle = handle;
+            _channel._senders.push(this);
+            return true;
+        }
+
+        /**
+         * @return `true` if the value was sent, `false` if the channel was closed.
+         */
+        bool await_resume() const noexcept {
+            return _sent;
+        }
+
+        friend class Channel;
+    };
+
+    class ReceiveAwaiter {
+    private:
+        Channel& _channel;
+        std::optional<ElementT> _value;
+        std::coroutine_handle<> _handle;
+        ReceiveAwaiter* _next = nullptr;
+
+    public:
+        explicit ReceiveAwaiter(Channel& channel) noexcept
+            : _channel(channel) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            std::lock_guard lock(_channel._mutex);
+            if (_channel._size > 0) {
+                _value.emplace(_channel.popSlot());
+                if (SendAwaiter* sender = _channel._senders.pop()) {
+                    _channel.pushSlot(std::move(sender->_value));
+                    sender->_sent = true;
+                    _channel._pool.schedule(sender->_handle);
+                }
+                return false;
+            }
+            if (_channel._closed) {
+                return false;
+            }
+            _handle = handle;
+            _channel._receivers.push(this);
+            return true;
+        }
+
+        /**
+         * @return The received value, or `std::nullopt` once the channel is closed and drained.
+         */
+        std::optional<ElementT> await_resume() noexcept {
+            return std::move(_value);
+        }
+
+        friend class Channel;
+    };
+
+private:
+    template <typename AwaiterT>
+    struct WaitList {
+        AwaiterT* head = nullptr;
+        AwaiterT* tail = nullptr;
+
+        void push(AwaiterT* awaiter) noexcept {
+            if (tail != nullptr) {
+                tail->_next = awaiter;
+            } else {
+                head = awaiter;
+            }
+            tail = awaiter;
+        }
+
+        AwaiterT* pop() noexcept {
+            AwaiterT* awaiter = head;
+            if (awaiter != nullptr) {
+                head = awaiter->_next;
+                if (head == nullptr) {
+                    tail = nullptr;
+                }
+            }
+            return awaiter;
+        }
+    };
+
+    ThreadPool& _pool;
+    std::mutex _mutex;
+    DArray<std::optional<ElementT>> _slots;
+    size_t _head = 0;
+    size_t _size = 0;
+    bool _closed = false;
+    WaitList<SendAwaiter> _senders;
+    WaitList<ReceiveAwaiter> _receivers;
+
+public:
+    /**
+     * @brief Constructs an empty channel.
+     * @param pool The pool that resumes stages woken by the channel.
+     * @param capacity The number of values buffered before senders are suspended (at least 1).
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    Channel(ThreadPool& pool, size_t capacity)
+        : _pool(pool)
+        , _slots(std::max<size_t>(capacity, 1)) {}
+
+    Channel(const Channel&) = delete;
+
+    Channel& operator=(const Channel&) = delete;
+
+    size_t capacity() const noexcept {
+        return _slots.size();
+    }
+
+    /**
+     * @brief Sends `value`, suspending while the channel is full. Use as `co_await channel.send(...)`.
+     */
+    SendAwaiter send(ElementT value) noexcept {
+        return SendAwaiter(*this, std::move(value));
+    }
+
+    /**
+     * @brief Receives the next value, suspending while the channel is empty. Use as `co_await channel.receive()`.
+     */
+    ReceiveAwaiter receive() noexcept {
+        return ReceiveAwaiter(*this);
+    }
+
+    /**
+     * @brief Closes the channel. Buffered values can still be received; after that receivers get
+     * `std::nullopt`. Suspended and later senders fail.
+     */
+    void close() noexcept {
+        std::lock_guard lock(_mutex);
+        _closed = true;
+        while (ReceiveAwaiter* receiver = _receivers.pop()) {
+            _pool.schedule(receiver->_handle);
+        }
+        while (SendAwaiter* sender = _senders.pop()) {
+            _pool.schedule(sender->_handle);
+        }
+    }
+
+private:
+    void pushSlot(ElementT&& value) noexcept {
+        _slots[(_head + _size) % _slots.size()].emplace(std::move(value));
+        ++_size;
+    }
+
+    ElementT popSlot() noexcept {
+        std::optional<ElementT>& slot = _slots[_head];
+        ElementT value = std::move(*slot);
+        slot.reset();
+        _head = (_head + 1) % _slots.size();
+        --_size;
+        return value;
+    }
+};
+
+/**
+ * @brief A thread-safe pool of reusable `DArray` batches.
+ * Buffers come out empty with at least `batchCapacity` reserved and go back in cleared but with
+ * their storage intact, so once the pool is warm, producing and consuming batches does not allocate.
+ * @tparam ElementT The element type of the batches.
+ */
+template <typename ElementT>
+class BufferPool {
+private:
+    std::mutex _mutex;
+    DArray<DArray<ElementT>> _free;
+    size_t _batchCapacity;
+
+public:
+    /**
+     * @brief Pre-allocates `bufferCount` buffers with room for `batchCapacity` elements each.
+     * At most `bufferCount` buffers are kept; extra released buffers are freed.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    BufferPool(size_t batchCapacity, size_t bufferCount)
+        : _batchCapacity(batchCapacity) {
+        _free.reserve(bufferCount);
+        for (size_t i = 0; i < bufferCount; ++i) {
+            _free.push(makeBuffer());
+        }
+    }
+
+    size_t batchCapacity() const noexcept {
+        return _batchCapacity;
+    }
+
+    /**
+     * @brief Returns the number of buffers currently in the pool.
+     */
+    size_t available() {
+        std::lock_guard lock(_mutex);
+        return _free.size();
+    }
+
+    /**
+     * @brief Takes an empty buffer from the pool, allocating a new one only if the pool is empty.
+     * @throws std::bad_alloc If a new buffer has to be allocated and allocation fails.
+     */
+    DArray<ElementT> acquire() {
+        {
+            std::lock_guard lock(_mutex);
+            if (!_free.empty()) {
+                DArray<ElementT> buffer = std::move(_free.back());
+                _free.pop();
+                return buffer;
+            }
+        }
+        return makeBuffer();
+    }
+
+    /**
+     * @brief Clears `buffer` and returns it to the pool.
+     */
+    void release(DArray<ElementT>&& buffer) noexcept {
+        buffer.clear();
+        std::lock_guard lock(_mutex);
+        if (_free.size() < _free.capacity()) {
+            _free.push(std::move(buffer));
+        }
+    }
+
+private:
+    DArray<ElementT> makeBuffer() {
+        DArray<ElementT> buffer;
+        buffer.reserve(_batchCapacity);
+        return buffer;
+    }
+};
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,74 @@
+#include "pipeline.hpp"
+#include <charconv>
+#include <chrono>
+#include <print>
+#include <string>
+
+namespace {
+
+constexpr size_t batchSize = 4096;
+constexpr int batchCount = 2000;
+
+// parse: turns text records into integers, one batch at a time.
+Stage parse(Channel<DArray<int>>& out, BufferPool<int>& buffers) {
+    std::string record;
+    for (int b = 0; b < batchCount; ++b) {
+        DArray<int> batch = buffers.acquire();
+        for (size_t i = 0; i < batchSize; ++i) {
+            record = std::to_string((b * batchSize + i) % 10007);
+            int value = 0;
+            std::from_chars(record.data(), record.data() + record.size(), value);
+            batch.push(value);
+        }
+        co_await out.send(std::move(batch));
+    }
+    out.close();
+}
+
+// filter: keeps values divisible by 3, reusing the incoming batch in place.
+Stage filter(Channel<DArray<int>>& in, Channel<DArray<int>>& out) {
+    while (std::optional<DArray<int>> batch = co_await in.receive()) {
+        size_t kept = 0;
+        for (int value : *batch) {
+            (*batch)[kept] = value;
+            kept += value % 3 == 0;
+        }
+        batch->erase(batch->begin() + kept, batch->end());
+        co_await out.send(std::move(*batch));
+    }
+    out.close();
+}
+
+// aggregate: sums everything and hands the buffers back to the pool.
+Stage aggregate(Channel<DArray<int>>& in, BufferPool<int>& buffers, long long& sum, long long& count) {
+    while (std::optional<DArray<int>> batch = co_await in.receive()) {
+        for (int value : *batch) {
+            sum += value;
+        }
+        count += static_cast<long long>(batch->size());
+        buffers.release(std::move(*batch));
+    }
+}
+
+} // namespace
+
+int main() {
+    ThreadPool pool(3);
+    BufferPool<int> buffers(batchSize, 8);
+    Channel<DArray<int>> parsed(pool, 2);
+    Channel<DArray<int>> filtered(pool, 2);
+    long long sum = 0;
+    long long count = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    pool.spawn(parse(parsed, buffers));
+    pool.spawn(filter(parsed, filtered));
+    pool.spawn(aggregate(filtered, buffers, sum, count));
+    pool.wait();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    double records = static_cast<double>(batchCount) * batchSize;
+    std::println("{} records in {:.3f} s ({:.1f} M records/s)", records, elapsed.count(), records / elapsed.count() / 1e6);
+    std::println("kept {} values, sum {}", count, sum);
+    std::println("buffers back in the pool: {} of 8", buffers.available());
+}
@@ -0,0 +1,160 @@
+#include "pipeline.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+Stage produce(Channel<int>& out, int count) {
+    for (int i = 0; i < count; ++i) {
+        co_await out.send(i);
+    }
+    out.close();
+}
+
+Stage consume(Channel<int>& in, std::atomic<long>& sum) {
+    while (std::optional<int> value = co_await in.receive()) {
+        sum += *value;
+    }
+}
+
+Stage generate(Channel<DArray<int>>& out, BufferPool<int>& buffers, int batches) {
+    for (int b = 0; b < batches; ++b) {
+        DArray<int> batch = buffers.acquire();
+        for (int i = 0; i < static_cast<int>(buffers.batchCapacity()); ++i) {
+            batch.push(i);
+        }
+        co_await out.send(std::move(batch));
+    }
+    out.close();
+}
+
+Stage keepEven(Channel<DArray<int>>& in, Channel<DArray<int>>& out, BufferPool<int>& buffers) {
+    while (std::optional<DArray<int>> batch = co_await in.receive()) {
+        DArray<int> filtered = buffers.acquire();
+        for (int value : *batch) {
+            if (value % 2 == 0) {
+                filtered.push(value);
+            }
+        }
+        buffers.release(std::move(*batch));
+        co_await out.send(std::move(filtered));
+    }
+    out.close();
+}
+
+Stage aggregate(Channel<DArray<int>>& in, BufferPool<int>& buffers, long& sum) {
+    while (std::optional<DArray<int>> batch = co_await in.receive()) {
+        sum += std::accumulate(batch->begin(), batch->end(), 0L);
+        buffers.release(std::move(*batch));
+    }
+}
+
+Stage fail() {
+    throw std::runtime_error("stage failed");
+    co_return;
+}
+
+Stage sendAfterClose(Channel<int>& channel, bool& sent) {
+    channel.close();
+    sent = co_await channel.send(1);
+}
+
+} // namespace
+
+// Test that a capacity-one channel applies backpressure without losing values
+TEST(PipelineTest, ProducerConsumer) {
+    ThreadPool pool(1);
+    Channel<int> channel(pool, 1);
+    std::atomic<long> sum = 0;
+
+    pool.spawn(consume(channel, sum));
+    pool.spawn(produce(channel, 10000));
+    pool.wait();
+
+    EXPECT_EQ(sum, 9999L * 10000 / 2);
+}
+
+// Test several consumers draining one channel on several threads
+TEST(PipelineTest, FanOut) {
+    ThreadPool pool(4);
+    Channel<int> channel(pool, 8);
+    std::atomic<long> sum = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        pool.spawn(consume(channel, sum));
+    }
+    pool.spawn(produce(channel, 100000));
+    pool.wait();
+
+    EXPECT_EQ(sum, 99999L * 100000 / 2);
+}
+
+// Test a three-stage batch pipeline that recycles its buffers
+TEST(PipelineTest, BatchPipeline) {
+    ThreadPool pool(2);
+    BufferPool<int> buffers(256, 8);
+    Channel<DArray<int>> raw(pool, 2);
+    Channel<DArray<int>> even(pool, 2);
+    long sum = 0;
+
+    pool.spawn(generate(raw, buffers, 1000));
+    pool.spawn(keepEven(raw, even, buffers));
+    pool.spawn(aggregate(even, buffers, sum));
+    pool.wait();
+
+    EXPECT_EQ(sum, 1000L * (254 * 128 / 2));
+    EXPECT_EQ(buffers.available(), 8);
+}
+
+// Test that buffers come back cleared with their capacity
+TEST(PipelineTest, BufferPool) {
+    BufferPool<int> buffers(16, 1);
+    DArray<int> buffer = buffers.acquire();
+    const int* storage = buffer.data();
+    buffer.push(1);
+
+    buffers.release(std::move(buffer));
+    DArray<int> reused = buffers.acquire();
+
+    EXPECT_TRUE(reused.empty());
+    EXPECT_EQ(reused.capacity(), 16);
+    EXPECT_EQ(reused.data(), storage);
+    EXPECT_EQ(buffers.available(), 0);
+    EXPECT_EQ(buffers.acquire().capacity(), 16);
+}
+
+// Test that exceptions escaping from a stage are rethrown by wait()
+TEST(PipelineTest, StageException) {
+    ThreadPool pool(1);
+
+    pool.spawn(fail());
+
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    EXPECT_NO_THROW(pool.wait());
+}
+
+// Test that sending on a closed channel fails
+TEST(PipelineTest, SendAfterClose) {
+    ThreadPool pool(1);
+    Channel<int> channel(pool, 1);
+    bool sent = true;
+
+    pool.spawn(sendAfterClose(channel, sent));
+    pool.wait();
+
+    EXPECT_FALSE(sent);
+}
+
+// Test the limit on concurrently alive stages
+TEST(PipelineTest, TooManyStages) {
+    ThreadPool pool(1, 1);
+    Channel<int> channel(pool, 1);
+    std::atomic<long> sum = 0;
+
+    pool.spawn(consume(channel, sum));
+    EXPECT_THROW(pool.spawn(produce(channel, 1)), std::length_error);
+    channel.close();
+    pool.wait();
+}
@@ -0,0 +1,1281 @@
+#ifndef ROARING_BITMAP_HPP
+#define ROARING_BITMAP_HPP
+
+#include "cpu_dispatch.hpp"
+#include "dynamic_array.hpp"
+#include "exception_guard.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+static_assert(std::endian::native == std::endian::little, "The roaring image format supports little-endian targets only");
+
+/**
+ * @brief A word-by-word operation between two bitsets. `AndNot` keeps the bits of the left
+ * operand that are not in the right one.
+ */
+enum class BitsetOperation : uint8_t {
+    And,
+    Or,
+    Xor,
+    AndNot,
+};
+
+// A container covers the 65536 values that share their upper 16 bits.
+inline constexpr size_t roaringBitsetWords = 1024;
+// Above this many values, a bitset is smaller than a sorted array.
+inline constexpr size_t roaringArrayLimit = 4096;
+
+// Bitset kernels: `out[i] = left[i] op right[i]` over the words of a container, returning the
+// number of bits set in `out`, so that the result is counted in the same pass that writes it.
+
+template <BitsetOperation OperationV>
+constexpr uint64_t applyBitsetOperation(uint64_t left, uint64_t right) noexcept {
+    if constexpr (OperationV == BitsetOperation::And) {
+        return left & right;
+    } else if constexpr (OperationV == BitsetOperation::Or) {
+        return left | right;
+    } else if constexpr (OperationV == BitsetOperation::Xor) {
+        return left ^ right;
+    } else {
+        return left & ~right;
+    }
+}
+
+template <BitsetOperation OperationV>
+uint32_t bitsetLoopScalar(const uint64_t* left, const uint64_t* right, uint64_t* out) noexcept {
+    uint32_t count = 0;
+    for (size_t i = 0; i < roaringBitsetWords; ++i) {
+        out[i] = applyBitsetOperation<OperationV>(left[i], right[i]);
+        count += static_cast<uint32_t>(std::popcount(out[i]));
+    }
+    return count;
+}
+
+inline uint32_t bitsetOperationScalar(BitsetOperation operation, const uint64_t* left, const uint64_t* right, uint64_t* out) noexcept {
+    switch (operation) {
+    case BitsetOperation::And:
+        return bitsetLoopScalar<BitsetOperation::And>(left, right, out);
+    case BitsetOperation::Or:
+        return bitsetLoopScalar<BitsetOperation::Or>(left, right, out);
+    case BitsetOperation::Xor:
+        return bitsetLoopScalar<BitsetOperation::Xor>(left, right, out);
+    case BitsetOperation::AndNot:
+        return bitsetLoopScalar<BitsetOperation::AndNot>(left, right, out);
+    }
+    return 0;
+}
+
+#if defined(__x86_64__)
+
+// Counts bits with two `pshufb` lookups of 4-bit counts per byte, summed into 64-bit lanes by `psadbw`.
+DS_TARGET_AVX2 inline __m256i popcountLanesAvx2(__m256i bytes) {
+    const __m256i counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(counts, _mm256_and_si256(bytes, nibble));
+    __m256i high = _mm256_shuffle_epi8(counts, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+template <BitsetOperation OperationV>
+DS_TARGET_AVX2 inline __m256i applyBitsetOperationAvx2(__m256i left, __m256i right) {
+    if constexpr (OperationV == BitsetOperation::And) {
+        return _mm256_and_si256(left, right);
+    } else if constexpr (OperationV == BitsetOperation::Or) {
+        return _mm256_or_si256(left, right);
+    } else if constexpr (OperationV == BitsetOperation::Xor) {
+        return _mm256_xor_si256(left, right);
+    } else {
+        return _mm256_andnot_si256(right, left);
+    }
+}
+
+template <BitsetOperation OperationV>
+DS_TARGET_AVX2 inline uint32_t bitsetLoopAvx2(const uint64_t* left, const uint64_t* right, uint64_t* out) {
+    __m256i counts = _mm256_setzero_si256();
+    for (size_t i = 0; i < roaringBitsetWords; i += 4) {
+        __m256i word = applyBitsetOperationAvx2<OperationV>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i)),
+                                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), word);
+        counts = _mm256_add_epi64(counts, popcountLanesAvx2(word));
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+    return static_cast<uint32_t>(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+}
+
+DS_TARGET_AVX2 inline uint32_t bitsetOperationAvx2(BitsetOperation operation, const uint64_t* left, const uint64_t* right, uint64_t* out) {
+    switch (operation) {
+    case BitsetOperation::And:
+        return bitsetLoopAvx2<BitsetOperation::And>(left, right, out);
+    case BitsetOperation::Or:
+        return bitsetLoopAvx2<BitsetOperation::Or>(left, right, out);
+    case BitsetOperation::Xor:
+        return bitsetLoopAvx2<BitsetOperation::Xor>(left, right, out);
+    case BitsetOperation::AndNot:
+        return bitsetLoopAvx2<BitsetOperation::AndNot>(left, right, out);
+    }
+    return 0;
+}
+
+// The same lookup on 64-byte vectors; `vpopcntq` would need AVX512_VPOPCNTDQ, which the target lacks.
+DS_TARGET_AVX512 inline __m512i popcountLanesAvx512(__m512i bytes) {
+    const __m512i counts = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i nibble = _mm512_set1_epi8(0x0f);
+    __m512i low = _mm512_shuffle_epi8(counts, _mm512_and_si512(bytes, nibble));
+    __m512i high = _mm512_shuffle_epi8(counts, _mm512_and_si512(_mm512_srli_epi16(bytes, 4), nibble));
+    return _mm512_sad_epu8(_mm512_add_epi8(low, high), _mm512_setzero_si512());
+}
+
+template <BitsetOperation OperationV>
+DS_TARGET_AVX512 inline __m512i applyBitsetOperationAvx512(__m512i left, __m512i right) {
+    if constexpr (OperationV == BitsetOperation::And) {
+        return _mm512_and_si512(left, right);
+    } else if constexpr (OperationV == BitsetOperation::Or) {
+        return _mm512_or_si512(left, right);
+    } else if constexpr (OperationV == BitsetOperation::Xor) {
+        return _mm512_xor_si512(left, right);
+    } else {
+        return _mm512_andnot_si512(right, left);
+    }
+}
+
+template <BitsetOperation OperationV>
+DS_TARGET_AVX512 inline uint32_t bitsetLoopAvx512(const uint64_t* left, const uint64_t* right, uint64_t* out) {
+    __m512i counts = _mm512_setzero_si512();
+    for (size_t i = 0; i < roaringBitsetWords; i += 8) {
+        __m512i word = applyBitsetOperationAvx512<OperationV>(_mm512_loadu_si512(left + i), _mm512_loadu_si512(right + i));
+        _mm512_storeu_si512(out + i, word);
+        counts = _mm512_add_epi64(counts, popcountLanesAvx512(word));
+    }
+    return static_cast<uint32_t>(_mm512_reduce_add_epi64(counts));
+}
+
+DS_TARGET_AVX512 inline uint32_t bitsetOperationAvx512(BitsetOperation operation, const uint64_t* left, const uint64_t* right, uint64_t* out) {
+    switch (operation) {
+    case BitsetOperation::And:
+        return bitsetLoopAvx512<BitsetOperation::And>(left, right, out);
+    case BitsetOperation::Or:
+        return bitsetLoopAvx512<BitsetOperation::Or>(left, right, out);
+    case BitsetOperation::Xor:
+        return bitsetLoopAvx512<BitsetOperation::Xor>(left, right, out);
+    case BitsetOperation::AndNot:
+        return bitsetLoopAvx512<BitsetOperation::AndNot>(left, right, out);
+    }
+    return 0;
+}
+
+#elif defined(__aarch64__)
+
+template <BitsetOperation OperationV>
+inline uint32_t bitsetLoopNeon(const uint64_t* left, const uint64_t* right, uint64_t* out) {
+    uint64x2_t counts = vdupq_n_u64(0);
+    for (size_t i = 0; i < roaringBitsetWords; i += 2) {
+        uint64x2_t a = vld1q_u64(left + i);
+        uint64x2_t b = vld1q_u64(right + i);
+        uint64x2_t word;
+        if constexpr (OperationV == BitsetOperation::And) {
+            word = vandq_u64(a, b);
+        } else if constexpr (OperationV == BitsetOperation::Or) {
+            word = vorrq_u64(a, b);
+        } else if constexpr (OperationV == BitsetOperation::Xor) {
+            word = veorq_u64(a, b);
+        } else {
+            word = vbicq_u64(a, b);
+        }
+        vst1q_u64(out + i, word);
+        counts = vpadalq_u32(counts, vpaddlq_u16(vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u64(word)))));
+    }
+    return static_cast<uint32_t>(vaddvq_u64(counts));
+}
+
+inline uint32_t bitsetOperationNeon(BitsetOperation operation, const uint64_t* left, const uint64_t* right, uint64_t* out) {
+    switch (operation) {
+    case BitsetOperation::And:
+        return bitsetLoopNeon<BitsetOperation::And>(left, right, out);
+    case BitsetOperation::Or:
+        return bitsetLoopNeon<BitsetOperation::Or>(left, right, out);
+    case BitsetOperation::Xor:
+        return bitsetLoopNeon<BitsetOperation::Xor>(left, right, out);
+    case BitsetOperation::AndNot:
+        return bitsetLoopNeon<BitsetOperation::AndNot>(left, right, out);
+    }
+    return 0;
+}
+
+#endif
+
+inline const Dispatched<uint32_t(BitsetOperation, const uint64_t*, const uint64_t*, uint64_t*)> bitsetOperationKernel = {
+    {CpuTarget::Scalar, bitsetOperationScalar},
+#if defined(__x86_64__)
+    {CpuTarget::Avx2, bitsetOperationAvx2},
+    {CpuTarget::Avx512, bitsetOperationAvx512},
+#elif defined(__aarch64__)
+    {CpuTarget::Neon, bitsetOperationNeon},
+#endif
+};
+
+// Intersection kernels for sorted arrays of distinct values. They return the size of the
+// intersection written to `out`, which must have room for `min(leftSize, rightSize) + 8` values:
+// the vector loop stores 8 lanes at a time.
+
+inline size_t intersectSortedScalar(const uint16_t* left, size_t leftSize, const uint16_t* right, size_t rightSize, uint16_t* out) noexcept {
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+    while (i < leftSize && j < rightSize) {
+        if (left[i] < right[j]) {
+            ++i;
+        } else if (right[j] < left[i]) {
+            ++j;
+        } else {
+            out[count++] = left[i];
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+#if defined(__x86_64__)
+
+// `pshufb` masks that move the 16-bit lanes selected by an 8-bit mask to the front.
+inline constexpr auto intersectShuffles = [] {
+    std::array<std::array<uint8_t, 16>, 256> shuffles{};
+    for (size_t mask = 0; mask < 256; ++mask) {
+        size_t position = 0;
+        for (size_t lane = 0; lane < 8; ++lane) {
+            if ((mask >> lane & 1) != 0) {
+                shuffles[mask][position++] = static_cast<uint8_t>(2 * lane);
+                shuffles[mask][position++] = static_cast<uint8_t>(2 * lane + 1);
+            }
+        }
+        for (; position < 16; ++position) {
+            shuffles[mask][position] = 0x80;
+        }
+    }
+    return shuffles;
+}();
+
+// Compares 8 values of each side at once with `pcmpestrm` (explicit lengths, so that zeros are
+// values rather than terminators), then advances the side whose block ends first.
+DS_TARGET_AVX2 inline size_t intersectSortedAvx2(const uint16_t* left, size_t leftSize, const uint16_t* right, size_t rightSize, uint16_t* out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+    while (i + 8 <= leftSize && j + 8 <= rightSize) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + j));
+        __m128i matches = _mm_cmpestrm(b, 8, a, 8, _SIDD_UWORD_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+        auto mask = static_cast<unsigned>(_mm_cvtsi128_si32(matches));
+        __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(intersectShuffles[mask].data()));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(a, shuffle));
+        count += static_cast<size_t>(std::popcount(mask));
+        uint16_t leftLast = left[i + 7];
+        uint16_t rightLast = right[j + 7];
+        i += leftLast <= rightLast ? 8 : 0;
+        j += rightLast <= leftLast ? 8 : 0;
+    }
+    return count + intersectSortedScalar(left + i, leftSize - i, right + j, rightSize - j, out + count);
+}
+
+#endif
+
+inline const Dispatched<size_t(const uint16_t*, size_t, const uint16_t*, size_t, uint16_t*)> intersectSortedKernel = {
+    {CpuTarget::Scalar, intersectSortedScalar},
+#if defined(__x86_64__)
+    {CpuTarget::Avx2, intersectSortedAvx2},
+#endif
+};
+
+/**
+ * @brief How a container stores its values.
+ */
+enum class RoaringContainerKind : uint8_t {
+    // Sorted 16-bit values; at most `roaringArrayLimit` of them.
+    Array,
+    // 65536 bits in `roaringBitsetWords` words.
+    Bitset,
+    // Sorted (start, length - 1) pairs of 16-bit values.
+    Run,
+};
+
+// A borrowed container, either from a `RoaringBitmap` or from a serialized image.
+struct RoaringContainerView {
+    RoaringContainerKind kind = RoaringContainerKind::Array;
+    uint32_t cardinality = 0;
+    // Array values or run pairs.
+    const uint16_t* values = nullptr;
+    size_t valueCount = 0;
+    // Bitset words.
+    const uint64_t* words = nullptr;
+};
+
+struct RoaringContainer {
+    RoaringContainerKind kind = RoaringContainerKind::Array;
+    uint32_t cardinality = 0;
+    DArray<uint16_t> values;
+    DArray<uint64_t> words;
+
+    RoaringContainerView view() const noexcept {
+        return {kind, cardinality, values.data(), values.size(), words.data()};
+    }
+};
+
+template <>
+inline constexpr bool isTriviallyRelocatable<RoaringContainer> = true;
+
+class RoaringView;
+
+/**
+ * @brief A compressed set of 32-bit integers in the Roaring layout: values are grouped by their
+ * upper 16 bits into containers of up to 65536, and each container is a sorted array, a bitset or
+ * a list of runs, whichever is smallest for its values. Sparse chunks cost 2 bytes per value, dense
+ * ones 8 KiB and ranges 4 bytes per run, and set operations go container by container: two bitsets
+ * combine in a vectorized kernel that counts the result as it writes it, two arrays intersect with
+ * `pcmpestrm` (or galloping when one is much smaller), and mixed pairs probe the bitset.
+ * Point updates switch between array and bitset at `roaringArrayLimit`; set operations, `addRange`
+ * and `optimize` also choose runs where they are smaller.
+ */
+class RoaringBitmap {
+    friend class RoaringView;
+
+private:
+    static constexpr uint32_t imageMagic = 0x314d4252; // "RBM1"
+    static constexpr size_t imageHeaderSize = 8;
+    static constexpr size_t descriptorSize = 16;
+
+    // Container keys (the upper 16 bits of their values), ascending.
+    DArray<uint16_t> _keys;
+    DArray<RoaringContainer> _containers;
+
+public:
+    RoaringBitmap() = default;
+
+    /**
+     * @brief Constructs a set of `values`.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    RoaringBitmap(std::initializer_list<uint32_t> values) {
+        for (uint32_t value : values) {
+            add(value);
+        }
+    }
+
+    /**
+     * @brief Returns the number of values, summing the per-container counts.
+     */
+    uint64_t cardinality() const noexcept {
+        uint64_t count = 0;
+        for (const RoaringContainer& container : _containers) {
+            count += container.cardinality;
+        }
+        return count;
+    }
+
+    bool empty() const noexcept {
+        return _containers.empty();
+    }
+
+    size_t containerCount() const noexcept {
+        return _containers.size();
+    }
+
+    /**
+     * @brief Returns how container `index` (in key order) stores its values.
+     */
+    RoaringContainerKind containerKind(size_t index) const noexcept {
+        return _containers[index].kind;
+    }
+
+    bool contains(uint32_t value) const noexcept {
+        size_t index = find(static_cast<uint16_t>(value >> 16));
+        return index != _keys.size() && containsLow(_containers[index].view(), static_cast<uint16_t>(value));
+    }
+
+    /**
+     * @brief Adds `value` to the set.
+     * @return Whether `value` was not a member before.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    bool add(uint32_t value) {
+        auto key = static_cast<uint16_t>(value >> 16);
+        auto low = static_cast<uint16_t>(value);
+        size_t index = lowerBound(key);
+        if (index == _keys.size() || _keys[index] != key) {
+            RoaringContainer container;
+            container.values.push(low);
+            container.cardinality = 1;
+            insertContainer(index, key, std::move(container));
+            return true;
+        }
+        RoaringContainer& container = _containers[index];
+        expandRuns(container);
+        if (container.kind == RoaringContainerKind::Array) {
+            uint16_t* position = std::lower_bound(container.values.begin(), container.values.end(), low);
+            if (position != container.values.end() && *position == low) {
+                return false;
+            }
+            if (container.cardinality < roaringArrayLimit) {
+                container.values.insert(position, low);
+                ++container.cardinality;
+                return true;
+            }
+            convert(container, RoaringContainerKind::Bitset);
+        }
+        uint64_t& word = container.words[low / 64];
+        uint64_t bit = uint64_t{1} << (low % 64);
+        if ((word & bit) != 0) {
+            return false;
+        }
+        word |= bit;
+        ++container.cardinality;
+        return true;
+    }
+
+    /**
+     * @brief Removes `value` from the set.
+     * @return Whether `value` was a member.
+     * @throws std::bad_alloc If memory allocation fails while a run container is expanded.
+     */
+    bool remove(uint32_t value) {
+        size_t index = find(static_cast<uint16_t>(value >> 16));
+        auto low = static_cast<uint16_t>(value);
+        if (index == _keys.size() || !containsLow(_containers[index].view(), low)) {
+            return false;
+        }
+        RoaringContainer& container = _containers[index];
+        expandRuns(container);
+        if (--container.cardinality == 0) {
+            _keys.erase(_keys.begin() + index);
+            _containers.erase(_containers.begin() + index);
+            return true;
+        }
+        if (container.kind == RoaringContainerKind::Array) {
+            container.values.erase(std::lower_bound(container.values.begin(), container.values.end(), low));
+        } else {
+            container.words[low / 64] &= ~(uint64_t{1} << (low % 64));
+            if (container.cardinality <= roaringArrayLimit) {
+                convert(container, RoaringContainerKind::Array);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Adds all values in [first, last). Chunks the range covers entirely become single runs.
+     * @throws std::out_of_range If `first > last` or `last > 2^32`.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    void addRange(uint64_t first, uint64_t last) {
+        if (first > last || last > (uint64_t{1} << 32)) {
+            throw std::out_of_range("Range out of the 32-bit universe");
+        }
+        if (first == last) {
+            return;
+        }
+        for (uint64_t key = first >> 16; key <= (last - 1) >> 16; ++key) {
+            auto low = static_cast<uint32_t>(std::max(first, key << 16) - (key << 16));
+            auto lowEnd = static_cast<uint32_t>(std::min(last, (key + 1) << 16) - (key << 16));
+            size_t index = lowerBound(static_cast<uint16_t>(key));
+            if (index == _keys.size() || _keys[index] != key) {
+                RoaringContainer container{RoaringContainerKind::Run, lowEnd - low, {}, {}};
+                container.values = {static_cast<uint16_t>(low), static_cast<uint16_t>(lowEnd - low - 1)};
+                chooseRepresentation(container);
+                insertContainer(index, static_cast<uint16_t>(key), std::move(container));
+                continue;
+            }
+            RoaringContainer& container = _containers[index];
+            DArray<uint64_t> words = bitsetFrom(container.view());
+            setBitRange(words.data(), low, lowEnd);
+            uint32_t cardinality = countBits(words.data());
+            container = makeBitset(std::move(words), cardinality);
+        }
+    }
+
+    void clear() noexcept {
+        _keys.clear();
+        _containers.clear();
+    }
+
+    /**
+     * @brief Converts every container to its smallest representation, including runs.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    void optimize() {
+        for (RoaringContainer& container : _containers) {
+            chooseRepresentation(container);
+        }
+    }
+
+    /**
+     * @brief Calls `function(value)` for every value in ascending order.
+     */
+    template <typename FunctionT>
+    void forEach(FunctionT function) const {
+        for (size_t i = 0; i < _keys.size(); ++i) {
+            forEachLow(_containers[i].view(), uint32_t{_keys[i]} << 16, function);
+        }
+    }
+
+    /**
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    friend RoaringBitmap operator&(const RoaringBitmap& left, const RoaringBitmap& right) {
+        return combine(BitsetOperation::And, left, right);
+    }
+
+    friend RoaringBitmap operator|(const RoaringBitmap& left, const RoaringBitmap& right) {
+        return combine(BitsetOperation::Or, left, right);
+    }
+
+    friend RoaringBitmap operator^(const RoaringBitmap& left, const RoaringBitmap& right) {
+        return combine(BitsetOperation::Xor, left, right);
+    }
+
+    /**
+     * @brief Returns the values of `left` that are not in `right`.
+     */
+    friend RoaringBitmap operator-(const RoaringBitmap& left, const RoaringBitmap& right) {
+        return combine(BitsetOperation::AndNot, left, right);
+    }
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other) {
+        return *this = *this & other;
+    }
+
+    RoaringBitmap& operator|=(const RoaringBitmap& other) {
+        return *this = *this | other;
+    }
+
+    RoaringBitmap& operator^=(const RoaringBitmap& other) {
+        return *this = *this ^ other;
+    }
+
+    RoaringBitmap& operator-=(const RoaringBitmap& other) {
+        return *this = *this - other;
+    }
+
+    /**
+     * @brief Compares the values, whatever representation each side chose for them.
+     */
+    friend bool operator==(const RoaringBitmap& left, const RoaringBitmap& right) {
+        if (!std::equal(left._keys.begin(), left._keys.end(), right._keys.begin(), right._keys.end())) {
+            return false;
+        }
+        for (size_t i = 0; i < left._containers.size(); ++i) {
+            if (!equalContainers(left._containers[i].view(), right._containers[i].view())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns the size of the image `serialize` appends.
+     */
+    size_t serializedSize() const noexcept {
+        size_t size = imageHeaderSize + descriptorSize * _containers.size();
+        for (const RoaringContainer& container : _containers) {
+            size = alignPayload(size) + payloadBytes(container.view());
+        }
+        return size;
+    }
+
+    /**
+     * @brief Appends the set as an image that `RoaringView` reads in place, e.g. from a mapped file:
+     * all little endian, a `uint32` magic and container count, then a 16-byte descriptor per
+     * container (`uint16` key, `uint8` kind, a zero byte, `uint32` cardinality, `uint32` payload
+     * element count, `uint32` payload offset from the image start), then the payloads at multiples of
+     * 8 bytes: `uint16` array values or run pairs, or 1024 `uint64` bitset words.
+     * @throws std::length_error If the image would exceed 4 GiB.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    void serialize(DArray<std::byte>& out) const {
+        size_t size = serializedSize();
+        if (size > UINT32_MAX) {
+            throw std::length_error("Roaring image exceeds 4 GiB");
+        }
+        size_t start = out.size();
+        out.resize(start + size);
+        std::byte* image = out.data() + start;
+        auto count = static_cast<uint32_t>(_containers.size());
+        std::memcpy(image, &imageMagic, 4);
+        std::memcpy(image + 4, &count, 4);
+        size_t offset = imageHeaderSize + descriptorSize * _containers.size();
+        for (size_t i = 0; i < _containers.size(); ++i) {
+            RoaringContainerView container = _containers[i].view();
+            offset = alignPayload(offset);
+            std::byte* descriptor = image + imageHeaderSize + descriptorSize * i;
+            auto elements = static_cast<uint32_t>(container.kind == RoaringContainerKind::Bitset ? roaringBitsetWords : container.valueCount);
+            auto payloadOffset = static_cast<uint32_t>(offset);
+            std::memcpy(descriptor, &_keys[i], 2);
+            descriptor[2] = static_cast<std::byte>(container.kind);
+            std::memcpy(descriptor + 4, &container.cardinality, 4);
+            std::memcpy(descriptor + 8, &elements, 4);
+            std::memcpy(descriptor + 12, &payloadOffset, 4);
+            const void* payload = container.kind == RoaringContainerKind::Bitset ? static_cast<const void*>(container.words) : container.values;
+            std::memcpy(image + offset, payload, payloadBytes(container));
+            offset += payloadBytes(container);
+        }
+    }
+
+    /**
+     * @brief Reads an image written by `serialize`. Unlike `RoaringView`, any alignment will do, and
+     * the payloads are checked against their descriptors as well.
+     * @throws std::invalid_argument If the image is malformed.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    static RoaringBitmap deserialize(std::span<const std::byte> image);
+
+private:
+    struct Operand {
+        RoaringContainerView view;
+        DArray<uint16_t> values;
+        DArray<uint64_t> words;
+    };
+
+    size_t lowerBound(uint16_t key) const noexcept {
+        return static_cast<size_t>(std::lower_bound(_keys.begin(), _keys.end(), key) - _keys.begin());
+    }
+
+    // Returns the index of the container for `key`, or the number of containers if there is none.
+    size_t find(uint16_t key) const noexcept {
+        size_t index = lowerBound(key);
+        return index != _keys.size() && _keys[index] == key ? index : _keys.size();
+    }
+
+    void insertContainer(size_t index, uint16_t key, RoaringContainer&& container) {
+        _keys.insert(_keys.begin() + index, key);
+        auto guard = makeExceptionGuard([&] { _keys.erase(_keys.begin() + index); });
+        _containers.insert(_containers.begin() + index, std::move(container));
+        guard.complete();
+    }
+
+    void append(uint16_t key, RoaringContainer&& container) {
+        insertContainer(_keys.size(), key, std::move(container));
+    }
+
+    static size_t alignPayload(size_t offset) noexcept {
+        return (offset + 7) & ~size_t{7};
+    }
+
+    static size_t payloadBytes(const RoaringContainerView& container) noexcept {
+        return container.kind == RoaringContainerKind::Bitset ? roaringBitsetWords * sizeof(uint64_t) : container.valueCount * sizeof(uint16_t);
+    }
+
+    static bool containsLow(const RoaringContainerView& container, uint16_t low) noexcept {
+        switch (container.kind) {
+        case RoaringContainerKind::Array:
+            return std::binary_search(container.values, container.values + container.valueCount, low);
+        case RoaringContainerKind::Bitset:
+            return (container.words[low / 64] >> (low % 64) & 1) != 0;
+        case RoaringContainerKind::Run: {
+            // Find the last run starting at or before `low`.
+            size_t first = 0;
+            size_t count = container.valueCount / 2;
+            while (count > 0) {
+                size_t half = count / 2;
+                if (container.values[2 * (first + half)] <= low) {
+                    first += half + 1;
+                    count -= half + 1;
+                } else {
+                    count = half;
+                }
+            }
+            return first > 0 && low - container.values[2 * first - 2] <= container.values[2 * first - 1];
+        }
+        }
+        return false;
+    }
+
+    template <typename FunctionT>
+    static void forEachLow(const RoaringContainerView& container, uint32_t base, FunctionT& function) {
+        switch (container.kind) {
+        case RoaringContainerKind::Array:
+            for (size_t i = 0; i < container.valueCount; ++i) {
+                function(base | container.values[i]);
+            }
+            break;
+        case RoaringContainerKind::Bitset:
+            for (size_t i = 0; i < roaringBitsetWords; ++i) {
+                for (uint64_t bits = container.words[i]; bits != 0; bits &= bits - 1) {
+                    function(base | static_cast<uint32_t>(i * 64 + static_cast<size_t>(std::countr_zero(bits))));
+                }
+            }
+            break;
+        case RoaringContainerKind::Run:
+            for (size_t i = 0; i < container.valueCount; i += 2) {
+                uint32_t start = container.values[i];
+                for (uint32_t low = start; low <= start + container.values[i + 1]; ++low) {
+                    function(base | low);
+                }
+            }
+            break;
+        }
+    }
+
+    // Sets the bits in [first, last) of a container's words.
+    static void setBitRange(uint64_t* words, uint32_t first, uint32_t last) noexcept {
+        size_t firstWord = first / 64;
+        size_t lastWord = (last - 1) / 64;
+        for (size_t index = firstWord; index <= lastWord; ++index) {
+            uint64_t mask = ~uint64_t{0};
+            if (index == firstWord) {
+                mask &= ~uint64_t{0} << (first % 64);
+            }
+            if (index == lastWord) {
+                mask &= ~uint64_t{0} >> (63 - (last - 1) % 64);
+            }
+            words[index] |= mask;
+        }
+    }
+
+    // Checks a payload from an image against its cardinality, before it becomes a container whose
+    // updates trust both: arrays ascend strictly, runs ascend without overlap and stay below 65536.
+    static void checkPayload(const RoaringContainerView& container) {
+        bool valid = true;
+        switch (container.kind) {
+        case RoaringContainerKind::Array:
+            for (size_t i = 1; valid && i < container.valueCount; ++i) {
+                valid = container.values[i - 1] < container.values[i];
+            }
+            break;
+        case RoaringContainerKind::Bitset:
+            valid = countBits(container.words) == container.cardinality;
+            break;
+        case RoaringContainerKind::Run: {
+            uint64_t cardinality = 0;
+            uint32_t nextStart = 0;
+            for (size_t i = 0; valid && i < container.valueCount; i += 2) {
+                uint32_t last = uint32_t{container.values[i]} + container.values[i + 1];
+                valid = container.values[i] >= nextStart && last <= UINT16_MAX;
+                nextStart = last + 1;
+                cardinality += uint64_t{container.values[i + 1]} + 1;
+            }
+            valid = valid && cardinality == container.cardinality;
+            break;
+        }
+        }
+        if (!valid) {
+            throw std::invalid_argument("Roaring container payload does not match its descriptor");
+        }
+    }
+
+    static uint32_t countBits(const uint64_t* words) noexcept {
+        uint32_t count = 0;
+        for (size_t i = 0; i < roaringBitsetWords; ++i) {
+            count += static_cast<uint32_t>(std::popcount(words[i]));
+        }
+        return count;
+    }
+
+    // Counts maximal runs of consecutive values.
+    static size_t countRuns(const RoaringContainerView& container) noexcept {
+        switch (container.kind) {
+        case RoaringContainerKind::Array: {
+            size_t runs = container.valueCount > 0 ? 1 : 0;
+            for (size_t i = 1; i < container.valueCount; ++i) {
+                runs += container.values[i] != container.values[i - 1] + 1 ? 1 : 0;
+            }
+            return runs;
+        }
+        case RoaringContainerKind::Bitset: {
+            // A run starts at every set bit whose lower neighbour is clear.
+            size_t runs = 0;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < roaringBitsetWords; ++i) {
+                uint64_t word = container.words[i];
+                runs += static_cast<size_t>(std::popcount(word & ~(word << 1 | carry)));
+                carry = word >> 63;
+            }
+            return runs;
+        }
+        case RoaringContainerKind::Run:
+            return container.valueCount / 2;
+        }
+        return 0;
+    }
+
+    static DArray<uint64_t> bitsetFrom(const RoaringContainerView& container) {
+        if (container.kind == RoaringContainerKind::Bitset) {
+            return DArray<uint64_t>(container.words, container.words + roaringBitsetWords);
+        }
+        DArray<uint64_t> words(roaringBitsetWords);
+        if (container.kind == RoaringContainerKind::Array) {
+            for (size_t i = 0; i < container.valueCount; ++i) {
+                words[container.values[i] / 64] |= uint64_t{1} << (container.values[i] % 64);
+            }
+        } else {
+            for (size_t i = 0; i < container.valueCount; i += 2) {
+                setBitRange(words.data(), container.values[i], uint32_t{container.values[i]} + container.values[i + 1] + 1);
+            }
+        }
+        return words;
+    }
+
+    static DArray<uint16_t> arrayFrom(const RoaringContainerView& container) {
+        if (container.kind == RoaringContainerKind::Array) {
+            return DArray<uint16_t>(container.values, container.values + container.valueCount);
+        }
+        DArray<uint16_t> values;
+        values.resizeForOverwrite(container.cardinality);
+        uint16_t* out = values.data();
+        auto write = [&out](uint32_t low) { *out++ = static_cast<uint16_t>(low); };
+        forEachLow(container, 0, write);
+        return values;
+    }
+
+    static DArray<uint16_t> runsFrom(const RoaringContainerView& container) {
+        DArray<uint16_t> runs;
+        runs.reserve(2 * countRuns(container));
+        auto addRun = [&runs](size_t start, size_t end) {
+            runs.push(static_cast<uint16_t>(start));
+            runs.push(static_cast<uint16_t>(end - start - 1));
+        };
+        switch (container.kind) {
+        case RoaringContainerKind::Array:
+            for (size_t i = 0; i < container.valueCount;) {
+                size_t start = i++;
+                while (i < container.valueCount && container.values[i] == container.values[i - 1] + 1) {
+                    ++i;
+                }
+                addRun(container.values[start], size_t{container.values[i - 1]} + 1);
+            }
+            break;
+        case RoaringContainerKind::Bitset: {
+            // Fill the zeros below a run's first bit, then the run's end is the first zero above it.
+            size_t index = 0;
+            uint64_t word = container.words[0];
+            while (true) {
+                while (word == 0) {
+                    if (++index == roaringBitsetWords) {
+                        return runs;
+                    }
+                    word = container.words[index];
+                }
+                size_t start = index * 64 + static_cast<size_t>(std::countr_zero(word));
+                word |= word - 1;
+                while (word == ~uint64_t{0}) {
+                    if (++index == roaringBitsetWords) {
+                        addRun(start, roaringBitsetWords * 64);
+                        return runs;
+                    }
+                    word = container.words[index];
+                }
+                addRun(start, index * 64 + static_cast<size_t>(std::countr_zero(~word)));
+                word &= word + 1;
+            }
+        }
+        case RoaringContainerKind::Run:
+            runs.insert(runs.end(), container.values, container.values + container.valueCount);
+            break;
+        }
+        return runs;
+    }
+
+    static void convert(RoaringContainer& container, RoaringContainerKind kind) {
+        RoaringContainer converted{kind, container.cardinality, {}, {}};
+        if (kind == RoaringContainerKind::Bitset) {
+            converted.words = bitsetFrom(container.view());
+        } else if (kind == RoaringContainerKind::Array) {
+            converted.values = arrayFrom(container.view());
+        } else {
+            converted.values = runsFrom(container.view());
+        }
+        container = std::move(converted);
+    }
+
+    // Turns a run container into an array or a bitset, for point updates.
+    static void expandRuns(RoaringContainer& container) {
+        if (container.kind == RoaringContainerKind::Run) {
+            convert(container, container.cardinality <= roaringArrayLimit ? RoaringContainerKind::Array : RoaringContainerKind::Bitset);
+        }
+    }
+
+    static void chooseRepresentation(RoaringContainer& container) {
+        if (container.cardinality == 0) {
+            return;
+        }
+        size_t plainBytes = container.cardinality <= roaringArrayLimit ? 2 * container.cardinality : roaringBitsetWords * 8;
+        size_t runBytes = 4 * countRuns(container.view());
+        RoaringContainerKind kind = runBytes < plainBytes                          ? RoaringContainerKind::Run
+                                    : container.cardinality <= roaringArrayLimit ? RoaringContainerKind::Array
+                                                                                 : RoaringContainerKind::Bitset;
+        if (kind != container.kind) {
+            convert(container, kind);
+        }
+    }
+
+    static RoaringContainer makeArray(DArray<uint16_t>&& values) {
+        RoaringContainer container{RoaringContainerKind::Array, static_cast<uint32_t>(values.size()), std::move(values), {}};
+        chooseRepresentation(container);
+        return container;
+    }
+
+    static RoaringContainer makeBitset(DArray<uint64_t>&& words, uint32_t cardinality) {
+        RoaringContainer container{RoaringContainerKind::Bitset, cardinality, {}, std::move(words)};
+        chooseRepresentation(container);
+        return container;
+    }
+
+    // Binary operations see runs as the array or bitset they expand to.
+    static Operand operandFrom(const RoaringContainerView& container) {
+        Operand operand{container, {}, {}};
+        if (container.kind != RoaringContainerKind::Run) {
+            return operand;
+        }
+        if (container.cardinality <= roaringArrayLimit) {
+            operand.values = arrayFrom(container);
+            operand.view = {RoaringContainerKind::Array, container.cardinality, operand.values.data(), operand.values.size(), nullptr};
+        } else {
+            operand.words = bitsetFrom(container);
+            operand.view = {RoaringContainerKind::Bitset, container.cardinality, nullptr, 0, operand.words.data()};
+        }
+        return operand;
+    }
+
+    // Intersects a short sorted array with a much longer one by exponential search.
+    static size_t intersectGalloping(const uint16_t* small, size_t smallSize, const uint16_t* large, size_t largeSize, uint16_t* out) noexcept {
+        size_t count = 0;
+        size_t position = 0;
+        for (size_t i = 0; i < smallSize && position < largeSize; ++i) {
+            size_t bound = 1;
+            while (position + bound < largeSize && large[position + bound] < small[i]) {
+                bound *= 2;
+            }
+            position = static_cast<size_t>(std::lower_bound(large + position, large + std::min(position + bound + 1, largeSize), small[i]) - large);
+            if (position < largeSize && large[position] == small[i]) {
+                out[count++] = small[i];
+            }
+        }
+        return count;
+    }
+
+    static RoaringContainer combineArrays(BitsetOperation operation, const RoaringContainerView& left, const RoaringContainerView& right) {
+        const uint16_t* a = left.values;
+        const uint16_t* b = right.values;
+        size_t aSize = left.valueCount;
+        size_t bSize = right.valueCount;
+        DArray<uint16_t> values;
+        if (operation == BitsetOperation::And) {
+            values.resizeForOverwrite(std::min(aSize, bSize) + 8);
+            size_t count = aSize * 64 < bSize   ? intersectGalloping(a, aSize, b, bSize, values.data())
+                           : bSize * 64 < aSize ? intersectGalloping(b, bSize, a, aSize, values.data())
+                                                : intersectSortedKernel(a, aSize, b, bSize, values.data());
+            values.resize(count);
+            return makeArray(std::move(values));
+        }
+        // Values only on the left are always kept.
+        bool keepRight = operation != BitsetOperation::AndNot;
+        bool keepBoth = operation == BitsetOperation::Or;
+        values.resizeForOverwrite(aSize + bSize);
+        size_t i = 0;
+        size_t j = 0;
+        size_t count = 0;
+        while (i < aSize && j < bSize) {
+            if (a[i] < b[j]) {
+                values[count++] = a[i++];
+            } else if (b[j] < a[i]) {
+                values[count] = b[j++];
+                count += keepRight ? 1 : 0;
+            } else {
+                values[count] = a[i++];
+                count += keepBoth ? 1 : 0;
+                ++j;
+            }
+        }
+        for (; i < aSize; ++i) {
+            values[count++] = a[i];
+        }
+        for (; keepRight && j < bSize; ++j) {
+            values[count++] = b[j];
+        }
+        values.resize(count);
+        return makeArray(std::move(values));
+    }
+
+    static RoaringContainer combineMixed(BitsetOperation operation, const RoaringContainerView& left, const RoaringContainerView& right) {
+        bool leftIsArray = left.kind == RoaringContainerKind::Array;
+        const RoaringContainerView& array = leftIsArray ? left : right;
+        const RoaringContainerView& bitset = leftIsArray ? right : left;
+        auto inBitset = [&bitset](uint16_t low) { return (bitset.words[low / 64] >> (low % 64) & 1) != 0; };
+        if (operation == BitsetOperation::And || (operation == BitsetOperation::AndNot && leftIsArray)) {
+            bool keepMembers = operation == BitsetOperation::And;
+            DArray<uint16_t> values;
+            values.resizeForOverwrite(array.valueCount);
+            size_t count = 0;
+            for (size_t i = 0; i < array.valueCount; ++i) {
+                values[count] = array.values[i];
+                count += inBitset(array.values[i]) == keepMembers ? 1 : 0;
+            }
+            values.resize(count);
+            return makeArray(std::move(values));
+        }
+        // The result is the bitset with the array's bits set, flipped or cleared.
+        DArray<uint64_t> words(bitset.words, bitset.words + roaringBitsetWords);
+        uint32_t cardinality = bitset.cardinality;
+        for (size_t i = 0; i < array.valueCount; ++i) {
+            uint16_t low = array.values[i];
+            uint64_t bit = uint64_t{1} << (low % 64);
+            bool present = (words[low / 64] & bit) != 0;
+            if (operation == BitsetOperation::Or) {
+                words[low / 64] |= bit;
+                cardinality += present ? 0 : 1;
+            } else if (operation == BitsetOperation::Xor) {
+                words[low / 64] ^= bit;
+                cardinality = present ? cardinality - 1 : cardinality + 1;
+            } else {
+                words[low / 64] &= ~bit;
+                cardinality -= present ? 1 : 0;
+            }
+        }
+        return makeBitset(std::move(words), cardinality);
+    }
+
+    static RoaringContainer combineContainers(BitsetOperation operation, const RoaringContainerView& left, const RoaringContainerView& right) {
+        Operand a = operandFrom(left);
+        Operand b = operandFrom(right);
+        bool leftIsArray = a.view.kind == RoaringContainerKind::Array;
+        bool rightIsArray = b.view.kind == RoaringContainerKind::Array;
+        if (leftIsArray && rightIsArray) {
+            return combineArrays(operation, a.view, b.view);
+        }
+        if (leftIsArray || rightIsArray) {
+            return combineMixed(operation, a.view, b.view);
+        }
+        DArray<uint64_t> words;
+        words.resizeForOverwrite(roaringBitsetWords);
+        uint32_t cardinality = bitsetOperationKernel(operation, a.view.words, b.view.words, words.data());
+        return makeBitset(std::move(words), cardinality);
+    }
+
+    static RoaringBitmap combine(BitsetOperation operation, const RoaringBitmap& left, const RoaringBitmap& right) {
+        bool keepLeft = operation != BitsetOperation::And;
+        bool keepRight = operation == BitsetOperation::Or || operation == BitsetOperation::Xor;
+        RoaringBitmap result;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < left._keys.size() || j < right._keys.size()) {
+            if (j == right._keys.size() || (i < left._keys.size() && left._keys[i] < right._keys[j])) {
+                if (keepLeft) {
+                    result.append(left._keys[i], RoaringContainer(left._containers[i]));
+                }
+                ++i;
+            } else if (i == left._keys.size() || right._keys[j] < left._keys[i]) {
+                if (keepRight) {
+                    result.append(right._keys[j], RoaringContainer(right._containers[j]));
+                }
+                ++j;
+            } else {
+                RoaringContainer container = combineContainers(operation, left._containers[i].view(), right._containers[j].view());
+                if (container.cardinality > 0) {
+                    result.append(left._keys[i], std::move(container));
+                }
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    static bool equalContainers(const RoaringContainerView& left, const RoaringContainerView& right) {
+        if (left.cardinality != right.cardinality) {
+            return false;
+        }
+        if (left.kind == right.kind && left.kind != RoaringContainerKind::Bitset) {
+            return std::equal(left.values, left.values + left.valueCount, right.values, right.values + right.valueCount);
+        }
+        DArray<uint64_t> a = bitsetFrom(left);
+        DArray<uint64_t> b = bitsetFrom(right);
+        return std::equal(a.begin(), a.end(), b.begin());
+    }
+};
+
+/**
+ * @brief Read-only access to an image written by `RoaringBitmap::serialize`, in place: nothing is
+ * copied, so a mapped file is only paged in where queries touch it. The constructor checks the
+ * header and every descriptor, so no query reads outside the image; payload contents are trusted
+ * (an unsorted array gives wrong answers, not undefined behavior) until `toBitmap` checks them.
+ */
+class RoaringView {
+private:
+    const std::byte* _image = nullptr;
+    size_t _count = 0;
+
+public:
+    RoaringView() = default;
+
+    /**
+     * @throws std::invalid_argument If the image is malformed or not 8-byte aligned.
+     */
+    explicit RoaringView(std::span<const std::byte> image)
+        : _image(image.data()) {
+        if (reinterpret_cast<uintptr_t>(image.data()) % alignof(uint64_t) != 0) {
+            throw std::invalid_argument("Roaring image is not 8-byte aligned");
+        }
+        uint32_t magic = 0;
+        uint32_t count = 0;
+        if (image.size() < RoaringBitmap::imageHeaderSize) {
+            throw std::invalid_argument("Truncated roaring image");
+        }
+        std::memcpy(&magic, _image, 4);
+        std::memcpy(&count, _image + 4, 4);
+        if (magic != RoaringBitmap::imageMagic) {
+            throw std::invalid_argument("Not a roaring image");
+        }
+        if (count > (image.size() - RoaringBitmap::imageHeaderSize) / RoaringBitmap::descriptorSize) {
+            throw std::invalid_argument("Truncated roaring image");
+        }
+        _count = count;
+        for (size_t i = 0; i < _count; ++i) {
+            Descriptor descriptor = descriptorAt(i);
+            if (i > 0 && descriptorAt(i - 1).key >= descriptor.key) {
+                throw std::invalid_argument("Roaring container keys are not ascending");
+            }
+            uint64_t bytes = 0;
+            bool valid = descriptor.cardinality >= 1 && descriptor.cardinality <= 65536 && descriptor.offset % 8 == 0;
+            switch (descriptor.kind) {
+            case RoaringContainerKind::Array:
+                valid = valid && descriptor.elements == descriptor.cardinality;
+                bytes = uint64_t{descriptor.elements} * 2;
+                break;
+            case RoaringContainerKind::Bitset:
+                valid = valid && descriptor.elements == roaringBitsetWords;
+                bytes = uint64_t{descriptor.elements} * 8;
+                break;
+            case RoaringContainerKind::Run:
+                valid = valid && descriptor.elements > 0 && descriptor.elements % 2 == 0;
+                bytes = uint64_t{descriptor.elements} * 2;
+                break;
+            default:
+                valid = false;
+            }
+            if (!valid || descriptor.offset + bytes > image.size()) {
+                throw std::invalid_argument("Malformed roaring container");
+            }
+        }
+    }
+
+    size_t containerCount() const noexcept {
+        return _count;
+    }
+
+    uint64_t cardinality() const noexcept {
+        uint64_t count = 0;
+        for (size_t i = 0; i < _count; ++i) {
+            count += descriptorAt(i).cardinality;
+        }
+        return count;
+    }
+
+    bool contains(uint32_t value) const noexcept {
+        auto key = static_cast<uint16_t>(value >> 16);
+        size_t first = 0;
+        size_t count = _count;
+        while (count > 0) {
+            size_t half = count / 2;
+            if (keyAt(first + half) < key) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        return first < _count && keyAt(first) == key && RoaringBitmap::containsLow(containerAt(descriptorAt(first)), static_cast<uint16_t>(value));
+    }
+
+    /**
+     * @brief Calls `function(value)` for every value in ascending order.
+     */
+    template <typename FunctionT>
+    void forEach(FunctionT function) const {
+        for (size_t i = 0; i < _count; ++i) {
+            Descriptor descriptor = descriptorAt(i);
+            RoaringBitmap::forEachLow(containerAt(descriptor), uint32_t{descriptor.key} << 16, function);
+        }
+    }
+
+    /**
+     * @brief Copies the image into an owning set, after checking every payload.
+     * @throws std::invalid_argument If a payload does not match its descriptor.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    RoaringBitmap toBitmap() const {
+        RoaringBitmap bitmap;
+        bitmap._keys.reserve(_count);
+        bitmap._containers.reserve(_count);
+        for (size_t i = 0; i < _count; ++i) {
+            Descriptor descriptor = descriptorAt(i);
+            RoaringContainerView view = containerAt(descriptor);
+            RoaringBitmap::checkPayload(view);
+            RoaringContainer container{view.kind, view.cardinality, {}, {}};
+            if (view.kind == RoaringContainerKind::Bitset) {
+                container.words = DArray<uint64_t>(view.words, view.words + roaringBitsetWords);
+            } else {
+                container.values = DArray<uint16_t>(view.values, view.values + view.valueCount);
+            }
+            bitmap.append(descriptor.key, std::move(container));
+        }
+        return bitmap;
+    }
+
+private:
+    struct Descriptor {
+        uint16_t key;
+        RoaringContainerKind kind;
+        uint32_t cardinality;
+        uint32_t elements;
+        uint32_t offset;
+    };
+
+    const std::byte* descriptorBytes(size_t index) const noexcept {
+        return _image + RoaringBitmap::imageHeaderSize + RoaringBitmap::descriptorSize * index;
+    }
+
+    uint16_t keyAt(size_t index) const noexcept {
+        uint16_t key = 0;
+        std::memcpy(&key, descriptorBytes(index), 2);
+        return key;
+    }
+
+    Descriptor descriptorAt(size_t index) const noexcept {
+        const std::byte* bytes = descriptorBytes(index);
+        Descriptor descriptor{keyAt(index), static_cast<RoaringContainerKind>(bytes[2]), 0, 0, 0};
+        std::memcpy(&descriptor.cardinality, bytes + 4, 4);
+        std::memcpy(&descriptor.elements, bytes + 8, 4);
+        std::memcpy(&descriptor.offset, bytes + 12, 4);
+        return descriptor;
+    }
+
+    RoaringContainerView containerAt(const Descriptor& descriptor) const noexcept {
+        const std::byte* payload = _image + descriptor.offset;
+        if (descriptor.kind == RoaringContainerKind::Bitset) {
+            return {descriptor.kind, descriptor.cardinality, nullptr, 0, reinterpret_cast<const uint64_t*>(payload)};
+        }
+        return {descriptor.kind, descriptor.cardinality, reinterpret_cast<const uint16_t*>(payload), descriptor.elements, nullptr};
+    }
+};
+
+inline RoaringBitmap RoaringBitmap::deserialize(std::span<const std::byte> image) {
+    if (reinterpret_cast<uintptr_t>(image.data()) % alignof(uint64_t) == 0) {
+        return RoaringView(image).toBitmap();
+    }
+    DArray<uint64_t> aligned((image.size() + 7) / 8);
+    std::memcpy(aligned.data(), image.data(), image.size());
+    return RoaringView(std::span(reinterpret_cast<const std::byte*>(aligned.data()), image.size())).toBitmap();
+}
+
+#endif // ROARING_BITMAP_HPP
@@ -0,0 +1,92 @@
+#include "roaring_bitmap.hpp"
+#include <chrono>
+#include <print>
+#include <random>
+
+// The container kernels on their own, per instruction set, then whole-set operations on mixed
+// data. The bitset kernels stream 24 KiB per call, so they run from L1/L2 and show the vector width.
+
+namespace {
+
+constexpr int repetitions = 20000;
+
+template <typename FunctionT>
+double nanosecondsPerCall(int calls, FunctionT function) {
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        checksum += function();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("  (checksum {})", checksum);
+    return elapsed.count() / calls;
+}
+
+RoaringBitmap randomBitmap(std::mt19937& random, uint32_t chunks, uint32_t perChunk) {
+    RoaringBitmap bitmap;
+    for (uint32_t chunk = 0; chunk < chunks; ++chunk) {
+        for (uint32_t i = 0; i < perChunk; ++i) {
+            bitmap.add(chunk << 16 | (random() & 0xffff));
+        }
+    }
+    bitmap.addRange(uint64_t{chunks} << 16, uint64_t{chunks + 16} << 16);
+    return bitmap;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 random(5);
+    DArray<uint64_t> left(roaringBitsetWords);
+    DArray<uint64_t> right(roaringBitsetWords);
+    DArray<uint64_t> out(roaringBitsetWords);
+    for (size_t i = 0; i < roaringBitsetWords; ++i) {
+        left[i] = uint64_t{random()} << 32 | random();
+        right[i] = uint64_t{random()} << 32 | random();
+    }
+    DArray<uint16_t> a;
+    DArray<uint16_t> b;
+    for (uint32_t value = 0; value < 65536; ++value) {
+        if (random() % 20 == 0) {
+            a.push(static_cast<uint16_t>(value));
+        }
+        if (random() % 20 == 0) {
+            b.push(static_cast<uint16_t>(value));
+        }
+    }
+    DArray<uint16_t> intersection(std::min(a.size(), b.size()) + 8);
+
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        auto target = static_cast<CpuTarget>(i);
+        if (!cpuTargetEnabled(target)) {
+            continue;
+        }
+        if (auto kernel = bitsetOperationKernel.variant(target)) {
+            double ns = nanosecondsPerCall(repetitions, [&] { return kernel(BitsetOperation::And, left.data(), right.data(), out.data()); });
+            std::println("{} bitset AND + count: {:.0f} ns ({:.2f} words/ns)", cpuTargetName(target), ns, roaringBitsetWords / ns);
+        }
+        if (auto kernel = intersectSortedKernel.variant(target)) {
+            double ns = nanosecondsPerCall(repetitions, [&] { return kernel(a.data(), a.size(), b.data(), b.size(), intersection.data()); });
+            std::println("{} array intersection of {} and {}: {:.0f} ns", cpuTargetName(target), a.size(), b.size(), ns);
+        }
+    }
+
+    // 64 dense chunks, 64 sparse ones and 16 runs on each side, overlapping.
+    RoaringBitmap dense = randomBitmap(random, 64, 40000);
+    RoaringBitmap sparse = randomBitmap(random, 128, 300);
+    dense.optimize();
+    sparse.optimize();
+    std::println("sets of {} and {} values in {} and {} containers", dense.cardinality(), sparse.cardinality(), dense.containerCount(), sparse.containerCount());
+    double andTime = nanosecondsPerCall(200, [&] { return (dense & sparse).cardinality(); });
+    double orTime = nanosecondsPerCall(200, [&] { return (dense | sparse).cardinality(); });
+    double xorTime = nanosecondsPerCall(200, [&] { return (dense ^ sparse).cardinality(); });
+    std::println("AND {:.1f} us, OR {:.1f} us, XOR {:.1f} us", andTime / 1000, orTime / 1000, xorTime / 1000);
+    double cardinality = nanosecondsPerCall(repetitions, [&] { return dense.cardinality(); });
+    std::println("cardinality: {:.1f} ns", cardinality);
+
+    DArray<std::byte> image;
+    dense.serialize(image);
+    RoaringView view(image);
+    double probe = nanosecondsPerCall(1'000'000, [&] { return view.contains(random() % (80u << 16)) ? 1 : 0; });
+    std::println("image of {} bytes, in-place lookup: {:.1f} ns", image.size(), probe);
+}
@@ -0,0 +1,324 @@
+#include "roaring_bitmap.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+std::vector<uint32_t> valuesOf(const RoaringBitmap& bitmap) {
+    std::vector<uint32_t> values;
+    bitmap.forEach([&](uint32_t value) { values.push_back(value); });
+    return values;
+}
+
+// Chunks of every kind: sparse values, a dense random chunk, long runs and a full chunk.
+std::set<uint32_t> mixedValues(uint32_t seed) {
+    std::mt19937 random(seed);
+    std::set<uint32_t> values;
+    for (int i = 0; i < 2000; ++i) {
+        values.insert(random() % (1u << 19));
+    }
+    for (int i = 0; i < 30000; ++i) {
+        values.insert((3u << 16) | (random() & 0xffff));
+    }
+    uint32_t start = (5u << 16) + random() % 1000;
+    for (uint32_t value = start; value < start + 70000; ++value) {
+        values.insert(value);
+    }
+    for (uint32_t value = 9u << 16; value < 10u << 16; ++value) {
+        values.insert(value);
+    }
+    values.insert(0);
+    values.insert(UINT32_MAX);
+    return values;
+}
+
+RoaringBitmap bitmapOf(const std::set<uint32_t>& values) {
+    RoaringBitmap bitmap;
+    for (uint32_t value : values) {
+        bitmap.add(value);
+    }
+    bitmap.optimize();
+    return bitmap;
+}
+
+} // namespace
+
+// Test point updates against std::set, across the array/bitset switch in both directions
+TEST(RoaringBitmapTest, AddRemoveContains) {
+    std::mt19937 random(1);
+    RoaringBitmap bitmap;
+    std::set<uint32_t> reference;
+    for (int i = 0; i < 20000; ++i) {
+        uint32_t value = (random() % 3) << 16 | (random() % 12000);
+        EXPECT_EQ(bitmap.add(value), reference.insert(value).second);
+    }
+    EXPECT_EQ(bitmap.cardinality(), reference.size());
+    EXPECT_EQ(bitmap.containerKind(0), RoaringContainerKind::Bitset);
+    for (int i = 0; i < 40000; ++i) {
+        uint32_t value = (random() % 4) << 16 | (random() % 12000);
+        EXPECT_EQ(bitmap.remove(value), reference.erase(value) == 1);
+        uint32_t probe = (random() % 4) << 16 | (random() % 12000);
+        ASSERT_EQ(bitmap.contains(probe), reference.contains(probe));
+    }
+    EXPECT_EQ(bitmap.cardinality(), reference.size());
+    EXPECT_EQ(bitmap.containerKind(0), RoaringContainerKind::Array);
+    EXPECT_EQ(valuesOf(bitmap), std::vector<uint32_t>(reference.begin(), reference.end()));
+
+    for (uint32_t value : reference) {
+        bitmap.remove(value);
+    }
+    EXPECT_TRUE(bitmap.empty());
+    EXPECT_FALSE(bitmap.contains(0));
+}
+
+// Test that ranges become runs, and that point updates inside a run keep the other values
+TEST(RoaringBitmapTest, Ranges) {
+    RoaringBitmap bitmap;
+    bitmap.addRange(65530, 3 * 65536 + 10);
+    EXPECT_EQ(bitmap.cardinality(), 3 * 65536 + 10 - 65530);
+    EXPECT_EQ(bitmap.containerCount(), 4);
+    for (size_t i = 0; i < bitmap.containerCount(); ++i) {
+        EXPECT_EQ(bitmap.containerKind(i), RoaringContainerKind::Run);
+    }
+    EXPECT_FALSE(bitmap.contains(65529));
+    EXPECT_TRUE(bitmap.contains(65530));
+    EXPECT_TRUE(bitmap.contains(2 * 65536 + 17));
+    EXPECT_TRUE(bitmap.contains(3 * 65536 + 9));
+    EXPECT_FALSE(bitmap.contains(3 * 65536 + 10));
+
+    EXPECT_TRUE(bitmap.remove(100000));
+    EXPECT_FALSE(bitmap.contains(100000));
+    EXPECT_TRUE(bitmap.contains(100001));
+    EXPECT_EQ(bitmap.cardinality(), 3 * 65536 + 9 - 65530);
+    bitmap.optimize();
+    EXPECT_EQ(bitmap.containerKind(1), RoaringContainerKind::Run);
+
+    // Overlapping an existing container merges into it.
+    bitmap.addRange(3 * 65536, 3 * 65536 + 5000);
+    EXPECT_EQ(bitmap.containerKind(3), RoaringContainerKind::Run);
+    EXPECT_TRUE(bitmap.contains(3 * 65536 + 4999));
+
+    RoaringBitmap everything;
+    everything.addRange(0, uint64_t{1} << 32);
+    EXPECT_EQ(everything.cardinality(), uint64_t{1} << 32);
+    EXPECT_TRUE(everything.contains(UINT32_MAX));
+    EXPECT_THROW(everything.addRange(5, 4), std::out_of_range);
+    EXPECT_THROW(everything.addRange(0, (uint64_t{1} << 32) + 1), std::out_of_range);
+}
+
+// Test every operation between every pair of container kinds against std::set_* results
+TEST(RoaringBitmapTest, SetOperations) {
+    std::set<uint32_t> a = mixedValues(2);
+    std::set<uint32_t> b = mixedValues(3);
+    RoaringBitmap left = bitmapOf(a);
+    RoaringBitmap right = bitmapOf(b);
+    // Without `optimize`, the runs of the right side stay arrays and bitsets.
+    RoaringBitmap plainRight;
+    for (uint32_t value : b) {
+        plainRight.add(value);
+    }
+
+    auto expect = [](const RoaringBitmap& result, const std::vector<uint32_t>& expected) {
+        EXPECT_EQ(result.cardinality(), expected.size());
+        EXPECT_EQ(valuesOf(result), expected);
+    };
+    for (const RoaringBitmap* other : {&right, &plainRight}) {
+        std::vector<uint32_t> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        expect(left & *other, expected);
+        expected.clear();
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        expect(left | *other, expected);
+        expected.clear();
+        std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        expect(left ^ *other, expected);
+        expected.clear();
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        expect(left - *other, expected);
+        expected.clear();
+        std::set_difference(b.begin(), b.end(), a.begin(), a.end(), std::back_inserter(expected));
+        expect(*other - left, expected);
+    }
+    EXPECT_TRUE((left ^ left).empty());
+    EXPECT_EQ(right, plainRight);
+    EXPECT_FALSE(left == right);
+
+    RoaringBitmap accumulated = left;
+    accumulated |= right;
+    accumulated -= right;
+    EXPECT_EQ(accumulated, left - right);
+}
+
+// Test that every kernel variant the CPU supports matches the scalar loops, including zero values
+TEST(RoaringBitmapTest, Kernels) {
+    std::mt19937_64 random(4);
+    std::vector<uint64_t> left(roaringBitsetWords);
+    std::vector<uint64_t> right(roaringBitsetWords);
+    for (size_t i = 0; i < roaringBitsetWords; ++i) {
+        left[i] = random();
+        right[i] = i % 7 == 0 ? ~uint64_t{0} : random() & random();
+    }
+    std::vector<uint16_t> a;
+    std::vector<uint16_t> b;
+    for (uint32_t value = 0; value < 65536; ++value) {
+        if (value % 3 == 0 || random() % 4 == 0) {
+            a.push_back(static_cast<uint16_t>(value));
+        }
+        if (value % 5 == 0 || random() % 4 == 0) {
+            b.push_back(static_cast<uint16_t>(value));
+        }
+    }
+    std::vector<uint16_t> expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        auto target = static_cast<CpuTarget>(i);
+        if (!cpuTargetEnabled(target)) {
+            continue;
+        }
+        SCOPED_TRACE(cpuTargetName(target));
+        if (auto kernel = bitsetOperationKernel.variant(target)) {
+            for (BitsetOperation operation : {BitsetOperation::And, BitsetOperation::Or, BitsetOperation::Xor, BitsetOperation::AndNot}) {
+                std::vector<uint64_t> out(roaringBitsetWords);
+                std::vector<uint64_t> reference(roaringBitsetWords);
+                uint32_t count = kernel(operation, left.data(), right.data(), out.data());
+                EXPECT_EQ(count, bitsetOperationScalar(operation, left.data(), right.data(), reference.data()));
+                EXPECT_EQ(out, reference);
+            }
+        }
+        if (auto kernel = intersectSortedKernel.variant(target)) {
+            for (size_t size : {size_t{0}, size_t{7}, size_t{8}, size_t{100}, a.size()}) {
+                std::vector<uint16_t> out(std::min(size, b.size()) + 8);
+                size_t count = kernel(a.data(), size, b.data(), b.size(), out.data());
+                std::vector<uint16_t> prefix;
+                std::set_intersection(a.begin(), a.begin() + size, b.begin(), b.end(), std::back_inserter(prefix));
+                out.resize(count);
+                EXPECT_EQ(out, prefix) << "size " << size;
+            }
+            std::vector<uint16_t> out(std::min(a.size(), b.size()) + 8);
+            out.resize(kernel(b.data(), b.size(), a.data(), a.size(), out.data()));
+            EXPECT_EQ(out, expected);
+        }
+    }
+}
+
+// Test that an image reads back in place and into a copy, at any buffer alignment for the copy
+TEST(RoaringBitmapTest, Serialization) {
+    std::set<uint32_t> values = mixedValues(5);
+    RoaringBitmap bitmap = bitmapOf(values);
+    DArray<std::byte> image;
+    bitmap.serialize(image);
+    EXPECT_EQ(image.size(), bitmap.serializedSize());
+
+    RoaringView view(image);
+    EXPECT_EQ(view.containerCount(), bitmap.containerCount());
+    EXPECT_EQ(view.cardinality(), values.size());
+    for (uint32_t probe : {0u, 1u, 3u << 16, (3u << 16) + 77, 5u << 16, 9u << 16, (9u << 16) + 65535, 11u << 16, UINT32_MAX}) {
+        EXPECT_EQ(view.contains(probe), values.contains(probe)) << probe;
+    }
+    std::vector<uint32_t> viewed;
+    view.forEach([&](uint32_t value) { viewed.push_back(value); });
+    EXPECT_EQ(viewed, std::vector<uint32_t>(values.begin(), values.end()));
+    EXPECT_EQ(RoaringBitmap::deserialize(image), bitmap);
+
+    DArray<std::byte> shifted(3);
+    bitmap.serialize(shifted);
+    std::span<const std::byte> unaligned(shifted.data() + 3, shifted.size() - 3);
+    EXPECT_THROW(RoaringView{unaligned}, std::invalid_argument);
+    EXPECT_EQ(RoaringBitmap::deserialize(unaligned), bitmap);
+
+    DArray<std::byte> empty;
+    RoaringBitmap().serialize(empty);
+    EXPECT_TRUE(RoaringBitmap::deserialize(empty).empty());
+}
+
+// Test that malformed images are rejected before any query reads them
+TEST(RoaringBitmapTest, MalformedImages) {
+    RoaringBitmap bitmap{1, 2, 3, 70000, 140000};
+    DArray<std::byte> image;
+    bitmap.serialize(image);
+    auto rejected = [](DArray<std::byte> bytes) {
+        EXPECT_THROW(RoaringView{bytes}, std::invalid_argument);
+    };
+    rejected(DArray<std::byte>(image.begin(), image.begin() + 6));
+    rejected(DArray<std::byte>(image.begin(), image.end() - 2));
+
+    DArray<std::byte> corrupt = image;
+    corrupt[0] = std::byte{'X'};
+    rejected(corrupt);
+    corrupt = image;
+    corrupt[8 + 16] = std::byte{0}; // The second key equals the first.
+    rejected(corrupt);
+    corrupt = image;
+    corrupt[8 + 2] = std::byte{7}; // Unknown kind.
+    rejected(corrupt);
+    corrupt = image;
+    corrupt[8 + 12] = std::byte{0xf8}; // Offset past the end.
+    rejected(corrupt);
+    corrupt = image;
+    corrupt[8 + 4] = std::byte{9}; // Array cardinality disagrees with its length.
+    rejected(corrupt);
+}
+
+// Test that deserialization checks every payload against its descriptor before copying it
+TEST(RoaringBitmapTest, CorruptPayloads) {
+    auto imageOf = [](const RoaringBitmap& bitmap) {
+        DArray<std::byte> image;
+        bitmap.serialize(image);
+        return image;
+    };
+    // The first container's cardinality, and its payload as 16-bit values.
+    auto cardinality = [](DArray<std::byte>& image) { return reinterpret_cast<uint32_t*>(image.data() + 8 + 4); };
+    auto payload = [](DArray<std::byte>& image) {
+        uint32_t offset = 0;
+        std::memcpy(&offset, image.data() + 8 + 12, 4);
+        return reinterpret_cast<uint16_t*>(image.data() + offset);
+    };
+    auto rejected = [](const DArray<std::byte>& image) {
+        EXPECT_THROW(RoaringBitmap::deserialize(image), std::invalid_argument);
+    };
+
+    RoaringBitmap range;
+    range.addRange(0, 100);
+    DArray<std::byte> image = imageOf(range);
+    ASSERT_EQ(range.containerKind(0), RoaringContainerKind::Run);
+    *cardinality(image) = 1; // The runs hold 100 values.
+    rejected(image);
+    EXPECT_EQ(RoaringView(image).containerCount(), 1);
+
+    RoaringBitmap runs;
+    runs.addRange(0, 10);
+    runs.addRange(20, 30);
+    runs.addRange(65500, 65536);
+    image = imageOf(runs);
+    ASSERT_EQ(runs.containerKind(0), RoaringContainerKind::Run);
+    payload(image)[2] = 5; // The second run overlaps the first.
+    rejected(image);
+    image = imageOf(runs);
+    payload(image)[5] = 40; // The last run ends past 65535.
+    *cardinality(image) += 5;
+    rejected(image);
+
+    image = imageOf(RoaringBitmap{1, 2, 3});
+    std::swap(payload(image)[0], payload(image)[1]);
+    rejected(image);
+    image = imageOf(RoaringBitmap{1, 2, 3});
+    payload(image)[1] = 1; // A duplicate.
+    rejected(image);
+
+    RoaringBitmap dense;
+    for (uint32_t value = 0; value < 65536; value += 3) {
+        dense.add(value);
+    }
+    image = imageOf(dense);
+    ASSERT_EQ(dense.containerKind(0), RoaringContainerKind::Bitset);
+    payload(image)[0] ^= 2;
+    rejected(image);
+    payload(image)[0] ^= 2;
+    EXPECT_EQ(RoaringBitmap::deserialize(image), dense);
+}
@@ -0,0 +1,187 @@
+#ifndef SIMD_KERNELS_HPP
+#define SIMD_KERNELS_HPP
+
+#include "cpu_dispatch.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Vectorized kernels over contiguous `int32_t` data (a `DArray<int32_t>` converts to the span).
+// Each kernel has a scalar variant plus one per instruction set; `sumValues` and `findValue` are
+// bound to the best of them at startup (see `Dispatched`).
+
+inline int64_t sumValuesScalar(std::span<const int32_t> values) {
+    int64_t sum = 0;
+    for (int32_t value : values) {
+        sum += value;
+    }
+    return sum;
+}
+
+inline size_t findValueScalar(std::span<const int32_t> values, int32_t needle) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] == needle) {
+            return i;
+        }
+    }
+    return values.size();
+}
+
+#if defined(__x86_64__)
+
+DS_TARGET_AVX2 inline int64_t sumValuesAvx2(std::span<const int32_t> values) {
+    const int32_t* data = values.data();
+    size_t size = values.size();
+    size_t i = 0;
+    __m256i low = _mm256_setzero_si256();
+    __m256i high = _mm256_setzero_si256();
+    for (; i + 8 <= size; i += 8) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(chunk)));
+        high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(chunk, 1)));
+    }
+    __m256i lanes = _mm256_add_epi64(low, high);
+    __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+    int64_t sum = _mm_cvtsi128_si64(pair) + _mm_extract_epi64(pair, 1);
+    for (; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+DS_TARGET_AVX2 inline size_t findValueAvx2(std::span<const int32_t> values, int32_t needle) {
+    const int32_t* data = values.data();
+    size_t size = values.size();
+    size_t i = 0;
+    __m256i broadcast = _mm256_set1_epi32(needle);
+    for (; i + 8 <= size; i += 8) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(chunk, broadcast))));
+        if (mask != 0) {
+            return i + std::countr_zero(mask);
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] == needle) {
+            return i;
+        }
+    }
+    return size;
+}
+
+DS_TARGET_AVX512 inline int64_t sumValuesAvx512(std::span<const int32_t> values) {
+    const int32_t* data = values.data();
+    size_t size = values.size();
+    size_t i = 0;
+    __m512i low = _mm512_setzero_si512();
+    __m512i high = _mm512_setzero_si512();
+    for (; i + 16 <= size; i += 16) {
+        __m512i chunk = _mm512_loadu_si512(data + i);
+        low = _mm512_add_epi64(low, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(chunk)));
+        high = _mm512_add_epi64(high, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(chunk, 1)));
+    }
+    if (i < size) {
+        // Masked loads never touch memory past the end of the span.
+        auto tail = static_cast<__mmask16>((1u << (size - i)) - 1);
+        __m512i chunk = _mm512_maskz_loadu_epi32(tail, data + i);
+        low = _mm512_add_epi64(low, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(chunk)));
+        high = _mm512_add_epi64(high, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(chunk, 1)));
+    }
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(low, high));
+}
+
+DS_TARGET_AVX512 inline size_t findValueAvx512(std::span<const int32_t> values, int32_t needle) {
+    const int32_t* data = values.data();
+    size_t size = values.size();
+    size_t i = 0;
+    __m512i broadcast = _mm512_set1_epi32(needle);
+    for (; i + 16 <= size; i += 16) {
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data + i), broadcast);
+        if (mask != 0) {
+            return i + std::countr_zero(static_cast<uint32_t>(mask));
+        }
+    }
+    if (i < size) {
+        auto tail = static_cast<__mmask16>((1u << (size - i)) - 1);
+        __mmask16 mask = _mm512_mask_cmpeq_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, data + i), broadcast);
+        if (mask != 0) {
+            return i + std::countr_zero(static_cast<uint32_t>(mask));
+        }
+    }
+    return size;
+}
+
+#elif defined(__aarch64__)
+
+inline int64_t sumValuesNeon(std::span<const int32_t> values) {
+    const int32_t* data = values.data();
+    size_t size = values.size();
+    size_t i = 0;
+    int64x2_t low = vdupq_n_s64(0);
+    int64x2_t high = vdupq_n_s64(0);
+    for (; i + 8 <= size; i += 8) {
+        low = vpadalq_s32(low, vld1q_s32(data + i));
+        high = vpadalq_s32(high, vld1q_s32(data + i + 4));
+    }
+    int64_t sum = vaddvq_s64(vaddq_s64(low, high));
+    for (; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+inline size_t findValueNeon(std::span<const int32_t> values, int32_t needle) {
+    const int32_t* data = values.data();
+    size_t size = values.size();
+    size_t i = 0;
+    int32x4_t broadcast = vdupq_n_s32(needle);
+    for (; i + 8 <= size; i += 8) {
+        uint32x4_t equal = vorrq_u32(vceqq_s32(vld1q_s32(data + i), broadcast), vceqq_s32(vld1q_s32(data + i + 4), broadcast));
+        if (vmaxvq_u32(equal) != 0) {
+            break;
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] == needle) {
+            return i;
+        }
+    }
+    return size;
+}
+
+#endif
+
+/**
+ * @brief Returns the sum of `values`, widened to 64 bits.
+ */
+inline const Dispatched<int64_t(std::span<const int32_t>)> sumValues = {
+    {CpuTarget::Scalar, sumValuesScalar},
+#if defined(__x86_64__)
+    {CpuTarget::Avx2, sumValuesAvx2},
+    {CpuTarget::Avx512, sumValuesAvx512},
+#elif defined(__aarch64__)
+    {CpuTarget::Neon, sumValuesNeon},
+#endif
+};
+
+/**
+ * @brief Returns the index of the first element equal to `needle`, or `values.size()` if there is none.
+ */
+inline const Dispatched<size_t(std::span<const int32_t>, int32_t)> findValue = {
+    {CpuTarget::Scalar, findValueScalar},
+#if defined(__x86_64__)
+    {CpuTarget::Avx2, findValueAvx2},
+    {CpuTarget::Avx512, findValueAvx512},
+#elif defined(__aarch64__)
+    {CpuTarget::Neon, findValueNeon},
+#endif
+};
+
+#endif // SIMD_KERNELS_HPP
@@ -0,0 +1,312 @@
+#ifndef SIZE_CLASS_POOL_HPP
+#define SIZE_CLASS_POOL_HPP
+
+#include "dynamic_array.hpp"
+#include "exception_guard.hpp"
+#include "type_list.hpp"
+#include "unique_pointer.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief The slot size and alignment shared by the objects of one slab.
+ */
+struct SizeClass {
+    size_t size;
+    size_t alignment;
+
+    friend constexpr auto operator<=>(const SizeClass&, const SizeClass&) = default;
+};
+
+/**
+ * @brief Returns the size class of `T`: a slot must also hold the free-list link while it is free.
+ */
+template <typename T>
+constexpr SizeClass sizeClassOf() noexcept {
+    size_t alignment = std::max(alignof(T), alignof(void*));
+    size_t size = std::max(sizeof(T), sizeof(void*));
+    return {(size + alignment - 1) & ~(alignment - 1), alignment};
+}
+
+template <typename TypesT, Allocator UpstreamT = DefaultAllocator>
+class SizeClassPool;
+
+/**
+ * @brief A pool allocator for a fixed set of hot types.
+ * The size classes of the listed types are computed at compile time; types with equal size and
+ * alignment share a class. Each class owns a free list threaded through slabs of `slabSize`
+ * bytes, so allocating a listed type (`create<T>()`, `allocate<T>()`) is a free-list pop and
+ * freeing it a push, with the class chosen by a constant index rather than by the size.
+ * Not thread-safe. Satisfies the `Allocator` concept for other requests too: those that fit a
+ * class are served from it, larger ones from upstream; pass `SizeClassPoolAllocator` (a copyable
+ * handle) where the allocator is stored by value.
+ * @tparam Types The hot types.
+ * @tparam UpstreamT The allocator slabs are taken from. Defaults to `DefaultAllocator`.
+ */
+template <typename... Types, Allocator UpstreamT>
+class SizeClassPool<TypeList<Types...>, UpstreamT> {
+    static_assert(sizeof...(Types) > 0, "A pool needs at least one type");
+
+public:
+    using TypeListType = TypeList<Types...>;
+
+    // Slabs are aligned to their size, so the slab of any pointer is found by masking the address.
+    static constexpr size_t slabSize = 64 * 1024;
+
+private:
+    static constexpr std::array<SizeClass, sizeof...(Types)> typeClasses = {sizeClassOf<Types>()...};
+
+    static constexpr size_t countClasses() noexcept {
+        std::array<SizeClass, sizeof...(Types)> classes = typeClasses;
+        std::sort(classes.begin(), classes.end());
+        return static_cast<size_t>(std::unique(classes.begin(), classes.end()) - classes.begin());
+    }
+
+public:
+    static constexpr size_t classCount = countClasses();
+
+    // The distinct classes, ordered by size.
+    static constexpr std::array<SizeClass, classCount> classes = [] {
+        std::array<SizeClass, sizeof...(Types)> sorted = typeClasses;
+        std::sort(sorted.begin(), sorted.end());
+        std::unique(sorted.begin(), sorted.end());
+        std::array<SizeClass, classCount> distinct{};
+        std::copy_n(sorted.begin(), classCount, distinct.begin());
+        return distinct;
+    }();
+
+    /**
+     * @brief The index of the class `T` is allocated from.
+     */
+    template <typename T>
+        requires(TypeListType::template contains_v<T>)
+    static constexpr size_t classIndex = [] {
+        size_t index = 0;
+        while (classes[index] != sizeClassOf<T>()) {
+            ++index;
+        }
+        return index;
+    }();
+
+private:
+    static constexpr size_t largeClass = SIZE_MAX;
+    static constexpr std::align_val_t slabAlignment = static_cast<std::align_val_t>(slabSize);
+
+    struct alignas(std::max_align_t) SlabHeader {
+        SlabHeader* next;
+        size_t sizeClass;
+    };
+
+    static_assert(classes.back().size + sizeof(SlabHeader) + classes.back().alignment <= slabSize, "Listed types must be much smaller than a slab");
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct ClassState {
+        FreeSlot* free = nullptr;
+        std::byte* cursor = nullptr;
+        std::byte* end = nullptr;
+    };
+
+    std::array<ClassState, classCount> _classes{};
+    SlabHeader* _slabs = nullptr;
+    size_t _slabCount = 0;
+    UpstreamT _upstream;
+
+public:
+    SizeClassPool() noexcept = default;
+
+    SizeClassPool(const SizeClassPool&) = delete;
+
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    /**
+     * @brief Destructor.
+     * Returns all slabs to upstream. Objects still in the pool are not destroyed.
+     */
+    ~SizeClassPool() noexcept {
+        while (_slabs != nullptr) {
+            SlabHeader* next = _slabs->next;
+            _upstream.deallocate(_slabs, slabAlignment);
+            _slabs = next;
+        }
+    }
+
+    /**
+     * @brief Returns uninitialized storage for one `T`.
+     * @throws std::bad_alloc If a new slab is needed and upstream allocation fails.
+     */
+    template <typename T>
+        requires(TypeListType::template contains_v<T>)
+    void* allocate() {
+        return allocateFromClass(classIndex<T>);
+    }
+
+    /**
+     * @brief Returns the storage of a `T` obtained from `allocate<T>()` to its class.
+     */
+    template <typename T>
+        requires(TypeListType::template contains_v<T>)
+    void deallocate(T* pointer) noexcept {
+        deallocateToClass(classIndex<T>, pointer);
+    }
+
+    /**
+     * @brief Constructs a `T` from `args` in pool storage.
+     * @throws std::bad_alloc If a new slab is needed and upstream allocation fails.
+     * @throws Any exception thrown by the T constructor; the storage is returned to the pool.
+     */
+    template <typename T, typename... Args>
+        requires(TypeListType::template contains_v<T>)
+    T* create(Args&&... args) {
+        void* storage = allocate<T>();
+        auto guard = makeExceptionGuard([&] { deallocateToClass(classIndex<T>, storage); });
+        T* object = new (storage) T(std::forward<Args>(args)...);
+        guard.complete();
+        return object;
+    }
+
+    /**
+     * @brief Destroys a `T` obtained from `create<T>()` and returns its storage to the pool.
+     */
+    template <typename T>
+        requires(TypeListType::template contains_v<T>)
+    void destroy(T* object) noexcept {
+        object->~T();
+        deallocate(object);
+    }
+
+    /**
+     * @brief Allocates `count` bytes aligned to `alignment` (the `Allocator` interface).
+     * Served from the smallest class that fits, or directly from upstream if none does.
+     * @throws std::bad_alloc If upstream allocation fails or `alignment` is not below `slabSize`.
+     */
+    void* allocate(size_t count, std::align_val_t alignment) {
+        auto align = static_cast<size_t>(alignment);
+        for (size_t i = 0; i < classCount; ++i) {
+            if (classes[i].size >= count && classes[i].alignment >= align) {
+                return allocateFromClass(i);
+            }
+        }
+        return allocateLarge(count, align);
+    }
+
+    /**
+     * @brief Frees memory obtained from `allocate(count, alignment)` or `allocate<T>()`.
+     * The class is read from the header of the slab the pointer lies in.
+     */
+    void deallocate(void* pointer, std::align_val_t) noexcept {
+        SlabHeader* header = slabOf(pointer);
+        if (header->sizeClass == largeClass) {
+            _upstream.deallocate(header, slabAlignment);
+        } else {
+            deallocateToClass(header->sizeClass, pointer);
+        }
+    }
+
+    /**
+     * @brief Returns the number of slabs taken from upstream.
+     */
+    size_t slabCount() const noexcept {
+        return _slabCount;
+    }
+
+private:
+    static SlabHeader* slabOf(void* pointer) noexcept {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(pointer) & ~(uintptr_t{slabSize} - 1));
+    }
+
+    void* allocateFromClass(size_t index) {
+        ClassState& state = _classes[index];
+        if (state.free != nullptr) [[likely]] {
+            FreeSlot* slot = state.free;
+            state.free = slot->next;
+            return slot;
+        }
+        return allocateSlot(index);
+    }
+
+    void deallocateToClass(size_t index, void* pointer) noexcept {
+        ClassState& state = _classes[index];
+        state.free = new (pointer) FreeSlot{state.free};
+    }
+
+    // Slow path: bumps a slot out of the class's current slab, starting a new slab when it is used up.
+    [[gnu::noinline]] void* allocateSlot(size_t index) {
+        ClassState& state = _classes[index];
+        size_t size = classes[index].size;
+        if (static_cast<size_t>(state.end - state.cursor) < size) {
+            void* memory = _upstream.allocate(slabSize, slabAlignment);
+            _slabs = new (memory) SlabHeader{_slabs, index};
+            ++_slabCount;
+            auto first = reinterpret_cast<uintptr_t>(_slabs + 1);
+            size_t align = classes[index].alignment;
+            state.cursor = reinterpret_cast<std::byte*>((first + align - 1) & ~(uintptr_t{align} - 1));
+            state.end = static_cast<std::byte*>(memory) + slabSize;
+        }
+        void* slot = state.cursor;
+        state.cursor += size;
+        return slot;
+    }
+
+    // Large blocks get a header of their own at a slab-aligned address, so `deallocate` can tell
+    // them apart from slots.
+    void* allocateLarge(size_t count, size_t align) {
+        size_t offset = std::max((sizeof(SlabHeader) + align - 1) & ~(align - 1), sizeof(SlabHeader));
+        if (offset >= slabSize) {
+            throw std::bad_alloc();
+        }
+        void* memory = _upstream.allocate(offset + count, slabAlignment);
+        new (memory) SlabHeader{nullptr, largeClass};
+        return static_cast<std::byte*>(memory) + offset;
+    }
+};
+
+/**
+ * @brief A copyable `Allocator` handle that forwards to a `SizeClassPool`. The pool must outlive it.
+ */
+template <typename PoolT>
+struct SizeClassPoolAllocator {
+    PoolT* pool = nullptr;
+
+    void* allocate(size_t count, std::align_val_t alignment) const {
+        return pool->allocate(count, alignment);
+    }
+
+    void deallocate(void* pointer, std::align_val_t alignment) const noexcept {
+        pool->deallocate(pointer, alignment);
+    }
+};
+
+/**
+ * @brief A `UniquePointer` deleter that destroys the object and returns it to its pool.
+ */
+template <typename T, typename PoolT>
+struct PoolDeleter {
+    PoolT* pool = nullptr;
+
+    void operator()(T* object) const noexcept {
+        pool->destroy(object);
+    }
+};
+
+template <typename T, typename PoolT>
+using PoolPointer = UniquePointer<T, PoolDeleter<T, PoolT>>;
+
+/**
+ * @brief Constructs a `T` from `args` in `pool` and returns an owning pointer that frees it there.
+ * @throws std::bad_alloc If a new slab is needed and upstream allocation fails.
+ * @throws Any exception thrown by the T constructor.
+ */
+template <typename T, typename PoolT, typename... Args>
+PoolPointer<T, PoolT> makePooled(PoolT& pool, Args&&... args) {
+    return PoolPointer<T, PoolT>(pool.template create<T>(std::forward<Args>(args)...), PoolDeleter<T, PoolT>{&pool});
+}
+
+#endif // SIZE_CLASS_POOL_HPP
@@ -0,0 +1,75 @@
+#include "dynamic_array.hpp"
+#include "size_class_pool.hpp"
+#include <chrono>
+#include <print>
+
+namespace {
+
+struct Order {
+    int64_t id;
+    double price;
+    int64_t quantity;
+};
+
+struct Fill {
+    int64_t orderId;
+    int32_t quantity;
+};
+
+struct Session {
+    char user[40];
+    int64_t lastSeen;
+};
+
+using Pool = SizeClassPool<TypeList<Order, Fill, Session>>;
+
+constexpr int rounds = 200;
+constexpr int liveObjects = 10000;
+
+// Allocates a working set of orders and fills, then frees and reallocates it, as a matching
+// engine would over a trading session. Returns a checksum so the work is not optimized away.
+template <typename CreateOrderT, typename CreateFillT, typename DestroyT>
+int64_t churn(CreateOrderT createOrder, CreateFillT createFill, DestroyT destroy) {
+    DArray<Order*> orders(liveObjects);
+    DArray<Fill*> fills(liveObjects);
+    int64_t checksum = 0;
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < liveObjects; ++i) {
+            orders[i] = createOrder(round * liveObjects + i);
+            fills[i] = createFill(orders[i]->id);
+        }
+        for (int i = 0; i < liveObjects; ++i) {
+            checksum += orders[i]->id + fills[i]->quantity;
+            destroy(orders[i]);
+            destroy(fills[i]);
+        }
+    }
+    return checksum;
+}
+
+} // namespace
+
+int main() {
+    auto start = std::chrono::steady_clock::now();
+    int64_t heapChecksum = churn([](int64_t id) { return new Order{id, 1.5, 10}; },
+                                 [](int64_t id) { return new Fill{id, 5}; },
+                                 [](auto* object) { delete object; });
+    std::chrono::duration<double> heapTime = std::chrono::steady_clock::now() - start;
+
+    Pool pool;
+    start = std::chrono::steady_clock::now();
+    int64_t poolChecksum = churn([&](int64_t id) { return pool.create<Order>(id, 1.5, 10); },
+                                 [&](int64_t id) { return pool.create<Fill>(id, 5); },
+                                 [&](auto* object) { pool.destroy(object); });
+    std::chrono::duration<double> poolTime = std::chrono::steady_clock::now() - start;
+
+    std::println("size classes: {}", Pool::classCount);
+    for (const SizeClass& sizeClass : Pool::classes) {
+        std::println("  {} bytes, aligned to {}", sizeClass.size, sizeClass.alignment);
+    }
+    std::println("new/delete: {:.3f} s (checksum {})", heapTime.count(), heapChecksum);
+    std::println("pool:       {:.3f} s (checksum {}), {} slabs", poolTime.count(), poolChecksum, pool.slabCount());
+
+    PoolPointer<Session, Pool> session = makePooled<Session>(pool, Session{"alice", 42});
+    std::println("session {} last seen at {}", session->user, session->lastSeen);
+}
@@ -0,0 +1,146 @@
+#include "size_class_pool.hpp"
+#include <gtest/gtest.h>
+#include <set>
+#include <stdexcept>
+
+namespace {
+
+struct Small {
+    int32_t value;
+};
+
+struct Node {
+    Node* left;
+    Node* right;
+    int64_t key;
+};
+
+struct Order {
+    int64_t id;
+    double price;
+    int64_t quantity;
+};
+
+struct alignas(64) Line {
+    std::byte bytes[64];
+};
+
+struct Counted {
+    static int liveCount;
+    int value;
+
+    explicit Counted(int value)
+        : value(value) {
+        if (value < 0) {
+            throw std::invalid_argument("negative");
+        }
+        ++liveCount;
+    }
+
+    ~Counted() {
+        --liveCount;
+    }
+};
+
+int Counted::liveCount = 0;
+
+using Pool = SizeClassPool<TypeList<Small, Node, Order, Line, Counted>>;
+
+} // namespace
+
+// Test that size classes are computed and shared at compile time
+TEST(SizeClassPoolTest, Classes) {
+    static_assert(sizeClassOf<Small>() == SizeClass{sizeof(void*), alignof(void*)});
+    static_assert(sizeClassOf<Line>() == SizeClass{64, 64});
+    // Node and Order have the same size and alignment, as do Small and Counted.
+    static_assert(Pool::classCount == 3);
+    static_assert(Pool::classIndex<Node> == Pool::classIndex<Order>);
+    static_assert(Pool::classIndex<Small> == Pool::classIndex<Counted>);
+    static_assert(Pool::classIndex<Small> == 0);
+    static_assert(Pool::classIndex<Line> == 2);
+    SUCCEED();
+}
+
+// Test that freed slots are reused in last-in first-out order and that objects are aligned
+TEST(SizeClassPoolTest, FreeListReuse) {
+    Pool pool;
+
+    void* first = pool.allocate<Node>();
+    void* second = pool.allocate<Order>();
+    EXPECT_NE(first, second);
+    pool.deallocate(static_cast<Node*>(first));
+    EXPECT_EQ(pool.allocate<Order>(), first);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.allocate<Line>()) % 64, 0);
+    }
+    EXPECT_EQ(pool.slabCount(), 2);
+}
+
+// Test that slots of a class never overlap, across slabs
+TEST(SizeClassPoolTest, ManyObjects) {
+    Pool pool;
+    DArray<Node*> nodes;
+    std::set<uintptr_t> addresses;
+
+    for (int i = 0; i < 10000; ++i) {
+        Node* node = pool.create<Node>(nullptr, nullptr, i);
+        nodes.push(node);
+        addresses.insert(reinterpret_cast<uintptr_t>(node));
+    }
+
+    EXPECT_EQ(addresses.size(), 10000);
+    EXPECT_GT(pool.slabCount(), 1);
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(nodes[i]->key, i);
+        pool.destroy(nodes[i]);
+    }
+    size_t slabs = pool.slabCount();
+    for (int i = 0; i < 10000; ++i) {
+        pool.create<Order>(i, 1.0, 1);
+    }
+    EXPECT_EQ(pool.slabCount(), slabs);
+}
+
+// Test that a throwing constructor returns the slot to the pool
+TEST(SizeClassPoolTest, CreateFailure) {
+    Pool pool;
+    void* slot = pool.allocate<Counted>();
+    pool.deallocate(static_cast<Counted*>(slot));
+
+    EXPECT_THROW(pool.create<Counted>(-1), std::invalid_argument);
+    EXPECT_EQ(pool.allocate<Counted>(), slot);
+}
+
+// Test that UniquePointer with a pool deleter returns the object to its pool
+TEST(SizeClassPoolTest, PoolPointer) {
+    Pool pool;
+    void* slot;
+    {
+        PoolPointer<Counted, Pool> pointer = makePooled<Counted>(pool, 7);
+        slot = pointer.get();
+        EXPECT_EQ(pointer->value, 7);
+        EXPECT_EQ(Counted::liveCount, 1);
+    }
+    EXPECT_EQ(Counted::liveCount, 0);
+    EXPECT_EQ(pool.allocate<Small>(), slot);
+}
+
+// Test the Allocator interface: small requests use the classes, others go upstream
+TEST(SizeClassPoolTest, AllocatorInterface) {
+    static_assert(Allocator<Pool>);
+    static_assert(Allocator<SizeClassPoolAllocator<Pool>>);
+    Pool pool;
+
+    void* small = pool.allocate(4, std::align_val_t{4});
+    void* line = pool.allocate(40, std::align_val_t{64});
+    void* large = pool.allocate(100000, std::align_val_t{16});
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(line) % 64, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 16, 0);
+    static_cast<std::byte*>(large)[99999] = std::byte{1};
+    pool.deallocate(small, std::align_val_t{4});
+    pool.deallocate(line, std::align_val_t{64});
+    pool.deallocate(large, std::align_val_t{16});
+    EXPECT_EQ(pool.allocate<Small>(), small);
+    EXPECT_EQ(pool.allocate<Line>(), line);
+}
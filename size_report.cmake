@@ -0,0 +1,34 @@
+# Prints the bytes of machine code (.text on ELF, __text on Mach-O) in each object file passed by
+# the `dynamic_array_size_report` target. The shared relocation cores are only in the baseline
+# object, so each type's object holds just the code of its own instantiation.
+#
+# Inputs: SIZE_TOOL, BASELINE, COUNT, and NAME_<i> / OBJECT_<i> for i in [0, COUNT).
+
+function(text_bytes object result)
+    execute_process(COMMAND ${SIZE_TOOL} -A ${object} OUTPUT_VARIABLE output RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "${SIZE_TOOL} failed on ${object}")
+    endif()
+    set(total 0)
+    string(REPLACE "\n" ";" lines "${output}")
+    foreach(line IN LISTS lines)
+        if(line MATCHES "^(\\.text[^ \t]*|__text)[ \t]+([0-9]+)")
+            math(EXPR total "${total} + ${CMAKE_MATCH_2}")
+        endif()
+    endforeach()
+    set(${result} ${total} PARENT_SCOPE)
+endfunction()
+
+text_bytes(${BASELINE} cores)
+message("DArray .text bytes per instantiation (shared relocation cores: ${cores} bytes, counted once)")
+math(EXPR last "${COUNT} - 1")
+foreach(index RANGE ${last})
+    text_bytes(${OBJECT_${index}} own)
+    string(LENGTH "${NAME_${index}}" length)
+    set(spaces " ")
+    if(length LESS 40)
+        math(EXPR padding "40 - ${length}")
+        string(REPEAT " " ${padding} spaces)
+    endif()
+    message("  ${NAME_${index}}${spaces}${own}")
+endforeach()
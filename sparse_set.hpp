@@ -0,0 +1,157 @@
+#ifndef SPARSE_SET_HPP
+#define SPARSE_SET_HPP
+
+#include "dynamic_array.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * @brief A set of integer IDs drawn from a fixed universe [0, universe) (Briggs-Torczon sparse set).
+ * Members are kept packed in a dense array, and a sparse array maps every ID to its position in
+ * the dense array. An ID is a member only if the two agree, so stale sparse entries are harmless:
+ * `clear()` just forgets the dense members, and every operation, including `clear()`, is O(1).
+ * Iteration walks the dense array sequentially (in unspecified order).
+ * @tparam KeyT The unsigned integer type of the IDs. Defaults to `uint32_t`.
+ * @tparam AllocatorT The allocator type used for both arrays. Defaults to `DefaultAllocator`.
+ */
+template <std::unsigned_integral KeyT = uint32_t, Allocator AllocatorT = DefaultAllocator>
+class SparseSet {
+private:
+    DArray<KeyT, AllocatorT> _dense;
+    DArray<KeyT, AllocatorT> _sparse;
+
+    template <typename T>
+    friend struct FootprintTraits;
+
+public:
+    /**
+     * @brief Constructs an empty set for IDs in [0, universe).
+     * The sparse index is allocated (and zeroed) once here; nothing is ever O(universe) afterwards.
+     * @param universe The number of possible IDs.
+     * @throws std::length_error If `universe` IDs are not representable by `KeyT`.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    explicit SparseSet(size_t universe)
+        : _sparse(checkedUniverse(universe)) {}
+
+    /**
+     * @brief Returns the number of possible IDs.
+     */
+    size_t universe() const noexcept {
+        return _sparse.size();
+    }
+
+    /**
+     * @brief Returns the number of members.
+     */
+    size_t size() const noexcept {
+        return _dense.size();
+    }
+
+    bool empty() const noexcept {
+        return _dense.empty();
+    }
+
+    /**
+     * @brief Checks whether `id` is a member. IDs outside the universe are never members.
+     */
+    bool contains(KeyT id) const noexcept {
+        if (id >= _sparse.size()) {
+            return false;
+        }
+        KeyT position = _sparse[id];
+        return position < _dense.size() && _dense[position] == id;
+    }
+
+    /**
+     * @brief Adds `id` to the set.
+     * @return `true` if `id` was added, `false` if it was already a member.
+     * @throws std::out_of_range If `id` is outside the universe.
+     * @throws std::bad_alloc If the dense array has to grow and allocation fails.
+     */
+    bool insert(KeyT id) {
+        if (id >= _sparse.size()) {
+            throw std::out_of_range("Id is out of range");
+        }
+        if (contains(id)) {
+            return false;
+        }
+        _dense.push(id);
+        _sparse[id] = static_cast<KeyT>(_dense.size() - 1);
+        return true;
+    }
+
+    /**
+     * @brief Removes `id` from the set by moving the last member into its place.
+     * Invalidates the position (but not the membership) of the last member.
+     * @return `true` if `id` was removed, `false` if it was not a member.
+     */
+    bool erase(KeyT id) noexcept {
+        if (!contains(id)) {
+            return false;
+        }
+        KeyT position = _sparse[id];
+        KeyT last = _dense.back();
+        _dense[position] = last;
+        _sparse[last] = position;
+        _dense.pop();
+        return true;
+    }
+
+    /**
+     * @brief Removes all members in O(1). The sparse index is left as is.
+     */
+    void clear() noexcept {
+        _dense.clear();
+    }
+
+    /**
+     * @brief Pre-allocates the dense array for `n` members.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    void reserve(size_t n) {
+        _dense.reserve(n);
+    }
+
+    /**
+     * @brief Returns the position of `id` in the dense array. Undefined behavior if `id` is not a member.
+     */
+    size_t indexOf(KeyT id) const noexcept {
+        return _sparse[id];
+    }
+
+    /**
+     * @brief Returns the member at dense position `index`. No bounds checking is performed.
+     */
+    KeyT operator[](size_t index) const noexcept {
+        return _dense[index];
+    }
+
+    /**
+     * @brief Returns a pointer to the dense array of members.
+     */
+    const KeyT* data() const noexcept {
+        return _dense.data();
+    }
+
+    const KeyT* begin() const noexcept {
+        return _dense.begin();
+    }
+
+    const KeyT* end() const noexcept {
+        return _dense.end();
+    }
+
+private:
+    static size_t checkedUniverse(size_t universe) {
+        if (universe > 0 && universe - 1 > std::numeric_limits<KeyT>::max()) {
+            throw std::length_error("Universe is too large for the key type");
+        }
+        return universe;
+    }
+};
+
+#endif // SPARSE_SET_HPP
@@ -0,0 +1,23 @@
+#include "sparse_set.hpp"
+#include <print>
+
+int main() {
+    constexpr uint32_t connections = 1 << 20;
+    SparseSet<> active(connections);
+
+    for (int tick = 0; tick < 3; ++tick) {
+        // Only a handful of the million connection ids are active on any tick.
+        for (uint32_t id = tick; id < connections; id += 100'003) {
+            active.insert(id);
+        }
+        active.erase(tick);
+
+        std::print("tick {}: {} active:", tick, active.size());
+        for (uint32_t id : active) {
+            std::print(" {}", id);
+        }
+        std::println("");
+
+        active.clear(); // O(1), independent of the universe size
+    }
+}
@@ -0,0 +1,117 @@
+#include "sparse_set.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <vector>
+
+TEST(SparseSetTest, EmptySet) {
+    SparseSet<> set(100);
+    EXPECT_EQ(set.universe(), 100);
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.contains(0));
+    EXPECT_FALSE(set.contains(99));
+    EXPECT_FALSE(set.contains(1000));
+}
+
+TEST(SparseSetTest, InsertAndContains) {
+    SparseSet<> set(100);
+    EXPECT_TRUE(set.insert(42));
+    EXPECT_TRUE(set.insert(7));
+    EXPECT_FALSE(set.insert(42));
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_TRUE(set.contains(42));
+    EXPECT_TRUE(set.contains(7));
+    EXPECT_FALSE(set.contains(0));
+    EXPECT_EQ(set[set.indexOf(7)], 7);
+    EXPECT_THROW(set.insert(100), std::out_of_range);
+}
+
+TEST(SparseSetTest, EraseMovesLastMember) {
+    SparseSet<> set(10);
+    set.insert(1);
+    set.insert(2);
+    set.insert(3);
+    EXPECT_TRUE(set.erase(1));
+    EXPECT_FALSE(set.erase(1));
+    EXPECT_FALSE(set.contains(1));
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_EQ(set[0], 3);
+    EXPECT_EQ(set.indexOf(3), 0);
+    EXPECT_TRUE(set.erase(3));
+    EXPECT_TRUE(set.erase(2));
+    EXPECT_TRUE(set.empty());
+}
+
+TEST(SparseSetTest, ClearIsConstantTimeAndForgetsMembers) {
+    SparseSet<> set(1'000'000);
+    for (uint32_t id = 0; id < 1000; ++id) {
+        set.insert(id * 997);
+    }
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    for (uint32_t id = 0; id < 1000; ++id) {
+        EXPECT_FALSE(set.contains(id * 997));
+    }
+    // Stale sparse entries must not make new members look present or absent.
+    set.insert(997);
+    EXPECT_TRUE(set.contains(997));
+    EXPECT_FALSE(set.contains(0));
+    EXPECT_EQ(set.size(), 1);
+}
+
+TEST(SparseSetTest, IterationIsDense) {
+    SparseSet<uint16_t> set(1000);
+    std::vector<uint16_t> ids = {500, 3, 999, 42};
+    for (uint16_t id : ids) {
+        set.insert(id);
+    }
+    std::vector<uint16_t> iterated(set.begin(), set.end());
+    EXPECT_EQ(iterated, ids);
+    EXPECT_EQ(set.data(), set.begin());
+}
+
+TEST(SparseSetTest, UniverseMustFitKeyType) {
+    EXPECT_NO_THROW(SparseSet<uint8_t>(256));
+    EXPECT_THROW(SparseSet<uint8_t>(257), std::length_error);
+}
+
+TEST(SparseSetTest, KeyAsWideAsSizeT) {
+    SparseSet<uint64_t> set(10);
+    EXPECT_EQ(set.universe(), 10);
+    EXPECT_TRUE(set.insert(9));
+    EXPECT_TRUE(set.contains(9));
+    EXPECT_NO_THROW(SparseSet<size_t>(0));
+}
+
+TEST(SparseSetTest, MatchesReference) {
+    std::mt19937 random(7);
+    SparseSet<> set(512);
+    std::set<uint32_t> reference;
+    for (int step = 0; step < 20000; ++step) {
+        uint32_t id = random() % 512;
+        switch (random() % 7) {
+        case 0:
+        case 1:
+        case 2:
+            EXPECT_EQ(set.insert(id), reference.insert(id).second);
+            break;
+        case 3:
+        case 4:
+            EXPECT_EQ(set.erase(id), reference.erase(id) == 1);
+            break;
+        case 5:
+            EXPECT_EQ(set.contains(id), reference.count(id) == 1);
+            break;
+        default:
+            if (random() % 100 == 0) {
+                set.clear();
+                reference.clear();
+            }
+        }
+        ASSERT_EQ(set.size(), reference.size());
+    }
+    std::vector<uint32_t> members(set.begin(), set.end());
+    std::sort(members.begin(), members.end());
+    EXPECT_EQ(members, std::vector<uint32_t>(reference.begin(), reference.end()));
+}
@@ -0,0 +1,278 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include "cache_line.hpp"
+#include "dynamic_array.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief A wait-free single-producer/single-consumer ring queue.
+ * Exactly one thread may push and exactly one (other) thread may pop at a time.
+ * The capacity is rounded up to a power of two so that slot lookup is a mask.
+ * Producer and consumer indices live on separate cache lines, and each side keeps a
+ * cached copy of the other side's index so that the shared line is only read when the
+ * cached value says the queue looks full (producer) or empty (consumer).
+ * @tparam ElementT The type of elements stored in the queue.
+ * @tparam AllocatorT The allocator type used for the slot storage. Defaults to `DefaultAllocator`.
+ */
+template <typename ElementT, Allocator AllocatorT = DefaultAllocator>
+class SpscQueue {
+private:
+    struct Slot {
+        alignas(ElementT) std::byte storage[sizeof(ElementT)];
+
+        ElementT* get() noexcept {
+            return std::launder(reinterpret_cast<ElementT*>(storage));
+        }
+    };
+
+    static_assert(sizeof(Slot) == sizeof(ElementT));
+
+    static constexpr bool bulkCopyable = std::is_trivially_copyable_v<ElementT>;
+
+    // Read-only after construction, shared by both sides.
+    alignas(cacheLineSize) DArray<Slot, AllocatorT> _slots;
+    size_t _mask;
+
+    // Consumer side: owns `_head`, caches the producer's `_tail`.
+    alignas(cacheLineSize) std::atomic<size_t> _head = 0;
+    size_t _cachedTail = 0;
+
+    // Producer side: owns `_tail`, caches the consumer's `_head`.
+    alignas(cacheLineSize) std::atomic<size_t> _tail = 0;
+    size_t _cachedHead = 0;
+
+public:
+    /**
+     * @brief Constructs an empty queue able to hold at least `capacity` elements.
+     * @param capacity The minimum capacity. Rounded up to the next power of two (at least 1).
+     * @throws std::length_error If the rounded capacity is not representable.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    explicit SpscQueue(size_t capacity)
+        : _slots(roundedCapacity(capacity))
+        , _mask(_slots.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Destructor.
+     * Destroys the elements still in the queue. Both sides must have stopped.
+     */
+    ~SpscQueue() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<ElementT>) {
+            size_t tail = _tail.load(std::memory_order_acquire);
+            for (size_t head = _head.load(std::memory_order_relaxed); head != tail; ++head) {
+                slotAt(head).get()->~ElementT();
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of slots in the queue (a power of two).
+     */
+    size_t capacity() const noexcept {
+        return _mask + 1;
+    }
+
+    /**
+     * @brief Returns an approximate number of elements in the queue.
+     * Exact only when called from the producer or consumer thread while the other side is idle.
+     */
+    size_t size() const noexcept {
+        size_t head = _head.load(std::memory_order_acquire);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    /**
+     * @brief Checks whether the queue looks empty. Same caveats as `size()`.
+     */
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Appends a copy of `element`. Producer only.
+     * @return `true` on success, `false` if the queue is full.
+     * @throws Any exception thrown by the ElementT copy constructor (the queue is unchanged).
+     */
+    bool tryPush(const ElementT& element) {
+        return tryEmplace(element);
+    }
+
+    /**
+     * @brief Appends `element` (moved). Producer only.
+     * @return `true` on success, `false` if the queue is full (`element` is left untouched).
+     */
+    bool tryPush(ElementT&& element) {
+        return tryEmplace(std::move(element));
+    }
+
+    /**
+     * @brief Constructs an element in-place at the back of the queue. Producer only.
+     * @return `true` on success, `false` if the queue is full.
+     * @throws Any exception thrown by the ElementT constructor (the queue is unchanged).
+     */
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == capacity()) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == capacity()) {
+                return false;
+            }
+        }
+        new (slotAt(tail).storage) ElementT(std::forward<Args>(args)...);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copies as many elements from [first, last) as currently fit. Producer only.
+     * Trivially copyable elements are transferred with at most two `memcpy` calls.
+     * All copied elements are published with a single release store.
+     * @return The number of elements pushed (a prefix of the range).
+     * @throws Any exception thrown by the ElementT copy constructor. Elements copied before
+     * the failure are published.
+     */
+    size_t pushMany(const ElementT* first, const ElementT* last) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t n = static_cast<size_t>(last - first);
+        size_t free = capacity() - (tail - _cachedHead);
+        if (free < n) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            free = capacity() - (tail - _cachedHead);
+        }
+        n = std::min(n, free);
+        if (n == 0) {
+            return 0;
+        }
+        if constexpr (bulkCopyable) {
+            size_t index = tail & _mask;
+            size_t firstChunk = std::min(n, capacity() - index);
+            std::memcpy(_slots.data() + index, first, firstChunk * sizeof(ElementT));
+            std::memcpy(_slots.data(), first + firstChunk, (n - firstChunk) * sizeof(ElementT));
+        } else {
+            size_t count = 0;
+            try {
+                for (; count < n; ++count) {
+                    new (slotAt(tail + count).storage) ElementT(first[count]);
+                }
+            } catch (...) {
+                _tail.store(tail + count, std::memory_order_release);
+                throw;
+            }
+        }
+        _tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Moves the front element into `element`. Consumer only.
+     * @return `true` on success, `false` if the queue is empty.
+     */
+    bool tryPop(ElementT& element) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) {
+                return false;
+            }
+        }
+        ElementT* src = slotAt(head).get();
+        element = std::move(*src);
+        src->~ElementT();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns a pointer to the front element without removing it. Consumer only.
+     * @return A pointer to the front element, or `nullptr` if the queue is empty.
+     */
+    ElementT* front() noexcept {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) {
+                return nullptr;
+            }
+        }
+        return slotAt(head).get();
+    }
+
+    /**
+     * @brief Removes the front element. Consumer only.
+     * Undefined behavior if `front()` has not returned a non-null pointer since the last pop.
+     */
+    void pop() noexcept {
+        size_t head = _head.load(std::memory_order_relaxed);
+        slotAt(head).get()->~ElementT();
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Moves up to `n` front elements into `dst`. Consumer only.
+     * `dst` must point to `n` constructed (assignable) elements.
+     * Trivially copyable elements are transferred with at most two `memcpy` calls.
+     * @return The number of elements popped.
+     */
+    size_t popMany(ElementT* dst, size_t n) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t available = _cachedTail - head;
+        if (available < n) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            available = _cachedTail - head;
+        }
+        n = std::min(n, available);
+        if (n == 0) {
+            return 0;
+        }
+        if constexpr (bulkCopyable) {
+            size_t index = head & _mask;
+            size_t firstChunk = std::min(n, capacity() - index);
+            std::memcpy(dst, _slots.data() + index, firstChunk * sizeof(ElementT));
+            std::memcpy(dst + firstChunk, _slots.data(), (n - firstChunk) * sizeof(ElementT));
+        } else {
+            size_t count = 0;
+            try {
+                for (; count < n; ++count) {
+                    ElementT* src = slotAt(head + count).get();
+                    dst[count] = std::move(*src);
+                    src->~ElementT();
+                }
+            } catch (...) {
+                _head.store(head + count, std::memory_order_release);
+                throw;
+            }
+        }
+        _head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    static size_t roundedCapacity(size_t capacity) {
+        if (capacity > (std::numeric_limits<size_t>::max() >> 1) + 1) {
+            throw std::length_error("Required capacity is too large");
+        }
+        return std::bit_ceil(capacity > 0 ? capacity : 1);
+    }
+
+    Slot& slotAt(size_t position) noexcept {
+        return _slots[position & _mask];
+    }
+};
+
+#endif // SPSC_QUEUE_HPP
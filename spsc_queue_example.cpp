@@ -0,0 +1,71 @@
+#include "spsc_queue.hpp"
+#include <chrono>
+#include <cstdint>
+#include <print>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+void pinToCpu(std::thread& thread, int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+int main() {
+    constexpr uint64_t count = 50'000'000;
+    constexpr size_t batchSize = 64;
+    SpscQueue<uint64_t> queue(4096);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&] {
+        uint64_t batch[batchSize];
+        uint64_t next = 0;
+        while (next < count) {
+            size_t n = std::min<uint64_t>(batchSize, count - next);
+            for (size_t i = 0; i < n; ++i) {
+                batch[i] = next + i;
+            }
+            size_t pushed = queue.pushMany(batch, batch + n);
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            next += pushed;
+        }
+    });
+
+    std::thread consumer([&] {
+        uint64_t batch[batchSize];
+        uint64_t received = 0;
+        uint64_t sum = 0;
+        while (received < count) {
+            size_t n = queue.popMany(batch, batchSize);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < n; ++i) {
+                sum += batch[i];
+            }
+            received += n;
+        }
+        std::println("checksum: {}", sum == count * (count - 1) / 2 ? "ok" : "mismatch");
+    });
+
+    pinToCpu(producer, 0);
+    pinToCpu(consumer, 1);
+    producer.join();
+    consumer.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("{} items in {:.3f} s: {:.1f} M items/s", count, elapsed.count(), count / elapsed.count() / 1e6);
+}
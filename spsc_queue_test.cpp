@@ -0,0 +1,165 @@
+#include "spsc_queue.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+TEST(SpscQueueTest, CapacityIsRoundedToPowerOfTwo) {
+    EXPECT_EQ(SpscQueue<int>(0).capacity(), 1);
+    EXPECT_EQ(SpscQueue<int>(1).capacity(), 1);
+    EXPECT_EQ(SpscQueue<int>(5).capacity(), 8);
+    EXPECT_EQ(SpscQueue<int>(64).capacity(), 64);
+}
+
+TEST(SpscQueueTest, IndicesLiveOnSeparateCacheLines) {
+    EXPECT_EQ(alignof(SpscQueue<int>), cacheLineSize);
+    EXPECT_GE(sizeof(SpscQueue<int>), 3 * cacheLineSize);
+}
+
+TEST(SpscQueueTest, PushAndPop) {
+    SpscQueue<int> queue(4);
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.size(), 4);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, FrontAndPop) {
+    SpscQueue<std::string> queue(2);
+    EXPECT_EQ(queue.front(), nullptr);
+    queue.tryEmplace(3, 'a');
+    ASSERT_NE(queue.front(), nullptr);
+    EXPECT_EQ(*queue.front(), "aaa");
+    queue.pop();
+    EXPECT_EQ(queue.front(), nullptr);
+}
+
+TEST(SpscQueueTest, WrapAround) {
+    SpscQueue<int> queue(4);
+    int value = 0;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.tryPush(i));
+        ASSERT_TRUE(queue.tryPush(i + 1000));
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i + 1000);
+    }
+}
+
+TEST(SpscQueueTest, PushManyPopManyTrivial) {
+    SpscQueue<int> queue(8);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10] = {};
+
+    EXPECT_EQ(queue.pushMany(in, in + 5), 5);
+    EXPECT_EQ(queue.popMany(out, 3), 3);
+    // Next batch wraps around the end of the ring.
+    EXPECT_EQ(queue.pushMany(in + 5, in + 10), 5);
+    EXPECT_EQ(queue.pushMany(in, in + 10), 1);
+    EXPECT_EQ(queue.popMany(out + 3, 7), 7);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_EQ(queue.popMany(out, 1), 1);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(queue.popMany(out, 1), 0);
+}
+
+TEST(SpscQueueTest, PushManyPopManyNonTrivial) {
+    SpscQueue<std::string> queue(4);
+    std::string in[3] = {"a", "b", "c"};
+    std::string out[3];
+    EXPECT_EQ(queue.pushMany(in, in + 3), 3);
+    EXPECT_EQ(queue.pushMany(in, in + 3), 1);
+    EXPECT_EQ(queue.popMany(out, 3), 3);
+    EXPECT_EQ(out[0], "a");
+    EXPECT_EQ(out[1], "b");
+    EXPECT_EQ(out[2], "c");
+    EXPECT_EQ(queue.size(), 1);
+}
+
+struct Counted {
+    static int alive;
+
+    Counted() {
+        ++alive;
+    }
+
+    Counted(const Counted&) {
+        ++alive;
+    }
+
+    Counted& operator=(const Counted&) = default;
+
+    ~Counted() {
+        --alive;
+    }
+};
+
+int Counted::alive = 0;
+
+TEST(SpscQueueTest, DestructorDestroysRemainingElements) {
+    Counted::alive = 0;
+    {
+        SpscQueue<Counted> queue(4);
+        queue.tryEmplace();
+        queue.tryEmplace();
+        queue.tryEmplace();
+        Counted out;
+        queue.tryPop(out);
+        EXPECT_EQ(Counted::alive, 3);
+    }
+    EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(SpscQueueTest, ProducerConsumerThreads) {
+    constexpr size_t count = 1'000'000;
+    SpscQueue<size_t> queue(1024);
+
+    std::thread producer([&] {
+        size_t batch[16];
+        size_t next = 0;
+        while (next < count) {
+            if (next % 3 == 0) {
+                if (queue.tryPush(next)) {
+                    ++next;
+                } else {
+                    std::this_thread::yield();
+                }
+            } else {
+                size_t n = std::min<size_t>(16, count - next);
+                for (size_t i = 0; i < n; ++i) {
+                    batch[i] = next + i;
+                }
+                next += queue.pushMany(batch, batch + n);
+            }
+        }
+    });
+
+    size_t expected = 0;
+    size_t batch[32];
+    bool ordered = true;
+    while (expected < count) {
+        size_t n = queue.popMany(batch, 32);
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ordered = ordered && batch[i] == expected++;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,403 @@
+#ifndef STABLE_ARRAY_HPP
+#define STABLE_ARRAY_HPP
+
+#include "dynamic_array.hpp"
+#include "unique_pointer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief An array of individually owned objects with stable addresses (a `DArray<UniquePointer<T>>`
+ * replacement) whose pointees live in chunked arenas instead of separate heap blocks.
+ * Pointees are placed one after another in insertion order, so iterating a freshly built array
+ * walks memory sequentially. Erasing an element only destroys its pointee and returns the slot
+ * to a free list; `compact()` reorders all pointees to match index order after heavy churn.
+ * Iteration prefetches pointees a few elements ahead.
+ * @tparam ElementT The type of elements stored in the array.
+ * @tparam AllocatorT The allocator used for the arena chunks and the index. Defaults to `DefaultAllocator`.
+ */
+template <typename ElementT, Allocator AllocatorT = DefaultAllocator>
+class StableArray {
+public:
+    /**
+     * @brief Deleter for handles released from the array: destroys the pointee and returns its
+     * slot to the owning array's arena.
+     */
+    struct ArenaDeleter {
+        StableArray* owner = nullptr;
+
+        void operator()(ElementT* pointer) const noexcept {
+            owner->destroyReleased(pointer);
+        }
+    };
+
+    /**
+     * @brief Owning handle to a pointee that lives in the array's arena. Must not outlive the array.
+     */
+    using Handle = UniquePointer<ElementT, ArenaDeleter>;
+
+    /**
+     * @brief Number of elements ahead of the current one whose pointees are prefetched during iteration.
+     */
+    static constexpr size_t prefetchDistance = 8;
+
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementT;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const ElementT*, ElementT*>;
+        using reference = std::conditional_t<IsConst, const ElementT&, ElementT&>;
+
+    private:
+        ElementT* const* _position = nullptr;
+        ElementT* const* _end = nullptr;
+
+    public:
+        Iterator() noexcept = default;
+
+        Iterator(ElementT* const* position, ElementT* const* end) noexcept
+            : _position(position)
+            , _end(end) {
+            for (size_t i = 0; i < prefetchDistance && _position + i < _end; ++i) {
+                prefetch(_position[i]);
+            }
+        }
+
+        reference operator*() const noexcept {
+            return **_position;
+        }
+
+        pointer operator->() const noexcept {
+            return *_position;
+        }
+
+        Iterator& operator++() noexcept {
+            ++_position;
+            if (_end - _position > static_cast<std::ptrdiff_t>(prefetchDistance)) {
+                prefetch(_position[prefetchDistance]);
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {
+            return _position == other._position;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+private:
+    DArray<ElementT*, AllocatorT> _index;
+    DArray<ElementT*, AllocatorT> _chunks;
+    DArray<ElementT*, AllocatorT> _free;
+    size_t _chunkCapacity;
+    size_t _bumpUsed = 0;
+    size_t _released = 0;
+    AllocatorT _allocator;
+
+    template <typename T>
+    friend struct FootprintTraits;
+
+public:
+    /**
+     * @brief Constructs an empty array.
+     * @param chunkCapacity The number of pointees per arena chunk. Defaults to as many as fit in 4 KiB (at least 1).
+     */
+    explicit StableArray(size_t chunkCapacity = defaultChunkCapacity())
+        : _chunkCapacity(chunkCapacity > 0 ? chunkCapacity : 1) {}
+
+    StableArray(const StableArray&) = delete;
+
+    StableArray& operator=(const StableArray&) = delete;
+
+    /**
+     * @brief Destructor.
+     * Destroys all elements and releases the arena. Handles obtained with `release()` must be gone by now.
+     */
+    ~StableArray() noexcept {
+        assert(_released == 0);
+        clear();
+        for (ElementT* chunk : _chunks) {
+            _allocator.deallocate(chunk, alignment());
+        }
+    }
+
+    /**
+     * @brief Accesses the element at the specified index. No bounds checking is performed.
+     */
+    ElementT& operator[](size_t index) noexcept {
+        return *_index[index];
+    }
+
+    /**
+     * @brief Accesses the element at the specified index (const version). No bounds checking is performed.
+     */
+    const ElementT& operator[](size_t index) const noexcept {
+        return *_index[index];
+    }
+
+    /**
+     * @brief Accesses the element at the specified index with bounds checking.
+     * @throws std::out_of_range If `index` is out of bounds.
+     */
+    ElementT& at(size_t index) {
+        return *_index.at(index);
+    }
+
+    /**
+     * @brief Accesses the element at the specified index with bounds checking (const version).
+     * @throws std::out_of_range If `index` is out of bounds.
+     */
+    const ElementT& at(size_t index) const {
+        return *_index.at(index);
+    }
+
+    /**
+     * @brief Returns the stable address of the element at the specified index.
+     */
+    ElementT* get(size_t index) const noexcept {
+        return _index[index];
+    }
+
+    ElementT& front() noexcept {
+        return *_index.front();
+    }
+
+    const ElementT& front() const noexcept {
+        return *_index.front();
+    }
+
+    ElementT& back() noexcept {
+        return *_index.back();
+    }
+
+    const ElementT& back() const noexcept {
+        return *_index.back();
+    }
+
+    iterator begin() noexcept {
+        return iterator(_index.begin(), _index.end());
+    }
+
+    iterator end() noexcept {
+        return iterator(_index.end(), _index.end());
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(_index.begin(), _index.end());
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(_index.end(), _index.end());
+    }
+
+    bool empty() const noexcept {
+        return _index.empty();
+    }
+
+    size_t size() const noexcept {
+        return _index.size();
+    }
+
+    /**
+     * @brief Returns the number of pointee slots in the arena (used, free and released).
+     */
+    size_t capacity() const noexcept {
+        return _chunks.size() * _chunkCapacity;
+    }
+
+    size_t chunkCapacity() const noexcept {
+        return _chunkCapacity;
+    }
+
+    /**
+     * @brief Appends a copy of `element`.
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws Any exception thrown by the ElementT copy constructor.
+     */
+    void push(const ElementT& element) {
+        emplaceAtEnd(element);
+    }
+
+    /**
+     * @brief Appends `element` (moved).
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws Any exception thrown by the ElementT move constructor.
+     */
+    void push(ElementT&& element) {
+        emplaceAtEnd(std::move(element));
+    }
+
+    /**
+     * @brief Constructs an element in-place at the end of the array.
+     * @return A reference to the newly constructed element.
+     * @throws std::bad_alloc If memory allocation fails.
+     * @throws Any exception thrown by the ElementT constructor.
+     */
+    template <typename... Args>
+    ElementT& emplaceAtEnd(Args&&... args) {
+        if (_index.size() == _index.capacity()) {
+            _index.reserve(std::max<size_t>(_index.capacity() * 2, 1));
+        }
+        ElementT* slot = allocateSlot();
+        try {
+            new (slot) ElementT(std::forward<Args>(args)...);
+        } catch (...) {
+            _free.push(slot);
+            throw;
+        }
+        _index.push(slot);
+        return *slot;
+    }
+
+    /**
+     * @brief Removes the last element. Undefined behavior if the array is empty.
+     */
+    void pop() noexcept {
+        destroyPointee(_index.back());
+        _index.pop();
+    }
+
+    /**
+     * @brief Erases the element at `index`. Other elements keep their addresses.
+     */
+    void erase(size_t index) noexcept {
+        destroyPointee(_index[index]);
+        _index.erase(_index.begin() + index);
+    }
+
+    /**
+     * @brief Removes the element at `index` from the array and returns an owning handle to it.
+     * The pointee stays in the arena until the handle is reset; the handle must not outlive the array.
+     */
+    Handle release(size_t index) noexcept {
+        ElementT* pointer = _index[index];
+        _index.erase(_index.begin() + index);
+        ++_released;
+        Handle handle(pointer);
+        handle.getDeleter().owner = this;
+        return handle;
+    }
+
+    /**
+     * @brief Destroys all elements. The arena keeps its chunks for reuse.
+     */
+    void clear() noexcept {
+        for (size_t i = _index.size(); i-- > 0;) {
+            destroyPointee(_index[i]);
+        }
+        _index.clear();
+    }
+
+    /**
+     * @brief Moves all pointees into fresh chunks laid out in index order and releases the old arena.
+     * Invalidates all element addresses. Must not be called while released handles are alive.
+     * @throws std::logic_error If handles obtained with `release()` are still alive.
+     * @throws std::bad_alloc If memory allocation fails (the array is unchanged).
+     */
+    void compact()
+        requires std::is_nothrow_move_constructible_v<ElementT>
+    {
+        if (_released > 0) {
+            throw std::logic_error("Cannot compact while released handles are alive");
+        }
+        size_t chunkCount = (_index.size() + _chunkCapacity - 1) / _chunkCapacity;
+        DArray<ElementT*, AllocatorT> chunks;
+        DArray<ElementT*, AllocatorT> free;
+        chunks.reserve(chunkCount);
+        free.reserve(chunkCount * _chunkCapacity);
+        try {
+            for (size_t i = 0; i < chunkCount; ++i) {
+                chunks.push(allocateChunk());
+            }
+        } catch (...) {
+            for (ElementT* chunk : chunks) {
+                _allocator.deallocate(chunk, alignment());
+            }
+            throw;
+        }
+
+        for (size_t i = 0; i < _index.size(); ++i) {
+            ElementT* dst = chunks[i / _chunkCapacity] + i % _chunkCapacity;
+            new (dst) ElementT(std::move(*_index[i]));
+            _index[i]->~ElementT();
+            _index[i] = dst;
+        }
+        for (ElementT* chunk : _chunks) {
+            _allocator.deallocate(chunk, alignment());
+        }
+        _chunks.swap(chunks);
+        _free.swap(free);
+        _bumpUsed = _index.size() - (chunkCount > 0 ? (chunkCount - 1) * _chunkCapacity : 0);
+    }
+
+private:
+    static size_t defaultChunkCapacity() noexcept {
+        return std::max<size_t>(1, 4096 / sizeof(ElementT));
+    }
+
+    static std::align_val_t alignment() noexcept {
+        return static_cast<std::align_val_t>(alignof(ElementT));
+    }
+
+    static void prefetch(const ElementT* pointer) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(pointer);
+#else
+        (void)pointer;
+#endif
+    }
+
+    ElementT* allocateChunk() {
+        return static_cast<ElementT*>(_allocator.allocate(_chunkCapacity * sizeof(ElementT), alignment()));
+    }
+
+    // Free slots are reused first; otherwise slots are handed out sequentially from the last chunk.
+    // The free list always has room for every slot in the arena, so returning a slot never allocates.
+    ElementT* allocateSlot() {
+        if (!_free.empty()) {
+            ElementT* slot = _free.back();
+            _free.pop();
+            return slot;
+        }
+        if (_chunks.empty() || _bumpUsed == _chunkCapacity) {
+            if (_chunks.size() == _chunks.capacity()) {
+                _chunks.reserve(std::max<size_t>(_chunks.capacity() * 2, 1));
+            }
+            _free.reserve((_chunks.size() + 1) * _chunkCapacity);
+            _chunks.push(allocateChunk());
+            _bumpUsed = 0;
+        }
+        return _chunks.back() + _bumpUsed++;
+    }
+
+    void destroyPointee(ElementT* pointer) noexcept {
+        pointer->~ElementT();
+        _free.push(pointer);
+    }
+
+    void destroyReleased(ElementT* pointer) noexcept {
+        assert(_released > 0);
+        --_released;
+        destroyPointee(pointer);
+    }
+
+    friend struct ArenaDeleter;
+};
+
+#endif // STABLE_ARRAY_HPP
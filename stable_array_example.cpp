@@ -0,0 +1,47 @@
+#include "stable_array.hpp"
+#include <chrono>
+#include <print>
+
+struct Particle {
+    double x, y, z;
+    double mass;
+};
+
+template <typename F>
+double measure(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main() {
+    constexpr size_t count = 1'000'000;
+
+    DArray<UniquePointer<Particle>> pointers;
+    StableArray<Particle> particles;
+    for (size_t i = 0; i < count; ++i) {
+        pointers.push(makeUnique<Particle>(1.0, 2.0, 3.0, double(i)));
+        particles.emplaceAtEnd(1.0, 2.0, 3.0, double(i));
+    }
+    // Churn: drop the upper half and append replacements, which reuse the freed slots in reverse order.
+    for (size_t i = 0; i < count / 2; ++i) {
+        particles.pop();
+    }
+    for (size_t i = 0; i < count / 2; ++i) {
+        particles.emplaceAtEnd(1.0, 2.0, 3.0, double(i));
+    }
+
+    double sum = 0;
+    std::println("DArray<UniquePointer>:   {:.2f} ms", measure([&] {
+                     for (auto& p : pointers) sum += p->mass;
+                 }));
+    std::println("StableArray (churned):   {:.2f} ms", measure([&] {
+                     for (auto& p : particles) sum += p.mass;
+                 }));
+    particles.compact();
+    std::println("StableArray (compacted): {:.2f} ms", measure([&] {
+                     for (auto& p : particles) sum += p.mass;
+                 }));
+    std::println("checksum: {}", sum);
+}
@@ -0,0 +1,198 @@
+#include "stable_array.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+struct Tracked {
+    static int alive;
+
+    int value;
+
+    Tracked(int value)
+        : value(value) {
+        ++alive;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value) {
+        ++alive;
+    }
+
+    ~Tracked() {
+        --alive;
+    }
+};
+
+int Tracked::alive = 0;
+
+class StableArrayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Tracked::alive = 0;
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(Tracked::alive, 0);
+    }
+};
+
+TEST_F(StableArrayTest, PushAndAccess) {
+    StableArray<Tracked> array(4);
+    for (int i = 0; i < 10; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    EXPECT_EQ(array.size(), 10);
+    EXPECT_EQ(array.capacity(), 12);
+    EXPECT_EQ(Tracked::alive, 10);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(array[i].value, i);
+    }
+    EXPECT_EQ(array.front().value, 0);
+    EXPECT_EQ(array.back().value, 9);
+    EXPECT_THROW(array.at(10), std::out_of_range);
+}
+
+TEST_F(StableArrayTest, PointeesAreSequentialInInsertionOrder) {
+    StableArray<Tracked> array(8);
+    for (int i = 0; i < 8; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    for (int i = 1; i < 8; ++i) {
+        EXPECT_EQ(array.get(i), array.get(i - 1) + 1);
+    }
+}
+
+TEST_F(StableArrayTest, AddressesAreStable) {
+    StableArray<Tracked> array(2);
+    array.emplaceAtEnd(0);
+    Tracked* first = array.get(0);
+    for (int i = 1; i < 100; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    array.erase(50);
+    EXPECT_EQ(array.get(0), first);
+    EXPECT_EQ(array[50].value, 51);
+}
+
+TEST_F(StableArrayTest, ErasedSlotsAreReused) {
+    StableArray<Tracked> array(4);
+    for (int i = 0; i < 4; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    Tracked* erased = array.get(1);
+    array.erase(1);
+    array.emplaceAtEnd(4);
+    EXPECT_EQ(array.get(3), erased);
+    EXPECT_EQ(array.capacity(), 4);
+    array.pop();
+    EXPECT_EQ(array.size(), 3);
+}
+
+TEST_F(StableArrayTest, Iteration) {
+    StableArray<std::string> array(3);
+    for (int i = 0; i < 20; ++i) {
+        array.push(std::to_string(i));
+    }
+    int expected = 0;
+    for (const std::string& element : array) {
+        EXPECT_EQ(element, std::to_string(expected++));
+    }
+    EXPECT_EQ(expected, 20);
+
+    const auto& constArray = array;
+    expected = 0;
+    for (auto it = constArray.begin(); it != constArray.end(); ++it) {
+        EXPECT_EQ(it->size(), std::to_string(expected++).size());
+    }
+    static_assert(std::forward_iterator<StableArray<int>::iterator>);
+    static_assert(std::forward_iterator<StableArray<int>::const_iterator>);
+}
+
+TEST_F(StableArrayTest, ReleaseHandsOutOwningHandle) {
+    StableArray<Tracked> array(4);
+    array.emplaceAtEnd(1);
+    array.emplaceAtEnd(2);
+    {
+        StableArray<Tracked>::Handle handle = array.release(0);
+        EXPECT_EQ(array.size(), 1);
+        EXPECT_EQ(handle->value, 1);
+        EXPECT_EQ(Tracked::alive, 2);
+        EXPECT_THROW(array.compact(), std::logic_error);
+    }
+    EXPECT_EQ(Tracked::alive, 1);
+    EXPECT_NO_THROW(array.compact());
+}
+
+TEST_F(StableArrayTest, CompactRestoresIndexOrder) {
+    StableArray<Tracked> array(4);
+    for (int i = 0; i < 16; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    for (int i = 0; i < 8; ++i) {
+        array.erase(i);
+        array.emplaceAtEnd(100 + i);
+    }
+    array.compact();
+    EXPECT_EQ(array.capacity(), 16);
+    EXPECT_EQ(Tracked::alive, 16);
+    for (size_t i = 1; i < array.size(); ++i) {
+        if (i % 4 != 0) {
+            EXPECT_EQ(array.get(i), array.get(i - 1) + 1);
+        }
+    }
+    EXPECT_EQ(array[0].value, 1);
+    EXPECT_EQ(array[15].value, 107);
+
+    array.emplaceAtEnd(200);
+    EXPECT_EQ(array.capacity(), 20);
+    EXPECT_EQ(array.back().value, 200);
+}
+
+TEST_F(StableArrayTest, CompactAfterShrinking) {
+    StableArray<Tracked> array(4);
+    for (int i = 0; i < 10; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    while (array.size() > 5) {
+        array.erase(0);
+    }
+    array.compact();
+    EXPECT_EQ(array.capacity(), 8);
+    array.emplaceAtEnd(10);
+    array.emplaceAtEnd(11);
+    array.emplaceAtEnd(12);
+    EXPECT_EQ(array.capacity(), 8);
+    EXPECT_EQ(array.get(7), array.get(6) + 1);
+    array.emplaceAtEnd(13);
+    EXPECT_EQ(array.capacity(), 12);
+}
+
+TEST_F(StableArrayTest, ClearKeepsArena) {
+    StableArray<Tracked> array(4);
+    for (int i = 0; i < 8; ++i) {
+        array.emplaceAtEnd(i);
+    }
+    Tracked* first = array.get(0);
+    array.clear();
+    EXPECT_TRUE(array.empty());
+    EXPECT_EQ(Tracked::alive, 0);
+    array.emplaceAtEnd(0);
+    EXPECT_EQ(array.get(0), first);
+    EXPECT_EQ(array.capacity(), 8);
+}
+
+struct ThrowingConstructor {
+    ThrowingConstructor(bool fail) {
+        if (fail) {
+            throw std::runtime_error("Construction failed");
+        }
+    }
+};
+
+TEST_F(StableArrayTest, ConstructorFailureReturnsSlot) {
+    StableArray<ThrowingConstructor> array(2);
+    array.emplaceAtEnd(false);
+    EXPECT_THROW(array.emplaceAtEnd(true), std::runtime_error);
+    EXPECT_EQ(array.size(), 1);
+    array.emplaceAtEnd(false);
+    EXPECT_EQ(array.capacity(), 2);
+}
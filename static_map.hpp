@@ -0,0 +1,371 @@
+#ifndef STATIC_MAP_HPP
+#define STATIC_MAP_HPP
+
+#include "type_list.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Key types a static table can hash at compile time.
+ */
+template <typename T>
+concept StaticKey = std::integral<T> || std::is_enum_v<T> || std::same_as<T, std::string_view>;
+
+/**
+ * @brief Hashes `key` with `seed` (FNV-1a for strings, then the splitmix64 finalizer). constexpr,
+ * so tables are built by the compiler and looked up with the same function at run time.
+ */
+template <StaticKey KeyT>
+constexpr uint64_t staticHash(const KeyT& key, uint64_t seed) noexcept {
+    uint64_t hash;
+    if constexpr (std::same_as<KeyT, std::string_view>) {
+        hash = 0xcbf29ce484222325 ^ seed;
+        for (char c : key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+        }
+    } else if constexpr (std::is_enum_v<KeyT>) {
+        hash = static_cast<uint64_t>(std::to_underlying(key)) ^ (seed * 0x9e3779b97f4a7c15);
+    } else {
+        hash = static_cast<uint64_t>(key) ^ (seed * 0x9e3779b97f4a7c15);
+    }
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief An immutable set of `N` keys, built at compile time (declare it `constexpr`), so that it
+ * is placed in `.rodata` (`.data.rel.ro` if it holds pointers, as string views do) and needs no
+ * initialization at startup.
+ * Keys are stored sorted; a minimal-size perfect hash (hash and displace) maps each key to its
+ * position, so `indexOf` costs two hashes and one key comparison.
+ * @tparam KeyT An integral, enum or `std::string_view` key type.
+ * @tparam N The number of keys.
+ */
+template <StaticKey KeyT, size_t N>
+class StaticSet {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    // The number of slots and of displacement buckets; at most twice the number of keys.
+    static constexpr size_t tableSize = std::bit_ceil(std::max<size_t>(N, 1));
+
+private:
+    static constexpr int32_t maxSeed = 1 << 20;
+
+    std::array<KeyT, N> _keys{};
+    // Per bucket: a seed for the second hash, or -1 - slot for buckets holding a single key.
+    std::array<int32_t, tableSize> _displacements{};
+    // Per slot: the index of its key, or N if the slot is empty.
+    std::array<uint32_t, tableSize> _slots{};
+
+public:
+    /**
+     * @brief Builds the set from `keys`, in any order.
+     * @throws std::invalid_argument If a key appears twice (a compile error in a constant expression).
+     * @throws std::logic_error If no perfect hash is found, which is astronomically unlikely.
+     */
+    constexpr explicit StaticSet(const std::array<KeyT, N>& keys)
+        : _keys(keys) {
+        std::sort(_keys.begin(), _keys.end());
+        if (std::adjacent_find(_keys.begin(), _keys.end()) != _keys.end()) {
+            throw std::invalid_argument("Duplicate key");
+        }
+        buildHash();
+    }
+
+    /**
+     * @brief Returns the position of `key` in sorted order, or `npos` if it is not a member.
+     */
+    constexpr size_t indexOf(const KeyT& key) const noexcept {
+        size_t slot = slotOf(key, _displacements[bucketOf(key)]);
+        uint32_t index = _slots[slot];
+        return index < N && _keys[index] == key ? index : npos;
+    }
+
+    constexpr bool contains(const KeyT& key) const noexcept {
+        return indexOf(key) != npos;
+    }
+
+    static constexpr size_t size() noexcept {
+        return N;
+    }
+
+    /**
+     * @brief Returns the keys in sorted order.
+     */
+    constexpr const std::array<KeyT, N>& keys() const noexcept {
+        return _keys;
+    }
+
+    constexpr auto begin() const noexcept {
+        return _keys.begin();
+    }
+
+    constexpr auto end() const noexcept {
+        return _keys.end();
+    }
+
+private:
+    static constexpr size_t bucketOf(const KeyT& key) noexcept {
+        return staticHash(key, 0) & (tableSize - 1);
+    }
+
+    static constexpr size_t slotOf(const KeyT& key, int32_t displacement) noexcept {
+        if (displacement < 0) {
+            return static_cast<size_t>(-1 - displacement);
+        }
+        return staticHash(key, static_cast<uint64_t>(displacement)) & (tableSize - 1);
+    }
+
+    // Places the keys of the largest buckets first, each with the first seed that sends all of
+    // them to distinct free slots; single-key buckets then take the remaining slots directly.
+    constexpr void buildHash() {
+        std::array<size_t, N> bucketOfKey{};
+        std::array<size_t, tableSize> bucketSizes{};
+        for (size_t i = 0; i < N; ++i) {
+            bucketOfKey[i] = bucketOf(_keys[i]);
+            ++bucketSizes[bucketOfKey[i]];
+        }
+        std::array<size_t, tableSize> order{};
+        for (size_t b = 0; b < tableSize; ++b) {
+            order[b] = b;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t left, size_t right) {
+            return bucketSizes[left] != bucketSizes[right] ? bucketSizes[left] > bucketSizes[right] : left < right;
+        });
+        // The keys grouped by bucket (a counting sort), so each bucket's keys are found in O(1).
+        std::array<size_t, tableSize + 1> bucketStarts{};
+        for (size_t b = 0; b < tableSize; ++b) {
+            bucketStarts[b + 1] = bucketStarts[b] + bucketSizes[b];
+        }
+        std::array<size_t, N> byBucket{};
+        std::array<size_t, tableSize> filled{};
+        for (size_t i = 0; i < N; ++i) {
+            byBucket[bucketStarts[bucketOfKey[i]] + filled[bucketOfKey[i]]++] = i;
+        }
+        _slots.fill(static_cast<uint32_t>(N));
+
+        std::array<size_t, N> members{};
+        std::array<size_t, N> candidates{};
+        size_t nextFree = 0;
+        for (size_t bucket : order) {
+            size_t count = bucketSizes[bucket];
+            for (size_t k = 0; k < count; ++k) {
+                members[k] = byBucket[bucketStarts[bucket] + k];
+            }
+            if (count == 0) {
+                break;
+            }
+            if (count == 1) {
+                while (_slots[nextFree] != N) {
+                    ++nextFree;
+                }
+                _slots[nextFree] = static_cast<uint32_t>(members[0]);
+                _displacements[bucket] = -1 - static_cast<int32_t>(nextFree);
+                continue;
+            }
+            int32_t seed = 1;
+            while (!tryPlace(members, count, seed, candidates)) {
+                if (++seed == maxSeed) {
+                    throw std::logic_error("No perfect hash found");
+                }
+            }
+            for (size_t k = 0; k < count; ++k) {
+                _slots[candidates[k]] = static_cast<uint32_t>(members[k]);
+            }
+            _displacements[bucket] = seed;
+        }
+    }
+
+    constexpr bool tryPlace(const std::array<size_t, N>& members, size_t count, int32_t seed, std::array<size_t, N>& candidates) const {
+        for (size_t k = 0; k < count; ++k) {
+            candidates[k] = slotOf(_keys[members[k]], seed);
+            if (_slots[candidates[k]] != N) {
+                return false;
+            }
+            for (size_t j = 0; j < k; ++j) {
+                if (candidates[j] == candidates[k]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief An immutable map from `N` keys to values of one type, built at compile time.
+ * Values are stored in key order next to the `StaticSet` of keys.
+ * Usage: `constexpr auto codes = makeStaticMap<std::string_view, int>({{"ok", 200}, {"not found", 404}});`.
+ */
+template <StaticKey KeyT, typename ValueT, size_t N>
+class StaticMap {
+private:
+    StaticSet<KeyT, N> _keys;
+    std::array<ValueT, N> _values{};
+
+public:
+    /**
+     * @brief Builds the map from key-value pairs, in any order.
+     * @throws std::invalid_argument If a key appears twice.
+     */
+    constexpr explicit StaticMap(const std::array<std::pair<KeyT, ValueT>, N>& entries)
+        : _keys(keysOf(entries)) {
+        for (const auto& [key, value] : entries) {
+            _values[_keys.indexOf(key)] = value;
+        }
+    }
+
+    /**
+     * @brief Returns a pointer to the value of `key`, or nullptr if there is none.
+     */
+    constexpr const ValueT* find(const KeyT& key) const noexcept {
+        size_t index = _keys.indexOf(key);
+        return index == StaticSet<KeyT, N>::npos ? nullptr : &_values[index];
+    }
+
+    /**
+     * @brief Returns the value of `key`.
+     * @throws std::out_of_range If there is no such key.
+     */
+    constexpr const ValueT& at(const KeyT& key) const {
+        const ValueT* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("Key not found");
+        }
+        return *value;
+    }
+
+    constexpr bool contains(const KeyT& key) const noexcept {
+        return _keys.contains(key);
+    }
+
+    static constexpr size_t size() noexcept {
+        return N;
+    }
+
+    /**
+     * @brief Returns the keys in sorted order.
+     */
+    constexpr const std::array<KeyT, N>& keys() const noexcept {
+        return _keys.keys();
+    }
+
+    /**
+     * @brief Returns the values, in the order of `keys()`.
+     */
+    constexpr const std::array<ValueT, N>& values() const noexcept {
+        return _values;
+    }
+
+private:
+    static constexpr std::array<KeyT, N> keysOf(const std::array<std::pair<KeyT, ValueT>, N>& entries) noexcept {
+        std::array<KeyT, N> keys{};
+        for (size_t i = 0; i < N; ++i) {
+            keys[i] = entries[i].first;
+        }
+        return keys;
+    }
+};
+
+/**
+ * @brief An immutable map from keys to values of different types (such as handlers of distinct
+ * lambda types), built at compile time. The i-th key maps to the i-th value; a lookup finds the
+ * index through a `StaticSet` and dispatches to the value with a switch over the `TypeList`.
+ * Usage: `constexpr auto handlers = makeStaticTupleMap<int>(std::pair{1, onLogin}, std::pair{2, onLogout});`.
+ */
+template <StaticKey KeyT, typename... ValueTs>
+class StaticTupleMap {
+public:
+    using ValueTypes = TypeList<ValueTs...>;
+
+private:
+    static constexpr size_t count = sizeof...(ValueTs);
+
+    StaticSet<KeyT, count> _keys;
+    // The index into `_values` of each key of `_keys`, in sorted order.
+    std::array<size_t, count> _valueIndexes{};
+    std::tuple<ValueTs...> _values;
+
+public:
+    constexpr explicit StaticTupleMap(std::pair<KeyT, ValueTs>... entries)
+        : _keys(std::array<KeyT, count>{entries.first...})
+        , _values(std::move(entries.second)...) {
+        std::array<KeyT, count> keys{entries.first...};
+        for (size_t i = 0; i < count; ++i) {
+            _valueIndexes[_keys.indexOf(keys[i])] = i;
+        }
+    }
+
+    /**
+     * @brief Calls `visitor` with the value of `key`, if there is one.
+     * @return Whether `key` was found.
+     */
+    template <typename VisitorT>
+    constexpr bool visit(const KeyT& key, VisitorT&& visitor) const {
+        size_t index = _keys.indexOf(key);
+        if (index == StaticSet<KeyT, count>::npos) {
+            return false;
+        }
+        dispatch(_valueIndexes[index], visitor, std::index_sequence_for<ValueTs...>{});
+        return true;
+    }
+
+    /**
+     * @brief Returns the value given as the `I`-th entry.
+     */
+    template <size_t I>
+    constexpr const typename ValueTypes::template type_at_t<I>& get() const noexcept {
+        return std::get<I>(_values);
+    }
+
+    constexpr bool contains(const KeyT& key) const noexcept {
+        return _keys.contains(key);
+    }
+
+    static constexpr size_t size() noexcept {
+        return count;
+    }
+
+private:
+    template <typename VisitorT, size_t... Is>
+    constexpr void dispatch(size_t valueIndex, VisitorT& visitor, std::index_sequence<Is...>) const {
+        ((valueIndex == Is ? (visitor(std::get<Is>(_values)), true) : false) || ...);
+    }
+};
+
+/**
+ * @brief Builds a `StaticSet` from a braced list of keys: `makeStaticSet<int>({2, 3, 5, 7})`.
+ */
+template <StaticKey KeyT, size_t N>
+constexpr StaticSet<KeyT, N> makeStaticSet(const KeyT (&keys)[N]) {
+    return StaticSet<KeyT, N>(std::to_array(keys));
+}
+
+/**
+ * @brief Builds a `StaticMap` from a braced list of key-value pairs.
+ */
+template <StaticKey KeyT, typename ValueT, size_t N>
+constexpr StaticMap<KeyT, ValueT, N> makeStaticMap(const std::pair<KeyT, ValueT> (&entries)[N]) {
+    return StaticMap<KeyT, ValueT, N>(std::to_array(entries));
+}
+
+/**
+ * @brief Builds a `StaticTupleMap` from key-value pairs whose values may differ in type.
+ */
+template <StaticKey KeyT, typename... ValueTs>
+constexpr StaticTupleMap<KeyT, ValueTs...> makeStaticTupleMap(std::pair<KeyT, ValueTs>... entries) {
+    return StaticTupleMap<KeyT, ValueTs...>(std::move(entries)...);
+}
+
+#endif // STATIC_MAP_HPP
@@ -0,0 +1,79 @@
+#include "static_map.hpp"
+#include <chrono>
+#include <print>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+enum class Side { Buy, Sell, Short };
+
+constexpr auto sideNames = makeStaticMap<Side, std::string_view>({
+    {Side::Buy, "buy"},
+    {Side::Sell, "sell"},
+    {Side::Short, "short"},
+});
+
+constexpr auto sidesByName = makeStaticMap<std::string_view, Side>({
+    {"buy", Side::Buy},
+    {"sell", Side::Sell},
+    {"short", Side::Short},
+});
+
+constexpr auto httpReasons = makeStaticMap<int, std::string_view>({
+    {200, "OK"}, {201, "Created"}, {204, "No Content"}, {301, "Moved Permanently"}, {304, "Not Modified"},
+    {400, "Bad Request"}, {401, "Unauthorized"}, {403, "Forbidden"}, {404, "Not Found"}, {409, "Conflict"},
+    {429, "Too Many Requests"}, {500, "Internal Server Error"}, {502, "Bad Gateway"}, {503, "Service Unavailable"},
+});
+
+// Handlers of different types, dispatched by message type without virtual calls or std::function.
+constexpr auto handlers = makeStaticTupleMap<char>(
+    std::pair{'A', [](int quantity) { std::println("add {}", quantity); }},
+    std::pair{'X', [](int quantity) { std::println("cancel {}", quantity); }},
+    std::pair{'E', [](int quantity) { std::println("execute {}", quantity); }});
+
+constexpr int lookups = 10'000'000;
+
+template <typename LookupT>
+double measure(LookupT lookup) {
+    auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (int i = 0; i < lookups; ++i) {
+        checksum += lookup(200 + (i * 7) % 400);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("  (checksum {})", checksum);
+    return elapsed.count() / lookups;
+}
+
+} // namespace
+
+int main() {
+    for (Side side : sideNames.keys()) {
+        std::println("{} -> {}", sideNames.at(side), static_cast<int>(sidesByName.at(sideNames.at(side))));
+    }
+    for (char type : {'A', 'E', 'Z'}) {
+        if (!handlers.visit(type, [](const auto& handler) { handler(100); })) {
+            std::println("no handler for {}", type);
+        }
+    }
+
+    // The static map is ready before main; the hash map is built here, at startup.
+    auto start = std::chrono::steady_clock::now();
+    std::unordered_map<int, std::string_view> runtimeReasons(httpReasons.keys().size());
+    for (size_t i = 0; i < httpReasons.size(); ++i) {
+        runtimeReasons.emplace(httpReasons.keys()[i], httpReasons.values()[i]);
+    }
+    std::chrono::duration<double, std::micro> buildTime = std::chrono::steady_clock::now() - start;
+    std::println("unordered_map built in {:.1f} us", buildTime.count());
+
+    double staticTime = measure([](int code) {
+        const std::string_view* reason = httpReasons.find(code);
+        return reason == nullptr ? 0 : reason->size();
+    });
+    double runtimeTime = measure([&](int code) {
+        auto found = runtimeReasons.find(code);
+        return found == runtimeReasons.end() ? 0 : found->second.size();
+    });
+    std::println("StaticMap: {:.2f} ns per lookup, unordered_map: {:.2f} ns per lookup", staticTime, runtimeTime);
+}
@@ -0,0 +1,116 @@
+#include "static_map.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace {
+
+enum class Color { Red, Green, Blue };
+
+constexpr auto primes = makeStaticSet<int>({13, 2, 7, 3, 11, 5});
+
+constexpr auto colorNames = makeStaticMap<Color, std::string_view>({
+    {Color::Red, "red"},
+    {Color::Green, "green"},
+    {Color::Blue, "blue"},
+});
+
+constexpr auto colorsByName = makeStaticMap<std::string_view, Color>({
+    {"red", Color::Red},
+    {"green", Color::Green},
+    {"blue", Color::Blue},
+});
+
+// Lookups are constant expressions, so nothing is left to initialize at run time.
+static_assert(primes.contains(7) && !primes.contains(9));
+static_assert(colorNames.at(Color::Green) == "green");
+static_assert(colorsByName.at("blue") == Color::Blue);
+static_assert(colorsByName.find("purple") == nullptr);
+
+// Builds a set of `N` keys spread over the whole range of int64_t.
+template <size_t N>
+constexpr StaticSet<int64_t, N> spreadKeys() {
+    std::array<int64_t, N> keys{};
+    for (size_t i = 0; i < N; ++i) {
+        keys[i] = static_cast<int64_t>(i * 0x9e3779b97f4a7c15 >> 3) - static_cast<int64_t>(i);
+    }
+    return StaticSet<int64_t, N>(keys);
+}
+
+} // namespace
+
+// Test that a set finds its members, in sorted positions, and rejects everything else
+TEST(StaticMapTest, Set) {
+    EXPECT_EQ(primes.size(), 6);
+    EXPECT_EQ(primes.indexOf(2), 0);
+    EXPECT_EQ(primes.indexOf(13), 5);
+    for (int i = -100; i < 100; ++i) {
+        bool isPrime = i == 2 || i == 3 || i == 5 || i == 7 || i == 11 || i == 13;
+        EXPECT_EQ(primes.contains(i), isPrime) << i;
+    }
+    int previous = 0;
+    for (int prime : primes) {
+        EXPECT_GT(prime, previous);
+        previous = prime;
+    }
+}
+
+// Test that a large set gets a perfect hash: every key is found at its own position
+TEST(StaticMapTest, LargeSet) {
+    static constexpr auto keys = spreadKeys<1000>();
+    static_assert(keys.tableSize == 1024);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(keys.indexOf(keys.keys()[i]), i);
+        EXPECT_FALSE(keys.contains(keys.keys()[i] + 1));
+    }
+}
+
+// Test enum to string maps in both directions
+TEST(StaticMapTest, Map) {
+    for (Color color : {Color::Red, Color::Green, Color::Blue}) {
+        EXPECT_EQ(colorsByName.at(colorNames.at(color)), color);
+    }
+    EXPECT_EQ(colorsByName.keys()[0], "blue");
+    EXPECT_EQ(colorsByName.values()[0], Color::Blue);
+    std::string runtimeName = "gr";
+    runtimeName += "een";
+    EXPECT_EQ(*colorsByName.find(runtimeName), Color::Green);
+    EXPECT_THROW(colorsByName.at("Red"), std::out_of_range);
+    EXPECT_FALSE(colorNames.contains(static_cast<Color>(7)));
+}
+
+// Test that duplicate keys are rejected
+TEST(StaticMapTest, DuplicateKeys) {
+    EXPECT_THROW(makeStaticSet<int>({1, 2, 1}), std::invalid_argument);
+    EXPECT_THROW((makeStaticMap<std::string_view, int>({{"a", 1}, {"a", 2}})), std::invalid_argument);
+}
+
+// Test that a tuple map dispatches each key to its value of its own type
+TEST(StaticMapTest, TupleMap) {
+    static constexpr auto handlers = makeStaticTupleMap<std::string_view>(
+        std::pair{"count"sv, [](int n) { return n + 1; }},
+        std::pair{"scale"sv, 2.5},
+        std::pair{"name"sv, "static"sv});
+    static_assert(std::same_as<decltype(handlers)::ValueTypes::type_at_t<1>, double>);
+    static_assert(handlers.get<1>() == 2.5);
+
+    std::string seen;
+    auto visitor = [&](const auto& value) {
+        using ValueT = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::same_as<ValueT, double>) {
+            seen += std::to_string(static_cast<int>(value * 2));
+        } else if constexpr (std::same_as<ValueT, std::string_view>) {
+            seen += value;
+        } else {
+            seen += std::to_string(value(41));
+        }
+    };
+    EXPECT_TRUE(handlers.visit("count", visitor));
+    EXPECT_TRUE(handlers.visit("scale", visitor));
+    EXPECT_TRUE(handlers.visit("name", visitor));
+    EXPECT_FALSE(handlers.visit("other", visitor));
+    EXPECT_EQ(seen, "425static");
+}
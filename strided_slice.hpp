@@ -0,0 +1,156 @@
+#ifndef STRIDED_SLICE_HPP
+#define STRIDED_SLICE_HPP
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+
+/**
+ * @brief A non-owning view of every `stride`-th element of contiguous storage.
+ * Models `std::ranges::random_access_range` and `std::ranges::view`, so it can be passed to
+ * range algorithms and adaptors without copying. Like `std::span`, it does not extend the lifetime
+ * of the underlying storage and is invalidated by anything that reallocates it.
+ * @tparam ElementT The element type. Use a const type for a read-only view.
+ */
+template <typename ElementT>
+class StridedSlice : public std::ranges::view_interface<StridedSlice<ElementT>> {
+public:
+    class Iterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<ElementT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ElementT*;
+        using reference = ElementT&;
+
+    private:
+        ElementT* _data = nullptr;
+        std::ptrdiff_t _index = 0;
+        std::ptrdiff_t _stride = 1;
+
+    public:
+        Iterator() noexcept = default;
+
+        Iterator(ElementT* data, std::ptrdiff_t index, std::ptrdiff_t stride) noexcept
+            : _data(data)
+            , _index(index)
+            , _stride(stride) {}
+
+        ElementT& operator*() const noexcept {
+            return _data[_index * _stride];
+        }
+
+        ElementT* operator->() const noexcept {
+            return _data + _index * _stride;
+        }
+
+        ElementT& operator[](std::ptrdiff_t n) const noexcept {
+            return _data[(_index + n) * _stride];
+        }
+
+        Iterator& operator++() noexcept {
+            ++_index;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        Iterator& operator--() noexcept {
+            --_index;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept {
+            Iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        Iterator& operator+=(std::ptrdiff_t n) noexcept {
+            _index += n;
+            return *this;
+        }
+
+        Iterator& operator-=(std::ptrdiff_t n) noexcept {
+            _index -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, std::ptrdiff_t n) noexcept {
+            return it += n;
+        }
+
+        friend Iterator operator+(std::ptrdiff_t n, Iterator it) noexcept {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, std::ptrdiff_t n) noexcept {
+            return it -= n;
+        }
+
+        friend std::ptrdiff_t operator-(const Iterator& a, const Iterator& b) noexcept {
+            return a._index - b._index;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {
+            return _index == other._index;
+        }
+
+        std::strong_ordering operator<=>(const Iterator& other) const noexcept {
+            return _index <=> other._index;
+        }
+    };
+
+private:
+    ElementT* _data = nullptr;
+    size_t _size = 0;
+    std::ptrdiff_t _stride = 1;
+
+public:
+    StridedSlice() noexcept = default;
+
+    /**
+     * @brief Views `size` elements starting at `data`, `stride` elements apart.
+     * Iterators keep an element index rather than a pointer, so no pointer past the storage is ever formed.
+     * @param stride The distance between consecutive elements. Negative strides walk backwards; zero repeats one element.
+     */
+    StridedSlice(ElementT* data, size_t size, std::ptrdiff_t stride) noexcept
+        : _data(data)
+        , _size(size)
+        , _stride(stride) {}
+
+    Iterator begin() const noexcept {
+        return Iterator(_data, 0, _stride);
+    }
+
+    Iterator end() const noexcept {
+        return Iterator(_data, static_cast<std::ptrdiff_t>(_size), _stride);
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    std::ptrdiff_t stride() const noexcept {
+        return _stride;
+    }
+
+    /**
+     * @brief Accesses the `index`-th element of the slice. No bounds checking is performed.
+     */
+    ElementT& operator[](size_t index) const noexcept {
+        return _data[static_cast<std::ptrdiff_t>(index) * _stride];
+    }
+};
+
+template <typename ElementT>
+inline constexpr bool std::ranges::enable_borrowed_range<StridedSlice<ElementT>> = true;
+
+#endif // STRIDED_SLICE_HPP
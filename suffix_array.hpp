@@ -0,0 +1,339 @@
+#ifndef SUFFIX_ARRAY_HPP
+#define SUFFIX_ARRAY_HPP
+
+#include "dynamic_array.hpp"
+#include "worker_threads.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Writes the suffix array of `text[0, n)` into `suffixes` by induced sorting (SA-IS, in the
+ * formulation without an explicit sentinel), in O(n) time. Symbols must be below `alphabetSize`,
+ * and `n` below the largest `IndexT`, which marks empty slots.
+ * Besides `suffixes`, it needs one bit per symbol for the L/S types, 2 * `alphabetSize` bucket
+ * bounds, and for the reduced problem at most 2n `IndexT`s, released level by level.
+ * @throws std::bad_alloc If memory allocation fails.
+ */
+template <typename SymbolT, std::unsigned_integral IndexT>
+void inducedSort(const SymbolT* text, size_t n, size_t alphabetSize, IndexT* suffixes) {
+    constexpr IndexT empty = std::numeric_limits<IndexT>::max();
+    if (n <= 2) {
+        if (n > 0) {
+            bool ordered = n == 1 || text[0] < text[1];
+            suffixes[0] = ordered ? 0 : 1;
+            suffixes[n - 1] = ordered ? static_cast<IndexT>(n - 1) : 0;
+        }
+        return;
+    }
+
+    // A suffix is S-type if it is smaller than the next one, L-type otherwise; the last is L-type.
+    DArray<uint64_t> sTypes((n + 63) / 64);
+    auto isS = [&sTypes](size_t i) { return (sTypes[i / 64] >> (i % 64) & 1) != 0; };
+    auto isLms = [&](size_t i) { return i > 0 && isS(i) && !isS(i - 1); };
+    for (size_t i = n - 1; i-- > 0;) {
+        if (text[i] == text[i + 1] ? isS(i + 1) : text[i] < text[i + 1]) {
+            sTypes[i / 64] |= uint64_t{1} << (i % 64);
+        }
+    }
+
+    // Each symbol's bucket holds its L-type suffixes, then its S-type ones.
+    DArray<IndexT> bucketStarts(alphabetSize + 1);
+    DArray<IndexT> sStarts(alphabetSize + 1);
+    for (size_t i = 0; i < n; ++i) {
+        if (isS(i)) {
+            ++bucketStarts[static_cast<size_t>(text[i]) + 1];
+        } else {
+            ++sStarts[static_cast<size_t>(text[i])];
+        }
+    }
+    for (size_t symbol = 0; symbol <= alphabetSize; ++symbol) {
+        sStarts[symbol] += bucketStarts[symbol];
+        if (symbol < alphabetSize) {
+            bucketStarts[symbol + 1] += sStarts[symbol];
+        }
+    }
+
+    // Places the LMS suffixes in the given order, then induces the L-type suffixes left to right
+    // and the S-type suffixes right to left.
+    DArray<IndexT> cursors(alphabetSize + 1);
+    auto induce = [&](std::span<const IndexT> lms) {
+        std::fill(suffixes, suffixes + n, empty);
+        std::copy(sStarts.begin(), sStarts.end(), cursors.begin());
+        for (IndexT position : lms) {
+            suffixes[cursors[text[position]]++] = position;
+        }
+        std::copy(bucketStarts.begin(), bucketStarts.end(), cursors.begin());
+        suffixes[cursors[text[n - 1]]++] = static_cast<IndexT>(n - 1);
+        for (size_t i = 0; i < n; ++i) {
+            IndexT position = suffixes[i];
+            if (position != empty && position > 0 && !isS(position - 1)) {
+                suffixes[cursors[text[position - 1]]++] = position - 1;
+            }
+        }
+        std::copy(bucketStarts.begin(), bucketStarts.end(), cursors.begin());
+        for (size_t i = n; i-- > 0;) {
+            IndexT position = suffixes[i];
+            if (position != empty && position > 0 && isS(position - 1)) {
+                suffixes[--cursors[static_cast<size_t>(text[position - 1]) + 1]] = position - 1;
+            }
+        }
+    };
+
+    DArray<IndexT> lms;
+    for (size_t i = 1; i < n; ++i) {
+        if (isLms(i)) {
+            lms.push(static_cast<IndexT>(i));
+        }
+    }
+    induce(lms);
+    if (lms.empty()) {
+        return;
+    }
+
+    // The induced order is right for the LMS substrings (up to and including the next LMS
+    // symbol). Name them by that order; if names repeat, sort the string of names recursively.
+    size_t m = lms.size();
+    DArray<IndexT> sortedLms;
+    sortedLms.reserve(m);
+    for (size_t i = 0; i < n; ++i) {
+        if (suffixes[i] != empty && isLms(suffixes[i])) {
+            sortedLms.push(suffixes[i]);
+        }
+    }
+    DArray<IndexT> reduced;
+    reduced.resizeForOverwrite(m);
+    size_t lastName = 0;
+    {
+        // LMS positions are at least two apart, so half the position is a unique slot.
+        DArray<IndexT> names;
+        names.resizeForOverwrite(n / 2 + 1);
+        auto substringEnd = [&](size_t position) {
+            do {
+                ++position;
+            } while (position < n && !isLms(position));
+            return position;
+        };
+        names[sortedLms[0] / 2] = 0;
+        for (size_t i = 1; i < m; ++i) {
+            size_t left = sortedLms[i - 1];
+            size_t right = sortedLms[i];
+            size_t leftEnd = substringEnd(left);
+            bool same = leftEnd - left == substringEnd(right) - right;
+            for (; same && left < leftEnd; ++left, ++right) {
+                same = text[left] == text[right];
+            }
+            same = same && left < n && right < n && text[left] == text[right];
+            lastName += same ? 0 : 1;
+            names[sortedLms[i] / 2] = static_cast<IndexT>(lastName);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            reduced[i] = names[lms[i] / 2];
+        }
+    }
+    if (lastName + 1 < m) {
+        inducedSort(reduced.data(), m, lastName + 1, sortedLms.data());
+    } else {
+        for (size_t i = 0; i < m; ++i) {
+            sortedLms[reduced[i]] = static_cast<IndexT>(i);
+        }
+    }
+    reduced = DArray<IndexT>();
+    for (IndexT& position : sortedLms) {
+        position = lms[position];
+    }
+    induce(sortedLms);
+}
+
+/**
+ * @brief The suffix array of a text: the start of every suffix, in lexicographic order of the
+ * suffixes, built by SA-IS in O(n). Every occurrence of a pattern is the start of a suffix that
+ * the pattern prefixes, and those suffixes are adjacent in the order, so a query is two binary
+ * searches: O(m log n) for a pattern of length m, and fewer symbol comparisons in practice, as each
+ * step skips the prefix both bounds are known to share with the pattern.
+ * The text is not copied and must outlive the suffix array. `IndexT` sets the width of the
+ * positions: `uint32_t` covers texts below 4 GiB at 4 bytes per symbol.
+ * @tparam IndexT An unsigned integer type wider than the text length.
+ */
+template <std::unsigned_integral IndexT = uint32_t>
+class SuffixArray {
+private:
+    std::string_view _text;
+    DArray<IndexT> _suffixes;
+
+public:
+    SuffixArray() = default;
+
+    /**
+     * @brief Builds the suffix array of `text`, comparing symbols as unsigned bytes.
+     * @throws std::length_error If `IndexT` cannot represent the text length.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    explicit SuffixArray(std::string_view text)
+        : _text(text) {
+        if (text.size() >= std::numeric_limits<IndexT>::max()) {
+            throw std::length_error("Text too long for the suffix array index type");
+        }
+        _suffixes.resizeForOverwrite(text.size());
+        inducedSort(reinterpret_cast<const unsigned char*>(text.data()), text.size(), 256, _suffixes.data());
+    }
+
+    std::string_view text() const noexcept {
+        return _text;
+    }
+
+    size_t size() const noexcept {
+        return _suffixes.size();
+    }
+
+    /**
+     * @brief Returns the suffix starts in suffix order.
+     */
+    std::span<const IndexT> suffixes() const noexcept {
+        return _suffixes;
+    }
+
+    /**
+     * @brief Returns the start of the suffix of rank `rank`.
+     */
+    IndexT operator[](size_t rank) const noexcept {
+        return _suffixes[rank];
+    }
+
+    /**
+     * @brief Builds the LCP array by Kasai's algorithm in O(n): element `i` is the length of the
+     * longest common prefix of the suffixes of ranks `i - 1` and `i`, and element 0 is 0.
+     * Needs a temporary rank array of n `IndexT`s.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    DArray<IndexT> lcpArray() const {
+        size_t n = size();
+        DArray<IndexT> lcp(n);
+        DArray<IndexT> ranks;
+        ranks.resizeForOverwrite(n);
+        for (size_t rank = 0; rank < n; ++rank) {
+            ranks[_suffixes[rank]] = static_cast<IndexT>(rank);
+        }
+        // The suffix after one with a common prefix of h shares at least h - 1 with its predecessor.
+        size_t common = 0;
+        for (size_t position = 0; position < n; ++position) {
+            if (ranks[position] == 0) {
+                common = 0;
+                continue;
+            }
+            size_t previous = _suffixes[ranks[position] - 1];
+            while (position + common < n && previous + common < n && _text[position + common] == _text[previous + common]) {
+                ++common;
+            }
+            lcp[ranks[position]] = static_cast<IndexT>(common);
+            common -= common > 0 ? 1 : 0;
+        }
+        return lcp;
+    }
+
+    /**
+     * @brief Returns the ranks [first, last) of the suffixes that start with `pattern`.
+     * An empty pattern matches every suffix.
+     */
+    std::pair<size_t, size_t> equalRange(std::string_view pattern) const noexcept {
+        return {bound(pattern, false), bound(pattern, true)};
+    }
+
+    /**
+     * @brief Returns the starts of all occurrences of `pattern`, in suffix order.
+     */
+    std::span<const IndexT> occurrences(std::string_view pattern) const noexcept {
+        auto [first, last] = equalRange(pattern);
+        return std::span<const IndexT>(_suffixes).subspan(first, last - first);
+    }
+
+    size_t count(std::string_view pattern) const noexcept {
+        auto [first, last] = equalRange(pattern);
+        return last - first;
+    }
+
+    bool contains(std::string_view pattern) const noexcept {
+        size_t first = bound(pattern, false);
+        return first < size() && _text.substr(_suffixes[first]).starts_with(pattern);
+    }
+
+private:
+    // Returns the first rank whose suffix is not below `pattern`, or with `upper`, the first rank
+    // whose suffix neither is below `pattern` nor starts with it.
+    size_t bound(std::string_view pattern, bool upper) const noexcept {
+        size_t low = 0;
+        size_t high = size();
+        // Symbols of the pattern matched by the suffixes just below `low` and at `high`; every suffix
+        // in between matches at least the smaller of the two.
+        size_t lowMatch = 0;
+        size_t highMatch = 0;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            std::string_view suffix = _text.substr(_suffixes[middle]);
+            size_t matched = std::min(lowMatch, highMatch);
+            while (matched < pattern.size() && matched < suffix.size() && suffix[matched] == pattern[matched]) {
+                ++matched;
+            }
+            bool below;
+            if (matched == pattern.size()) {
+                below = upper;
+            } else if (matched == suffix.size()) {
+                below = true;
+            } else {
+                below = static_cast<unsigned char>(suffix[matched]) < static_cast<unsigned char>(pattern[matched]);
+            }
+            if (below) {
+                low = middle + 1;
+                lowMatch = matched;
+            } else {
+                high = middle;
+                highMatch = matched;
+            }
+        }
+        return low;
+    }
+};
+
+/**
+ * @brief Builds one suffix array per shard, on up to `std::thread::hardware_concurrency()`
+ * threads that take the largest remaining shard first. Occurrences that cross a shard boundary
+ * are not found, so split text where patterns cannot span, e.g. at line ends. If a thread cannot
+ * be started, the others build its share.
+ * @throws std::length_error If `IndexT` cannot represent the length of a shard.
+ * @throws std::bad_alloc If memory allocation fails.
+ */
+template <std::unsigned_integral IndexT = uint32_t>
+DArray<SuffixArray<IndexT>> buildSuffixArrays(std::span<const std::string_view> shards) {
+    DArray<SuffixArray<IndexT>> arrays(shards.size());
+    DArray<size_t> order;
+    order.resizeForOverwrite(shards.size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t left, size_t right) { return shards[left].size() > shards[right].size(); });
+
+    size_t workers = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), shards.size());
+    std::atomic<size_t> next = 0;
+    runWorkers(workers, [&](size_t) {
+        try {
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < shards.size(); i = next.fetch_add(1, std::memory_order_relaxed)) {
+                arrays[order[i]] = SuffixArray<IndexT>(shards[order[i]]);
+            }
+        } catch (...) {
+            // The other workers stop after their current shard.
+            next.store(shards.size(), std::memory_order_relaxed);
+            throw;
+        }
+    });
+    return arrays;
+}
+
+#endif // SUFFIX_ARRAY_HPP
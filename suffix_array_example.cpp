@@ -0,0 +1,59 @@
+#include "suffix_array.hpp"
+#include <chrono>
+#include <format>
+#include <print>
+#include <random>
+#include <string>
+
+// Substring search over a synthetic service log, split into shards at line ends and indexed in
+// parallel, against scanning the text for every query.
+
+namespace {
+
+constexpr size_t lineCount = 400'000;
+constexpr size_t shardCount = 8;
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+    const char* levels[] = {"INFO", "WARN", "ERROR", "DEBUG"};
+    const char* events[] = {"request served", "cache miss", "connection reset by peer", "retrying upstream", "slow query"};
+    std::mt19937 random(6);
+    std::string log;
+    for (size_t line = 0; line < lineCount; ++line) {
+        log += std::format("2024-05-{:02} {} user={} {} in {} ms\n", 1 + line * 30 / lineCount, levels[random() % 4], random() % 50'000, events[random() % 5],
+                           random() % 2000);
+    }
+
+    DArray<std::string_view> shards;
+    std::string_view rest = log;
+    while (!rest.empty()) {
+        size_t end = rest.find('\n', std::min(rest.size() - 1, log.size() / shardCount)) + 1;
+        shards.push(rest.substr(0, end));
+        rest.remove_prefix(end);
+    }
+    auto start = std::chrono::steady_clock::now();
+    DArray<SuffixArray<>> index = buildSuffixArrays(std::span<const std::string_view>(shards));
+    std::println("indexed {:.1f} MB in {} shards: {:.0f} ms", log.size() / 1e6, shards.size(), millisecondsSince(start));
+
+    for (std::string_view pattern : {"connection reset", "user=4242 ", "ERROR user=1234", "2024-05-17 WARN", "not in the log"}) {
+        start = std::chrono::steady_clock::now();
+        size_t matches = 0;
+        for (const SuffixArray<>& shard : index) {
+            matches += shard.count(pattern);
+        }
+        double indexed = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        size_t scanned = 0;
+        for (size_t position = log.find(pattern); position != std::string::npos; position = log.find(pattern, position + 1)) {
+            ++scanned;
+        }
+        double scan = millisecondsSince(start);
+        std::println("\"{}\": {} matches, {:.1f} us indexed, {:.0f} us scanning ({} matches)", pattern, matches, indexed * 1000, scan * 1000, scanned);
+    }
+}
@@ -0,0 +1,133 @@
+#include "suffix_array.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string randomText(std::mt19937& random, size_t length, char alphabetSize) {
+    std::string text(length, 'a');
+    for (char& symbol : text) {
+        symbol = static_cast<char>('a' + random() % alphabetSize);
+    }
+    return text;
+}
+
+std::vector<size_t> naiveSuffixArray(std::string_view text) {
+    std::vector<size_t> suffixes(text.size());
+    std::iota(suffixes.begin(), suffixes.end(), 0);
+    std::sort(suffixes.begin(), suffixes.end(), [&](size_t left, size_t right) { return text.substr(left) < text.substr(right); });
+    return suffixes;
+}
+
+size_t naiveCount(std::string_view text, std::string_view pattern) {
+    size_t count = 0;
+    for (size_t position = text.find(pattern); position != std::string_view::npos; position = text.find(pattern, position + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+template <typename IndexT>
+std::vector<size_t> positionsOf(const SuffixArray<IndexT>& array) {
+    return std::vector<size_t>(array.suffixes().begin(), array.suffixes().end());
+}
+
+} // namespace
+
+// Test construction against sorting the suffixes, for short texts and for texts whose names repeat
+TEST(SuffixArrayTest, MatchesNaiveSort) {
+    std::mt19937 random(1);
+    for (std::string text : {"", "a", "ab", "ba", "aa", "banana", "mississippi", "abracadabra", "aaaaaaaaaa", "abababababab", "\xff\x01\x80"}) {
+        EXPECT_EQ(positionsOf(SuffixArray<>(text)), naiveSuffixArray(text)) << text;
+    }
+    for (size_t length : {3, 10, 100, 1000, 5000}) {
+        for (char alphabetSize : {1, 2, 4, 26}) {
+            std::string text = randomText(random, length, alphabetSize);
+            ASSERT_EQ(positionsOf(SuffixArray<>(text)), naiveSuffixArray(text)) << length << " " << int{alphabetSize};
+        }
+    }
+    std::string periodic;
+    for (int i = 0; i < 300; ++i) {
+        periodic += "abcab";
+        periodic += static_cast<char>('a' + i % 3);
+    }
+    EXPECT_EQ(positionsOf(SuffixArray<uint64_t>(periodic)), naiveSuffixArray(periodic));
+    EXPECT_EQ(positionsOf(SuffixArray<uint16_t>(periodic)), naiveSuffixArray(periodic));
+}
+
+// Test that the index type bounds the text length
+TEST(SuffixArrayTest, IndexWidth) {
+    std::string text(254, 'x');
+    EXPECT_EQ(positionsOf(SuffixArray<uint8_t>(text)), naiveSuffixArray(text));
+    text.push_back('y');
+    EXPECT_THROW(SuffixArray<uint8_t>{text}, std::length_error);
+}
+
+// Test the LCP array against direct comparison of neighbouring suffixes
+TEST(SuffixArrayTest, Lcp) {
+    std::mt19937 random(2);
+    for (char alphabetSize : {1, 2, 4}) {
+        std::string text = randomText(random, 3000, alphabetSize);
+        SuffixArray<> array(text);
+        DArray<uint32_t> lcp = array.lcpArray();
+        ASSERT_EQ(lcp.size(), text.size());
+        EXPECT_EQ(lcp[0], 0);
+        for (size_t rank = 1; rank < text.size(); ++rank) {
+            std::string_view previous = std::string_view(text).substr(array[rank - 1]);
+            std::string_view current = std::string_view(text).substr(array[rank]);
+            size_t common = static_cast<size_t>(std::mismatch(previous.begin(), previous.end(), current.begin(), current.end()).first - previous.begin());
+            ASSERT_EQ(lcp[rank], common) << "rank " << rank;
+        }
+    }
+    EXPECT_TRUE(SuffixArray<>("").lcpArray().empty());
+}
+
+// Test substring queries against scanning the text
+TEST(SuffixArrayTest, Queries) {
+    std::mt19937 random(3);
+    std::string text = randomText(random, 20000, 4);
+    SuffixArray<> array(text);
+    for (int i = 0; i < 2000; ++i) {
+        std::string pattern = i % 2 == 0 ? text.substr(random() % text.size(), 1 + random() % 12) : randomText(random, 1 + random() % 10, 5);
+        size_t expected = naiveCount(text, pattern);
+        ASSERT_EQ(array.count(pattern), expected) << pattern;
+        EXPECT_EQ(array.contains(pattern), expected > 0);
+        for (uint32_t position : array.occurrences(pattern)) {
+            ASSERT_EQ(text.compare(position, pattern.size(), pattern), 0);
+        }
+    }
+    EXPECT_EQ(array.count(""), text.size());
+    EXPECT_FALSE(array.contains(text + "a"));
+    EXPECT_TRUE(array.contains(text));
+    EXPECT_FALSE(SuffixArray<>("").contains("a"));
+
+    // Bytes compare unsigned, as during construction.
+    SuffixArray<> bytes("a\xff" "b\x01" "a\xff");
+    EXPECT_EQ(bytes.count("a\xff"), 2);
+    EXPECT_EQ(bytes.count("\x01"), 1);
+}
+
+// Test that shards built in parallel equal shards built one by one, and that failures propagate
+TEST(SuffixArrayTest, Shards) {
+    std::mt19937 random(4);
+    std::vector<std::string> texts;
+    for (size_t length : {5000, 10, 0, 800, 3000, 1}) {
+        texts.push_back(randomText(random, length, 3));
+    }
+    std::vector<std::string_view> shards(texts.begin(), texts.end());
+    DArray<SuffixArray<>> arrays = buildSuffixArrays(shards);
+    ASSERT_EQ(arrays.size(), shards.size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        EXPECT_EQ(arrays[i].text().data(), shards[i].data());
+        EXPECT_EQ(positionsOf(arrays[i]), naiveSuffixArray(shards[i]));
+    }
+    EXPECT_TRUE(buildSuffixArrays(std::span<const std::string_view>()).empty());
+
+    std::string longShard(300, 'z');
+    shards.push_back(longShard);
+    EXPECT_THROW(buildSuffixArrays<uint8_t>(shards), std::length_error);
+}
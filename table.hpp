@@ -0,0 +1,447 @@
+#ifndef TABLE_HPP
+#define TABLE_HPP
+
+#include "dynamic_array.hpp"
+#include "type_list.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+/**
+ * @brief The value types a table column can hold. The order defines `ColumnType`.
+ */
+using ColumnTypes = TypeList<int32_t, int64_t, double, std::string>;
+
+/**
+ * @brief Runtime tag of a column's value type (the index of the type in `ColumnTypes`).
+ */
+enum class ColumnType : uint8_t {
+    Int32,
+    Int64,
+    Double,
+    String,
+};
+
+template <typename T>
+    requires ColumnTypes::contains_v<T>
+inline constexpr ColumnType columnTypeOf = static_cast<ColumnType>(ColumnTypes::index_of_v<T>);
+
+/**
+ * @brief Name and type of one column of a table schema.
+ */
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+/**
+ * @brief A named, type-tagged column: a `DArray` of one of the `ColumnTypes`.
+ */
+class Column {
+private:
+    template <typename List>
+    struct StorageOf;
+
+    template <typename... Types>
+    struct StorageOf<TypeList<Types...>> {
+        using type = std::variant<DArray<Types>...>;
+    };
+
+    using Storage = typename StorageOf<ColumnTypes>::type;
+
+    std::string _name;
+    Storage _values;
+
+public:
+    /**
+     * @brief Constructs an empty column.
+     * @throws std::invalid_argument If `type` is not a valid `ColumnType`.
+     */
+    Column(std::string name, ColumnType type)
+        : _name(std::move(name))
+        , _values(makeStorage(type, std::make_index_sequence<ColumnTypes::size>())) {}
+
+    const std::string& name() const noexcept {
+        return _name;
+    }
+
+    ColumnType type() const noexcept {
+        return static_cast<ColumnType>(_values.index());
+    }
+
+    size_t size() const noexcept {
+        return std::visit([](const auto& values) { return values.size(); }, _values);
+    }
+
+    size_t capacity() const noexcept {
+        return std::visit([](const auto& values) { return values.capacity(); }, _values);
+    }
+
+    /**
+     * @brief Returns the values of the column.
+     * @tparam T The value type of the column.
+     * @throws std::invalid_argument If the column does not hold values of type `T`.
+     */
+    template <typename T>
+    const DArray<T>& values() const {
+        if (const DArray<T>* values = std::get_if<DArray<T>>(&_values)) {
+            return *values;
+        }
+        throw std::invalid_argument("Column type mismatch");
+    }
+
+private:
+    template <size_t... Indices>
+    static Storage makeStorage(ColumnType type, std::index_sequence<Indices...>) {
+        using Factory = Storage (*)();
+        static constexpr std::array<Factory, sizeof...(Indices)> factories = {
+            [] { return Storage(std::in_place_index<Indices>); }...,
+        };
+        auto index = static_cast<size_t>(type);
+        if (index >= factories.size()) {
+            throw std::invalid_argument("Unknown column type");
+        }
+        return factories[index]();
+    }
+
+    template <typename T>
+    DArray<T>& mutableValues() noexcept {
+        return *std::get_if<DArray<T>>(&_values);
+    }
+
+    void reserve(size_t n) {
+        std::visit([n](auto& values) { values.reserve(n); }, _values);
+    }
+
+    void truncate(size_t n) noexcept {
+        std::visit([n](auto& values) { values.erase(values.begin() + n, values.end()); }, _values);
+    }
+
+    friend class Table;
+};
+
+/**
+ * @brief A non-owning selection of table columns, e.g. the columns a query reads.
+ * Invalidated by anything that modifies the table.
+ */
+class Projection {
+private:
+    DArray<const Column*> _columns;
+    size_t _rowCount = 0;
+
+public:
+    Projection(DArray<const Column*> columns, size_t rowCount) noexcept
+        : _columns(std::move(columns))
+        , _rowCount(rowCount) {}
+
+    size_t rowCount() const noexcept {
+        return _rowCount;
+    }
+
+    size_t columnCount() const noexcept {
+        return _columns.size();
+    }
+
+    const Column& column(size_t index) const noexcept {
+        return *_columns[index];
+    }
+};
+
+/**
+ * @brief A columnar table whose schema is only known at runtime.
+ * Each column is a `DArray` of one of the `ColumnTypes`; all columns have the same number of rows.
+ * Rows are appended in batches, which are written one column at a time.
+ */
+class Table {
+private:
+    DArray<Column> _columns;
+    size_t _rowCount = 0;
+
+public:
+    /**
+     * @brief Constructs an empty table with the given schema.
+     * @throws std::invalid_argument If a column name is repeated or a column type is unknown.
+     */
+    explicit Table(std::span<const ColumnSpec> schema) {
+        _columns.reserve(schema.size());
+        for (const ColumnSpec& spec : schema) {
+            if (findColumn(spec.name) != nullptr) {
+                throw std::invalid_argument("Duplicate column name");
+            }
+            _columns.emplaceAtEnd(spec.name, spec.type);
+        }
+    }
+
+    explicit Table(std::initializer_list<ColumnSpec> schema)
+        : Table(std::span<const ColumnSpec>(schema.begin(), schema.size())) {}
+
+    size_t rowCount() const noexcept {
+        return _rowCount;
+    }
+
+    size_t columnCount() const noexcept {
+        return _columns.size();
+    }
+
+    const Column& column(size_t index) const noexcept {
+        return _columns[index];
+    }
+
+    /**
+     * @brief Returns the column called `name`.
+     * @throws std::out_of_range If there is no such column.
+     */
+    const Column& column(std::string_view name) const {
+        if (const Column* column = findColumn(name)) {
+            return *column;
+        }
+        throw std::out_of_range("Unknown column");
+    }
+
+    /**
+     * @brief Returns a projection onto the named columns, in the given order. Nothing is copied.
+     * @throws std::out_of_range If a column does not exist.
+     */
+    Projection project(std::initializer_list<std::string_view> names) const {
+        DArray<const Column*> columns;
+        columns.reserve(names.size());
+        for (std::string_view name : names) {
+            columns.push(&column(name));
+        }
+        return Projection(std::move(columns), _rowCount);
+    }
+
+    /**
+     * @brief Returns a projection onto all columns.
+     */
+    Projection project() const {
+        DArray<const Column*> columns;
+        columns.reserve(_columns.size());
+        for (const Column& column : _columns) {
+            columns.push(&column);
+        }
+        return Projection(std::move(columns), _rowCount);
+    }
+
+    /**
+     * @brief Appends a batch of rows, given as a contiguous range of tuples (e.g. a `DArray` or a span).
+     * Tuple element `i` goes to column `i`. Every column grows at most once per batch and is then
+     * filled in one sequential pass. If an exception is thrown the table is left unchanged.
+     * @throws std::invalid_argument If the tuple types do not match the schema.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    template <std::ranges::contiguous_range RowsT>
+        requires std::ranges::sized_range<RowsT>
+    void appendRows(const RowsT& rows) {
+        appendTuples(std::span(std::ranges::data(rows), std::ranges::size(rows)));
+    }
+
+    /**
+     * @brief Appends a single row. Prefer `appendRows` for bulk loads.
+     * @throws std::invalid_argument If the value types do not match the schema.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    template <typename... Types>
+    void appendRow(Types... values) {
+        std::tuple<Types...> row(std::move(values)...);
+        appendTuples(std::span<const std::tuple<Types...>>(&row, 1));
+    }
+
+private:
+    const Column* findColumn(std::string_view name) const noexcept {
+        for (const Column& column : _columns) {
+            if (column.name() == name) {
+                return &column;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename... Types>
+    void appendTuples(std::span<const std::tuple<Types...>> rows) {
+        checkRowType<Types...>();
+        size_t required = _rowCount + rows.size();
+        try {
+            for (Column& column : _columns) {
+                if (required > column.capacity()) {
+                    column.reserve(std::max(required, column.capacity() * 2));
+                }
+            }
+            appendColumns(rows, std::index_sequence_for<Types...>());
+        } catch (...) {
+            for (Column& column : _columns) {
+                column.truncate(_rowCount);
+            }
+            throw;
+        }
+        _rowCount = required;
+    }
+
+    template <typename... Types>
+    void checkRowType() const {
+        constexpr ColumnType types[] = {columnTypeOf<Types>...};
+        if (sizeof...(Types) != _columns.size()) {
+            throw std::invalid_argument("Row does not match the table schema");
+        }
+        for (size_t i = 0; i < sizeof...(Types); ++i) {
+            if (types[i] != _columns[i].type()) {
+                throw std::invalid_argument("Row does not match the table schema");
+            }
+        }
+    }
+
+    template <typename... Types, size_t... Indices>
+    void appendColumns(std::span<const std::tuple<Types...>> rows, std::index_sequence<Indices...>) {
+        (appendColumn<Indices>(rows), ...);
+    }
+
+    template <size_t Index, typename... Types>
+    void appendColumn(std::span<const std::tuple<Types...>> rows) {
+        using T = std::tuple_element_t<Index, std::tuple<Types...>>;
+        DArray<T>& values = _columns[Index].template mutableValues<T>();
+        for (const std::tuple<Types...>& row : rows) {
+            values.push(std::get<Index>(row));
+        }
+    }
+};
+
+/**
+ * @brief A morsel of a scan: `size()` consecutive rows of a projection starting at `offset()`,
+ * plus a selection vector of the row positions (relative to `offset()`) that passed the filters
+ * applied so far. A batch is reused across morsels, so steady-state scanning does not allocate.
+ */
+class Batch {
+private:
+    const Projection* _projection = nullptr;
+    size_t _offset = 0;
+    size_t _size = 0;
+    DArray<uint32_t> _selection;
+
+public:
+    size_t offset() const noexcept {
+        return _offset;
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    /**
+     * @brief Returns the values of projected column `index` for the rows of the morsel.
+     * @throws std::invalid_argument If the column does not hold values of type `T`.
+     */
+    template <typename T>
+    std::span<const T> column(size_t index) const {
+        return _projection->column(index).values<T>().slice(_offset, _size);
+    }
+
+    /**
+     * @brief Returns the positions (relative to `offset()`) of the rows that are still selected.
+     */
+    std::span<const uint32_t> selection() const noexcept {
+        return {_selection.data(), _selection.size()};
+    }
+
+    /**
+     * @brief Keeps only the selected rows whose value in projected column `index` satisfies `predicate`.
+     * The selection vector is compacted without branching on the predicate result.
+     * @return The number of rows still selected.
+     * @throws std::invalid_argument If the column does not hold values of type `T`.
+     */
+    template <typename T, typename Predicate>
+    size_t filter(size_t index, Predicate predicate) {
+        std::span<const T> values = column<T>(index);
+        uint32_t* selection = _selection.data();
+        size_t kept = 0;
+        for (uint32_t row : _selection) {
+            selection[kept] = row;
+            kept += static_cast<bool>(predicate(values[row]));
+        }
+        _selection.erase(_selection.begin() + kept, _selection.end());
+        return kept;
+    }
+
+private:
+    void reset(const Projection& projection, size_t offset, size_t size) {
+        _projection = &projection;
+        _offset = offset;
+        _size = size;
+        _selection.reserve(size);
+        _selection.clear();
+        for (uint32_t row = 0; row < size; ++row) {
+            _selection.push(row);
+        }
+    }
+
+    friend class MorselScan;
+};
+
+/**
+ * @brief Hands out fixed-size morsels of a projection to worker threads.
+ * Each worker owns a `Batch` and calls `next()` until it returns `false`; morsels are claimed with
+ * a single atomic increment, so faster workers simply process more of them.
+ * The table must not be modified while the scan is running.
+ */
+class MorselScan {
+public:
+    static constexpr size_t defaultMorselSize = 2048;
+
+private:
+    Projection _projection;
+    size_t _morselSize;
+    std::atomic<size_t> _nextMorsel = 0;
+
+public:
+    /**
+     * @param projection The columns to scan.
+     * @param morselSize The number of rows per morsel (clamped to [1, 2^32 - 1]).
+     */
+    explicit MorselScan(Projection projection, size_t morselSize = defaultMorselSize)
+        : _projection(std::move(projection))
+        , _morselSize(std::clamp<size_t>(morselSize, 1, std::numeric_limits<uint32_t>::max())) {}
+
+    MorselScan(const MorselScan&) = delete;
+
+    MorselScan& operator=(const MorselScan&) = delete;
+
+    const Projection& projection() const noexcept {
+        return _projection;
+    }
+
+    size_t morselSize() const noexcept {
+        return _morselSize;
+    }
+
+    size_t morselCount() const noexcept {
+        return (_projection.rowCount() + _morselSize - 1) / _morselSize;
+    }
+
+    /**
+     * @brief Claims the next morsel and loads it into `batch` with every row selected. Thread-safe.
+     * @return `false` once all morsels have been handed out.
+     * @throws std::bad_alloc If the batch's selection vector cannot be grown to the morsel's row count.
+     */
+    bool next(Batch& batch) {
+        size_t morsel = _nextMorsel.fetch_add(1, std::memory_order_relaxed);
+        if (morsel >= morselCount()) {
+            return false;
+        }
+        size_t offset = morsel * _morselSize;
+        batch.reset(_projection, offset, std::min(_morselSize, _projection.rowCount() - offset));
+        return true;
+    }
+};
+
+#endif // TABLE_HPP
@@ -0,0 +1,64 @@
+#include "table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <print>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+int main() {
+    Table orders({
+        {"id", ColumnType::Int64},
+        {"region", ColumnType::Int32},
+        {"amount", ColumnType::Double},
+        {"customer", ColumnType::String},
+    });
+
+    constexpr int64_t rowCount = 4'000'000;
+    constexpr int64_t batchSize = 100'000;
+    DArray<std::tuple<int64_t, int32_t, double, std::string>> rows;
+    rows.reserve(batchSize);
+    for (int64_t first = 0; first < rowCount; first += batchSize) {
+        rows.clear();
+        for (int64_t id = first; id < first + batchSize; ++id) {
+            rows.push({id, static_cast<int32_t>(id % 16), static_cast<double>(id % 1000), "c" + std::to_string(id % 97)});
+        }
+        orders.appendRows(rows);
+    }
+
+    // SELECT sum(amount) FROM orders WHERE region = 3 AND amount >= 500
+    // Only the two columns the query reads are scanned.
+    MorselScan scan(orders.project({"region", "amount"}));
+    std::atomic<double> total = 0;
+    std::atomic<int64_t> matches = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&] {
+            Batch batch;
+            double localTotal = 0;
+            int64_t localMatches = 0;
+            while (scan.next(batch)) {
+                batch.filter<int32_t>(0, [](int32_t region) { return region == 3; });
+                localMatches += batch.filter<double>(1, [](double amount) { return amount >= 500; });
+                std::span<const double> amounts = batch.column<double>(1);
+                for (uint32_t row : batch.selection()) {
+                    localTotal += amounts[row];
+                }
+            }
+            total += localTotal;
+            matches += localMatches;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    std::println("{} rows, {} morsels of {} rows, {} workers", orders.rowCount(), scan.morselCount(), scan.morselSize(), workerCount);
+    std::println("{} matching rows, sum(amount) = {:.0f}, scan took {:.1f} ms", matches.load(), total.load(), elapsed.count());
+}
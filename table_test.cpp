@@ -0,0 +1,187 @@
+#include "table.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace {
+
+using Row = std::tuple<int64_t, double, std::string>;
+
+Table makeTable() {
+    return Table({
+        {"id", ColumnType::Int64},
+        {"price", ColumnType::Double},
+        {"name", ColumnType::String},
+    });
+}
+
+} // namespace
+
+// Test schema introspection
+TEST(TableTest, Schema) {
+    Table table = makeTable();
+
+    EXPECT_EQ(table.columnCount(), 3);
+    EXPECT_EQ(table.rowCount(), 0);
+    EXPECT_EQ(table.column(1).name(), "price");
+    EXPECT_EQ(table.column("name").type(), ColumnType::String);
+    EXPECT_EQ(columnTypeOf<int32_t>, ColumnType::Int32);
+    EXPECT_THROW(table.column("missing"), std::out_of_range);
+    EXPECT_THROW(Table({{"a", ColumnType::Int32}, {"a", ColumnType::Double}}), std::invalid_argument);
+    EXPECT_THROW(Table({{"a", static_cast<ColumnType>(42)}}), std::invalid_argument);
+}
+
+// Test that batches are appended column by column
+TEST(TableTest, AppendRows) {
+    Table table = makeTable();
+    DArray<Row> rows = {{1, 1.5, "a"s}, {2, 2.5, "b"s}};
+
+    table.appendRows(rows);
+    table.appendRow(int64_t{3}, 3.5, "c"s);
+
+    EXPECT_EQ(table.rowCount(), 3);
+    const DArray<int64_t>& ids = table.column("id").values<int64_t>();
+    const DArray<std::string>& names = table.column("name").values<std::string>();
+    EXPECT_EQ(ids.size(), 3);
+    EXPECT_EQ(ids[2], 3);
+    EXPECT_EQ(names[1], "b");
+    EXPECT_THROW(table.column("id").values<double>(), std::invalid_argument);
+}
+
+// Test that rows not matching the schema are rejected without changing the table
+TEST(TableTest, AppendRowsSchemaMismatch) {
+    Table table = makeTable();
+    table.appendRow(int64_t{1}, 1.0, "a"s);
+
+    EXPECT_THROW(table.appendRow(1, 1.0, "a"s), std::invalid_argument);
+    EXPECT_THROW(table.appendRow(int64_t{1}, 1.0), std::invalid_argument);
+
+    EXPECT_EQ(table.rowCount(), 1);
+    for (size_t i = 0; i < table.columnCount(); ++i) {
+        EXPECT_EQ(table.column(i).size(), 1);
+    }
+}
+
+// Test that projections refer to the table's columns instead of copying them
+TEST(TableTest, Projection) {
+    Table table = makeTable();
+    table.appendRow(int64_t{7}, 0.5, "x"s);
+
+    Projection projection = table.project({"name", "id"});
+
+    EXPECT_EQ(projection.columnCount(), 2);
+    EXPECT_EQ(projection.rowCount(), 1);
+    EXPECT_EQ(&projection.column(0), &table.column("name"));
+    EXPECT_EQ(&projection.column(1), &table.column("id"));
+    EXPECT_EQ(table.project().columnCount(), 3);
+    EXPECT_THROW(table.project({"id", "missing"}), std::out_of_range);
+}
+
+// Test that a scan hands out every row exactly once in fixed-size morsels
+TEST(TableTest, MorselScan) {
+    Table table = makeTable();
+    DArray<Row> rows;
+    for (int64_t i = 0; i < 1000; ++i) {
+        rows.push({i, i * 0.5, std::to_string(i)});
+    }
+    table.appendRows(rows);
+
+    MorselScan scan(table.project({"id"}), 64);
+    Batch batch;
+    int64_t sum = 0;
+    size_t morsels = 0;
+    while (scan.next(batch)) {
+        EXPECT_EQ(batch.offset(), morsels * 64);
+        EXPECT_EQ(batch.selection().size(), batch.size());
+        for (int64_t id : batch.column<int64_t>(0)) {
+            sum += id;
+        }
+        ++morsels;
+    }
+
+    EXPECT_EQ(morsels, scan.morselCount());
+    EXPECT_EQ(morsels, 16);
+    EXPECT_EQ(batch.size(), 1000 - 15 * 64);
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    EXPECT_FALSE(scan.next(batch));
+    // Row indices within a batch are 32-bit.
+    EXPECT_EQ(MorselScan(table.project({"id"}), 0).morselSize(), 1);
+    EXPECT_EQ(MorselScan(table.project({"id"}), SIZE_MAX).morselSize(), UINT32_MAX);
+}
+
+// Test that an oversized morsel only allocates the rows the table actually has
+TEST(TableTest, MorselScanLargerThanTable) {
+    Table table = makeTable();
+    for (int64_t i = 0; i < 3; ++i) {
+        table.appendRow(i, i * 0.5, std::to_string(i));
+    }
+
+    MorselScan scan(table.project({"id"}), SIZE_MAX);
+    Batch batch;
+    ASSERT_TRUE(scan.next(batch));
+    EXPECT_EQ(batch.offset(), 0);
+    EXPECT_EQ(batch.size(), 3);
+    EXPECT_EQ(batch.selection().size(), 3);
+    EXPECT_FALSE(scan.next(batch));
+}
+
+// Test that filters narrow the selection vector
+TEST(TableTest, Filter) {
+    Table table = makeTable();
+    DArray<Row> rows;
+    for (int64_t i = 0; i < 100; ++i) {
+        rows.push({i, static_cast<double>(i % 10), "n"s});
+    }
+    table.appendRows(rows);
+
+    MorselScan scan(table.project({"price", "id"}), 50);
+    Batch batch;
+    ASSERT_TRUE(scan.next(batch));
+    ASSERT_TRUE(scan.next(batch));
+
+    EXPECT_EQ(batch.filter<double>(0, [](double price) { return price < 3; }), 15);
+    EXPECT_EQ(batch.filter<int64_t>(1, [](int64_t id) { return id % 2 == 0; }), 10);
+
+    std::span<const int64_t> ids = batch.column<int64_t>(1);
+    for (uint32_t row : batch.selection()) {
+        EXPECT_LT(ids[row] % 10, 3);
+        EXPECT_EQ(ids[row] % 2, 0);
+        EXPECT_GE(ids[row], 50);
+    }
+    EXPECT_THROW(batch.filter<std::string>(0, [](const std::string&) { return true; }), std::invalid_argument);
+}
+
+// Test a scan shared by several worker threads
+TEST(TableTest, ParallelScan) {
+    Table table({{"value", ColumnType::Int32}});
+    DArray<std::tuple<int32_t>> rows;
+    for (int32_t i = 0; i < 100000; ++i) {
+        rows.push({i % 100});
+    }
+    table.appendRows(rows);
+
+    MorselScan scan(table.project({"value"}), 1000);
+    std::atomic<int64_t> selected = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&] {
+            Batch batch;
+            int64_t local = 0;
+            while (scan.next(batch)) {
+                local += batch.filter<int32_t>(0, [](int32_t value) { return value >= 90; });
+            }
+            selected += local;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(selected, 10000);
+}
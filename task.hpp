@@ -0,0 +1,343 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include "dynamic_array.hpp"
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * @brief Promise base that places coroutine frames in memory from an `Allocator`.
+ * A coroutine opts in by taking `std::allocator_arg` followed by the allocator as its first
+ * parameters (after `*this` for member coroutines). A copy of the allocator is stored behind the
+ * frame so that the frame can be freed with it. Without those parameters, frames come from a
+ * default-constructed `AllocatorT`, if it has a default constructor.
+ * @tparam AllocatorT The allocator frames are drawn from.
+ */
+template <Allocator AllocatorT>
+class FrameAllocation {
+private:
+    static constexpr std::align_val_t frameAlignment = static_cast<std::align_val_t>(__STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    static size_t allocatorOffset(size_t size) noexcept {
+        return (size + alignof(AllocatorT) - 1) & ~(alignof(AllocatorT) - 1);
+    }
+
+    static void* allocateFrame(size_t size, const AllocatorT& allocator) {
+        AllocatorT copy = allocator;
+        void* frame = copy.allocate(allocatorOffset(size) + sizeof(AllocatorT), frameAlignment);
+        new (static_cast<std::byte*>(frame) + allocatorOffset(size)) AllocatorT(std::move(copy));
+        return frame;
+    }
+
+public:
+    // Always inlined so that the coroutine never calls a member template `operator new` directly:
+    // GCC 12 pairs it with the non-template `operator delete` by mangled name and reports a false
+    // -Wmismatched-new-delete at every coroutine using it (GCC bug 109224). A diagnostic pragma here
+    // would not help: the warning is reported at the coroutine, in the including file.
+    template <typename... Args>
+    [[gnu::always_inline]] static void* operator new(size_t size, std::allocator_arg_t, const AllocatorT& allocator, const Args&...) {
+        return allocateFrame(size, allocator);
+    }
+
+    template <typename Self, typename... Args>
+    [[gnu::always_inline]] static void* operator new(size_t size, const Self&, std::allocator_arg_t, const AllocatorT& allocator, const Args&...) {
+        return allocateFrame(size, allocator);
+    }
+
+    static void* operator new(size_t size)
+        requires std::default_initializable<AllocatorT>
+    {
+        return allocateFrame(size, AllocatorT());
+    }
+
+    static void operator delete(void* frame, size_t size) noexcept {
+        auto* stored = std::launder(reinterpret_cast<AllocatorT*>(static_cast<std::byte*>(frame) + allocatorOffset(size)));
+        AllocatorT allocator = std::move(*stored);
+        stored->~AllocatorT();
+        allocator.deallocate(frame, frameAlignment);
+    }
+};
+
+template <typename ValueT>
+class TaskResult {
+private:
+    std::variant<std::monostate, ValueT, std::exception_ptr> _result;
+
+public:
+    template <typename T>
+        requires std::convertible_to<T, ValueT>
+    void return_value(T&& value) noexcept(std::is_nothrow_constructible_v<ValueT, T>) {
+        _result.template emplace<1>(std::forward<T>(value));
+    }
+
+    void unhandled_exception() noexcept {
+        _result.template emplace<2>(std::current_exception());
+    }
+
+    ValueT takeResult() {
+        if (_result.index() == 2) {
+            std::rethrow_exception(std::get<2>(_result));
+        }
+        return std::move(std::get<1>(_result));
+    }
+};
+
+template <>
+class TaskResult<void> {
+private:
+    std::exception_ptr _error;
+
+public:
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+        _error = std::current_exception();
+    }
+
+    void takeResult() {
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+    }
+};
+
+/**
+ * @brief A lazily started coroutine that produces a `ValueT` and is consumed with `co_await`.
+ * Awaiting a task starts it, and when it finishes its awaiter is resumed by symmetric transfer, so
+ * arbitrarily long chains of synchronously completing tasks run in constant stack space.
+ * @tparam ValueT The result type. Defaults to `void`.
+ * @tparam AllocatorT The allocator coroutine frames are drawn from (see `FrameAllocation`).
+ */
+template <typename ValueT = void, Allocator AllocatorT = DefaultAllocator>
+class Task {
+public:
+    struct promise_type : FrameAllocation<AllocatorT>, TaskResult<ValueT> {
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                return handle.promise().continuation;
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept {
+            return {};
+        }
+    };
+
+    struct Awaiter {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept {
+            return handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        ValueT await_resume() {
+            return handle.promise().takeResult();
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> _handle;
+
+public:
+    Task(Task&& other) noexcept
+        : _handle(std::exchange(other._handle, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != std::addressof(other)) {
+            destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+
+    Task& operator=(const Task&) = delete;
+
+    ~Task() noexcept {
+        destroy();
+    }
+
+    Awaiter operator co_await() && noexcept {
+        return Awaiter{_handle};
+    }
+
+    bool done() const noexcept {
+        return _handle.done();
+    }
+
+    /**
+     * @brief Runs the task on the calling thread and returns its result.
+     * Only for tasks that complete without waiting on external events (e.g. at the top of a
+     * synchronous request handler); a task that suspends for any other reason is left unfinished.
+     * @throws Any exception thrown by the task.
+     */
+    ValueT run() {
+        _handle.resume();
+        assert(_handle.done());
+        return _handle.promise().takeResult();
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle(handle) {}
+
+    void destroy() noexcept {
+        if (_handle) {
+            _handle.destroy();
+            _handle = nullptr;
+        }
+    }
+};
+
+/**
+ * @brief A synchronous generator: a coroutine that `co_yield`s a sequence of `ValueT`, consumed as an input range.
+ * Yielded values are not copied; the iterator refers to the yielded object until the next increment.
+ * @tparam ValueT The type of the yielded values.
+ * @tparam AllocatorT The allocator coroutine frames are drawn from (see `FrameAllocation`).
+ */
+template <typename ValueT, Allocator AllocatorT = DefaultAllocator>
+class Generator {
+public:
+    struct promise_type : FrameAllocation<AllocatorT> {
+        std::add_pointer_t<ValueT> current = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(ValueT& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        std::suspend_always yield_value(ValueT&& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            error = std::current_exception();
+        }
+
+        template <typename T>
+        void await_transform(T&&) = delete;
+    };
+
+    class Iterator {
+    public:
+        using value_type = std::remove_cvref_t<ValueT>;
+        using difference_type = std::ptrdiff_t;
+
+    private:
+        std::coroutine_handle<promise_type> _handle;
+
+    public:
+        Iterator() noexcept = default;
+
+        explicit Iterator(std::coroutine_handle<promise_type> handle) noexcept
+            : _handle(handle) {}
+
+        ValueT& operator*() const noexcept {
+            return *_handle.promise().current;
+        }
+
+        Iterator& operator++() {
+            advance(_handle);
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return _handle.done();
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> _handle;
+
+public:
+    Generator(Generator&& other) noexcept
+        : _handle(std::exchange(other._handle, nullptr)) {}
+
+    Generator(const Generator&) = delete;
+
+    Generator& operator=(const Generator&) = delete;
+
+    ~Generator() noexcept {
+        if (_handle) {
+            _handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Starts the generator and returns an iterator to the first yielded value.
+     * May be called once.
+     * @throws Any exception thrown by the generator before its first `co_yield`.
+     */
+    Iterator begin() {
+        advance(_handle);
+        return Iterator(_handle);
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle(handle) {}
+
+    static void advance(std::coroutine_handle<promise_type> handle) {
+        handle.resume();
+        if (handle.done() && handle.promise().error) {
+            std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+        }
+    }
+};
+
+#endif // TASK_HPP
@@ -0,0 +1,75 @@
+#include "arena.hpp"
+#include "task.hpp"
+#include <chrono>
+#include <print>
+
+namespace {
+
+using FrameAllocator = ArenaAllocator<>;
+
+constexpr int requestCount = 200000;
+
+// A request handler split into small coroutines, as a parser/validator/lookup chain would be.
+template <Allocator AllocatorT>
+Task<int, AllocatorT> parseField(std::allocator_arg_t, AllocatorT, int request, int field) {
+    co_return (request * 31 + field) % 97;
+}
+
+template <Allocator AllocatorT>
+Task<bool, AllocatorT> validate(std::allocator_arg_t, AllocatorT allocator, int request) {
+    int checksum = 0;
+    for (int field = 0; field < 8; ++field) {
+        checksum += co_await parseField(std::allocator_arg, allocator, request, field);
+    }
+    co_return checksum % 2 == 0;
+}
+
+template <Allocator AllocatorT>
+Task<int, AllocatorT> handle(std::allocator_arg_t, AllocatorT allocator, int request) {
+    bool valid = co_await validate(std::allocator_arg, allocator, request);
+    co_return valid ? 200 : 400;
+}
+
+// Serves every request with a given allocator and returns the number of successful ones.
+template <Allocator AllocatorT, typename ResetT>
+int serve(AllocatorT allocator, ResetT reset) {
+    int ok = 0;
+    for (int request = 0; request < requestCount; ++request) {
+        ok += handle(std::allocator_arg, allocator, request).run() == 200;
+        reset();
+    }
+    return ok;
+}
+
+Generator<int, FrameAllocator> fibonacci(std::allocator_arg_t, FrameAllocator, int count) {
+    int a = 0;
+    int b = 1;
+    for (int i = 0; i < count; ++i) {
+        co_yield a;
+        a = std::exchange(b, a + b);
+    }
+}
+
+} // namespace
+
+int main() {
+    Arena<> arena(4096);
+
+    auto start = std::chrono::steady_clock::now();
+    int heapOk = serve(DefaultAllocator(), [] {});
+    auto heapTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    int arenaOk = serve(FrameAllocator{&arena}, [&] { arena.reset(); });
+    auto arenaTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::println("heap frames:  {} ok in {:.3f} s", heapOk, heapTime.count());
+    std::println("arena frames: {} ok in {:.3f} s", arenaOk, arenaTime.count());
+
+    std::print("fibonacci:");
+    for (int value : fibonacci(std::allocator_arg, FrameAllocator{&arena}, 10)) {
+        std::print(" {}", value);
+    }
+    std::println("");
+    std::println("arena bytes in use: {}", arena.bytesAllocated());
+}
@@ -0,0 +1,184 @@
+#include "arena.hpp"
+#include "task.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+struct CountingAllocator {
+    static int allocations;
+    static int deallocations;
+
+    void* allocate(size_t count, std::align_val_t alignment) const {
+        ++allocations;
+        return ::operator new(count, alignment);
+    }
+
+    void deallocate(void* pointer, std::align_val_t alignment) const noexcept {
+        ++deallocations;
+        ::operator delete(pointer, alignment);
+    }
+};
+
+int CountingAllocator::allocations = 0;
+int CountingAllocator::deallocations = 0;
+
+using RequestArena = Arena<CountingAllocator>;
+using FrameAllocator = ArenaAllocator<CountingAllocator>;
+
+Task<int, FrameAllocator> leaf(std::allocator_arg_t, FrameAllocator, int value) {
+    co_return value;
+}
+
+Task<int, FrameAllocator> sum(std::allocator_arg_t, FrameAllocator allocator, int count) {
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += co_await leaf(std::allocator_arg, allocator, i);
+    }
+    co_return total;
+}
+
+Task<int, FrameAllocator> countUp(std::allocator_arg_t, FrameAllocator allocator, int count) {
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += co_await leaf(std::allocator_arg, allocator, 1);
+    }
+    co_return total;
+}
+
+Task<void, FrameAllocator> throwing(std::allocator_arg_t, FrameAllocator) {
+    throw std::runtime_error("handler failed");
+    co_return;
+}
+
+Task<bool, FrameAllocator> catching(std::allocator_arg_t, FrameAllocator allocator) {
+    try {
+        co_await throwing(std::allocator_arg, allocator);
+    } catch (const std::runtime_error&) {
+        co_return true;
+    }
+    co_return false;
+}
+
+Generator<int, FrameAllocator> iota(std::allocator_arg_t, FrameAllocator, int count) {
+    for (int i = 0; i < count; ++i) {
+        co_yield i;
+    }
+}
+
+Generator<int> failing() {
+    co_yield 1;
+    throw std::runtime_error("generator failed");
+}
+
+Task<std::unique_ptr<int>> makeValue() {
+    co_return std::make_unique<int>(42);
+}
+
+struct Handler {
+    int base = 100;
+
+    Task<int, FrameAllocator> handle(std::allocator_arg_t, FrameAllocator allocator, int value) {
+        co_return base + co_await leaf(std::allocator_arg, allocator, value);
+    }
+};
+
+class TaskTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        CountingAllocator::allocations = 0;
+        CountingAllocator::deallocations = 0;
+    }
+};
+
+} // namespace
+
+// Test that awaited tasks produce their results
+TEST_F(TaskTest, AwaitChain) {
+    RequestArena arena;
+    FrameAllocator allocator{&arena};
+
+    EXPECT_EQ(sum(std::allocator_arg, allocator, 10).run(), 45);
+    EXPECT_EQ(Handler().handle(std::allocator_arg, allocator, 5).run(), 105);
+    EXPECT_EQ(*makeValue().run(), 42);
+}
+
+// Test that all frames of a request come from its arena
+TEST_F(TaskTest, FramesFromArena) {
+    {
+        RequestArena arena(1 << 20);
+        FrameAllocator allocator{&arena};
+
+        for (int request = 0; request < 100; ++request) {
+            EXPECT_EQ(sum(std::allocator_arg, allocator, 100).run(), 4950);
+            EXPECT_GT(arena.bytesAllocated(), 0);
+            arena.reset();
+            EXPECT_EQ(arena.bytesAllocated(), 0);
+        }
+
+        EXPECT_EQ(CountingAllocator::allocations, 1);
+    }
+    EXPECT_EQ(CountingAllocator::deallocations, 1);
+}
+
+// Test that frames outgrowing a chunk spill into new chunks that are freed together
+TEST_F(TaskTest, ArenaGrowth) {
+    {
+        RequestArena arena(256);
+        FrameAllocator allocator{&arena};
+
+        EXPECT_EQ(sum(std::allocator_arg, allocator, 50).run(), 1225);
+        EXPECT_GT(CountingAllocator::allocations, 1);
+
+        arena.reset();
+        EXPECT_EQ(CountingAllocator::allocations - CountingAllocator::deallocations, 1);
+    }
+    EXPECT_EQ(CountingAllocator::allocations, CountingAllocator::deallocations);
+}
+
+// Test that symmetric transfer keeps the stack flat for long chains of synchronous tasks
+TEST_F(TaskTest, SymmetricTransfer) {
+#if !defined(__clang__) && (!defined(__OPTIMIZE__) || defined(__SANITIZE_ADDRESS__))
+    GTEST_SKIP() << "GCC only turns symmetric transfer into a tail call at -O2 and above, without AddressSanitizer";
+#endif
+    RequestArena arena(1 << 20);
+    FrameAllocator allocator{&arena};
+
+    EXPECT_EQ(countUp(std::allocator_arg, allocator, 1'000'000).run(), 1'000'000);
+}
+
+// Test that exceptions travel to the awaiting task
+TEST_F(TaskTest, Exception) {
+    RequestArena arena;
+    FrameAllocator allocator{&arena};
+
+    EXPECT_TRUE(catching(std::allocator_arg, allocator).run());
+    EXPECT_THROW(throwing(std::allocator_arg, allocator).run(), std::runtime_error);
+}
+
+// Test a generator with an arena-allocated frame
+TEST_F(TaskTest, Generator) {
+    RequestArena arena;
+    int total = 0;
+    int count = 0;
+
+    for (int value : iota(std::allocator_arg, FrameAllocator{&arena}, 5)) {
+        total += value;
+        ++count;
+    }
+
+    EXPECT_EQ(count, 5);
+    EXPECT_EQ(total, 10);
+    EXPECT_GT(arena.bytesAllocated(), 0);
+    static_assert(std::ranges::input_range<Generator<int>>);
+}
+
+// Test that exceptions thrown by a generator reach the consumer
+TEST_F(TaskTest, GeneratorException) {
+    Generator<int> generator = failing();
+    auto it = generator.begin();
+
+    EXPECT_EQ(*it, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+}
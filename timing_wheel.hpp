@@ -0,0 +1,309 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include "dynamic_array.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Identifies a scheduled timer. Stale handles (fired or cancelled timers) are detected
+ * through a generation counter, so keeping them around is harmless.
+ */
+struct TimerHandle {
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+};
+
+/**
+ * @brief A hierarchical timing wheel for large numbers of timeouts.
+ * Time is measured in integer ticks. Level `k` has 64 buckets, each covering 64^k ticks.
+ * Timers live in a `DArray` node pool and buckets are intrusive doubly linked lists of pool
+ * indices, so schedule and cancel are O(1) and never allocate once the pool has grown.
+ *
+ * Cascading is spread over time: while level `k` is in bucket `c`, it moves the timers of bucket
+ * `c + 1` down a few at a time on every tick, finishing by the last tick of bucket `c`, instead of
+ * moving the whole bucket at once when it becomes current. Timers are placed so that they never
+ * land in a bucket that is already being drained.
+ * @tparam PayloadT The value delivered when a timer fires. Must be default constructible and movable.
+ * @tparam AllocatorT The allocator type used for the node pool and buckets. Defaults to `DefaultAllocator`.
+ */
+template <typename PayloadT, Allocator AllocatorT = DefaultAllocator>
+class TimingWheel {
+public:
+    static constexpr size_t slotBits = 6;
+    static constexpr size_t slotsPerLevel = size_t{1} << slotBits;
+    static constexpr size_t levels = 6;
+
+private:
+    static constexpr uint32_t nil = std::numeric_limits<uint32_t>::max();
+    static constexpr uint16_t freeBucket = std::numeric_limits<uint16_t>::max();
+    static constexpr size_t slotMask = slotsPerLevel - 1;
+
+    struct Node {
+        uint64_t deadline = 0;
+        uint32_t prev = nil;
+        uint32_t next = nil;
+        uint32_t generation = 0;
+        uint16_t bucket = freeBucket;
+        PayloadT payload{};
+    };
+
+    DArray<Node, AllocatorT> _nodes;
+    DArray<uint32_t, AllocatorT> _heads;
+    DArray<uint32_t, AllocatorT> _bucketSizes;
+    DArray<PayloadT, AllocatorT> _expired;
+    uint32_t _drainCursors[levels];
+    uint32_t _freeHead = nil;
+    size_t _size = 0;
+    uint64_t _now;
+
+public:
+    /**
+     * @brief Constructs an empty wheel.
+     * @param now The current tick.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    explicit TimingWheel(uint64_t now = 0)
+        : _heads(nil, levels * slotsPerLevel)
+        , _bucketSizes(0u, levels * slotsPerLevel)
+        , _now(now) {
+        resetDrainCursors();
+    }
+
+    /**
+     * @brief Returns the current tick.
+     */
+    uint64_t now() const noexcept {
+        return _now;
+    }
+
+    /**
+     * @brief Returns the number of pending timers.
+     */
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Pre-allocates room for `n` timers so that scheduling does not allocate.
+     * @throws std::bad_alloc If memory allocation fails.
+     */
+    void reserve(size_t n) {
+        _nodes.reserve(n);
+        _expired.reserve(n);
+    }
+
+    /**
+     * @brief Schedules `payload` to fire at tick `deadline`.
+     * Deadlines at or before the current tick fire on the next tick.
+     * @return A handle that can be used to cancel or reschedule the timer.
+     * @throws std::bad_alloc If the node pool has to grow and allocation fails.
+     * @throws std::length_error If more than 2^32 - 1 timers are pending.
+     */
+    TimerHandle schedule(uint64_t deadline, PayloadT payload) {
+        uint32_t index = allocateNode();
+        Node& node = _nodes[index];
+        node.deadline = deadline > _now ? deadline : _now + 1;
+        node.payload = std::move(payload);
+        place(index);
+        ++_size;
+        return {index, node.generation};
+    }
+
+    /**
+     * @brief Schedules `payload` to fire `delay` ticks from now.
+     */
+    TimerHandle scheduleAfter(uint64_t delay, PayloadT payload) {
+        return schedule(_now + delay, std::move(payload));
+    }
+
+    /**
+     * @brief Checks whether `handle` refers to a pending timer.
+     */
+    bool contains(TimerHandle handle) const noexcept {
+        return handle.index < _nodes.size() &&
+               _nodes[handle.index].generation == handle.generation &&
+               _nodes[handle.index].bucket != freeBucket;
+    }
+
+    /**
+     * @brief Cancels a pending timer in O(1).
+     * @return `true` if the timer was pending, `false` if it already fired or was cancelled.
+     */
+    bool cancel(TimerHandle handle) noexcept {
+        if (!contains(handle)) {
+            return false;
+        }
+        unlink(handle.index);
+        freeNode(handle.index);
+        return true;
+    }
+
+    /**
+     * @brief Moves a pending timer to a new deadline in O(1). The handle stays valid.
+     * @return `true` if the timer was pending, `false` if it already fired or was cancelled.
+     */
+    bool reschedule(TimerHandle handle, uint64_t deadline) noexcept {
+        if (!contains(handle)) {
+            return false;
+        }
+        unlink(handle.index);
+        _nodes[handle.index].deadline = deadline > _now ? deadline : _now + 1;
+        place(handle.index);
+        return true;
+    }
+
+    /**
+     * @brief Advances the wheel to tick `now` and collects the payloads of all timers that became due.
+     * Timers fire in tick order; timers due on the same tick fire in unspecified order.
+     * Costs one step per elapsed tick plus the work for due and cascaded timers; stretches of
+     * time in which no timers are pending are skipped in O(1).
+     * @return The due payloads as one contiguous span, valid until the next call to `advance`.
+     * @throws std::bad_alloc If growing the expiry buffer fails. Use `reserve()` to rule this out.
+     */
+    std::span<PayloadT> advance(uint64_t now) {
+        _expired.clear();
+        while (_now < now) {
+            if (_size == 0) {
+                _now = now;
+                resetDrainCursors();
+                break;
+            }
+            tick();
+        }
+        return {_expired.data(), _expired.size()};
+    }
+
+private:
+    static size_t shift(size_t level) noexcept {
+        return slotBits * level;
+    }
+
+    void resetDrainCursors() noexcept {
+        for (uint32_t& cursor : _drainCursors) {
+            cursor = nil;
+        }
+    }
+
+    uint32_t allocateNode() {
+        if (_freeHead != nil) {
+            uint32_t index = _freeHead;
+            _freeHead = _nodes[index].next;
+            return index;
+        }
+        if (_nodes.size() >= nil) {
+            throw std::length_error("Too many timers");
+        }
+        _nodes.emplaceAtEnd();
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    void freeNode(uint32_t index) noexcept {
+        Node& node = _nodes[index];
+        node.bucket = freeBucket;
+        ++node.generation;
+        node.next = _freeHead;
+        _freeHead = index;
+        --_size;
+    }
+
+    // Picks the lowest level whose parent level sees the deadline in its current or next bucket.
+    // At that level the deadline is at least two buckets ahead, so it never lands in the bucket the
+    // level is currently draining (always the one right after the current bucket).
+    void place(uint32_t index) noexcept {
+        uint64_t deadline = _nodes[index].deadline;
+        size_t level = 0;
+        while (level + 1 < levels && (deadline >> shift(level + 1)) - (_now >> shift(level + 1)) > 1) {
+            ++level;
+        }
+        size_t slot = (deadline >> shift(level)) & slotMask;
+        link(index, level * slotsPerLevel + slot);
+    }
+
+    void link(uint32_t index, size_t bucket) noexcept {
+        Node& node = _nodes[index];
+        node.bucket = static_cast<uint16_t>(bucket);
+        node.prev = nil;
+        node.next = _heads[bucket];
+        if (node.next != nil) {
+            _nodes[node.next].prev = index;
+        }
+        _heads[bucket] = index;
+        ++_bucketSizes[bucket];
+    }
+
+    void unlink(uint32_t index) noexcept {
+        Node& node = _nodes[index];
+        uint32_t& cursor = _drainCursors[node.bucket / slotsPerLevel];
+        if (cursor == index) {
+            cursor = node.next;
+        }
+        if (node.prev != nil) {
+            _nodes[node.prev].next = node.next;
+        } else {
+            _heads[node.bucket] = node.next;
+        }
+        if (node.next != nil) {
+            _nodes[node.next].prev = node.prev;
+        }
+        --_bucketSizes[node.bucket];
+    }
+
+    void tick() {
+        ++_now;
+        for (size_t level = levels - 1; level > 0; --level) {
+            uint64_t span = uint64_t{1} << shift(level);
+            uint64_t offset = _now & (span - 1);
+            size_t bucket = level * slotsPerLevel + (((_now >> shift(level)) + 1) & slotMask);
+            if (offset == 0) {
+                _drainCursors[level] = _heads[bucket];
+            }
+            drain(level, span - offset);
+        }
+        expire();
+    }
+
+    // Moves timers of the level's next bucket one level (or more) down. The budget is sized so
+    // that the bucket is empty (apart from timers a full rotation ahead) by the last tick of the
+    // current bucket.
+    void drain(size_t level, uint64_t ticksLeft) noexcept {
+        uint32_t& cursor = _drainCursors[level];
+        if (cursor == nil) {
+            return;
+        }
+        uint64_t nextBucket = (_now >> shift(level)) + 1;
+        uint64_t pending = _bucketSizes[_nodes[cursor].bucket];
+        uint64_t budget = ticksLeft == 1 ? std::numeric_limits<uint64_t>::max() : (pending + ticksLeft - 1) / ticksLeft;
+        for (; budget > 0 && cursor != nil; --budget) {
+            uint32_t index = cursor;
+            cursor = _nodes[index].next;
+            if ((_nodes[index].deadline >> shift(level)) == nextBucket) {
+                unlink(index);
+                place(index);
+            }
+        }
+    }
+
+    void expire() {
+        uint32_t index = _heads[_now & slotMask];
+        while (index != nil) {
+            uint32_t next = _nodes[index].next;
+            if (_nodes[index].deadline <= _now) {
+                _expired.push(std::move(_nodes[index].payload));
+                unlink(index);
+                freeNode(index);
+            }
+            index = next;
+        }
+    }
+};
+
+#endif // TIMING_WHEEL_HPP
@@ -0,0 +1,32 @@
+#include "timing_wheel.hpp"
+#include <chrono>
+#include <print>
+#include <random>
+
+int main() {
+    constexpr size_t connections = 1'000'000;
+    std::mt19937 random(1);
+    TimingWheel<uint32_t> wheel;
+    wheel.reserve(connections);
+    DArray<TimerHandle> timeouts;
+    timeouts.reserve(connections);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t id = 0; id < connections; ++id) {
+        timeouts.push(wheel.scheduleAfter(1000 + random() % 30'000, id));
+    }
+    // Most connections see traffic and push their timeout back.
+    for (uint32_t id = 0; id < connections; id += 2) {
+        wheel.reschedule(timeouts[id], wheel.now() + 60'000);
+    }
+    // Some close cleanly.
+    for (uint32_t id = 1; id < connections; id += 10) {
+        wheel.cancel(timeouts[id]);
+    }
+    size_t fired = 0;
+    for (uint64_t tick = 1; !wheel.empty(); ++tick) {
+        fired += wheel.advance(tick).size();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("{} timeouts fired, {} ticks, {:.1f} ms", fired, wheel.now(), elapsed.count());
+}
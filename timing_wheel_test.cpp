@@ -0,0 +1,155 @@
+#include "timing_wheel.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(TimingWheelTest, FiresAtDeadline) {
+    TimingWheel<int> wheel;
+    wheel.schedule(5, 1);
+    wheel.schedule(3, 2);
+    EXPECT_EQ(wheel.size(), 2);
+
+    EXPECT_TRUE(wheel.advance(2).empty());
+    auto due = wheel.advance(3);
+    ASSERT_EQ(due.size(), 1);
+    EXPECT_EQ(due[0], 2);
+    EXPECT_TRUE(wheel.advance(4).empty());
+    due = wheel.advance(5);
+    ASSERT_EQ(due.size(), 1);
+    EXPECT_EQ(due[0], 1);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, PastDeadlineFiresOnNextTick) {
+    TimingWheel<int> wheel(100);
+    wheel.schedule(50, 7);
+    auto due = wheel.advance(101);
+    ASSERT_EQ(due.size(), 1);
+    EXPECT_EQ(due[0], 7);
+}
+
+TEST(TimingWheelTest, BatchedExpiryIsContiguous) {
+    TimingWheel<int> wheel;
+    for (int i = 0; i < 100; ++i) {
+        wheel.schedule(10 + i % 3, i);
+    }
+    auto due = wheel.advance(12);
+    EXPECT_EQ(due.size(), 100);
+    std::vector<int> values(due.begin(), due.end());
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+}
+
+TEST(TimingWheelTest, FiresInTickOrderAcrossLevels) {
+    TimingWheel<uint64_t> wheel;
+    std::vector<uint64_t> deadlines = {1, 63, 64, 65, 127, 128, 4095, 4096, 4097, 300'000, 1 << 24};
+    for (uint64_t deadline : deadlines) {
+        wheel.schedule(deadline, deadline);
+    }
+    std::vector<uint64_t> fired;
+    uint64_t now = 0;
+    while (!wheel.empty()) {
+        now += 1;
+        for (uint64_t deadline : wheel.advance(now)) {
+            EXPECT_EQ(deadline, now);
+            fired.push_back(deadline);
+        }
+    }
+    EXPECT_EQ(fired, deadlines);
+}
+
+TEST(TimingWheelTest, Cancel) {
+    TimingWheel<std::string> wheel;
+    TimerHandle a = wheel.schedule(10, "a");
+    TimerHandle b = wheel.schedule(5000, "b");
+    EXPECT_TRUE(wheel.contains(a));
+    EXPECT_TRUE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.contains(a));
+    EXPECT_FALSE(wheel.cancel(a));
+    EXPECT_TRUE(wheel.advance(10).empty());
+
+    auto due = wheel.advance(5000);
+    ASSERT_EQ(due.size(), 1);
+    EXPECT_EQ(due[0], "b");
+    EXPECT_FALSE(wheel.cancel(b));
+}
+
+TEST(TimingWheelTest, StaleHandleDoesNotCancelReusedNode) {
+    TimingWheel<int> wheel;
+    TimerHandle first = wheel.schedule(1, 1);
+    wheel.advance(1);
+    TimerHandle second = wheel.schedule(2, 2);
+    EXPECT_EQ(first.index, second.index);
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_TRUE(wheel.contains(second));
+}
+
+TEST(TimingWheelTest, Reschedule) {
+    TimingWheel<int> wheel;
+    TimerHandle handle = wheel.schedule(100, 1);
+    EXPECT_TRUE(wheel.reschedule(handle, 20));
+    auto due = wheel.advance(20);
+    ASSERT_EQ(due.size(), 1);
+    EXPECT_FALSE(wheel.reschedule(handle, 30));
+}
+
+TEST(TimingWheelTest, EmptyWheelJumpsAhead) {
+    TimingWheel<int> wheel;
+    wheel.advance(1'000'000'000'000);
+    EXPECT_EQ(wheel.now(), 1'000'000'000'000);
+    wheel.scheduleAfter(70, 1);
+    EXPECT_TRUE(wheel.advance(1'000'000'000'069).empty());
+    EXPECT_EQ(wheel.advance(1'000'000'000'070).size(), 1);
+}
+
+TEST(TimingWheelTest, MatchesReferenceUnderRandomChurn) {
+    std::mt19937_64 random(42);
+    TimingWheel<int> wheel(12345);
+    std::multimap<uint64_t, int> reference;
+    std::vector<std::pair<TimerHandle, uint64_t>> handles;
+    int nextId = 0;
+
+    uint64_t now = wheel.now();
+    for (int step = 0; step < 20000; ++step) {
+        int action = random() % 10;
+        if (action < 6) {
+            uint64_t delay = 1 + random() % (random() % 4 == 0 ? 300'000 : 5'000);
+            int id = nextId++;
+            handles.push_back({wheel.schedule(now + delay, id), now + delay});
+            reference.insert({now + delay, id});
+        } else if (action < 8 && !handles.empty()) {
+            size_t pick = random() % handles.size();
+            auto [handle, deadline] = handles[pick];
+            if (wheel.cancel(handle)) {
+                // Ids are handed out in the same order as `handles` grows.
+                int id = static_cast<int>(pick);
+                for (auto [it, end] = reference.equal_range(deadline); it != end; ++it) {
+                    if (it->second == id) {
+                        reference.erase(it);
+                        break;
+                    }
+                }
+            }
+        } else {
+            now += 1 + random() % 200;
+            std::vector<int> fired;
+            for (int id : wheel.advance(now)) {
+                fired.push_back(id);
+            }
+            std::vector<int> expected;
+            while (!reference.empty() && reference.begin()->first <= now) {
+                expected.push_back(reference.begin()->second);
+                reference.erase(reference.begin());
+            }
+            std::sort(fired.begin(), fired.end());
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(fired, expected) << "at tick " << now;
+        }
+        ASSERT_EQ(wheel.size(), reference.size());
+    }
+}
@@ -3,7 +3,6 @@
 
 #include <concepts>
 #include <cstddef>
-#include <print>
 #include <type_traits>
 #include <utility>
 
@@ -113,6 +112,12 @@ public:
     UniquePointer(ValueT* pointer) noexcept
         : _pointer(pointer) {}
 
+    template <typename DeleterU>
+        requires std::constructible_from<DeleterT, DeleterU>
+    UniquePointer(ValueT* pointer, DeleterU&& deleter) noexcept(std::is_nothrow_constructible_v<DeleterT, DeleterU>)
+        : _pointer(pointer)
+        , _deleter(std::forward<DeleterU>(deleter)) {}
+
     UniquePointer(const UniquePointer&) = delete;
 
     UniquePointer(UniquePointer&& other) noexcept
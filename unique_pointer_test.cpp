@@ -1,6 +1,7 @@
 #include "unique_pointer.hpp"
 #include <gtest/gtest.h>
 #include <initializer_list>
+#include <print>
 
 // =============================================================================
 // Concepts
@@ -147,6 +148,18 @@ TEST_F(UniquePointerTest, ConstructorWithValue) {
     EXPECT_EQ(*ptr, 42);
 }
 
+TEST_F(UniquePointerTest, ConstructorWithValueAndDeleter) {
+    int* rawPtr = new int(42);
+    TestDeleter deleter;
+    {
+        UniquePointer<int, TestDeleter> ptr(rawPtr, deleter);
+
+        EXPECT_EQ(ptr.get(), rawPtr);
+        EXPECT_EQ(TestDeleter::copyConstructedCount, 1);
+    }
+    EXPECT_EQ(TestDeleter::callCount, 1);
+}
+
 TEST_F(UniquePointerTest, MoveConstructor) {
     int* rawPtr = new int(42);
 
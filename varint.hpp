@@ -0,0 +1,235 @@
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include "cpu_dispatch.hpp"
+#include "dynamic_array.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Variable-length integer encodings. LEB128 is the one-value-at-a-time format used for lengths
+// and single records. Stream VByte encodes arrays of 32-bit values: the 2-bit byte lengths of
+// four values are packed into one control byte and stored apart from the value bytes, so a
+// decoder expands four values with a single table-driven byte shuffle instead of branching on
+// every byte.
+
+/**
+ * @brief Maps signed integers to unsigned ones so that values of small magnitude encode short.
+ */
+constexpr uint32_t zigzagEncode(int32_t value) noexcept {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+constexpr int32_t zigzagDecode(uint32_t value) noexcept {
+    return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+}
+
+/**
+ * @brief Appends `value` as LEB128: seven bits per byte, low bits first, high bit set on every
+ * byte but the last.
+ */
+inline void writeVarint(uint64_t value, DArray<std::byte>& out) {
+    while (value >= 0x80) {
+        out.push(static_cast<std::byte>(value | 0x80));
+        value >>= 7;
+    }
+    out.push(static_cast<std::byte>(value));
+}
+
+/**
+ * @brief Reads bytes from a span, checking every read against its end.
+ */
+class ByteReader {
+private:
+    const std::byte* _cursor;
+    const std::byte* _end;
+
+public:
+    explicit ByteReader(std::span<const std::byte> input) noexcept
+        : _cursor(input.data())
+        , _end(input.data() + input.size()) {}
+
+    /**
+     * @brief Consumes `n` bytes and returns a pointer to the first of them.
+     * @throws std::out_of_range If fewer than `n` bytes remain.
+     */
+    const std::byte* take(size_t n) {
+        if (n > remaining()) {
+            throw std::out_of_range("Truncated input");
+        }
+        const std::byte* bytes = _cursor;
+        _cursor += n;
+        return bytes;
+    }
+
+    /**
+     * @brief Consumes one LEB128 value.
+     * @throws std::out_of_range If the input ends inside the value.
+     * @throws std::invalid_argument If the value does not fit into 64 bits.
+     */
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            auto byte = static_cast<uint64_t>(*take(1));
+            value |= (byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                if (shift == 63 && byte > 1) {
+                    break;
+                }
+                return value;
+            }
+        }
+        throw std::invalid_argument("Varint overflows 64 bits");
+    }
+
+    std::span<const std::byte> rest() const noexcept {
+        return {_cursor, remaining()};
+    }
+
+    size_t remaining() const noexcept {
+        return static_cast<size_t>(_end - _cursor);
+    }
+};
+
+/**
+ * @brief Lookup tables of the Stream VByte decoder, indexed by control byte.
+ */
+struct StreamVByteTables {
+    // For each control byte, the byte shuffle that spreads its value bytes over four 32-bit lanes;
+    // 0xff clears the byte.
+    std::array<std::array<uint8_t, 16>, 256> shuffle;
+    // For each control byte, the number of value bytes it covers (4 to 16).
+    std::array<uint8_t, 256> length;
+};
+
+constexpr StreamVByteTables makeStreamVByteTables() noexcept {
+    StreamVByteTables tables{};
+    for (unsigned control = 0; control < 256; ++control) {
+        uint8_t position = 0;
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            unsigned bytes = ((control >> (2 * lane)) & 3) + 1;
+            for (unsigned b = 0; b < 4; ++b) {
+                tables.shuffle[control][4 * lane + b] = b < bytes ? static_cast<uint8_t>(position + b) : 0xff;
+            }
+            position += static_cast<uint8_t>(bytes);
+        }
+        tables.length[control] = position;
+    }
+    return tables;
+}
+
+inline constexpr StreamVByteTables streamVByteTables = makeStreamVByteTables();
+
+/**
+ * @brief Returns the number of control bytes that describe `count` values.
+ */
+constexpr size_t streamVByteControlSize(size_t count) noexcept {
+    return (count + 3) / 4;
+}
+
+/**
+ * @brief Appends `values` in Stream VByte format: `streamVByteControlSize(n)` control bytes, then
+ * the 1 to 4 little-endian bytes of each value.
+ */
+inline void encodeStreamVByte(std::span<const uint32_t> values, DArray<std::byte>& out) {
+    size_t controlSize = streamVByteControlSize(values.size());
+    size_t start = out.size();
+    out.resizeForOverwrite(start + controlSize + 4 * values.size());
+    std::byte* control = out.data() + start;
+    std::byte* data = control + controlSize;
+    for (size_t i = 0; i < values.size(); i += 4) {
+        unsigned bits = 0;
+        for (size_t lane = 0; lane < 4 && i + lane < values.size(); ++lane) {
+            uint32_t value = values[i + lane];
+            unsigned bytes = value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+            std::memcpy(data, &value, 4); // Little endian: the low `bytes` bytes come first.
+            data += bytes;
+            bits |= (bytes - 1) << (2 * lane);
+        }
+        control[i / 4] = static_cast<std::byte>(bits);
+    }
+    out.resize(static_cast<size_t>(data - out.data()));
+}
+
+// Decoder kernels. `data` must hold every value byte the control bytes announce; the vector loops
+// read 16 bytes at a time and stop while fewer than that remain, leaving the rest to the scalar loop.
+
+inline void decodeStreamVByteScalar(const std::byte* control, const std::byte* data, const std::byte*, size_t count, uint32_t* values) {
+    for (size_t i = 0; i < count; ++i) {
+        unsigned bytes = ((static_cast<unsigned>(control[i / 4]) >> (2 * (i % 4))) & 3) + 1;
+        uint32_t value = 0;
+        std::memcpy(&value, data, bytes);
+        data += bytes;
+        values[i] = value;
+    }
+}
+
+#if defined(__x86_64__)
+
+DS_TARGET_AVX2 inline void decodeStreamVByteAvx2(const std::byte* control, const std::byte* data, const std::byte* end, size_t count, uint32_t* values) {
+    size_t i = 0;
+    for (; i + 4 <= count && end - data >= 16; i += 4) {
+        auto bits = static_cast<uint8_t>(control[i / 4]);
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(streamVByteTables.shuffle[bits].data()));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_shuffle_epi8(bytes, shuffle));
+        data += streamVByteTables.length[bits];
+    }
+    decodeStreamVByteScalar(control + i / 4, data, end, count - i, values + i);
+}
+
+#elif defined(__aarch64__)
+
+inline void decodeStreamVByteNeon(const std::byte* control, const std::byte* data, const std::byte* end, size_t count, uint32_t* values) {
+    size_t i = 0;
+    for (; i + 4 <= count && end - data >= 16; i += 4) {
+        auto bits = static_cast<uint8_t>(control[i / 4]);
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(data));
+        uint8x16_t shuffle = vld1q_u8(streamVByteTables.shuffle[bits].data());
+        // Out-of-range indices (0xff) produce zero bytes, as with `pshufb`.
+        vst1q_u32(values + i, vreinterpretq_u32_u8(vqtbl1q_u8(bytes, shuffle)));
+        data += streamVByteTables.length[bits];
+    }
+    decodeStreamVByteScalar(control + i / 4, data, end, count - i, values + i);
+}
+
+#endif
+
+inline const Dispatched<void(const std::byte*, const std::byte*, const std::byte*, size_t, uint32_t*)> decodeStreamVByteKernel = {
+    {CpuTarget::Scalar, decodeStreamVByteScalar},
+#if defined(__x86_64__)
+    {CpuTarget::Avx2, decodeStreamVByteAvx2},
+#elif defined(__aarch64__)
+    {CpuTarget::Neon, decodeStreamVByteNeon},
+#endif
+};
+
+/**
+ * @brief Consumes `values.size()` Stream VByte values from `reader` into `values`.
+ * @throws std::out_of_range If the input is shorter than the control bytes announce.
+ */
+inline void decodeStreamVByte(ByteReader& reader, std::span<uint32_t> values) {
+    size_t count = values.size();
+    const std::byte* control = reader.take(streamVByteControlSize(count));
+    size_t dataSize = 0;
+    for (size_t i = 0; i < count / 4; ++i) {
+        dataSize += streamVByteTables.length[static_cast<uint8_t>(control[i])];
+    }
+    for (size_t i = count & ~size_t{3}; i < count; ++i) {
+        dataSize += ((static_cast<unsigned>(control[i / 4]) >> (2 * (i % 4))) & 3) + 1;
+    }
+    const std::byte* data = reader.take(dataSize);
+    decodeStreamVByteKernel(control, data, data + dataSize, count, values.data());
+}
+
+#endif // VARINT_HPP
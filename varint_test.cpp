@@ -0,0 +1,103 @@
+#include "varint.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+
+namespace {
+
+using DecodeKernel = void (*)(const std::byte*, const std::byte*, const std::byte*, size_t, uint32_t*);
+
+// Runs `check` with every decoder variant that this CPU can execute.
+template <typename CheckT>
+void forEachDecoder(CheckT check) {
+    for (size_t i = 0; i < cpuTargetCount; ++i) {
+        auto target = static_cast<CpuTarget>(i);
+        DecodeKernel kernel = decodeStreamVByteKernel.variant(target);
+        if (kernel != nullptr && cpuTargetEnabled(target)) {
+            SCOPED_TRACE(cpuTargetName(target));
+            check(kernel);
+        }
+    }
+}
+
+} // namespace
+
+// Test that zigzag maps small magnitudes to small codes and round-trips the extremes
+TEST(VarintTest, Zigzag) {
+    EXPECT_EQ(zigzagEncode(0), 0);
+    EXPECT_EQ(zigzagEncode(-1), 1);
+    EXPECT_EQ(zigzagEncode(1), 2);
+    EXPECT_EQ(zigzagEncode(-2), 3);
+    for (int32_t value : {0, 1, -1, 1000, -1000, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::min()}) {
+        EXPECT_EQ(zigzagDecode(zigzagEncode(value)), value);
+    }
+}
+
+// Test LEB128 sizes and round trips, including the 64-bit maximum
+TEST(VarintTest, Leb128) {
+    DArray<std::byte> out;
+    writeVarint(0, out);
+    writeVarint(127, out);
+    writeVarint(128, out);
+    writeVarint(std::numeric_limits<uint64_t>::max(), out);
+
+    EXPECT_EQ(out.size(), 1 + 1 + 2 + 10);
+    ByteReader reader(out);
+    EXPECT_EQ(reader.readVarint(), 0);
+    EXPECT_EQ(reader.readVarint(), 127);
+    EXPECT_EQ(reader.readVarint(), 128);
+    EXPECT_EQ(reader.readVarint(), std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(reader.remaining(), 0);
+}
+
+// Test that malformed LEB128 input is rejected
+TEST(VarintTest, Leb128Malformed) {
+    DArray<std::byte> truncated = {std::byte{0x80}, std::byte{0x80}};
+    ByteReader truncatedReader(truncated);
+    EXPECT_THROW(truncatedReader.readVarint(), std::out_of_range);
+
+    DArray<std::byte> overlong(std::byte{0xff}, 9);
+    overlong.push(std::byte{0x02});
+    ByteReader overlongReader(overlong);
+    EXPECT_THROW(overlongReader.readVarint(), std::invalid_argument);
+}
+
+// Test that every decoder variant reproduces values of every byte length, for all tail sizes
+TEST(VarintTest, StreamVByte) {
+    std::mt19937 random(42);
+    for (size_t count : {0, 1, 3, 4, 5, 17, 64, 1001}) {
+        DArray<uint32_t> values;
+        for (size_t i = 0; i < count; ++i) {
+            unsigned bits = 8 * (random() % 4 + 1);
+            values.push(static_cast<uint32_t>(random()) >> (32 - bits));
+        }
+        DArray<std::byte> encoded;
+        encodeStreamVByte(values, encoded);
+
+        forEachDecoder([&](DecodeKernel kernel) {
+            DArray<uint32_t> decoded(count);
+            const std::byte* data = encoded.data() + streamVByteControlSize(count);
+            kernel(encoded.data(), data, encoded.end(), count, decoded.data());
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_EQ(decoded[i], values[i]) << "count " << count << ", index " << i;
+            }
+        });
+        DArray<uint32_t> decoded(count);
+        ByteReader reader(encoded);
+        decodeStreamVByte(reader, decoded);
+        EXPECT_EQ(reader.remaining(), 0);
+        EXPECT_TRUE(std::equal(values.begin(), values.end(), decoded.begin()));
+    }
+}
+
+// Test that Stream VByte uses one byte per small value plus the control bytes
+TEST(VarintTest, StreamVByteSize) {
+    DArray<uint32_t> values(100);
+    DArray<std::byte> encoded;
+    encodeStreamVByte(values, encoded);
+    EXPECT_EQ(encoded.size(), 25 + 100);
+
+    DArray<uint32_t> decoded(101);
+    ByteReader reader(encoded);
+    EXPECT_THROW(decodeStreamVByte(reader, decoded), std::out_of_range);
+}
@@ -0,0 +1,59 @@
+#ifndef WORKER_THREADS_HPP
+#define WORKER_THREADS_HPP
+
+#include "dynamic_array.hpp"
+#include "exception_guard.hpp"
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+/**
+ * @brief Calls `function(worker)` for every worker in [0, workers): worker 0 on the calling thread
+ * and each other worker on a thread of its own, and returns once all of them have finished. If a
+ * thread cannot be started, its worker runs on the calling thread after worker 0.
+ * An exception thrown by a worker does not stop the others; once every thread has been joined,
+ * the exception of the lowest-numbered failed worker is rethrown.
+ * @throws std::bad_alloc If memory allocation fails.
+ */
+template <typename FunctionT>
+void runWorkers(size_t workers, const FunctionT& function) {
+    if (workers == 0) {
+        return;
+    }
+    DArray<std::exception_ptr> failures(workers);
+    auto run = [&function, &failures](size_t worker) noexcept {
+        try {
+            function(worker);
+        } catch (...) {
+            failures[worker] = std::current_exception();
+        }
+    };
+    {
+        DArray<std::thread> threads;
+        threads.reserve(workers - 1);
+        // Never completed: the threads are joined however the scope is left.
+        auto join = makeExceptionGuard([&threads]() noexcept {
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        });
+        try {
+            for (size_t worker = 1; worker < workers; ++worker) {
+                threads.push(std::thread(run, worker));
+            }
+        } catch (const std::system_error&) {
+        }
+        run(0);
+        for (size_t worker = threads.size() + 1; worker < workers; ++worker) {
+            run(worker);
+        }
+    }
+    for (const std::exception_ptr& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+}
+
+#endif // WORKER_THREADS_HPP
@@ -0,0 +1,47 @@
+#include "worker_threads.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+// Test that every worker runs once, worker 0 on the calling thread
+TEST(WorkerThreadsTest, RunsEveryWorker) {
+    std::vector<std::atomic<int>> runs(6);
+    std::thread::id caller = std::this_thread::get_id();
+    std::thread::id first;
+    runWorkers(runs.size(), [&](size_t worker) {
+        if (worker == 0) {
+            first = std::this_thread::get_id();
+        }
+        ++runs[worker];
+    });
+    for (const std::atomic<int>& count : runs) {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_EQ(first, caller);
+
+    runWorkers(0, [](size_t) { FAIL(); });
+}
+
+// Test that a failing worker, also on the calling thread, lets the others finish before its exception propagates
+TEST(WorkerThreadsTest, Exceptions) {
+    std::atomic<int> finished = 0;
+    auto failing = [&](size_t worker) {
+        if (worker == 0) {
+            throw std::runtime_error("worker 0");
+        }
+        if (worker == 2) {
+            throw std::logic_error("worker 2");
+        }
+        ++finished;
+    };
+    EXPECT_THROW(runWorkers(4, failing), std::runtime_error);
+    EXPECT_EQ(finished, 2);
+
+    EXPECT_THROW(runWorkers(3, [](size_t worker) {
+                     if (worker == 1) {
+                         throw std::logic_error("worker 1");
+                     }
+                 }),
+                 std::logic_error);
+}